@@ -0,0 +1,72 @@
+#include <Gauntlet.h>
+#include <Gauntlet/Core/Entrypoint.h>
+
+#include "BenchmarkLayer.h"
+
+namespace Gauntlet
+{
+
+class GauntletBenchmark final : public Application
+{
+  public:
+    GauntletBenchmark(const ApplicationSpecification& applicationSpec, const BenchmarkSpecification& benchmarkSpec)
+        : Application(applicationSpec)
+    {
+        // Nothing is presented, so there's nothing to sync to.
+        Renderer::GetSettings().VSync        = false;
+        Renderer::GetSettings().GPUProfiling = true;
+
+        PushLayer(new BenchmarkLayer(benchmarkSpec));
+    }
+
+    ~GauntletBenchmark() {}
+};
+
+// Usage: Benchmark [--scene path] [--frames N] [--warmup N] [--output path] [--width N] [--height N] [--radius R] [--elevation H]
+//                  [--frames-in-flight N] [--extra-entities N] [--render-thread 0|1] [--round-trip 0|1]
+Scoped<Application> CreateApplication(const CommandLineArguments& args)
+{
+    ApplicationSpecification appSpec = {};
+    appSpec.AppName                  = "Gauntlet Benchmark";
+    appSpec.GraphicsAPI              = RendererAPI::EAPI::Vulkan;
+    appSpec.CmdArgs                  = args;
+    appSpec.bHeadless                = true;
+
+    BenchmarkSpecification benchmarkSpec = {};
+    for (int32_t i = 1; i + 1 < args.argc; i += 2)
+    {
+        const std::string_view option = args.argv[i];
+        const char* value             = args.argv[i + 1];
+
+        if (option == "--scene")
+            benchmarkSpec.ScenePath = value;
+        else if (option == "--output")
+            benchmarkSpec.OutputPath = value;
+        else if (option == "--frames")
+            benchmarkSpec.FrameCount = static_cast<uint32_t>(std::stoul(value));
+        else if (option == "--warmup")
+            benchmarkSpec.WarmupFrames = static_cast<uint32_t>(std::stoul(value));
+        else if (option == "--width")
+            appSpec.Width = static_cast<uint32_t>(std::stoul(value));
+        else if (option == "--height")
+            appSpec.Height = static_cast<uint32_t>(std::stoul(value));
+        else if (option == "--radius")
+            benchmarkSpec.OrbitRadius = std::stof(value);
+        else if (option == "--elevation")
+            benchmarkSpec.OrbitHeight = std::stof(value);
+        else if (option == "--frames-in-flight")
+            Renderer::GetSettings().FramesInFlight = static_cast<uint32_t>(std::stoul(value));
+        else if (option == "--extra-entities")
+            benchmarkSpec.ExtraEntityCount = static_cast<uint32_t>(std::stoul(value));
+        else if (option == "--render-thread")
+            Renderer::GetSettings().RenderThread = std::stoul(value) != 0;
+        else if (option == "--round-trip")
+            benchmarkSpec.bRoundTrip = std::stoul(value) != 0;
+        else
+            LOG_WARN("Unknown benchmark option: %s", args.argv[i]);
+    }
+
+    return MakeScoped<GauntletBenchmark>(appSpec, benchmarkSpec);
+}
+
+}  // namespace Gauntlet
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Gauntlet.h>
+
+namespace Gauntlet
+{
+
+// Driven by the benchmark's scripted path only, so runs are repeatable regardless of input.
+class BenchmarkCamera final : public Gauntlet::Camera
+{
+  public:
+    BenchmarkCamera(const float aspectRatio = 0.0f, const float fov = 90.0f) : Gauntlet::Camera(aspectRatio), m_FOV(fov)
+    {
+        m_ZNear = 0.1f;
+        OnResize(m_AspectRatio);
+    }
+
+    ~BenchmarkCamera() = default;
+
+    void OnUpdate(const float deltaTime) final override {}
+    void OnEvent(Event& event) final override {}
+
+    void OnResize(float aspectRatio) final override
+    {
+        m_AspectRatio      = aspectRatio;
+        m_ProjectionMatrix = glm::perspective(glm::radians(m_FOV), m_AspectRatio, m_ZNear, m_ZFar);
+    }
+
+    void LookAt(const glm::vec3& position, const glm::vec3& target)
+    {
+        m_Position = position;
+        m_Target   = target;
+        RecalculateViewMatrix();
+    }
+
+  private:
+    float m_FOV        = 90.0f;
+    glm::vec3 m_Target = glm::vec3(0.0f);
+
+    void RecalculateViewMatrix() final override { m_ViewMatrix = glm::lookAt(m_Position, m_Target, glm::vec3(0.0f, 1.0f, 0.0f)); }
+};
+
+}  // namespace Gauntlet
@@ -0,0 +1,358 @@
+#include "BenchmarkLayer.h"
+#include "Gauntlet/Scene/SceneSerializer.h"
+
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <iomanip>
+#include <filesystem>
+
+namespace Gauntlet
+{
+
+// Scene simulation(particles, animations) steps by fixed delta, so every run sees the same frames.
+static constexpr float s_FixedDeltaTime = 1.0f / 60.0f;
+
+static nlohmann::ordered_json GetSummary(std::vector<float> samples)
+{
+    nlohmann::ordered_json summary = nlohmann::ordered_json::object();
+    if (samples.empty()) return summary;
+
+    std::sort(samples.begin(), samples.end());
+    const auto getPercentile = [&](const float percentile)
+    {
+        // Nearest rank.
+        const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0f * samples.size()));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+
+    summary["Min"]     = samples.front();
+    summary["Max"]     = samples.back();
+    summary["Average"] = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    summary["P50"]     = getPercentile(50.0f);
+    summary["P90"]     = getPercentile(90.0f);
+    summary["P95"]     = getPercentile(95.0f);
+    summary["P99"]     = getPercentile(99.0f);
+    return summary;
+}
+
+BenchmarkLayer::BenchmarkLayer(const BenchmarkSpecification& benchmarkSpec) : Layer("BenchmarkLayer"), m_Specification(benchmarkSpec)
+{
+    m_FrameTimes.reserve(m_Specification.FrameCount);
+    m_CPUFrameTimes.reserve(m_Specification.FrameCount);
+    m_GPUFrameTimes.reserve(m_Specification.FrameCount);
+    m_DrawCalls.reserve(m_Specification.FrameCount);
+    m_ExtractionTimes.reserve(m_Specification.FrameCount);
+}
+
+void BenchmarkLayer::OnAttach()
+{
+    m_Camera = MakeRef<BenchmarkCamera>();
+
+    // Meshes are streamed on background threads, frames are measured on the fully loaded scene, so load time includes waiting on them.
+    const double loadBegin = Timer::Now();
+    m_Scene                = MakeRef<Scene>();
+
+    SceneSerializer serializer(m_Scene);
+    const bool bIsLoaded = serializer.Deserialize(m_Specification.ScenePath);
+    do
+    {
+        // Nothing is recorded yet, so meshes can be published right here.
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        Mesh::PublishStreamedMeshes();
+    } while (Mesh::GetStreamingMeshCount() > 0);
+    m_LoadTime = Timer::Now() - loadBegin;
+
+    if (!bIsLoaded)
+    {
+        LOG_ERROR("Failed to load benchmark scene: %s", m_Specification.ScenePath.data());
+        Application::Get().Close();
+        return;
+    }
+
+    if (m_Specification.ExtraEntityCount > 0) SpawnExtraEntities();
+    if (m_Specification.bRoundTrip) RunRoundTrip();
+
+    LOG_INFO("Benchmark scene loaded in: %0.2f ms, running %u frames(+%u warmup).", m_LoadTime * 1000.0, m_Specification.FrameCount,
+             m_Specification.WarmupFrames);
+}
+
+void BenchmarkLayer::SpawnExtraEntities()
+{
+    std::vector<Ref<Mesh>> meshes;
+    const auto meshView = m_Scene->GetAllEntitiesWith<MeshComponent>();
+    for (auto entityID : meshView)
+    {
+        const auto& mesh = meshView.get<MeshComponent>(entityID).Mesh;
+        if (mesh) meshes.push_back(mesh);
+    }
+
+    // Without meshes stress entities are point lights, they still go through extraction.
+    const auto gridSize      = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(m_Specification.ExtraEntityCount))));
+    const float halfGridSize = gridSize * 0.5f;
+    for (uint32_t i = 0; i < m_Specification.ExtraEntityCount; ++i)
+    {
+        Entity entity = m_Scene->CreateEntity("Benchmark Entity");
+
+        auto& tc       = entity.GetComponent<TransformComponent>();
+        tc.Translation = glm::vec3(static_cast<float>(i % gridSize) - halfGridSize, 0.0f, static_cast<float>(i / gridSize) - halfGridSize);
+        tc.Scale       = glm::vec3(0.1f);
+
+        if (meshes.empty())
+            entity.AddComponent<PointLightComponent>().Intensity = 0.0f;
+        else
+            entity.AddComponent<MeshComponent>(meshes[i % meshes.size()]);
+    }
+
+    LOG_INFO("Benchmark spawned %u extra entities.", m_Specification.ExtraEntityCount);
+}
+
+// Rotation goes through euler angles in text scenes, so everything is compared with a small tolerance.
+static constexpr float s_ROUND_TRIP_EPSILON = 1e-4f;
+
+static bool IsNearlyEqual(const float lhs, const float rhs)
+{
+    return std::abs(lhs - rhs) <= s_ROUND_TRIP_EPSILON;
+}
+
+template <typename T> static bool IsNearlyEqual(const T& lhs, const T& rhs)
+{
+    return glm::all(glm::lessThanEqual(glm::abs(lhs - rhs), T(s_ROUND_TRIP_EPSILON)));
+}
+
+template <typename Component, typename EqualFunc>
+static bool IsComponentEqual(Scene& lhsScene, const entt::entity lhs, Scene& rhsScene, const entt::entity rhs, EqualFunc&& equalFunc)
+{
+    auto lhsView = lhsScene.GetAllEntitiesWith<Component>();
+    auto rhsView = rhsScene.GetAllEntitiesWith<Component>();
+
+    // Both entities have to either lack the component or hold equal ones.
+    const bool bHasComponent = lhsView.contains(lhs);
+    if (bHasComponent != rhsView.contains(rhs)) return false;
+
+    return !bHasComponent || equalFunc(lhsView.template get<Component>(lhs), rhsView.template get<Component>(rhs));
+}
+
+static uint64_t GetParentUUID(Scene& scene, const RelationshipComponent& rc)
+{
+    if (rc.Parent == entt::null) return 0;
+
+    return scene.GetAllEntitiesWith<IDComponent>().get<IDComponent>(rc.Parent).ID;
+}
+
+static bool IsEntityEqual(Scene& lhsScene, const entt::entity lhs, Scene& rhsScene, const entt::entity rhs)
+{
+    const auto isTagEqual       = [](const auto& lhsTag, const auto& rhsTag) { return lhsTag.Tag == rhsTag.Tag; };
+    const auto isTransformEqual = [](const auto& lhsTC, const auto& rhsTC)
+    {
+        return IsNearlyEqual(lhsTC.Translation, rhsTC.Translation) && IsNearlyEqual(lhsTC.Scale, rhsTC.Scale) &&
+               IsNearlyEqual(std::abs(glm::dot(lhsTC.Rotation, rhsTC.Rotation)), 1.0f);
+    };
+    const auto isRelationshipEqual = [&](const auto& lhsRC, const auto& rhsRC)
+    { return GetParentUUID(lhsScene, lhsRC) == GetParentUUID(rhsScene, rhsRC); };
+    const auto isCameraEqual = [](const auto& lhsCC, const auto& rhsCC) { return lhsCC.bIsActive == rhsCC.bIsActive; };
+    const auto isSpriteEqual = [](const auto& lhsSRC, const auto& rhsSRC) { return IsNearlyEqual(lhsSRC.Color, rhsSRC.Color); };
+    const auto isMeshEqual   = [](const auto& lhsMC, const auto& rhsMC)
+    { return lhsMC.Mesh->GetMeshNameWithDirectory() == rhsMC.Mesh->GetMeshNameWithDirectory(); };
+
+    if (!IsComponentEqual<TagComponent>(lhsScene, lhs, rhsScene, rhs, isTagEqual)) return false;
+    if (!IsComponentEqual<TransformComponent>(lhsScene, lhs, rhsScene, rhs, isTransformEqual)) return false;
+    if (!IsComponentEqual<RelationshipComponent>(lhsScene, lhs, rhsScene, rhs, isRelationshipEqual)) return false;
+    if (!IsComponentEqual<CameraComponent>(lhsScene, lhs, rhsScene, rhs, isCameraEqual)) return false;
+    if (!IsComponentEqual<SpriteRendererComponent>(lhsScene, lhs, rhsScene, rhs, isSpriteEqual)) return false;
+    if (!IsComponentEqual<MeshComponent>(lhsScene, lhs, rhsScene, rhs, isMeshEqual)) return false;
+
+    const auto isAnimatorEqual = [](const auto& lhsAC, const auto& rhsAC)
+    {
+        return lhsAC.AnimationIndex == rhsAC.AnimationIndex && lhsAC.bIsPlaying == rhsAC.bIsPlaying &&
+               IsNearlyEqual(lhsAC.PlaybackSpeed, rhsAC.PlaybackSpeed) && IsNearlyEqual(lhsAC.CrossFadeDuration, rhsAC.CrossFadeDuration);
+    };
+    const auto isPointLightEqual = [](const auto& lhsPLC, const auto& rhsPLC)
+    {
+        return IsNearlyEqual(lhsPLC.Color, rhsPLC.Color) && IsNearlyEqual(lhsPLC.Intensity, rhsPLC.Intensity) &&
+               lhsPLC.bIsActive == rhsPLC.bIsActive && lhsPLC.bCastShadows == rhsPLC.bCastShadows;
+    };
+    const auto isDirectionalLightEqual = [](const auto& lhsDLC, const auto& rhsDLC)
+    {
+        return IsNearlyEqual(lhsDLC.Color, rhsDLC.Color) && IsNearlyEqual(lhsDLC.Intensity, rhsDLC.Intensity) &&
+               lhsDLC.bCastShadows == rhsDLC.bCastShadows;
+    };
+    const auto isSpotLightEqual = [](const auto& lhsSLC, const auto& rhsSLC)
+    {
+        return IsNearlyEqual(lhsSLC.Color, rhsSLC.Color) && IsNearlyEqual(lhsSLC.Intensity, rhsSLC.Intensity) &&
+               IsNearlyEqual(lhsSLC.CutOff, rhsSLC.CutOff) && IsNearlyEqual(lhsSLC.OuterCutOff, rhsSLC.OuterCutOff) &&
+               lhsSLC.bIsActive == rhsSLC.bIsActive && lhsSLC.bCastShadows == rhsSLC.bCastShadows;
+    };
+    const auto isParticleEmitterEqual = [](const auto& lhsPEC, const auto& rhsPEC)
+    {
+        return IsNearlyEqual(lhsPEC.StartColor, rhsPEC.StartColor) && IsNearlyEqual(lhsPEC.EndColor, rhsPEC.EndColor) &&
+               IsNearlyEqual(lhsPEC.Velocity, rhsPEC.Velocity) && IsNearlyEqual(lhsPEC.VelocityVariation, rhsPEC.VelocityVariation) &&
+               IsNearlyEqual(lhsPEC.BoundsExtent, rhsPEC.BoundsExtent) && IsNearlyEqual(lhsPEC.SpawnRate, rhsPEC.SpawnRate) &&
+               IsNearlyEqual(lhsPEC.Lifetime, rhsPEC.Lifetime) && IsNearlyEqual(lhsPEC.StartSize, rhsPEC.StartSize) &&
+               IsNearlyEqual(lhsPEC.EndSize, rhsPEC.EndSize) && lhsPEC.bIsActive == rhsPEC.bIsActive;
+    };
+
+    return IsComponentEqual<AnimatorComponent>(lhsScene, lhs, rhsScene, rhs, isAnimatorEqual) &&
+           IsComponentEqual<PointLightComponent>(lhsScene, lhs, rhsScene, rhs, isPointLightEqual) &&
+           IsComponentEqual<DirectionalLightComponent>(lhsScene, lhs, rhsScene, rhs, isDirectionalLightEqual) &&
+           IsComponentEqual<SpotLightComponent>(lhsScene, lhs, rhsScene, rhs, isSpotLightEqual) &&
+           IsComponentEqual<ParticleEmitterComponent>(lhsScene, lhs, rhsScene, rhs, isParticleEmitterEqual);
+}
+
+void BenchmarkLayer::RunRoundTrip()
+{
+    const std::string roundTripPath = (std::filesystem::temp_directory_path() / "BenchmarkRoundTrip.gntlt").string();
+
+    double stepBegin = Timer::Now();
+    SceneSerializer(m_Scene).Serialize(roundTripPath, false);
+    m_RoundTrip.SerializeTime = (Timer::Now() - stepBegin) * 1000.0;
+
+    std::error_code errorCode;
+    m_RoundTrip.FileSize = static_cast<size_t>(std::filesystem::file_size(roundTripPath, errorCode));
+
+    Ref<Scene> loadedScene      = MakeRef<Scene>();
+    stepBegin                   = Timer::Now();
+    const bool bIsLoaded        = SceneSerializer(loadedScene).Deserialize(roundTripPath);
+    m_RoundTrip.DeserializeTime = (Timer::Now() - stepBegin) * 1000.0;
+    std::filesystem::remove(roundTripPath, errorCode);
+
+    if (!bIsLoaded)
+    {
+        LOG_ERROR("Round trip: failed to read the scene back!");
+        return;
+    }
+
+    auto loadedIDs = loadedScene->GetAllEntitiesWith<IDComponent>();
+    std::unordered_map<uint64_t, entt::entity> loadedEntities;
+    loadedEntities.reserve(loadedIDs.size());
+    for (const auto entityID : loadedIDs)
+        loadedEntities.emplace(loadedIDs.get<IDComponent>(entityID).ID, entityID);
+
+    auto ids = m_Scene->GetAllEntitiesWith<IDComponent>();
+    for (const auto entityID : ids)
+    {
+        const uint64_t uuid = ids.get<IDComponent>(entityID).ID;
+        ++m_RoundTrip.EntityCount;
+
+        const auto loadedIt = loadedEntities.find(uuid);
+        if (loadedIt != loadedEntities.end() && IsEntityEqual(*m_Scene, entityID, *loadedScene, loadedIt->second)) continue;
+
+        // First few are enough to see what's wrong.
+        if (m_RoundTrip.MismatchedEntities++ < 8)
+            LOG_ERROR("Round trip: entity %llu doesn't match!", static_cast<unsigned long long>(uuid));
+    }
+
+    m_RoundTrip.bPassed = m_RoundTrip.MismatchedEntities == 0 && loadedEntities.size() == m_RoundTrip.EntityCount;
+    LOG_INFO("Round trip %s: %u entities, %0.2f KB, written in %0.2f ms, read in %0.2f ms.", m_RoundTrip.bPassed ? "passed" : "failed",
+             m_RoundTrip.EntityCount, m_RoundTrip.FileSize / 1024.0, m_RoundTrip.SerializeTime, m_RoundTrip.DeserializeTime);
+}
+
+void BenchmarkLayer::OnUpdate(const float deltaTime)
+{
+    // Statistics of the previous frame are complete by now.
+    if (m_FrameIndex > m_Specification.WarmupFrames) SampleStatistics(deltaTime);
+    m_LastCPUWaitTime = Renderer::GetStats().CPUWaitTime;
+
+    if (m_FrameIndex == m_Specification.WarmupFrames + m_Specification.FrameCount)
+    {
+        WriteResults();
+        Application::Get().Close();
+    }
+
+    const uint32_t pathFrame = m_FrameIndex > m_Specification.WarmupFrames ? m_FrameIndex - m_Specification.WarmupFrames : 0;
+    const float angle        = glm::two_pi<float>() * pathFrame / std::max(m_Specification.FrameCount, 1u);
+    const glm::vec3 position(std::cos(angle) * m_Specification.OrbitRadius, m_Specification.OrbitHeight,
+                             std::sin(angle) * m_Specification.OrbitRadius);
+    m_Camera->LookAt(position, glm::vec3(0.0f));
+
+    Renderer::BeginScene(*m_Camera);
+
+    m_Scene->OnUpdate(s_FixedDeltaTime);
+
+    Renderer::EndScene();
+
+    ++m_FrameIndex;
+}
+
+void BenchmarkLayer::SampleStatistics(const float deltaTime)
+{
+    const auto& stats = Renderer::GetStats();
+
+    // CPU frame time excludes waiting on the in-flight fence, it's what CPU side would take if GPU kept up.
+    m_FrameTimes.push_back(deltaTime * 1000.0f);
+    m_CPUFrameTimes.push_back((deltaTime - m_LastCPUWaitTime) * 1000.0f);
+    m_DrawCalls.push_back(static_cast<float>(stats.FrameDrawCalls));
+    m_ExtractionTimes.push_back(m_Scene->GetStats().ExtractionTime);
+
+    // GPU results are frames in flight late && stay the same until new ones are read back, so they're sampled once.
+    if (stats.GPUMarkersSubmitTime != m_LastGPUSubmitTime)
+    {
+        m_LastGPUSubmitTime = stats.GPUMarkersSubmitTime;
+
+        float gpuFrameTime = 0.0f;
+        for (const auto& marker : stats.GPUMarkers)
+        {
+            if (marker.Depth == 0) gpuFrameTime += marker.Time;
+        }
+
+        m_GPUFrameTimes.push_back(gpuFrameTime);
+    }
+
+    m_PeakGPUMemory   = std::max(m_PeakGPUMemory, stats.GPUMemoryAllocated.load());
+    m_PeakAllocations = std::max(m_PeakAllocations, stats.Allocations.load());
+}
+
+void BenchmarkLayer::WriteResults() const
+{
+    const auto& stats  = Renderer::GetStats();
+    const auto& window = Application::Get().GetWindow();
+
+    nlohmann::ordered_json results;
+    results["Scene"]        = m_Specification.ScenePath;
+    results["Device"]       = stats.RenderingDevice;
+    results["Resolution"]   = {window->GetWidth(), window->GetHeight()};
+    results["Frames"]       = m_Specification.FrameCount;
+    results["WarmupFrames"] = m_Specification.WarmupFrames;
+    results["LoadTime"]     = m_LoadTime * 1000.0;
+    results["Entities"]     = m_Scene->GetStats().EntityCount;
+
+    // (ms), GPU one is the sum of top-level GPU markers of a frame.
+    results["FrameTime"]    = GetSummary(m_FrameTimes);
+    results["CPUFrameTime"] = GetSummary(m_CPUFrameTimes);
+    results["GPUFrameTime"] = GetSummary(m_GPUFrameTimes);
+    results["DrawCalls"]    = GetSummary(m_DrawCalls);
+
+    // (ms) Scene's typed views walked by job system workers && render packets merged into renderer.
+    results["ExtractionTime"] = GetSummary(m_ExtractionTimes);
+
+    auto& memory                 = results["Memory"];
+    memory["VMAAllocations"]     = stats.Allocations.load();
+    memory["PeakVMAAllocations"] = m_PeakAllocations;
+    memory["AllocatedImages"]    = stats.AllocatedImages.load();
+    memory["AllocatedBuffers"]   = stats.AllocatedBuffers.load();
+    memory["GPUMemoryMB"]        = stats.GPUMemoryAllocated.load() / 1024.0 / 1024.0;
+    memory["PeakGPUMemoryMB"]    = m_PeakGPUMemory / 1024.0 / 1024.0;
+    memory["RAMMemoryMB"]        = stats.RAMMemoryAllocated.load() / 1024.0 / 1024.0;
+
+    if (m_Specification.bRoundTrip)
+    {
+        auto& roundTrip              = results["RoundTrip"];
+        roundTrip["Passed"]          = m_RoundTrip.bPassed;
+        roundTrip["Entities"]        = m_RoundTrip.EntityCount;
+        roundTrip["Mismatched"]      = m_RoundTrip.MismatchedEntities;
+        roundTrip["FileSizeKB"]      = m_RoundTrip.FileSize / 1024.0;
+        roundTrip["SerializeTime"]   = m_RoundTrip.SerializeTime;
+        roundTrip["DeserializeTime"] = m_RoundTrip.DeserializeTime;
+    }
+
+    std::ofstream out(m_Specification.OutputPath, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+    {
+        LOG_ERROR("Failed to open benchmark output file: %s", m_Specification.OutputPath.data());
+        return;
+    }
+
+    out << std::setw(2) << results << std::endl;
+    LOG_INFO("Benchmark results written to: %s", m_Specification.OutputPath.data());
+}
+
+}  // namespace Gauntlet
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Gauntlet.h>
+#include "BenchmarkCamera.h"
+
+namespace Gauntlet
+{
+
+struct BenchmarkSpecification
+{
+    std::string ScenePath  = "Resources/Scenes/SponzaTest.gntlt";
+    std::string OutputPath = "BenchmarkResults.json";
+    uint32_t FrameCount    = 1000;
+    uint32_t WarmupFrames  = 60;  // Skipped, pipelines && caches settle during them.
+
+    // Stress entities on top of the scene, they share its meshes && are laid out in a grid around origin.
+    uint32_t ExtraEntityCount = 0;
+
+    // Camera orbits scene origin once over measured frames.
+    float OrbitRadius = 10.0f;
+    float OrbitHeight = 3.0f;
+
+    // Loaded scene(with stress entities) is written as compact text, read back && compared entity by entity.
+    bool bRoundTrip = false;
+};
+
+class BenchmarkLayer final : public Layer
+{
+  public:
+    BenchmarkLayer(const BenchmarkSpecification& benchmarkSpec);
+    ~BenchmarkLayer() = default;
+
+    void OnAttach() final override;
+    void OnDetach() final override {}
+
+    void OnUpdate(const float deltaTime) final override;
+    void OnEvent(Event& event) final override {}
+    void OnImGuiRender() final override {}
+
+  private:
+    BenchmarkSpecification m_Specification;
+    Ref<BenchmarkCamera> m_Camera;
+    Ref<Scene> m_Scene;
+
+    uint32_t m_FrameIndex      = 0;
+    double m_LoadTime          = 0.0;  // (s)
+    float m_LastCPUWaitTime    = 0.0f;
+    double m_LastGPUSubmitTime = 0.0;
+    size_t m_PeakGPUMemory     = 0;
+    size_t m_PeakAllocations   = 0;
+
+    struct RoundTripResult
+    {
+        bool bPassed                = false;
+        uint32_t EntityCount        = 0;
+        uint32_t MismatchedEntities = 0;
+        size_t FileSize             = 0;    // (bytes)
+        double SerializeTime        = 0.0;  // (ms)
+        double DeserializeTime      = 0.0;  // (ms)
+    } m_RoundTrip;
+
+    // (ms)
+    std::vector<float> m_FrameTimes;
+    std::vector<float> m_CPUFrameTimes;
+    std::vector<float> m_GPUFrameTimes;
+    std::vector<float> m_DrawCalls;
+    std::vector<float> m_ExtractionTimes;
+
+    void SpawnExtraEntities();
+    void RunRoundTrip();
+    void SampleStatistics(const float deltaTime);
+    void WriteResults() const;
+};
+
+}  // namespace Gauntlet
@@ -8,20 +8,35 @@ layout(location = 1) in vec2 in_TexCoord;
 layout(location = 2) in flat float in_TextureId;
 layout(location = 3) in vec3 in_Normal;
 
-layout(location = 1) out vec4 out_Normal;
-layout(location = 2) out vec4 out_FragColor;
+layout(location = 0) out vec4 out_FragColor;
+layout(location = 1) out vec4 out_Normal; // Octahedral normal in xy, roughness in z.
+layout(location = 2) out float out_AO;
 
 layout(set = 0, binding = 0) uniform sampler2D u_Sprites[32];
 
+// Keep in sync with Geometry.frag
+vec2 OctWrap(const vec2 v)
+{
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeOctahedral(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
 void main()
 {
 	int textureID = int(in_TextureId);
 	if(textureID >= 32) textureID = 0;
 
 	// TODO: 2d normal mapping?
-	out_Normal = vec4(in_Normal, 0.0);
+	out_Normal = vec4(EncodeOctahedral(normalize(in_Normal)), 1.0, 0.0);
 
 	const vec4 spriteTex = texture(u_Sprites[nonuniformEXT(textureID)], in_TexCoord);
 	if(spriteTex.a < 0.00001) discard;
-	out_FragColor = spriteTex * in_Color;
+	out_FragColor = vec4((spriteTex * in_Color).rgb, 0.0);
+	out_AO = 1.0;
 }
\ No newline at end of file
@@ -2,10 +2,10 @@
 
 #extension GL_KHR_vulkan_glsl : enable
 
-layout(location = 0) out vec4 out_Position;
-layout(location = 1) out vec4 out_Normal;
-layout(location = 2) out vec4 out_Albedo;
-layout(location = 3) out vec4 out_MRAO; // Metallic Roughness AO
+// Compact GBuffer, position is reconstructed from depth in lighting pass.
+layout(location = 0) out vec4 out_Albedo; // Albedo in rgb, metallic in a.
+layout(location = 1) out vec4 out_Normal; // Octahedral normal in xy, roughness in z.
+layout(location = 2) out float out_AO;
 
 layout(location = 0) in vec4 in_Color;
 layout(location = 1) in vec2 in_TexCoord;
@@ -27,19 +27,32 @@ layout(set = 0, binding = 6) uniform UBMaterialData
     float padding1;
 } u_PBRMaterial;
 
+// Maps unit vector onto octahedron unfolded into [0, 1] square.
+vec2 OctWrap(const vec2 v)
+{
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeOctahedral(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
 void main()
 {
-    out_Albedo = texture(u_Albedo, in_TexCoord) * in_Color * u_PBRMaterial.BaseColor;
-	if (out_Albedo.a < 0.00001) discard; // Temporary "alpha-blending"
-	
-    out_Position = vec4(in_FragmentPosition, 1.0);
+    const vec4 albedo = texture(u_Albedo, in_TexCoord) * in_Color * u_PBRMaterial.BaseColor;
+	if (albedo.a < 0.00001) discard; // Temporary "alpha-blending"
 	
 	// Transforming normal map from tangent space to world space.
-	const vec3 N = in_TBN * normalize(texture(u_NormalMap, in_TexCoord).rgb * 2.0 - 1.0);
-    out_Normal = normalize(vec4(N, 1.0));
+	const vec3 N = normalize(in_TBN * normalize(texture(u_NormalMap, in_TexCoord).rgb * 2.0 - 1.0));
 
 	const float Metallic = texture(u_MetallicMap,   in_TexCoord).r * u_PBRMaterial.Metallic;
 	const float Roughness = texture(u_RoughnessMap, in_TexCoord).r * u_PBRMaterial.Roughness;
 	const float AO = texture(u_AOMap, in_TexCoord).r;
-	out_MRAO = vec4(Metallic, Roughness, AO, 0.0);
+
+	out_Albedo = vec4(albedo.rgb, Metallic);
+	out_Normal = vec4(EncodeOctahedral(N), Roughness, 0.0);
+	out_AO = AO;
 }
\ No newline at end of file
@@ -7,10 +7,11 @@ layout(location = 0) in vec2 in_TexCoord;
 
 layout(location = 0) out vec4 out_FragColor;
 
-layout(set = 0, binding = 0) uniform sampler2D u_PositionMap;
-layout(set = 0, binding = 1) uniform sampler2D u_NormalMap;
-layout(set = 0, binding = 2) uniform sampler2D u_AlbedoMap;
-layout(set = 0, binding = 3) uniform sampler2D u_MRAO; // Metallic Roughness AO
+// Compact GBuffer, world position is reconstructed from depth.
+layout(set = 0, binding = 0) uniform sampler2D u_DepthMap;
+layout(set = 0, binding = 1) uniform sampler2D u_NormalMap; // Octahedral normal in xy, roughness in z.
+layout(set = 0, binding = 2) uniform sampler2D u_AlbedoMap; // Albedo in rgb, metallic in a.
+layout(set = 0, binding = 3) uniform sampler2D u_MaterialAOMap;
 layout(set = 0, binding = 4) uniform sampler2D u_SSAOMap;
 
 layout( push_constant ) uniform PushConstants
@@ -31,15 +32,16 @@ struct DirectionalLight
 
 struct PointLight
 {
-    vec4 Position;
+    vec4 Position; // w - radius
     vec4 Color;
     float Intensity;
     float IsActive;
+    int ShadowIndex; // First of 6 cube face entries in local shadows buffer, -1 - no shadow.
 };
 
 struct SpotLight
 {
-    vec4 Position;
+    vec4 Position; // w - radius
     vec4 Color;
     vec3 Direction;
     float CutOff;
@@ -47,22 +49,85 @@ struct SpotLight
 
     float Intensity;
     float IsActive;
+    int ShadowIndex; // -1 - no shadow.
 };
 
-#define MAX_POINT_LIGHTS 16
-#define MAX_SPOT_LIGHTS 8
+// Keep in sync with CoreRendererTypes.h
 #define MAX_DIR_LIGHTS 4
+#define LIGHT_CLUSTERS_X 16
+#define LIGHT_CLUSTERS_Y 9
+#define LIGHT_CLUSTERS_Z 24
+#define MAX_LIGHTS_PER_CLUSTER 128
+#define MAX_SHADOW_CASCADES 4
+
+struct LightCluster
+{
+    uint PointLightCount;
+    uint SpotLightCount;
+    uint LightIndices[MAX_LIGHTS_PER_CLUSTER]; // Point light indices first, then spot light indices.
+};
 
 layout(set = 0, binding = 5, scalar) uniform UBLightingData
 {
 	DirectionalLight DirLights[MAX_DIR_LIGHTS];
-	SpotLight SpotLights[MAX_SPOT_LIGHTS];
-	PointLight PointLights[MAX_POINT_LIGHTS];
 
 	float Gamma;
 	float Exposure;
+	mat4 InvViewProjection;
 } u_LightingData;
 
+layout(set = 0, binding = 6, scalar) uniform UBLightClustersData
+{
+    mat4 Projection;
+    mat4 InvProjection;
+    mat4 View;
+    float zNear;
+    float zFar;
+    uint PointLightCount;
+    uint SpotLightCount;
+} u_LightClustersData;
+
+layout(set = 0, binding = 7, scalar) readonly buffer PointLightsSSBO
+{
+    PointLight Lights[];
+} s_PointLights;
+
+layout(set = 0, binding = 8, scalar) readonly buffer SpotLightsSSBO
+{
+    SpotLight Lights[];
+} s_SpotLights;
+
+layout(set = 0, binding = 9, scalar) readonly buffer LightClustersSSBO
+{
+    LightCluster Clusters[];
+} s_LightClusters;
+
+// Cascades are stored as layers.
+layout(set = 0, binding = 10) uniform sampler2DArray u_ShadowMap;
+
+layout(set = 0, binding = 11, scalar) uniform UBShadowsData
+{
+    mat4 LightSpaceMatrices[MAX_SHADOW_CASCADES];
+    vec4 CascadeSplits; // View space far distance of each cascade.
+    uint CascadeCount;  // 0 - shadows disabled.
+    uint SoftShadows;
+    uint LightIndex;
+} u_ShadowsData;
+
+// Point && spot light shadows, every spot light or point light cube face owns a tile.
+struct LocalLightShadow
+{
+    mat4 ViewProjection;
+    vec4 AtlasRect; // xy - uv offset, zw - uv size, zero size - no shadow this frame.
+};
+
+layout(set = 0, binding = 12) uniform sampler2D u_LocalShadowAtlas;
+
+layout(set = 0, binding = 13, scalar) readonly buffer LocalShadowsSSBO
+{
+    LocalLightShadow Shadows[];
+} s_LocalShadows;
+
 const float PI = 3.14159265359;
 
 float DistributionGGX(vec3 N, vec3 H, float roughness)
@@ -103,16 +168,149 @@ vec3 fresnelSchlick(float cosTheta, vec3 F0)
     return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
 }
 
+// Inverse square falloff windowed to reach zero at light's radius, so lights culled by clusters don't pop.
+float GetDistanceAttenuation(const float distance, const float radius)
+{
+    const float distanceOverRadius = distance / radius;
+    const float window = clamp(1.0 - distanceOverRadius * distanceOverRadius * distanceOverRadius * distanceOverRadius, 0.0, 1.0);
+    return window * window / (distance * distance + 0.0001);
+}
+
+uint GetClusterIndex(const vec3 fragPos)
+{
+    const vec4 viewPos = u_LightClustersData.View * vec4(fragPos, 1.0);
+    const vec4 clipPos = u_LightClustersData.Projection * viewPos;
+    const vec2 screenUV = clamp(clipPos.xy / clipPos.w * 0.5 + 0.5, 0.0, 0.9999);
+
+    // Exponential depth slices, see LightCulling.comp
+    const float depth = max(-viewPos.z, u_LightClustersData.zNear);
+    const float slice = log(depth / u_LightClustersData.zNear) / log(u_LightClustersData.zFar / u_LightClustersData.zNear) * LIGHT_CLUSTERS_Z;
+
+    const uvec3 cluster = uvec3(uvec2(screenUV * vec2(LIGHT_CLUSTERS_X, LIGHT_CLUSTERS_Y)), min(uint(slice), LIGHT_CLUSTERS_Z - 1));
+    return cluster.x + cluster.y * LIGHT_CLUSTERS_X + cluster.z * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y;
+}
+
+float SampleShadowMap(const vec3 shadowCoord, const uint cascade, const vec2 offset)
+{
+    const float closestDepth = texture(u_ShadowMap, vec3(shadowCoord.xy + offset, cascade)).r;
+    return shadowCoord.z > closestDepth ? 0.0 : 1.0;
+}
+
+// 1.0 - lit, 0.0 - fully in shadow.
+float GetShadow(const vec3 fragPos, const vec3 N, const vec3 L)
+{
+    if (u_ShadowsData.CascadeCount == 0) return 1.0;
+
+    const float viewDepth = -(u_LightClustersData.View * vec4(fragPos, 1.0)).z;
+    if (viewDepth > u_ShadowsData.CascadeSplits[u_ShadowsData.CascadeCount - 1]) return 1.0;
+
+    uint cascade = 0;
+    while (cascade < u_ShadowsData.CascadeCount - 1 && viewDepth > u_ShadowsData.CascadeSplits[cascade]) ++cascade;
+
+    // Cached cascades may lag behind the camera a bit, so fall back to the next one if fragment isn't covered.
+    for (; cascade < u_ShadowsData.CascadeCount; ++cascade)
+    {
+        const vec4 lightSpacePos = u_ShadowsData.LightSpaceMatrices[cascade] * vec4(fragPos, 1.0);
+        vec3 shadowCoord = lightSpacePos.xyz / lightSpacePos.w;
+        shadowCoord.xy = vec2(shadowCoord.x * 0.5 + 0.5, 0.5 - shadowCoord.y * 0.5); // Viewport is flipped.
+        if (any(lessThan(shadowCoord, vec3(0.0))) || any(greaterThan(shadowCoord, vec3(1.0)))) continue;
+
+        // Slope scaled bias against acne.
+        shadowCoord.z -= max(0.0025 * (1.0 - max(dot(N, L), 0.0)), 0.00025);
+
+        if (u_ShadowsData.SoftShadows == 0) return SampleShadowMap(shadowCoord, cascade, vec2(0.0));
+
+        // 3x3 PCF
+        const vec2 texelSize = 1.0 / vec2(textureSize(u_ShadowMap, 0).xy);
+        float shadow = 0.0;
+        for (int x = -1; x <= 1; ++x)
+        {
+            for (int y = -1; y <= 1; ++y)
+                shadow += SampleShadowMap(shadowCoord, cascade, vec2(x, y) * texelSize);
+        }
+        return shadow / 9.0;
+    }
+
+    return 1.0;
+}
+
+// 1.0 - lit, 0.0 - fully in shadow.
+float GetLocalShadow(const int shadowIndex, const vec3 fragPos)
+{
+    const LocalLightShadow shadow = s_LocalShadows.Shadows[shadowIndex];
+    if (shadow.AtlasRect.z <= 0.0) return 1.0;
+
+    const vec4 lightSpacePos = shadow.ViewProjection * vec4(fragPos, 1.0);
+    if (lightSpacePos.w <= 0.0) return 1.0;
+
+    vec3 shadowCoord = lightSpacePos.xyz / lightSpacePos.w;
+    if (any(lessThan(shadowCoord, vec3(-1.0, -1.0, 0.0))) || any(greaterThan(shadowCoord, vec3(1.0)))) return 1.0;
+
+    // Viewport is flipped, then remap into the tile.
+    const vec2 tileUV = vec2(shadowCoord.x * 0.5 + 0.5, 0.5 - shadowCoord.y * 0.5);
+    const vec2 uv = shadow.AtlasRect.xy + tileUV * shadow.AtlasRect.zw;
+    const float depth = shadowCoord.z - 0.0005;
+
+    if (u_ShadowsData.SoftShadows == 0) return depth > texture(u_LocalShadowAtlas, uv).r ? 0.0 : 1.0;
+
+    // 3x3 PCF, kept inside the tile so neighbours don't bleed in.
+    const vec2 texelSize = 1.0 / vec2(textureSize(u_LocalShadowAtlas, 0));
+    const vec2 minUV = shadow.AtlasRect.xy + texelSize * 0.5;
+    const vec2 maxUV = shadow.AtlasRect.xy + shadow.AtlasRect.zw - texelSize * 0.5;
+    float result = 0.0;
+    for (int x = -1; x <= 1; ++x)
+    {
+        for (int y = -1; y <= 1; ++y)
+            result += depth > texture(u_LocalShadowAtlas, clamp(uv + vec2(x, y) * texelSize, minUV, maxUV)).r ? 0.0 : 1.0;
+    }
+    return result / 9.0;
+}
+
+// Picks cube face by the major axis of light to fragment vector, faces are stored in +X, -X, +Y, -Y, +Z, -Z order.
+float GetPointLightShadow(const PointLight light, const vec3 fragPos)
+{
+    if (light.ShadowIndex < 0) return 1.0;
+
+    const vec3 lightToFrag = fragPos - light.Position.xyz;
+    const vec3 absDir = abs(lightToFrag);
+    int face = 0;
+    if (absDir.x >= absDir.y && absDir.x >= absDir.z) face = lightToFrag.x > 0.0 ? 0 : 1;
+    else if (absDir.y >= absDir.z) face = lightToFrag.y > 0.0 ? 2 : 3;
+    else face = lightToFrag.z > 0.0 ? 4 : 5;
+
+    return GetLocalShadow(light.ShadowIndex + face, fragPos);
+}
+
+// Keep in sync with Geometry.frag
+vec3 DecodeOctahedral(const vec2 encoded)
+{
+    const vec2 f = encoded * 2.0 - 1.0;
+    vec3 n = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+    const float t = clamp(-n.z, 0.0, 1.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+// Viewport is flipped, so uv.y = 0 is the top of ndc.
+vec3 ReconstructWorldPosition(const vec2 uv, const float depth)
+{
+    const vec4 worldPos = u_LightingData.InvViewProjection * vec4(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, depth, 1.0);
+    return worldPos.xyz / worldPos.w;
+}
+
 void main()
 {
-    const vec3 albedo     = pow(texture(u_AlbedoMap, in_TexCoord).rgb, vec3(2.2));
-    const float metallic  = texture(u_MRAO, in_TexCoord).r;
-    const float roughness = texture(u_MRAO, in_TexCoord).y;
-    const vec3 fragPos = texture(u_PositionMap, in_TexCoord).rgb;
-    const float ao        = texture(u_MRAO, in_TexCoord).z;         // this one is from material
+    const vec4 albedoMetallic  = texture(u_AlbedoMap, in_TexCoord);
+    const vec4 normalRoughness = texture(u_NormalMap, in_TexCoord);
+
+    const vec3 albedo     = pow(albedoMetallic.rgb, vec3(2.2));
+    const float metallic  = albedoMetallic.a;
+    const float roughness = normalRoughness.z;
+    const vec3 fragPos    = ReconstructWorldPosition(in_TexCoord, texture(u_DepthMap, in_TexCoord).r);
+    const float ao        = texture(u_MaterialAOMap, in_TexCoord).r; // this one is from material
     const float calcAO    = texture(u_SSAOMap, in_TexCoord).r; // this one is calculated from scene
 
-    const vec3 N = texture(u_NormalMap, in_TexCoord).rgb;
+    const vec3 N = DecodeOctahedral(normalRoughness.xy);
     const vec3 V = normalize(u_MeshPushConstants.Data.xyz - fragPos);
 
     // calculate reflectance at normal incidence; if dia-electric (like plastic) use F0 
@@ -123,17 +321,24 @@ void main()
 
     // constant ambient light
     const vec3 ambient = vec3(0.03) * albedo * ao * calcAO;
-    for(int i = 0; i < MAX_POINT_LIGHTS; ++i)
+    color += ambient;
+
+    // Only lights binned into this fragment's cluster.
+    const uint clusterIndex = GetClusterIndex(fragPos);
+    const uint pointLightCount = s_LightClusters.Clusters[clusterIndex].PointLightCount;
+    const uint spotLightCount = s_LightClusters.Clusters[clusterIndex].SpotLightCount;
+
+    for(uint i = 0; i < pointLightCount; ++i)
     {
-        if(u_LightingData.PointLights[i].IsActive == 0) continue;
+        const PointLight light = s_PointLights.Lights[s_LightClusters.Clusters[clusterIndex].LightIndices[i]];
         vec3 Lo = vec3(0.0);
 
         // calculate per-light radiance
-        vec3 L = normalize(u_LightingData.PointLights[i].Position.xyz - fragPos);
+        vec3 L = normalize(light.Position.xyz - fragPos);
         vec3 H = normalize(V + L);
-        float distance = length(u_LightingData.PointLights[i].Position.xyz - fragPos);
-        float attenuation = 1.0 / (distance * distance) + 0.0001;
-        vec3 radiance = u_LightingData.PointLights[i].Color.xyz * attenuation *  u_LightingData.PointLights[i].Intensity;
+        float distance = length(light.Position.xyz - fragPos);
+        float attenuation = GetDistanceAttenuation(distance, light.Position.w);
+        vec3 radiance = light.Color.xyz * attenuation * light.Intensity * GetPointLightShadow(light, fragPos);
 
         // Cook-Torrance BRDF
         float NDF = DistributionGGX(N, H, roughness);
@@ -160,7 +365,7 @@ void main()
         // add to outgoing radiance Lo
         Lo += (kD * albedo / PI + specular) * radiance * NdotL;  // note that we already multiplied the BRDF by the Fresnel (kS) so we won't multiply by kS again
 
-        color += ambient + Lo;
+        color += Lo;
     }
 
     for(int i = 0; i < MAX_DIR_LIGHTS; ++i)
@@ -194,32 +399,34 @@ void main()
 
         // scale light by NdotL
         float NdotL = max(dot(N, L), 0.0);
-        const float I = NdotL *  u_LightingData.DirLights[i].Intensity;
+        float I = NdotL *  u_LightingData.DirLights[i].Intensity;
+        if (uint(i) == u_ShadowsData.LightIndex) I *= GetShadow(fragPos, N, L);
 
         // add to outgoing radiance Lo
         Lo += (kD * albedo / PI + specular) * radiance * I;  // note that we already multiplied the BRDF by the Fresnel (kS) so we won't multiply by kS again
         
-        color += ambient + Lo;
+        color += Lo;
     }
 
-    for(int i = 0; i < MAX_SPOT_LIGHTS; ++i)
+    for(uint i = 0; i < spotLightCount; ++i)
     {
-        if(u_LightingData.SpotLights[i].IsActive == 0) continue;
+        const SpotLight light = s_SpotLights.Lights[s_LightClusters.Clusters[clusterIndex].LightIndices[pointLightCount + i]];
         vec3 Lo = vec3(0.0);
 
         // check if lighting is inside the spotlight cone
-        vec3 L = normalize(u_LightingData.SpotLights[i].Position.xyz - fragPos);
+        vec3 L = normalize(light.Position.xyz - fragPos);
 
         // Spotlight
-        const float theta = dot(L, normalize(-u_LightingData.SpotLights[i].Direction)); 
-        const float epsilon   = u_LightingData.SpotLights[i].CutOff - u_LightingData.SpotLights[i].OuterCutOff;
-        const float radiusAttenutaion = clamp((theta - u_LightingData.SpotLights[i].OuterCutOff) / epsilon, 0.0, 1.0); // theta > outer cut off -> 0, inside cutoff -> 1, otherwise interpolate
+        const float theta = dot(L, normalize(-light.Direction)); 
+        const float epsilon   = light.CutOff - light.OuterCutOff;
+        const float radiusAttenutaion = clamp((theta - light.OuterCutOff) / epsilon, 0.0, 1.0); // theta > outer cut off -> 0, inside cutoff -> 1, otherwise interpolate
 
         // calculate per-light radiance
         vec3 H = normalize(V + L);
-        float distance = length(u_LightingData.SpotLights[i].Position.xyz - fragPos);
-        float attenuation = 1.0 / (distance * distance) + 0.0001;
-        vec3 radiance = u_LightingData.SpotLights[i].Color.xyz * attenuation * u_LightingData.SpotLights[i].Intensity * radiusAttenutaion;
+        float distance = length(light.Position.xyz - fragPos);
+        float attenuation = GetDistanceAttenuation(distance, light.Position.w);
+        vec3 radiance = light.Color.xyz * attenuation * light.Intensity * radiusAttenutaion;
+        if (light.ShadowIndex >= 0) radiance *= GetLocalShadow(light.ShadowIndex, fragPos);
 
         // Cook-Torrance BRDF
         float NDF = DistributionGGX(N, H, roughness);
@@ -245,7 +452,7 @@ void main()
 
         // add to outgoing radiance Lo
         Lo += (kD * albedo / PI + specular) * radiance * NdotL;  // note that we already multiplied the BRDF by the Fresnel (kS) so we won't multiply by kS again
-        color += ambient + Lo;
+        color += Lo;
     }
 
     // HDR tonemapping
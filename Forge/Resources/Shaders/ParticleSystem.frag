@@ -2,14 +2,16 @@
 
 #extension GL_KHR_vulkan_glsl : enable
 
-layout(location = 0) out vec4 out_Position;
-layout(location = 2) out vec4 out_Albedo;
+layout(location = 0) out vec4 out_Color;
 
-layout(location = 0) in vec3 in_Color;
-layout(location = 1) in vec3 in_FragPos;
+layout(location = 0) in vec4 in_Color;
+layout(location = 1) in vec2 in_UV;
 
 void main()
 {
-	out_Position = vec4(in_FragPos, 1.0f);
-	out_Albedo = vec4(in_Color, 1.0f);
-}
\ No newline at end of file
+	// Soft round particle.
+	const float falloff = 1.0 - smoothstep(0.5, 1.0, length(in_UV));
+	if (falloff <= 0.0) discard;
+
+	out_Color = vec4(in_Color.rgb, in_Color.a * falloff);
+}
@@ -1,11 +1,32 @@
 #version 460
 
-layout(location = 0) in vec3 in_Pos;
-layout(location = 1) in vec3 in_Velocity;
-layout(location = 2) in vec3 in_Color;
+#extension GL_EXT_scalar_block_layout : require
 
-layout(location = 0) out vec3 out_Color;
-layout(location = 1) out vec3 out_FragPos;
+// Particles are pulled from the pool in sorted order, each instance expands into a camera facing quad.
+// Keep in sync with ParticleSimulation.comp
+struct Particle
+{
+    vec3 Position;
+    float Age;
+    vec3 Velocity;
+    float Lifetime;
+    vec4 StartColor;
+    vec4 EndColor;
+    float StartSize;
+    float EndSize;
+    uint EmitterIndex;
+    float Padding;
+};
+
+layout(set = 0, binding = 0, scalar) readonly buffer ParticlesSSBO
+{
+    Particle Particles[];
+} s_Particles;
+
+layout(set = 0, binding = 1, scalar) readonly buffer SortListSSBO
+{
+    uvec2 Entries[];
+} s_SortList;
 
 layout(push_constant) uniform PushConstants
 {
@@ -13,17 +34,21 @@ layout(push_constant) uniform PushConstants
 	mat4 CameraView;
 } u_ParticlePushConstants;
 
-out gl_PerVertex
-{
-	vec4 gl_Position;
-	float gl_PointSize;
-};
+layout(location = 0) out vec4 out_Color;
+layout(location = 1) out vec2 out_UV;
+
+const vec2 s_QuadCorners[6] = vec2[6](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0), vec2(-1.0, -1.0));
 
 void main()
 {
-	out_FragPos = in_Pos;
-	gl_Position = u_ParticlePushConstants.CameraProjection * u_ParticlePushConstants.CameraView * vec4(out_FragPos, 1.0f); 
-	gl_PointSize = 8.0f;
+	const Particle particle = s_Particles.Particles[s_SortList.Entries[gl_InstanceIndex].y];
+	const float t           = clamp(particle.Age / particle.Lifetime, 0.0, 1.0);
+	const vec2 corner       = s_QuadCorners[gl_VertexIndex];
+
+	vec4 viewPosition = u_ParticlePushConstants.CameraView * vec4(particle.Position, 1.0);
+	viewPosition.xy += corner * mix(particle.StartSize, particle.EndSize, t) * 0.5;
+	gl_Position = u_ParticlePushConstants.CameraProjection * viewPosition;
 
-	out_Color = in_Color;
-}
\ No newline at end of file
+	out_Color = mix(particle.StartColor, particle.EndColor, t);
+	out_UV    = corner;
+}
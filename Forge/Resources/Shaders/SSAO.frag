@@ -6,22 +6,25 @@ layout(location = 0) in vec2 in_UV;
 
 layout(location = 0) out float out_FragColor;
 
-layout(set = 0, binding = 0) uniform sampler2D u_PositionMap;
-layout(set = 0, binding = 1) uniform sampler2D u_NormalMap;
+layout(set = 0, binding = 0) uniform sampler2D u_DepthMap;
+layout(set = 0, binding = 1) uniform sampler2D u_NormalMap; // Octahedral normal in xy.
 layout(set = 0, binding = 2) uniform sampler2D u_TexNoiseMap;
 
 layout(set = 0, binding = 3) uniform UBSSAO
 {
 	mat4 CameraProjection;
 	mat4 InvViewMatrix;
+	mat4 InvProjection;
 	float Radius;
 	float Bias;
 	int Magnitude;
+	int BlurRadius;
+	int ResolutionScale;
 } u_UBSSAO;
 
 vec2 GetNoiseUV()
 {
-	const ivec2 texDim   = textureSize(u_PositionMap, 0);
+	const ivec2 texDim   = textureSize(u_DepthMap, 0);
 	const ivec2 noiseDim = textureSize(u_TexNoiseMap, 0);
 	return vec2(float(texDim.x) / float(noiseDim.x), float(texDim.y) / float(noiseDim.y)) * in_UV;
 }
@@ -39,41 +42,53 @@ const vec3 samples[maxSamplesNum] = {
         vec3(-0.0664,-0.306636,0.20302),vec3(0.411915,-0.471147,0.198689)
 };
 
+// Keep in sync with Geometry.frag
+vec3 DecodeOctahedral(const vec2 encoded)
+{
+    const vec2 f = encoded * 2.0 - 1.0;
+    vec3 n = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+    const float t = clamp(-n.z, 0.0, 1.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+// Viewport is flipped, so uv.y = 0 is the top of ndc.
+vec3 ReconstructViewPosition(const vec2 uv)
+{
+    const vec4 viewPos = u_UBSSAO.InvProjection * vec4(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, texture(u_DepthMap, uv).r, 1.0);
+    return viewPos.xyz / viewPos.w;
+}
+
 void main()
 {
-	const vec3 worldPos = texture(u_PositionMap, in_UV).xyz;
-	const vec3 worldN = normalize(texture(u_NormalMap, in_UV)).xyz;
+	// Position is reconstructed from depth, so everything is done in view space.
+	const vec3 viewPos = ReconstructViewPosition(in_UV);
+	const vec3 viewN   = normalize(mat3(u_UBSSAO.InvViewMatrix) * DecodeOctahedral(texture(u_NormalMap, in_UV).xy));
 
 	// Random rotation vector along Z axis in tangent space
 	const vec3 randomVec = normalize(texture(u_TexNoiseMap, GetNoiseUV()).xyz);
 
-	// TBN change-of-basis from tanget space -> world space (since normal in world)
-	const vec3 T = normalize(randomVec - worldN * dot(randomVec, worldN)); // gram-schmidt orthogonalization(projecting randomVec onto worldN and making it perpendicular)
-	const vec3 B = cross(worldN, T);
-	const mat3 TBN = mat3(T, B, worldN);
+	// TBN change-of-basis from tanget space -> view space
+	const vec3 T = normalize(randomVec - viewN * dot(randomVec, viewN)); // gram-schmidt orthogonalization(projecting randomVec onto viewN and making it perpendicular)
+	const vec3 B = cross(viewN, T);
+	const mat3 TBN = mat3(T, B, viewN);
 	
 	float occlusion = 0.0f;
 	for(int i = 0; i < maxSamplesNum; ++i)
 	{
-	    vec3 samplePos = TBN * samples[i];
-	    samplePos = worldPos + samplePos * u_UBSSAO.Radius;
+	    const vec3 samplePos = viewPos + TBN * samples[i] * u_UBSSAO.Radius;
 
-		const vec3 sampleDir = normalize(samplePos - worldPos); // world space sample direction
-        const float NdotS = max(dot(worldN, sampleDir), 0); // to make sure that the angle between normal and sample direction is not obtuse(>90 degrees)
+		const vec3 sampleDir = normalize(samplePos - viewPos); // view space sample direction
+        const float NdotS = max(dot(viewN, sampleDir), 0); // to make sure that the angle between normal and sample direction is not obtuse(>90 degrees)
 		if(NdotS < 0.15) continue; // also if sampleDir is almost parallel it sucks
 
-		samplePos = vec3(u_UBSSAO.InvViewMatrix * vec4(samplePos, 1.0f)); // transform sample from world to view space
-
-		vec4 offsetUV = vec4(samplePos, 1.0f);
-		offsetUV      = u_UBSSAO.CameraProjection * offsetUV;   // view -> clip ([-w,w])
-		offsetUV.xy = (offsetUV.xy / offsetUV.w) * 0.5f + 0.5f; // clip -> [-1, 1] (ndc) -> UV space
-		offsetUV.y *= -1.0F;
+		vec4 offsetUV = u_UBSSAO.CameraProjection * vec4(samplePos, 1.0f); // view -> clip ([-w,w])
+		offsetUV.xy   = offsetUV.xy / offsetUV.w;                          // clip -> [-1, 1] (ndc)
+		offsetUV.xy   = vec2(offsetUV.x * 0.5f + 0.5f, 0.5f - offsetUV.y * 0.5f); // ndc -> UV space
 
 		// To make sure that distance between sampled pos and init pos in a hemisphere radius range
-		const vec4 worldOffsetPos = texture(u_PositionMap, offsetUV.xy);
-		const float rangeCheck = smoothstep(0.0, 1.0, u_UBSSAO.Radius / abs(worldPos.z -  worldOffsetPos.z));
-		
-		const vec3 renderedFragmentViewPos = vec3(u_UBSSAO.InvViewMatrix * worldOffsetPos); // transform offset pos from world to view space
+		const vec3 renderedFragmentViewPos = ReconstructViewPosition(offsetUV.xy);
+		const float rangeCheck = smoothstep(0.0, 1.0, u_UBSSAO.Radius / abs(viewPos.z - renderedFragmentViewPos.z));
 		occlusion += (renderedFragmentViewPos.z >= samplePos.z + u_UBSSAO.Bias ? 1.0f : 0.0f) * NdotS * rangeCheck; // in case rendered fragment is further than generated sample, then sample is not occluded
 	}
 	occlusion = 1.0f - (occlusion / (float(maxSamplesNum))); // subtract 1.0f(since 0 means occlusion, and 1 not) from mapped occlusion in range from [0, NUM_SAMPLES] to [0, 1]
@@ -83,7 +83,8 @@ void EditorLayer::OnImGuiRender()
             const wchar_t* path = (const wchar_t*)payload->Data;
             const std::filesystem::path fsPath(path);
 
-            if (fsPath.extension().string() == std::string(".gntlt"))
+            if (fsPath.extension().string() == std::string(".gntlt") ||
+                fsPath.extension().string() == SceneSerializer::s_RUNTIME_SCENE_EXTENSION)
                 OpenScene(fsPath.string());
             else if (fsPath.extension().string() == std::string(".gltf"))
             {
@@ -95,6 +96,16 @@ void EditorLayer::OnImGuiRender()
         ImGui::EndDragDropTarget();
     }
 
+    // Scene stays interactive while meshes stream in, their progress is overlaid in the viewport's corner.
+    if (const uint32_t streamingMeshCount = Mesh::GetStreamingMeshCount(); streamingMeshCount > 0)
+    {
+        const ImVec2 contentStart = ImGui::GetCursorStartPos();
+        ImGui::SetCursorPos(ImVec2(contentStart.x + 8.0f, contentStart.y + 8.0f));
+
+        const std::string overlay = "Streaming meshes: " + std::to_string(streamingMeshCount);
+        ImGui::ProgressBar(Mesh::GetStreamingProgress(), ImVec2(256.0f, 0.0f), overlay.data());
+    }
+
     ImGui::PopStyleVar();
     ImGui::End();
 
@@ -115,6 +126,8 @@ void EditorLayer::OnImGuiRender()
         ImGui::Text("Allocated Buffers: %llu", Stats.AllocatedBuffers.load());
         ImGui::Text("VRAM Usage: (%0.2f) MB", Stats.GPUMemoryAllocated.load() / 1024.0f / 1024.0f);
         ImGui::Text("RAM Usage: (%0.2f) MB", Stats.RAMMemoryAllocated.load() / 1024.0f / 1024.0f);
+        ImGui::Text("Transient Images: (%0.2f) MB, saved by aliasing: (%0.2f) MB", Stats.TransientMemoryAllocated / 1024.0f / 1024.0f,
+                    Stats.TransientMemorySaved / 1024.0f / 1024.0f);
 
         ImGui::Text("VMA Allocations: %llu", Stats.Allocations.load());
         ImGui::Text("Upload Heap Capacity: (%0.2f) MB", Stats.UploadHeapCapacity / 1024.0f / 1024.0f);
@@ -126,20 +139,50 @@ void EditorLayer::OnImGuiRender()
         ImGui::Text("CPU Wait Time: %0.2f ms", Stats.CPUWaitTime * 1000.0f);
         ImGui::Text("GPU Wait Time: %0.2f ms", Stats.GPUWaitTime * 1000.0f);
         ImGui::Text("Swapchain Image Present Time: %0.2fms", Stats.PresentTime * 1000.0f);
+        ImGui::Text("Low Latency Wait: %0.2f ms", Stats.LatencyWait * 1000.0f);
         ImGui::Text("FrameTime: %0.2f ms", Stats.FrameTime * 1000.0f);
         ImGui::Text("DrawCalls: %llu", Stats.DrawCalls.load());
         ImGui::Text("QuadCount: %llu", Stats.QuadCount.load());
+
+        const auto& SceneStats = m_ActiveScene->GetStats();
+        ImGui::Text("Scene Extraction: %0.3f ms, %u entities, %u jobs", SceneStats.ExtractionTime, SceneStats.EntityCount,
+                    SceneStats.ExtractionJobs);
+        ImGui::Text("Scene Animation: %0.3f ms, %u animators", SceneStats.AnimationTime, SceneStats.AnimatorCount);
         ImGui::Text("Rendering Device: %s", Stats.RenderingDevice.data());
 
         ImGui::End();
     }
 
+#if GNT_PROFILING
+    static bool bShowProfiler = true;
+    if (bShowProfiler)
+    {
+        ImGui::Begin("Profiler", &bShowProfiler);
+        DrawProfiler();
+        ImGui::End();
+    }
+#endif
+
     ImGui::Begin("Renderer Settings");
     auto& rs = Renderer::GetSettings();
     ImGui::Text("Viewport Size: (%u, %u)", (uint32_t)m_ViewportSize.x, (uint32_t)m_ViewportSize.y);
     ImGui::Checkbox("Render Wireframe", &rs.ShowWireframes);
     ImGui::Checkbox("ChromaticAberration View", &rs.ChromaticAberrationView);
     ImGui::Checkbox("VSync", &rs.VSync);
+    if (!rs.VSync)
+    {
+        static const char* s_PresentModes[] = {"Mailbox", "Immediate"};
+        int32_t presentMode                 = static_cast<int32_t>(rs.PresentMode);
+        if (ImGui::Combo("Present Mode", &presentMode, s_PresentModes, IM_ARRAYSIZE(s_PresentModes)))
+            rs.PresentMode = static_cast<EPresentMode>(presentMode);
+    }
+    int32_t framesInFlight = static_cast<int32_t>(rs.FramesInFlight);
+    if (ImGui::SliderInt("Frames In Flight", &framesInFlight, 1, MAX_FRAMES_IN_FLIGHT)) rs.FramesInFlight = framesInFlight;
+    ImGui::Checkbox("Low Latency", &rs.LowLatency);
+    ImGui::Checkbox("Alias Transient Images", &rs.AliasTransientImages);
+    ImGui::Checkbox("Parallel Recording", &rs.ParallelRecording);
+    ImGui::Checkbox("Render Thread", &rs.RenderThread);
+    ImGui::Checkbox("GPU Profiling", &rs.GPUProfiling);
     ImGui::SliderFloat("Gamma", &rs.Gamma, 1.0f, 2.6f, "%0.1f");
     //   ImGui::SliderFloat("Exposure", &rs.Exposure, 0.0f, 5.0f, "%0.1f");
     if (ImGui::TreeNodeEx("Shadows", ImGuiTreeNodeFlags_Framed))
@@ -158,14 +201,25 @@ void EditorLayer::OnImGuiRender()
             ImGui::EndCombo();
         }
 
+        ImGui::SliderInt("Cascades", &rs.Shadows.CascadeCount, 2, static_cast<int32_t>(s_MAX_SHADOW_CASCADES));
+        ImGui::SliderFloat("Split Lambda", &rs.Shadows.CascadeSplitLambda, 0.0f, 1.0f);
+        ImGui::SliderFloat("Shadow Distance", &rs.Shadows.ShadowDistance, 10.0f, 500.0f);
+        ImGui::SliderInt("Far Cascades Update Interval", &rs.Shadows.FarCascadeUpdateInterval, 1, 16);
+
+        ImGui::Separator();
+        ImGui::Checkbox("Point/Spot Light Shadows", &rs.Shadows.RenderLocalShadows);
+        ImGui::SliderInt("Atlas Tiles Update Budget", &rs.Shadows.LocalShadowUpdateBudget, 1, 64);
+
         ImGui::TreePop();
     }
 
     if (ImGui::TreeNodeEx("GPU-Based Particle System", ImGuiTreeNodeFlags_Framed))
     {
-        constexpr uint32_t min = 0;
-        constexpr uint32_t max = 5000;
-        ImGui::SliderScalar("Particles", ImGuiDataType_U32, &Renderer::GetSettings().ParticleCount, &min, &max);
+        // Pool is recreated on change && loses alive particles.
+        constexpr uint32_t min = 1024;
+        constexpr uint32_t max = 1 << 22;
+        ImGui::SliderScalar("Pool Size", ImGuiDataType_U32, &rs.ParticlePoolSize, &min, &max);
+        ImGui::Checkbox("Sort Particles", &rs.SortParticles);
 
         ImGui::TreePop();
     }
@@ -174,6 +228,18 @@ void EditorLayer::OnImGuiRender()
     {
         ImGui::Checkbox("Enable SSAO", &rs.AO.EnableSSAO);
         ImGui::Checkbox("Enable SSAO-Blur", &rs.AO.BlurSSAO);
+
+        ImGui::Text("SSAO Resolution:");
+        ImGui::SameLine();
+        if (ImGui::BeginCombo("##SSAOQuality", rs.AO.QualityPresets[rs.AO.CurrentQualityPreset].first.data()))
+        {
+            for (uint16_t i = 0; i < rs.AO.QualityPresets.size(); ++i)
+            {
+                if (ImGui::Selectable(rs.AO.QualityPresets[i].first.data())) rs.AO.CurrentQualityPreset = i;
+            }
+            ImGui::EndCombo();
+        }
+
         ImGui::SliderFloat("Sample Radius", &rs.AO.Radius, 0.5f, 5.0f);
         ImGui::SliderFloat("Sample Bias", &rs.AO.Bias, 0.0f, 2.0f);
         ImGui::SliderInt("Magnitude", &rs.AO.Magnitude, 0, 15);
@@ -183,15 +249,21 @@ void EditorLayer::OnImGuiRender()
 
     if (ImGui::TreeNodeEx("Pass Statistics", ImGuiTreeNodeFlags_Framed))
     {
-        const auto& passStats = Renderer::GetStats().PassStatistsics;
-        for (auto& passStat : passStats)
-            ImGui::Text("%s", passStat.data());
+        const auto& stats = Renderer::GetStats();
+        for (const auto& marker : stats.GPUMarkers)
+            ImGui::Text("%*s%s: %f (ms)", static_cast<int32_t>(marker.Depth * 2), "", marker.Name.data(), marker.Time);
+
+        ImGui::Text("Cascades rendered: %u", stats.ShadowCascadesRendered);
+        ImGui::Text("Local shadow tiles rendered: %u/%u", stats.LocalShadowTilesRendered, stats.LocalShadowTilesVisible);
+        ImGui::Text("Particle emitters: %u", stats.ParticleEmitters);
+        ImGui::Text("Skinned vertices: %u", stats.SkinnedVertices);
+        ImGui::Text("RenderGraph: %u/%u passes executed", stats.RenderGraphPassesExecuted, stats.RenderGraphPassCount);
 
         if (ImGui::TreeNodeEx("Pipeline Statistics", ImGuiTreeNodeFlags_Framed))
         {
-            const auto pipelineStats = Renderer::GetPipelineStatistics();
-            for (auto& pipelineStat : pipelineStats)
-                ImGui::Text("%s", pipelineStat.data());
+            const auto& pipelineStatNames = Renderer::GetPipelineStatisticsNames();
+            for (size_t i = 0; i < pipelineStatNames.size(); ++i)
+                ImGui::Text("%s%llu", pipelineStatNames[i].data(), static_cast<unsigned long long>(stats.PipelineStatisticsResults[i]));
 
             ImGui::TreePop();
         }
@@ -290,6 +362,81 @@ void EditorLayer::EndDockspace()
     ImGui::End();
 }
 
+#if GNT_PROFILING
+void EditorLayer::DrawProfiler()
+{
+    static int32_t s_CaptureFrameCount = 10;
+    ImGui::SliderInt("Frames", &s_CaptureFrameCount, 1, 300);
+    ImGui::SameLine();
+    // Requests are ignored while capture is in progress.
+    if (ImGui::Button(Profiler::IsCapturing() ? "Capturing..." : "Capture"))
+        Profiler::RequestCapture(static_cast<uint32_t>(s_CaptureFrameCount), "ProfilerCapture.json");
+
+    const auto& frame        = Profiler::GetLastFrame();
+    const double frameLength = frame.End - frame.Start;
+    if (frameLength <= 0.0) return;
+
+    ImGui::Text("CPU Frame: %0.3f ms", frameLength * 1000.0);
+
+    // Flame graph, row per zone depth, both CPU && GPU share the same scale so their lengths are comparable.
+    constexpr float rowHeight = 18.0f;
+    const float width         = ImGui::GetContentRegionAvail().x;
+    const double pixelsPerSec = width / frameLength;
+
+    auto* drawList      = ImGui::GetWindowDrawList();
+    const auto drawZone = [&](const ImVec2& origin, const char* name, const double start, const double end, const uint32_t depth,
+                              const ImU32 color)
+    {
+        const ImVec2 min(origin.x + static_cast<float>(start * pixelsPerSec), origin.y + depth * rowHeight);
+        const ImVec2 max(origin.x + static_cast<float>(end * pixelsPerSec), min.y + rowHeight - 1.0f);
+        drawList->AddRectFilled(min, max, color);
+
+        const float textWidth = ImGui::CalcTextSize(name).x;
+        if (max.x - min.x > textWidth + 4.0f) drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32_WHITE, name);
+        if (ImGui::IsMouseHoveringRect(min, max)) ImGui::SetTooltip("%s: %0.3f ms", name, (end - start) * 1000.0);
+    };
+
+    const auto drawTrack = [&](const std::string& trackName, const auto& zones, const double trackStart, const ImU32 color)
+    {
+        uint32_t maxDepth = 0;
+        for (const auto& zone : zones)
+            maxDepth = std::max(maxDepth, zone->Depth);
+
+        ImGui::SeparatorText(trackName.data());
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        for (const auto& zone : zones)
+        {
+            if constexpr (std::is_same_v<std::decay_t<decltype(zone->Name)>, std::string>)
+                drawZone(origin, zone->Name.data(), zone->Start - trackStart, zone->End - trackStart, zone->Depth, color);
+            else
+                drawZone(origin, zone->Name, zone->Start - trackStart, zone->End - trackStart, zone->Depth, color);
+        }
+        ImGui::Dummy(ImVec2(width, (maxDepth + 1) * rowHeight));
+    };
+
+    std::map<uint32_t, std::vector<const ProfilerZone*>> threadZones;
+    for (const auto& zone : frame.Zones)
+        threadZones[zone.ThreadIndex].push_back(&zone);
+
+    for (const auto& [threadIndex, zones] : threadZones)
+        drawTrack(Profiler::GetThreadName(threadIndex), zones, frame.Start, IM_COL32(70, 120, 190, 255));
+
+    // GPU results are a few frames behind, so they're placed relative to their own first marker.
+    std::map<uint32_t, std::vector<const ProfilerGPUZone*>> queueZones;
+    for (const auto& zone : frame.GPUZones)
+        queueZones[zone.QueueIndex].push_back(&zone);
+
+    for (const auto& [queueIndex, zones] : queueZones)
+    {
+        double queueStart = std::numeric_limits<double>::max();
+        for (const auto& zone : zones)
+            queueStart = std::min(queueStart, zone->Start);
+
+        drawTrack("GPU " + Profiler::GetGPUQueueName(queueIndex), zones, queueStart, IM_COL32(190, 100, 60, 255));
+    }
+}
+#endif
+
 void EditorLayer::UpdateViewportSize()
 {
     const auto bNeedViewportResize =
@@ -311,7 +458,8 @@ void EditorLayer::NewScene()
 
 void EditorLayer::OpenScene()
 {
-    const std::string filePath = FileDialogs::OpenFile("Gauntlet Scene (*.gntlt)\0*.gntlt\0");
+    const std::string filePath =
+        FileDialogs::OpenFile("Gauntlet Scene (*.gntlt)\0*.gntlt\0Gauntlet Runtime Scene (*.gntltb)\0*.gntltb\0");
 
     if (!filePath.empty()) OpenScene(filePath);
 }
@@ -321,21 +469,28 @@ void EditorLayer::OpenScene(const std::filesystem::path& path)
     m_ActiveScene = MakeRef<Scene>();
 
     SceneSerializer serializer(m_ActiveScene);
-    serializer.Deserialize(path.string());
+    if (path.extension().string() == SceneSerializer::s_RUNTIME_SCENE_EXTENSION)
+        serializer.DeserializeRuntime(path.string());
+    else
+        serializer.Deserialize(path.string());
 
     m_SceneHierarchyPanel.SetContext(m_ActiveScene);
 }
 
 void EditorLayer::SaveScene()
 {
-    const std::string filePath = FileDialogs::SaveFile("Gauntlet Scene (*.gntlt)\0*.gntlt\0");
+    const std::string filePath =
+        FileDialogs::SaveFile("Gauntlet Scene (*.gntlt)\0*.gntlt\0Gauntlet Runtime Scene (*.gntltb)\0*.gntltb\0");
 
     if (filePath.empty())
         LOG_WARN("Failed to save scene: %s", filePath.data());
     else
     {
         SceneSerializer serializer(m_ActiveScene);
-        serializer.Serialize(filePath);
+        if (std::filesystem::path(filePath).extension().string() == SceneSerializer::s_RUNTIME_SCENE_EXTENSION)
+            serializer.SerializeRuntime(filePath);
+        else
+            serializer.Serialize(filePath);
     }
 }
 }  // namespace Gauntlet
\ No newline at end of file
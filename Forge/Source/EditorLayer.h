@@ -44,6 +44,10 @@ class EditorLayer final : public Layer
 
     void UpdateViewportSize();
 
+#if GNT_PROFILING
+    void DrawProfiler();
+#endif
+
     // Scenes
     void NewScene();
     void SaveScene();
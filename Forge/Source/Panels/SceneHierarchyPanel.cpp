@@ -9,8 +9,10 @@
 
 namespace Gauntlet
 {
-static void DrawVec3Control(const std::string& label, glm::vec3& values, const float resetValue = 0.0f, const float columnWidth = 100.0f)
+static bool DrawVec3Control(const std::string& label, glm::vec3& values, const float resetValue = 0.0f, const float columnWidth = 100.0f)
 {
+    bool bIsChanged = false;
+
     ImGuiIO& io   = ImGui::GetIO();
     auto BoldFont = io.Fonts->Fonts[1];
 
@@ -32,13 +34,17 @@ static void DrawVec3Control(const std::string& label, glm::vec3& values, const f
     ImGui::PushStyleColor(ImGuiCol_ButtonActive, {0.8f, 0.1f, 0.15f, 1.0f});
 
     ImGui::PushFont(BoldFont);
-    if (ImGui::Button("X", ButtonSize)) values.x = resetValue;
+    if (ImGui::Button("X", ButtonSize))
+    {
+        values.x   = resetValue;
+        bIsChanged = true;
+    }
     ImGui::PopFont();
 
     ImGui::PopStyleColor(3);
 
     ImGui::SameLine();
-    ImGui::DragFloat("##X", &values.x, 0.05f, 0.0f, 0.0f, "%.2f");
+    if (ImGui::DragFloat("##X", &values.x, 0.05f, 0.0f, 0.0f, "%.2f")) bIsChanged = true;
     ImGui::PopItemWidth();
     ImGui::SameLine();
 
@@ -47,12 +53,16 @@ static void DrawVec3Control(const std::string& label, glm::vec3& values, const f
     ImGui::PushStyleColor(ImGuiCol_ButtonActive, {0.1f, 0.8f, 0.15f, 1.0f});
 
     ImGui::PushFont(BoldFont);
-    if (ImGui::Button("Y", ButtonSize)) values.y = resetValue;
+    if (ImGui::Button("Y", ButtonSize))
+    {
+        values.y   = resetValue;
+        bIsChanged = true;
+    }
     ImGui::PopFont();
     ImGui::PopStyleColor(3);
 
     ImGui::SameLine();
-    ImGui::DragFloat("##Y", &values.y, 0.05f, 0.0f, 0.0f, "%.2f");
+    if (ImGui::DragFloat("##Y", &values.y, 0.05f, 0.0f, 0.0f, "%.2f")) bIsChanged = true;
     ImGui::PopItemWidth();
     ImGui::SameLine();
 
@@ -61,18 +71,24 @@ static void DrawVec3Control(const std::string& label, glm::vec3& values, const f
     ImGui::PushStyleColor(ImGuiCol_ButtonActive, {0.15f, 0.1f, 0.8f, 1.0f});
 
     ImGui::PushFont(BoldFont);
-    if (ImGui::Button("Z", ButtonSize)) values.z = resetValue;
+    if (ImGui::Button("Z", ButtonSize))
+    {
+        values.z   = resetValue;
+        bIsChanged = true;
+    }
     ImGui::PopFont();
     ImGui::PopStyleColor(3);
 
     ImGui::SameLine();
-    ImGui::DragFloat("##Z", &values.z, 0.05f, 0.0f, 0.0f, "%.2f");
+    if (ImGui::DragFloat("##Z", &values.z, 0.05f, 0.0f, 0.0f, "%.2f")) bIsChanged = true;
     ImGui::PopItemWidth();
     ImGui::SameLine();
 
     ImGui::PopStyleVar();
     ImGui::Columns(1);
     ImGui::PopID();
+
+    return bIsChanged;
 }
 
 template <typename T, typename UIFunction> static void DrawComponent(const std::string& label, Entity entity, UIFunction&& uiFunction)
@@ -127,12 +143,40 @@ void SceneHierarchyPanel::OnImGuiRender()
 
     if (m_Context)
     {
-        m_Context->m_Registry.each(
-            [&](auto entityID)
+        // Children are drawn by their parents.
+        for (auto entityID : m_Context->m_Registry.view<RelationshipComponent>())
+        {
+            if (m_Context->m_Registry.get<RelationshipComponent>(entityID).Parent != entt::null) continue;
+
+            DrawEntityNode(Entity{entityID, m_Context.get()});
+        }
+
+        // Dropping onto empty space makes entity a root, smaller node targets take precedence.
+        if (ImGui::BeginDragDropTargetCustom(ImGui::GetCurrentWindow()->InnerRect, ImGui::GetID("Outliner")))
+        {
+            if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("OUTLINER_ENTITY"))
             {
-                Entity entity{entityID, m_Context.get()};
-                DrawEntityNode(entity);
-            });
+                m_ReparentedEntity = Entity{*static_cast<const entt::entity*>(payload->Data), m_Context.get()};
+                m_NewParent        = {};
+            }
+            ImGui::EndDragDropTarget();
+        }
+
+        // Hierarchy is modified after it's drawn, so links aren't changed while they're walked.
+        if (m_ReparentedEntity.IsValid())
+        {
+            m_Context->SetParent(m_ReparentedEntity, m_NewParent);
+            m_ReparentedEntity = {};
+            m_NewParent        = {};
+        }
+
+        if (m_DeletedEntity.IsValid())
+        {
+            m_Context->DestroyEntity(m_DeletedEntity);
+            m_DeletedEntity = {};
+
+            if (m_SelectionContext.IsValid() && !m_Context->m_Registry.valid(m_SelectionContext)) m_SelectionContext = {};
+        }
 
         // Deselection
         if (ImGui::IsMouseDown(ImGuiMouseButton_Left) && ImGui::IsWindowHovered()) m_SelectionContext = {};
@@ -155,10 +199,12 @@ void SceneHierarchyPanel::OnImGuiRender()
 
 void SceneHierarchyPanel::DrawEntityNode(Entity entity)
 {
-    auto& tag = entity.GetComponent<TagComponent>();
+    auto& tag                = entity.GetComponent<TagComponent>();
+    const auto& relationship = entity.GetComponent<RelationshipComponent>();
 
     ImGuiTreeNodeFlags SelectionFlag = m_SelectionContext == entity ? ImGuiTreeNodeFlags_Selected : 0;
-    const ImGuiTreeNodeFlags flags   = SelectionFlag | (ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanFullWidth);
+    ImGuiTreeNodeFlags LeafFlag      = relationship.FirstChild == entt::null ? ImGuiTreeNodeFlags_Leaf : 0;
+    const ImGuiTreeNodeFlags flags   = SelectionFlag | LeafFlag | (ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanFullWidth);
     bool bIsOpened                   = ImGui::TreeNodeEx((void*)(uint64_t)entity, flags, tag.Tag.data());
 
     if (ImGui::IsItemClicked())
@@ -166,6 +212,24 @@ void SceneHierarchyPanel::DrawEntityNode(Entity entity)
         m_SelectionContext = entity;
     }
 
+    if (ImGui::BeginDragDropSource())
+    {
+        const entt::entity entityHandle = entity;
+        ImGui::SetDragDropPayload("OUTLINER_ENTITY", &entityHandle, sizeof(entityHandle));
+        ImGui::Text(tag.Tag.data());
+        ImGui::EndDragDropSource();
+    }
+
+    if (ImGui::BeginDragDropTarget())
+    {
+        if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("OUTLINER_ENTITY"))
+        {
+            m_ReparentedEntity = Entity{*static_cast<const entt::entity*>(payload->Data), m_Context.get()};
+            m_NewParent        = entity;
+        }
+        ImGui::EndDragDropTarget();
+    }
+
     bool bIsEntityDeleted{false};
     if (ImGui::BeginPopupContextItem())
     {
@@ -176,15 +240,16 @@ void SceneHierarchyPanel::DrawEntityNode(Entity entity)
 
     if (bIsOpened)
     {
-        // Recursive open childs here
+        for (auto child = relationship.FirstChild; child != entt::null;)
+        {
+            DrawEntityNode(Entity{child, m_Context.get()});
+            child = m_Context->m_Registry.get<RelationshipComponent>(child).NextSibling;
+        }
+
         ImGui::TreePop();
     }
 
-    if (bIsEntityDeleted)
-    {
-        m_Context->DestroyEntity(entity);
-        if (m_SelectionContext == entity) m_SelectionContext = {};
-    }
+    if (bIsEntityDeleted) m_DeletedEntity = entity;
 }
 
 void SceneHierarchyPanel::ShowComponents(Entity entity)
@@ -195,7 +260,7 @@ void SceneHierarchyPanel::ShowComponents(Entity entity)
 
         char name[256];
         memset(name, 0, sizeof(name));
-        strcpy_s(name, sizeof(name), tag.data());
+        strncpy(name, tag.data(), sizeof(name) - 1);
 
         if (ImGui::InputText("##Tag", name, sizeof(name)))
         {
@@ -228,6 +293,12 @@ void SceneHierarchyPanel::ShowComponents(Entity entity)
             ImGui::CloseCurrentPopup();
         }
 
+        if (ImGui::MenuItem("Animator"))
+        {
+            m_SelectionContext.AddComponent<AnimatorComponent>();
+            ImGui::CloseCurrentPopup();
+        }
+
         if (ImGui::MenuItem("Point Light"))
         {
             m_SelectionContext.AddComponent<PointLightComponent>();
@@ -246,16 +317,30 @@ void SceneHierarchyPanel::ShowComponents(Entity entity)
             ImGui::CloseCurrentPopup();
         }
 
+        if (ImGui::MenuItem("Particle Emitter"))
+        {
+            m_SelectionContext.AddComponent<ParticleEmitterComponent>();
+            ImGui::CloseCurrentPopup();
+        }
+
         ImGui::EndPopup();
     }
     ImGui::PopItemWidth();
 
     DrawComponent<TransformComponent>("Transform", entity,
-                                      [](auto& tc)
+                                      [&](auto& tc)
                                       {
-                                          DrawVec3Control("Translation", tc.Translation);
-                                          DrawVec3Control("Rotation", tc.Rotation);
-                                          DrawVec3Control("Scale", tc.Scale);
+                                          bool bIsChanged = DrawVec3Control("Translation", tc.Translation);
+
+                                          glm::vec3 rotation = tc.GetEulerAngles();
+                                          if (DrawVec3Control("Rotation", rotation))
+                                          {
+                                              tc.SetEulerAngles(rotation);
+                                              bIsChanged = true;
+                                          }
+
+                                          if (DrawVec3Control("Scale", tc.Scale)) bIsChanged = true;
+                                          if (bIsChanged) m_Context->MarkTransformDirty(entity);
                                       });
 
     DrawComponent<SpriteRendererComponent>("SpriteRenderer", entity, [](auto& spc) { ImGui::ColorPicker4("Color", &spc.Color.r); });
@@ -272,6 +357,7 @@ void SceneHierarchyPanel::ShowComponents(Entity entity)
 
                                            ImGui::Separator();
                                            ImGui::Checkbox("Active", &lc.bIsActive);
+                                           ImGui::Checkbox("Cast Shadows", &lc.bCastShadows);
                                        });
 
     DrawComponent<DirectionalLightComponent>("DirectionalLightComponent", entity,
@@ -304,11 +390,65 @@ void SceneHierarchyPanel::ShowComponents(Entity entity)
 
                                           ImGui::Separator();
                                           ImGui::Checkbox("Active", &slc.bIsActive);
+                                          ImGui::Checkbox("Cast Shadows", &slc.bCastShadows);
                                       });
 
+    DrawComponent<ParticleEmitterComponent>("ParticleEmitter", entity,
+                                            [](auto& pec)
+                                            {
+                                                ImGui::Separator();
+                                                ImGui::ColorEdit4("Start Color", &pec.StartColor.r);
+                                                ImGui::ColorEdit4("End Color", &pec.EndColor.r);
+
+                                                ImGui::Separator();
+                                                DrawVec3Control("Velocity", pec.Velocity);
+                                                DrawVec3Control("Velocity Variation", pec.VelocityVariation);
+                                                DrawVec3Control("Bounds Extent", pec.BoundsExtent);
+
+                                                ImGui::Separator();
+                                                ImGui::DragFloat("Spawn Rate", &pec.SpawnRate, 1.0f, 0.0f, 100000.0f);
+                                                ImGui::DragFloat("Lifetime", &pec.Lifetime, 0.05f, 0.01f, 60.0f);
+                                                ImGui::DragFloat("Start Size", &pec.StartSize, 0.01f, 0.0f, 10.0f);
+                                                ImGui::DragFloat("End Size", &pec.EndSize, 0.01f, 0.0f, 10.0f);
+
+                                                ImGui::Separator();
+                                                ImGui::Checkbox("Active", &pec.bIsActive);
+                                            });
+
+    DrawComponent<AnimatorComponent>("Animator", entity,
+                                     [](auto& ac)
+                                     {
+                                         int32_t animationIndex = static_cast<int32_t>(ac.AnimationIndex);
+                                         if (ImGui::DragInt("Animation", &animationIndex, 0.1f, 0, 64))
+                                             ac.AnimationIndex = static_cast<uint32_t>(animationIndex);
+                                         ImGui::DragFloat("Playback Speed", &ac.PlaybackSpeed, 0.01f, -4.0f, 4.0f);
+                                         ImGui::DragFloat("Cross Fade", &ac.CrossFadeDuration, 0.01f, 0.0f, 2.0f);
+                                         ImGui::Checkbox("Playing", &ac.bIsPlaying);
+
+                                         if (ac.Animator && ac.Animator->GetAnimation())
+                                         {
+                                             const auto& animation = ac.Animator->GetAnimation();
+                                             ImGui::Text("%s: %0.2f / %0.2f ticks", animation->GetName().data(),
+                                                         ac.Animator->GetCurrentTime(), animation->GetDuration());
+                                             ImGui::Text("%zu keys, %0.2f KB", animation->GetKeyCount(),
+                                                         animation->GetMemorySize() / 1024.0f);
+                                             if (ac.Animator->IsCrossFading())
+                                                 ImGui::Text("Cross fading: %0.2f", ac.Animator->GetCrossFadeWeight());
+                                         }
+                                     });
+
     DrawComponent<MeshComponent>("Mesh", entity,
                                  [](auto& mc)
                                  {
+                                     if (!mc.Mesh) return;
+
+                                     // Submeshes && materials don't exist until geometry is published.
+                                     if (!mc.Mesh->IsLoaded())
+                                     {
+                                         ImGui::Text("Loading...");
+                                         return;
+                                     }
+
                                      for (uint32_t i = 0; i < mc.Mesh->GetSubmeshCount(); ++i)
                                      {
                                          ImGui::Separator();
@@ -23,6 +23,11 @@ class SceneHierarchyPanel final : private Uncopyable, private Unmovable
     Ref<Scene> m_Context;
     Entity m_SelectionContext;
 
+    // Outliner's drag && drop and context menu requests, applied once the hierarchy is drawn.
+    Entity m_ReparentedEntity;
+    Entity m_NewParent;
+    Entity m_DeletedEntity;
+
     void DrawEntityNode(Entity entity);
     void ShowComponents(Entity entity);
 };
@@ -8,6 +8,7 @@
 #include <Gauntlet/Core/Log.h>
 #include <Gauntlet/Layer/Layer.h>
 #include <Gauntlet/Core/Timer.h>
+#include <Gauntlet/Core/Profiler.h>
 #include <Gauntlet/Core/Random.h>
 
 // Math defines
@@ -6,11 +6,13 @@
 #include "Input.h"
 #include "JobSystem.h"
 #include "Timer.h"
+#include "Profiler.h"
 
 #include "Gauntlet/ImGui/ImGuiLayer.h"
 #include "Gauntlet/Renderer/GraphicsContext.h"
 #include "Gauntlet/Renderer/Renderer2D.h"
 #include "Gauntlet/Renderer/Renderer.h"
+#include "Gauntlet/Renderer/Mesh.h"
 
 namespace Gauntlet
 {
@@ -23,11 +25,13 @@ Application::Application(const ApplicationSpecification& ApplicationSpec)
     s_Instance = this;
 
     Log::Init();
+    GNT_PROFILE_THREAD("Main");
 
     JobSystem::Init();
     RendererAPI::Init(m_Specification.GraphicsAPI);
 
     WindowSpecification WindowSpec(m_Specification.AppName, m_Specification.Width, m_Specification.Height);
+    WindowSpec.bHeadless = m_Specification.bHeadless;
     m_Window.reset(Window::Create(WindowSpec));
     m_Window->SetWindowCallback(BIND_FN(Application::OnEvent));
     m_Window->SetWindowLogo(m_Specification.WindowLogoPath);
@@ -49,6 +53,8 @@ Application::Application(const ApplicationSpecification& ApplicationSpec)
     Renderer::Init();
     Renderer2D::Init();
 
+    if (m_Specification.bHeadless) return;
+
     m_ImGuiLayer = ImGuiLayer::Create();
     m_ImGuiLayer->OnAttach();
 }
@@ -56,6 +62,7 @@ Application::Application(const ApplicationSpecification& ApplicationSpec)
 void Application::Run()
 {
     m_LayerQueue.Init();
+    m_RenderThread.Start("Render");
 
     {
         const float prepareStartTime = static_cast<float>(Timer::Now());
@@ -69,28 +76,69 @@ void Application::Run()
     float lastFrameTime = 0.0F;
     while (m_Window->IsRunning())
     {
+        GNT_PROFILE_FRAME();
+
         if (!m_Window->IsMinimized())
         {
             m_Context->BeginRender();
 
-            Renderer::Begin();
-            Renderer2D::Begin();
-
-            m_LayerQueue.OnUpdate(m_MainThreadDelta);
-
-            Renderer2D::Flush();
-            Renderer::Flush();
-
-            m_ImGuiLayer->BeginRender();
-
-            m_LayerQueue.OnImGuiRender();
-
-            m_ImGuiLayer->EndRender();
+            // Render thread records snapshot extracted by the previous frame, while layers simulate && extract the next one.
+            const bool bUseRenderThread      = Renderer::GetSettings().RenderThread;
+            const bool bRecordOnRenderThread = bUseRenderThread && m_bHasPendingSnapshot;
+            if (bRecordOnRenderThread)
+            {
+                Renderer::SwapSnapshots();
+                Renderer2D::SwapSnapshots();
+                m_RenderThread.Submit([this] { RecordFrame(); });
+            }
+            else if (m_bHasPendingSnapshot)
+            {
+                // Render thread was turned off, its last snapshot is dropped, scene one is overwritten by Renderer::BeginScene() anyway.
+                Renderer2D::ClearSnapshot();
+            }
+
+            {
+                GNT_PROFILE_SCOPE("LayerQueue::OnUpdate");
+                m_LayerQueue.OnUpdate(m_MainThreadDelta);
+            }
+
+            if (bRecordOnRenderThread)
+            {
+                GNT_PROFILE_SCOPE("WaitForRenderThread");
+                m_RenderThread.Wait();
+            }
+            else if (!bUseRenderThread)
+            {
+                Renderer::SwapSnapshots();
+                Renderer2D::SwapSnapshots();
+                RecordFrame();
+            }
+
+            // First frame on render thread only extracts, its snapshot is recorded while the next one is extracted.
+            m_bHasPendingSnapshot = bUseRenderThread;
+
+            // Render thread is idle until the next snapshot, so streamed meshes are swapped in before simulation sees them.
+            Mesh::PublishStreamedMeshes();
+
+            Renderer::CollectPassStatistics();
+
+            if (m_ImGuiLayer)
+            {
+                GNT_PROFILE_SCOPE("ImGui");
+                m_ImGuiLayer->BeginRender();
+
+                m_LayerQueue.OnImGuiRender();
+
+                m_ImGuiLayer->EndRender();
+            }
 
             m_Context->EndRender();
         }
 
-        m_Window->OnUpdate();
+        {
+            GNT_PROFILE_SCOPE("Window::OnUpdate");
+            m_Window->OnUpdate();
+        }
 
         JobSystem::Update();
 
@@ -112,6 +160,19 @@ void Application::Run()
     }
 }
 
+void Application::RecordFrame()
+{
+    GNT_PROFILE_FUNCTION();
+
+    Renderer::Begin();
+    Renderer2D::Begin();
+
+    Renderer::RecordScene();
+
+    Renderer2D::Flush();
+    Renderer::Flush();
+}
+
 void Application::OnEvent(Event& e)
 {
     if (m_Window->IsMinimized()) return;
@@ -120,7 +181,7 @@ void Application::OnEvent(Event& e)
     EventDispatcher dispatcher(e);
     dispatcher.Dispatch<WindowCloseEvent>(BIND_FN(Application::OnWindowClosed));
 
-    m_ImGuiLayer->OnEvent(e);
+    if (m_ImGuiLayer) m_ImGuiLayer->OnEvent(e);
     if (e.IsHandled()) return;
 
     for (auto& layer : m_LayerQueue)
@@ -136,14 +197,18 @@ void Application::Close()
 
 Application::~Application()
 {
+    m_RenderThread.Shutdown();
     JobSystem::Shutdown();
 
+    // Streaming threads are done, so the last publish releases meshes that nothing else references.
+    Mesh::PublishStreamedMeshes();
+
     m_LayerQueue.Destroy();
 
     Renderer2D::Shutdown();
     Renderer::Shutdown();
 
-    m_ImGuiLayer->OnDetach();
+    if (m_ImGuiLayer) m_ImGuiLayer->OnDetach();
 
     m_Context->Destroy();
 
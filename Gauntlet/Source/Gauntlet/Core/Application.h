@@ -6,6 +6,7 @@
 #include "Gauntlet/Renderer/RendererAPI.h"
 
 #include "Gauntlet/Layer/LayerQueue.h"
+#include "Gauntlet/Core/Thread.h"
 
 namespace Gauntlet
 {
@@ -35,6 +36,7 @@ struct ApplicationSpecification final
     uint32_t Width;
     uint32_t Height;
     RendererAPI::EAPI GraphicsAPI;
+    bool bHeadless = false;  // No window && UI, frames are rendered into offscreen images.
 };
 
 class Application : private Uncopyable, private Unmovable
@@ -72,7 +74,11 @@ class Application : private Uncopyable, private Unmovable
     float m_MainThreadDelta = 0.0f;
     const std::thread::id m_MainThreadID;
 
+    Thread m_RenderThread;
+    bool m_bHasPendingSnapshot = false;  // Layers have extracted a frame that hasn't been recorded yet.
+
     void OnWindowClosed(WindowCloseEvent& InEvent) { Close(); }
+    void RecordFrame();
 };
 
 Scoped<Application> CreateApplication(const CommandLineArguments& args);
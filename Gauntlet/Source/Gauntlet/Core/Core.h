@@ -8,6 +8,8 @@
 #ifdef GNT_PLATFORM_WINDOWS
 #define NOMINMAX
 #include <Windows.h>
+#elif defined(GNT_PLATFORM_LINUX)
+#include <csignal>
 #endif
 
 #ifdef GNT_DEBUG
@@ -18,9 +20,9 @@
 
 #ifdef GNT_PLATFORM_WINDOWS
 #define GNT_DEBUG_BREAK() __debugbreak()
-#elif GNT_PLATFORM_LINUX
-#define GNT_DEBUG_BREAK() __builtin_debugtrap()
-#elif GNT_PLATFORM_MACOS
+#elif defined(GNT_PLATFORM_LINUX)
+#define GNT_DEBUG_BREAK() raise(SIGTRAP)
+#elif defined(GNT_PLATFORM_MACOS)
 #define GNT_DEBUG_BREAK() __builtin_trap()
 #endif
 
@@ -43,12 +45,18 @@ namespace Gauntlet
 
 #define MESH_SHADING_TEST 0
 
-static constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+// Per frame resources are allocated for the max, number of frames actually in flight is a renderer setting.
+static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
 
 #define MAX_WORKER_THREADS 8
 #define GRAPHICS_PREFER_INTEGRATED_GPU 0
 
+#ifdef _MSC_VER
 #define FORCEINLINE __forceinline
+#else
+// always_inline is an error on GCC when inlining isn't possible(virtuals), so plain inline is the closest match.
+#define FORCEINLINE inline
+#endif
 #define NODISCARD [[nodiscard]]
 #define BIT(x) (1 << (x))
 #define BIND_FN(fn) [this](auto&&... args) -> decltype(auto) { return this->fn(std::forward<decltype(args)>(args)...); }
@@ -1,7 +1,7 @@
 #pragma once
 #include <Gauntlet/Core/PlatformDetection.h>
 
-#ifdef GNT_PLATFORM_WINDOWS
+#if defined(GNT_PLATFORM_WINDOWS) || defined(GNT_PLATFORM_LINUX)
 
 namespace Gauntlet
 {
@@ -18,7 +18,7 @@ int32_t Main(int32_t argc, char** argv)
 
 }  // namespace Gauntlet
 
-#if GNT_RELEASE
+#if defined(GNT_PLATFORM_WINDOWS) && GNT_RELEASE
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR lpCmdLine, int nCmdShow)
 {
@@ -28,9 +28,15 @@ void JobSystem::Init()
 
     for (uint32_t i = 0; i < s_ThreadCount; ++i)
     {
-        s_Threads[i].Start();
+        s_Threads[i].Start("JobSystem_" + std::to_string(i));
         s_Threads[i].SetThreadAffinity(i);
     }
+
+    // Not pinned to any core, they mostly wait on disk && share cores with workers.
+    if (s_ThreadCount == 0) return;
+
+    for (uint32_t i = 0; i < s_BACKGROUND_THREAD_COUNT; ++i)
+        s_BackgroundThreads[i].Start("Streaming_" + std::to_string(i));
 }
 
 void JobSystem::Update()
@@ -38,9 +44,10 @@ void JobSystem::Update()
     for (auto& thread : s_Threads)
         thread.Wait();
 
+    // Render thread && main thread can both wait on jobs.
+    std::scoped_lock<std::mutex> Lock(s_QueueMutex);
     if (s_PendingJobs.empty()) return;
 
-    std::scoped_lock<std::mutex> Lock(s_QueueMutex);
     for (uint32_t i = 0; i < s_ThreadCount; ++i)
     {
         if (s_PendingJobs.empty()) break;
@@ -54,14 +61,42 @@ void JobSystem::Update()
 
 void JobSystem::Wait()
 {
-    do
+    bool bHasPendingJobs = true;
+    while (bHasPendingJobs)
     {
         Update();
-    } while (!s_PendingJobs.empty());
+
+        std::scoped_lock<std::mutex> Lock(s_QueueMutex);
+        bHasPendingJobs = !s_PendingJobs.empty();
+    }
+}
+
+void JobSystem::Wait(WaitGroup& group)
+{
+    // Pending jobs aren't dispatched until the next Update(), so the caller takes them instead of sleeping.
+    while (!group.IsDone())
+    {
+        Job job;
+        {
+            std::scoped_lock<std::mutex> Lock(s_QueueMutex);
+            if (s_PendingJobs.empty()) break;
+
+            job = std::move(s_PendingJobs.front());
+            s_PendingJobs.pop();
+        }
+
+        job();
+    }
+
+    group.Wait();
 }
 
 void JobSystem::Shutdown()
 {
+    // Background threads go first, streaming jobs may still submit work to workers.
+    for (auto& Thread : s_BackgroundThreads)
+        Thread.Shutdown();
+
     for (auto& Thread : s_Threads)
         Thread.Shutdown();
 }
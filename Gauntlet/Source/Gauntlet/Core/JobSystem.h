@@ -5,6 +5,47 @@
 
 namespace Gauntlet
 {
+
+// Counts jobs submitted with it, so caller waits only for its own jobs && not for the ones another thread submitted meanwhile.
+class WaitGroup final : private Uncopyable, private Unmovable
+{
+  public:
+    WaitGroup()  = default;
+    ~WaitGroup() = default;
+
+    FORCEINLINE bool IsDone()
+    {
+        std::unique_lock<std::mutex> Lock(m_Mutex);
+        return m_JobCount == 0;
+    }
+
+  private:
+    // Count is guarded by the mutex rather than atomic, so the last job is done touching the group before waiter can destroy it.
+    uint32_t m_JobCount = 0;
+    std::mutex m_Mutex;
+    std::condition_variable m_CondVar;
+
+    friend class JobSystem;
+
+    FORCEINLINE void Add()
+    {
+        std::unique_lock<std::mutex> Lock(m_Mutex);
+        ++m_JobCount;
+    }
+
+    FORCEINLINE void Done()
+    {
+        std::unique_lock<std::mutex> Lock(m_Mutex);
+        if (--m_JobCount == 0) m_CondVar.notify_all();
+    }
+
+    FORCEINLINE void Wait()
+    {
+        std::unique_lock<std::mutex> Lock(m_Mutex);
+        m_CondVar.wait(Lock, [this] { return m_JobCount == 0; });
+    }
+};
+
 class JobSystem final : private Uncopyable, private Unmovable
 {
   public:
@@ -14,6 +55,9 @@ class JobSystem final : private Uncopyable, private Unmovable
     static void Update();
     static void Wait();
 
+    // Runs pending jobs on the caller until the group is done, jobs of other groups keep running on workers.
+    static void Wait(WaitGroup& group);
+
     template <typename Func, typename... Args> static void Submit(Func&& InFunc, Args&&... args)
     {
         std::scoped_lock<std::mutex> Lock(s_QueueMutex);
@@ -38,6 +82,36 @@ class JobSystem final : private Uncopyable, private Unmovable
         s_PendingJobs.emplace(Command);
     }
 
+    template <typename Func, typename... Args> static void Submit(WaitGroup& group, Func&& InFunc, Args&&... args)
+    {
+        Job Command = std::bind(std::forward<Func>(InFunc), std::forward<Args>(args)...);
+
+        group.Add();
+        Submit(
+            [&group, Command]
+            {
+                Command();
+                group.Done();
+            });
+    }
+
+    // Long running jobs (asset streaming) go to their own threads, Wait() && Update() never block on them, so frames keep going.
+    template <typename Func, typename... Args> static void SubmitBackground(Func&& InFunc, Args&&... args)
+    {
+        std::scoped_lock<std::mutex> Lock(s_QueueMutex);
+
+        Job Command = std::bind(std::forward<Func>(InFunc), std::forward<Args>(args)...);
+        if (s_ThreadCount == 0)
+        {
+            Command();
+            return;
+        }
+
+        auto& thread = *std::min_element(s_BackgroundThreads.begin(), s_BackgroundThreads.end(),
+                                         [](const auto& lhs, const auto& rhs) { return lhs.GetJobsCount() < rhs.GetJobsCount(); });
+        thread.Submit(Command);
+    }
+
     FORCEINLINE static uint32_t GetThreadCount() { return s_ThreadCount; }
     FORCEINLINE static auto& GetThreads() { return s_Threads; }
 
@@ -45,6 +119,9 @@ class JobSystem final : private Uncopyable, private Unmovable
     inline static uint32_t s_ThreadCount = 0;
     inline static std::array<Thread, MAX_WORKER_THREADS> s_Threads;
 
+    static constexpr uint32_t s_BACKGROUND_THREAD_COUNT = 2;
+    inline static std::array<Thread, s_BACKGROUND_THREAD_COUNT> s_BackgroundThreads;
+
     inline static std::mutex s_QueueMutex;
     inline static std::queue<Job> s_PendingJobs;
 };
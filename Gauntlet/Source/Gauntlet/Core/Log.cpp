@@ -1,20 +1,438 @@
 #include <GauntletPCH.h>
 #include "Log.h"
 
+#include "Gauntlet/Core/Profiler.h"
+
+#include <atomic>
+#include <ctime>
+
 namespace Gauntlet
 {
-std::mutex Log::s_LogMutex;
-std::ofstream Log::s_Output;
+
+struct LogSlot
+{
+    std::atomic<uint64_t> Sequence = 0;  // Equals slot's position when free, position + 1 once its record is committed.
+    LogRecord Record;
+};
+
+struct LogArg
+{
+    ELogArgType Type = ELogArgType::LAT_INT;
+    union
+    {
+        int64_t Int;
+        uint64_t UInt;
+        double Double;
+        uintptr_t Pointer;
+        const char* String;
+    };
+};
+
+static constexpr uint64_t s_LogRingSize      = 4096;  // Power of two.
+static constexpr uint64_t s_MaxLogFileSize   = 16 * 1024 * 1024;
+static constexpr uint32_t s_MaxLogFileCount  = 4;  // Gauntlet.log && its rotated copies Gauntlet.1.log .. Gauntlet.3.log.
+static constexpr uint32_t s_MaxLogArgs       = LogRecord::s_PayloadSize / 2;
+static constexpr auto s_LoggerWakeupInterval = std::chrono::milliseconds(10);
+
+static const char* s_LogLevelStrings[] = {"[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[TRACE]: ", "[DEBUG]: "};
+static const char* s_LogLevelColors[]  = {"\033[31m", "\033[91m", "\033[93m", "\033[94m", "\033[97m", "\033[92m"};
+
+static std::array<LogSlot, s_LogRingSize> s_LogRing;
+static std::atomic<uint64_t> s_EnqueuePosition = 0;
+static std::atomic<uint64_t> s_WrittenPosition = 0;
+static uint64_t s_DequeuePosition              = 0;  // Touched by logger thread only.
+
+static std::atomic<bool> s_bLoggerRunning = false;
+static std::atomic<int64_t> s_CurrentTime = 0;  // Updated by logger thread, so producers don't query the clock themselves.
+static std::thread s_LoggerThread;
+static std::mutex s_WakeupMutex;
+static std::condition_variable s_WakeupCondition;
+
+static std::mutex s_OutputMutex;  // Contended only while messages are written synchronously, i.e. logger thread isn't running.
+static std::ofstream s_Output;
+static uint64_t s_OutputSize = 0;
+
+static thread_local LogRecord t_SyncRecord;
+static thread_local int64_t t_CachedTime = -1;
+static thread_local char t_CachedTimeString[32];
+
+static std::string GetLogFilePath(const uint32_t index)
+{
+    return index == 0 ? "Gauntlet.log" : "Gauntlet." + std::to_string(index) + ".log";
+}
+
+static const char* GetTimeString(const int64_t time)
+{
+    if (time == t_CachedTime) return t_CachedTimeString;
+
+    const std::time_t currentTime   = static_cast<std::time_t>(time);
+    const std::tm* currentLocalTime = std::localtime(&currentTime);
+    std::strftime(t_CachedTimeString, sizeof(t_CachedTimeString), "[%d/%m/%Y|%H:%M:%S]", currentLocalTime);
+    t_CachedTime = time;
+    return t_CachedTimeString;
+}
+
+template <typename T> static void AppendFormatted(std::string& out, const char* spec, const T value)
+{
+    char buffer[128]     = {0};
+    const int32_t length = snprintf(buffer, sizeof(buffer), spec, value);
+    if (length <= 0) return;
+
+    if (length < static_cast<int32_t>(sizeof(buffer)))
+    {
+        out.append(buffer, length);
+        return;
+    }
+
+    const size_t offset = out.size();
+    out.resize(offset + length + 1);
+    snprintf(out.data() + offset, length + 1, spec, value);
+    out.resize(offset + length);
+}
+
+static int64_t GetArgAsInt(const LogArg& arg)
+{
+    switch (arg.Type)
+    {
+        case ELogArgType::LAT_INT: return arg.Int;
+        case ELogArgType::LAT_UINT: return static_cast<int64_t>(arg.UInt);
+        case ELogArgType::LAT_DOUBLE: return static_cast<int64_t>(arg.Double);
+        case ELogArgType::LAT_POINTER: return static_cast<int64_t>(arg.Pointer);
+        default: return 0;
+    }
+}
+
+static double GetArgAsDouble(const LogArg& arg)
+{
+    switch (arg.Type)
+    {
+        case ELogArgType::LAT_INT: return static_cast<double>(arg.Int);
+        case ELogArgType::LAT_UINT: return static_cast<double>(arg.UInt);
+        case ELogArgType::LAT_DOUBLE: return arg.Double;
+        default: return 0.0;
+    }
+}
+
+// Conversion specifier gets its own length modifier, so it always matches captured 64-bit argument.
+static void AppendArg(std::string& out, char* spec, const uint32_t specLength, const char conversion, const LogArg& arg)
+{
+    switch (conversion)
+    {
+        case 'd':
+        case 'i':
+        {
+            memcpy(&spec[specLength], "lld", 4);
+            AppendFormatted(out, spec, static_cast<long long>(GetArgAsInt(arg)));
+            break;
+        }
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        {
+            const char suffix[] = {'l', 'l', conversion, '\0'};
+            memcpy(&spec[specLength], suffix, sizeof(suffix));
+            AppendFormatted(out, spec, static_cast<unsigned long long>(GetArgAsInt(arg)));
+            break;
+        }
+        case 'c':
+        {
+            memcpy(&spec[specLength], "c", 2);
+            AppendFormatted(out, spec, static_cast<int32_t>(GetArgAsInt(arg)));
+            break;
+        }
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+        {
+            const char suffix[] = {conversion, '\0'};
+            memcpy(&spec[specLength], suffix, sizeof(suffix));
+            AppendFormatted(out, spec, GetArgAsDouble(arg));
+            break;
+        }
+        case 's':
+        {
+            if (arg.Type != ELogArgType::LAT_STRING && arg.Type != ELogArgType::LAT_HEAP_STRING)
+            {
+                out.append("(invalid)");
+                break;
+            }
+
+            if (specLength == 1)
+            {
+                out.append(arg.String);
+                break;
+            }
+
+            memcpy(&spec[specLength], "s", 2);
+            AppendFormatted(out, spec, arg.String);
+            break;
+        }
+        case 'p':
+        {
+            memcpy(&spec[specLength], "p", 2);
+            AppendFormatted(out, spec, reinterpret_cast<const void*>(arg.Pointer));
+            break;
+        }
+        default: out.append("(invalid)"); break;
+    }
+}
+
+static void AppendMessage(std::string& out, const char* format, const LogArg* args, const uint32_t argCount)
+{
+    uint32_t argIndex = 0;
+    for (const char* c = format; *c; ++c)
+    {
+        if (*c != '%')
+        {
+            out.push_back(*c);
+            continue;
+        }
+
+        if (c[1] == '%')
+        {
+            out.push_back('%');
+            ++c;
+            continue;
+        }
+
+        // Flags, width && precision are kept as is, length modifiers are dropped.
+        char spec[32]       = "%";
+        uint32_t specLength = 1;
+        const char* it      = c + 1;
+        while (*it && strchr("-+ #0123456789.", *it) && specLength < sizeof(spec) - 4)
+            spec[specLength++] = *it++;
+        while (*it && strchr("hljztL", *it))
+            ++it;
+
+        if (!*it)
+        {
+            out.append(c);
+            break;
+        }
+
+        c = it;
+        if (argIndex < argCount)
+            AppendArg(out, spec, specLength, *it, args[argIndex++]);
+        else
+            out.append("(missing)");
+    }
+}
+
+// Decodes && formats record into console && file outputs, heap strings are freed afterwards.
+static void FormatRecord(const LogRecord& record, std::string& consoleOut, std::string& fileOut)
+{
+    LogArg args[s_MaxLogArgs];
+    uint32_t argCount = 0;
+    for (uint32_t offset = 0; offset < record.Size && argCount < s_MaxLogArgs;)
+    {
+        LogArg& arg = args[argCount++];
+        arg.Type    = static_cast<ELogArgType>(record.Payload[offset++]);
+        switch (arg.Type)
+        {
+            case ELogArgType::LAT_STRING:
+            {
+                arg.String = &record.Payload[offset];
+                offset += static_cast<uint32_t>(strlen(arg.String)) + 1;
+                break;
+            }
+            case ELogArgType::LAT_HEAP_STRING:
+            {
+                char* heapString = nullptr;
+                memcpy(&heapString, &record.Payload[offset], sizeof(heapString));
+                arg.String = heapString;
+                offset += sizeof(heapString);
+                break;
+            }
+            case ELogArgType::LAT_POINTER:
+            {
+                memcpy(&arg.Pointer, &record.Payload[offset], sizeof(arg.Pointer));
+                offset += sizeof(arg.Pointer);
+                break;
+            }
+            default:
+            {
+                memcpy(&arg.UInt, &record.Payload[offset], sizeof(arg.UInt));
+                offset += sizeof(arg.UInt);
+                break;
+            }
+        }
+    }
+
+    const auto levelIndex  = static_cast<uint32_t>(record.Level);
+    const size_t fileStart = fileOut.size();
+    fileOut.append(GetTimeString(record.Time));
+    fileOut.push_back(' ');
+    fileOut.append(s_LogLevelStrings[levelIndex]);
+    if (argCount > 0) AppendMessage(fileOut, args[0].String, &args[1], argCount - 1);
+
+    consoleOut.append(s_LogLevelColors[levelIndex]);
+    consoleOut.append(fileOut, fileStart, std::string::npos);
+    consoleOut.append(" \033[0m\n");
+    fileOut.push_back('\n');
+
+    for (uint32_t i = 0; i < argCount; ++i)
+        if (args[i].Type == ELogArgType::LAT_HEAP_STRING) delete[] args[i].String;
+}
+
+static void RotateLogFiles()
+{
+    s_Output.close();
+
+    std::error_code errorCode;
+    std::filesystem::remove(GetLogFilePath(s_MaxLogFileCount - 1), errorCode);
+    for (uint32_t i = s_MaxLogFileCount - 1; i > 0; --i)
+        std::filesystem::rename(GetLogFilePath(i - 1), GetLogFilePath(i), errorCode);
+
+    s_Output     = std::ofstream(GetLogFilePath(0), std::ios::out | std::ios::trunc | std::ios::binary);
+    s_OutputSize = 0;
+}
+
+static void WriteOutput(const std::string& consoleOut, const std::string& fileOut)
+{
+    std::scoped_lock<std::mutex> lock(s_OutputMutex);
+    fwrite(consoleOut.data(), 1, consoleOut.size(), stdout);
+    fflush(stdout);
+
+    if (!s_Output.is_open()) return;
+
+    s_Output.write(fileOut.data(), fileOut.size());
+    s_Output.flush();
+
+    s_OutputSize += fileOut.size();
+    if (s_OutputSize >= s_MaxLogFileSize) RotateLogFiles();
+}
+
+static void LoggerThreadLoop()
+{
+    GNT_PROFILE_THREAD("Logger");
+
+    std::string consoleOut;
+    std::string fileOut;
+    for (;;)
+    {
+        s_CurrentTime.store(static_cast<int64_t>(std::time(nullptr)), std::memory_order_relaxed);
+        const bool bRunning = s_bLoggerRunning.load(std::memory_order_acquire);
+
+        consoleOut.clear();
+        fileOut.clear();
+
+        uint32_t recordCount = 0;
+        while (recordCount < s_LogRingSize)
+        {
+            auto& slot = s_LogRing[s_DequeuePosition & (s_LogRingSize - 1)];
+            if (slot.Sequence.load(std::memory_order_acquire) != s_DequeuePosition + 1) break;
+
+            FormatRecord(slot.Record, consoleOut, fileOut);
+            slot.Sequence.store(s_DequeuePosition + s_LogRingSize, std::memory_order_release);
+            ++s_DequeuePosition;
+            ++recordCount;
+        }
+
+        if (recordCount > 0)
+        {
+            WriteOutput(consoleOut, fileOut);
+            s_WrittenPosition.store(s_DequeuePosition, std::memory_order_release);
+            continue;
+        }
+
+        // Slots claimed before shutdown are still drained.
+        if (!bRunning && s_DequeuePosition == s_EnqueuePosition.load(std::memory_order_acquire)) break;
+
+        std::unique_lock<std::mutex> lock(s_WakeupMutex);
+        s_WakeupCondition.wait_for(lock, s_LoggerWakeupInterval);
+    }
+}
 
 void Log::Init()
 {
-    s_Output = std::ofstream("Gauntlet.log", std::ios::out | std::ios::trunc);
-    if (!s_Output.is_open()) LOG_WARN("Failed to create/open log file! %s");
+    s_Output     = std::ofstream(GetLogFilePath(0), std::ios::out | std::ios::trunc | std::ios::binary);
+    s_OutputSize = 0;
+
+    for (uint64_t i = 0; i < s_LogRingSize; ++i)
+        s_LogRing[i].Sequence.store(i, std::memory_order_relaxed);
+    s_EnqueuePosition.store(0, std::memory_order_relaxed);
+    s_WrittenPosition.store(0, std::memory_order_relaxed);
+    s_DequeuePosition = 0;
+    s_CurrentTime.store(static_cast<int64_t>(std::time(nullptr)), std::memory_order_relaxed);
+
+    s_bLoggerRunning.store(true, std::memory_order_release);
+    s_LoggerThread = std::thread(&LoggerThreadLoop);
+
+    if (!s_Output.is_open()) LOG_WARN("Failed to create/open log file: %s", GetLogFilePath(0).data());
 }
 
 void Log::Shutdown()
 {
+    s_bLoggerRunning.store(false, std::memory_order_release);
+    s_WakeupCondition.notify_one();
+    if (s_LoggerThread.joinable()) s_LoggerThread.join();
+
+    std::scoped_lock<std::mutex> lock(s_OutputMutex);
     s_Output.close();
 }
 
-}  // namespace Gauntlet
\ No newline at end of file
+LogRecord& Log::BeginRecord(const ELogLevel logLevel, uint64_t& outTicket)
+{
+    // Before Init() && after Shutdown() messages are written synchronously.
+    if (!s_bLoggerRunning.load(std::memory_order_acquire))
+    {
+        outTicket          = UINT64_MAX;
+        t_SyncRecord.Level = logLevel;
+        t_SyncRecord.Time  = static_cast<int64_t>(std::time(nullptr));
+        return t_SyncRecord;
+    }
+
+    uint64_t position = s_EnqueuePosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        auto& slot              = s_LogRing[position & (s_LogRingSize - 1)];
+        const uint64_t sequence = slot.Sequence.load(std::memory_order_acquire);
+        const auto difference   = static_cast<int64_t>(sequence - position);
+        if (difference == 0)
+        {
+            if (s_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                outTicket         = position;
+                slot.Record.Level = logLevel;
+                slot.Record.Time  = s_CurrentTime.load(std::memory_order_relaxed);
+                return slot.Record;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Ring is full, wait for logger thread instead of dropping messages.
+            s_WakeupCondition.notify_one();
+            std::this_thread::yield();
+            position = s_EnqueuePosition.load(std::memory_order_relaxed);
+        }
+        else
+            position = s_EnqueuePosition.load(std::memory_order_relaxed);
+    }
+}
+
+void Log::EndRecord(LogRecord& record, const uint64_t ticket)
+{
+    if (ticket == UINT64_MAX)
+    {
+        std::string consoleOut;
+        std::string fileOut;
+        FormatRecord(record, consoleOut, fileOut);
+        WriteOutput(consoleOut, fileOut);
+        return;
+    }
+
+    s_LogRing[ticket & (s_LogRingSize - 1)].Sequence.store(ticket + 1, std::memory_order_release);
+    if (record.Level > ELogLevel::LL_ERROR) return;
+
+    s_WakeupCondition.notify_one();
+    while (s_WrittenPosition.load(std::memory_order_acquire) <= ticket && s_bLoggerRunning.load(std::memory_order_acquire))
+        std::this_thread::yield();
+}
+
+}  // namespace Gauntlet
@@ -1,16 +1,22 @@
 #pragma once
 
 #include <Gauntlet/Core/Core.h>
-#include <mutex>
-#include <fstream>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Messages above this level are compiled out, so trace && debug ones cost nothing in release.
+#ifndef GNT_LOG_LEVEL
+#if GNT_RELEASE
+#define GNT_LOG_LEVEL 3  // ELogLevel::LL_INFO
+#else
+#define GNT_LOG_LEVEL 5  // ELogLevel::LL_DEBUG
+#endif
+#endif
 
 namespace Gauntlet
 {
-#define LOG_WARN_ENABLED 1
-#define LOG_TRACE_ENABLED 1
-
-static constexpr uint32_t s_OutMessageLength    = 32000;
-static constexpr uint32_t s_MaxTimeFormatLength = 100;
 
 enum class ELogLevel : uint8_t
 {
@@ -22,105 +28,152 @@ enum class ELogLevel : uint8_t
     LL_DEBUG
 };
 
-class Log final
+enum class ELogArgType : uint8_t
+{
+    LAT_INT = 0,
+    LAT_UINT,
+    LAT_DOUBLE,
+    LAT_POINTER,
+    LAT_STRING,       // Copied into payload.
+    LAT_HEAP_STRING,  // Didn't fit into payload, owned by record && freed once it's written.
+};
+
+// Format string && arguments are captured by value, formatting happens later on logger thread.
+struct LogRecord
+{
+    static constexpr uint32_t s_PayloadSize = 496;
+
+    int64_t Time    = 0;  // (s) Since epoch, comes from logger's per second clock.
+    ELogLevel Level = ELogLevel::LL_INFO;
+    uint16_t Size   = 0;          // Used bytes of payload.
+    char Payload[s_PayloadSize];  // Format string followed by arguments, each of them prefixed with ELogArgType.
+};
+
+class LogRecordEncoder final
 {
   public:
-    static void Init();
-    static void Shutdown();
+    explicit LogRecordEncoder(LogRecord& record) : m_Record(record) { m_Record.Size = 0; }
 
-    template <typename... Args> static void Output(ELogLevel logLevel, const char* message, Args&&... args)
+    template <typename T> void Encode(const T& arg)
     {
-        std::scoped_lock m_Lock(s_LogMutex);
-        s_Output                            = std::ofstream("Gauntlet.log", std::ios::out | std::ios::app);
-        static const char* LevelStrings[]   = {"[FATAL]: ", "[ERROR]: ", "[WARN]: ", "[INFO]: ", "[TRACE]: ", "[DEBUG]: "};
-        static const char* LogLevelColors[] = {
-            "\033[31m", "\033[91m", "\033[93m", "\033[94m", "\033[97m", "\033[92m",
-        };
-
-        int32_t LevelIndex = 0;
-        switch (logLevel)
+        using Type = std::decay_t<T>;
+        if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>)
+            EncodeString(arg ? arg : "(null)", arg ? strlen(arg) : 6);
+        else if constexpr (std::is_same_v<Type, std::string> || std::is_same_v<Type, std::string_view>)
+            EncodeString(arg.data(), arg.size());
+        else if constexpr (std::is_enum_v<Type>)
+            Encode(static_cast<std::underlying_type_t<Type>>(arg));
+        else if constexpr (std::is_floating_point_v<Type>)
+            EncodeValue(ELogArgType::LAT_DOUBLE, static_cast<double>(arg));
+        else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+            EncodeValue(ELogArgType::LAT_INT, static_cast<int64_t>(arg));
+        else if constexpr (std::is_integral_v<Type>)
+            EncodeValue(ELogArgType::LAT_UINT, static_cast<uint64_t>(arg));
+        else if constexpr (std::is_pointer_v<Type> || std::is_null_pointer_v<Type>)
+            EncodeValue(ELogArgType::LAT_POINTER, reinterpret_cast<uintptr_t>(static_cast<const volatile void*>(arg)));
+        else
+            static_assert(sizeof(Type) == 0, "Unsupported log argument type!");
+    }
+
+  private:
+    LogRecord& m_Record;
+
+    template <typename T> void EncodeValue(const ELogArgType type, const T value) { EncodeBytes(type, &value, sizeof(value)); }
+
+    // Arguments that don't fit are dropped, formatter prints them as missing.
+    bool EncodeBytes(const ELogArgType type, const void* data, const size_t size)
+    {
+        if (m_Record.Size + 1 + size > LogRecord::s_PayloadSize) return false;
+
+        m_Record.Payload[m_Record.Size] = static_cast<char>(type);
+        memcpy(&m_Record.Payload[m_Record.Size + 1], data, size);
+        m_Record.Size += static_cast<uint16_t>(1 + size);
+        return true;
+    }
+
+    void EncodeString(const char* str, const size_t length)
+    {
+        if (m_Record.Size + 1 + length + 1 <= LogRecord::s_PayloadSize)
         {
-            case ELogLevel::LL_FATAL:
-            {
-                LevelIndex = 0;
-                break;
-            }
-            case ELogLevel::LL_ERROR:
-            {
-                LevelIndex = 1;
-                break;
-            }
-            case ELogLevel::LL_WARN:
-            {
-                LevelIndex = 2;
-                break;
-            }
-            case ELogLevel::LL_INFO:
-            {
-                LevelIndex = 3;
-                break;
-            }
-            case ELogLevel::LL_TRACE:
-            {
-                LevelIndex = 4;
-                break;
-            }
-            case ELogLevel::LL_DEBUG:
-            {
-                LevelIndex = 5;
-                break;
-            }
+            m_Record.Payload[m_Record.Size] = static_cast<char>(ELogArgType::LAT_STRING);
+            memcpy(&m_Record.Payload[m_Record.Size + 1], str, length);
+            m_Record.Payload[m_Record.Size + 1 + length] = '\0';
+            m_Record.Size += static_cast<uint16_t>(1 + length + 1);
+            return;
         }
 
-        char FormattedMessage[s_OutMessageLength] = {0};
-        sprintf(FormattedMessage, message, args...);
+        // Long strings(e.g. validation messages) go to heap instead of being truncated.
+        if (m_Record.Size + 1 + sizeof(char*) > LogRecord::s_PayloadSize) return;
 
-        // Get global UTC time
-        const std::chrono::system_clock::time_point CurrentTimeUTC = std::chrono::system_clock::now();
+        char* heapString = new char[length + 1];
+        memcpy(heapString, str, length);
+        heapString[length] = '\0';
+        EncodeValue(ELogArgType::LAT_HEAP_STRING, heapString);
+    }
+};
 
-        // Convert to local time
-        const std::time_t CurrentTime   = std::chrono::system_clock::to_time_t(CurrentTimeUTC);
-        const std::tm* CurrentLocalTime = std::localtime(&CurrentTime);
+/*
+ * Producers claim records in a lock-free MPSC ring && only capture arguments, logger thread formats them, prints to console
+ * && batches writes to a log file that stays open && rotates by size. Fatal && error messages wait until they're written,
+ * so they survive the debug break that usually follows them.
+ */
+class Log final : private Uncopyable, private Unmovable
+{
+  public:
+    static void Init();
+    static void Shutdown();
 
-        // Format the time with timezone
-        char FormattedTime[s_MaxTimeFormatLength] = {0};
-        std::strftime(FormattedTime, s_MaxTimeFormatLength, "[%d/%m/%Y|%H:%M:%S]", CurrentLocalTime);
+    template <typename... Args> static void Output(const ELogLevel logLevel, const char* message, Args&&... args)
+    {
+        uint64_t ticket   = 0;
+        LogRecord& record = BeginRecord(logLevel, ticket);
 
-        char FinalOutMessage[s_OutMessageLength] = {0};
-        sprintf(FinalOutMessage, "%s %s%s", FormattedTime, LevelStrings[LevelIndex], FormattedMessage);
-        printf("%s%s \033[0m\n", LogLevelColors[LevelIndex], FinalOutMessage);
-        s_Output << FinalOutMessage << std::endl;
+        LogRecordEncoder encoder(record);
+        encoder.Encode(message);
+        (encoder.Encode(args), ...);
 
-        s_Output.close();
+        EndRecord(record, ticket);
     }
 
   private:
-    static std::mutex s_LogMutex;
-    static std::ofstream s_Output;
+    static LogRecord& BeginRecord(const ELogLevel logLevel, uint64_t& outTicket);
+    static void EndRecord(LogRecord& record, const uint64_t ticket);
 };
 
-#define LOG_INFO(message, ...) Gauntlet::Log::Output(Gauntlet::ELogLevel::LL_INFO, message, ##__VA_ARGS__)
-
-#if GNT_DEBUG
+#if GNT_LOG_LEVEL >= 0
 #define LOG_FATAL(message, ...) Gauntlet::Log::Output(Gauntlet::ELogLevel::LL_FATAL, message, ##__VA_ARGS__)
-#define LOG_ERROR(message, ...) Gauntlet::Log::Output(Gauntlet::ELogLevel::LL_ERROR, message, ##__VA_ARGS__)
-#define LOG_DEBUG(message, ...) Gauntlet::Log::Output(Gauntlet::ELogLevel::LL_DEBUG, message, ##__VA_ARGS__)
-#elif GNT_RELEASE
+#else
 #define LOG_FATAL(message, ...)
+#endif
+
+#if GNT_LOG_LEVEL >= 1
+#define LOG_ERROR(message, ...) Gauntlet::Log::Output(Gauntlet::ELogLevel::LL_ERROR, message, ##__VA_ARGS__)
+#else
 #define LOG_ERROR(message, ...)
-#define LOG_DEBUG(message, ...)
 #endif
 
-#if LOG_WARN_ENABLED
+#if GNT_LOG_LEVEL >= 2
 #define LOG_WARN(message, ...) Gauntlet::Log::Output(Gauntlet::ELogLevel::LL_WARN, message, ##__VA_ARGS__)
 #else
 #define LOG_WARN(message, ...)
 #endif
 
-#if LOG_TRACE_ENABLED
+#if GNT_LOG_LEVEL >= 3
+#define LOG_INFO(message, ...) Gauntlet::Log::Output(Gauntlet::ELogLevel::LL_INFO, message, ##__VA_ARGS__)
+#else
+#define LOG_INFO(message, ...)
+#endif
+
+#if GNT_LOG_LEVEL >= 4
 #define LOG_TRACE(message, ...) Gauntlet::Log::Output(Gauntlet::ELogLevel::LL_TRACE, message, ##__VA_ARGS__)
 #else
 #define LOG_TRACE(message, ...)
 #endif
 
-}  // namespace Gauntlet
\ No newline at end of file
+#if GNT_LOG_LEVEL >= 5
+#define LOG_DEBUG(message, ...) Gauntlet::Log::Output(Gauntlet::ELogLevel::LL_DEBUG, message, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(message, ...)
+#endif
+
+}  // namespace Gauntlet
@@ -0,0 +1,208 @@
+#include "GauntletPCH.h"
+#include "Profiler.h"
+
+#if GNT_PROFILING
+
+#include "Gauntlet/Renderer/GPUQueryRing.h"
+
+#include <iomanip>
+
+namespace Gauntlet
+{
+
+struct ProfilerThreadData
+{
+    std::string Name;
+    uint32_t Index = 0;
+    uint32_t Depth = 0;  // Touched by owning thread only.
+
+    std::mutex ZonesMutex;  // Contended only while NewFrame() drains zones.
+    std::vector<ProfilerZone> Zones;
+};
+
+struct ProfilerGPUQueueData
+{
+    std::string Name;
+    double LastSubmitTime = -1.0;  // Query ring keeps its results until new ones are available, so they're submitted once.
+};
+
+static std::mutex s_ThreadsMutex;
+static std::vector<Scoped<ProfilerThreadData>> s_Threads;
+static std::vector<ProfilerGPUQueueData> s_GPUQueues;
+static std::vector<double> s_CaptureFrameStarts;
+static thread_local ProfilerThreadData* t_ThreadData = nullptr;
+
+static ProfilerThreadData& GetThreadData()
+{
+    if (t_ThreadData) return *t_ThreadData;
+
+    std::scoped_lock<std::mutex> lock(s_ThreadsMutex);
+    auto& threadData  = s_Threads.emplace_back(MakeScoped<ProfilerThreadData>());
+    threadData->Index = static_cast<uint32_t>(s_Threads.size() - 1);
+    threadData->Name  = "Thread_" + std::to_string(threadData->Index);
+    t_ThreadData      = threadData.get();
+    return *t_ThreadData;
+}
+
+ProfilerScope::ProfilerScope(const char* name) : m_Name(name)
+{
+    Profiler::BeginZone();
+    m_Start = Timer::Now();
+}
+
+void Profiler::BeginZone()
+{
+    ++GetThreadData().Depth;
+}
+
+void Profiler::EndZone(const char* name, const double start)
+{
+    const double end = Timer::Now();
+    auto& threadData = GetThreadData();
+    --threadData.Depth;
+
+    std::scoped_lock<std::mutex> lock(threadData.ZonesMutex);
+    threadData.Zones.push_back({name, start, end, threadData.Index, threadData.Depth});
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    auto& threadData = GetThreadData();
+
+    std::scoped_lock<std::mutex> lock(s_ThreadsMutex);
+    threadData.Name = name;
+}
+
+std::string Profiler::GetThreadName(const uint32_t threadIndex)
+{
+    std::scoped_lock<std::mutex> lock(s_ThreadsMutex);
+    return threadIndex < s_Threads.size() ? s_Threads[threadIndex]->Name : "Unknown";
+}
+
+std::string Profiler::GetGPUQueueName(const uint32_t queueIndex)
+{
+    return queueIndex < s_GPUQueues.size() ? s_GPUQueues[queueIndex].Name : "Unknown";
+}
+
+void Profiler::NewFrame()
+{
+    const double now = Timer::Now();
+
+    s_LastFrame.Zones.clear();
+    {
+        std::scoped_lock<std::mutex> lock(s_ThreadsMutex);
+        for (auto& threadData : s_Threads)
+        {
+            std::scoped_lock<std::mutex> zonesLock(threadData->ZonesMutex);
+            s_LastFrame.Zones.insert(s_LastFrame.Zones.end(), threadData->Zones.begin(), threadData->Zones.end());
+            threadData->Zones.clear();
+        }
+    }
+    s_LastFrame.End = now;
+
+    if (IsCapturing())
+    {
+        s_Capture.Zones.insert(s_Capture.Zones.end(), s_LastFrame.Zones.begin(), s_LastFrame.Zones.end());
+        s_CaptureFrameStarts.push_back(s_LastFrame.Start);
+
+        if (--s_CaptureFramesLeft == 0) WriteCapture();
+    }
+
+    s_LastFrame.Start = now;
+}
+
+void Profiler::SubmitGPUMarkers(const std::string& queueName, const std::vector<GPUMarker>& markers, const double submitTime)
+{
+    auto queueIt = std::find_if(s_GPUQueues.begin(), s_GPUQueues.end(), [&](const auto& queue) { return queue.Name == queueName; });
+    if (queueIt == s_GPUQueues.end()) queueIt = s_GPUQueues.insert(s_GPUQueues.end(), ProfilerGPUQueueData{queueName});
+    if (queueIt->LastSubmitTime == submitTime) return;
+
+    queueIt->LastSubmitTime = submitTime;
+    const auto queueIndex   = static_cast<uint32_t>(std::distance(s_GPUQueues.begin(), queueIt));
+
+    auto& gpuZones = s_LastFrame.GPUZones;
+    gpuZones.erase(std::remove_if(gpuZones.begin(), gpuZones.end(), [&](const auto& zone) { return zone.QueueIndex == queueIndex; }),
+                   gpuZones.end());
+    for (const auto& marker : markers)
+    {
+        const double start = submitTime + marker.Start / 1000.0;
+        gpuZones.push_back({marker.Name, start, start + marker.Time / 1000.0, queueIndex, marker.Depth});
+        if (IsCapturing()) s_Capture.GPUZones.push_back(gpuZones.back());
+    }
+}
+
+void Profiler::RequestCapture(const uint32_t frameCount, const std::string& filePath)
+{
+    if (IsCapturing() || frameCount == 0) return;
+
+    s_Capture.Zones.clear();
+    s_Capture.GPUZones.clear();
+    s_CaptureFrameStarts.clear();
+    s_CaptureFilePath   = filePath;
+    s_CaptureFramesLeft = frameCount;
+}
+
+static std::string EscapeJSONString(const std::string_view str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (const char c : str)
+    {
+        if (c == '"' || c == '\\') result.push_back('\\');
+        result.push_back(c);
+    }
+    return result;
+}
+
+void Profiler::WriteCapture()
+{
+    std::ofstream out(s_CaptureFilePath, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+    {
+        LOG_WARN("Failed to open profiler capture file: %s", s_CaptureFilePath.data());
+        return;
+    }
+
+    // Chrome trace event format, complete events("X") are in microseconds. CPU threads are process 0, GPU queues are process 1.
+    const double captureStart = s_CaptureFrameStarts.empty() ? 0.0 : s_CaptureFrameStarts.front();
+    const auto toMicroseconds = [&](const double time) { return (time - captureStart) * 1000000.0; };
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"GPU\"}}";
+    {
+        std::scoped_lock<std::mutex> lock(s_ThreadsMutex);
+        for (const auto& threadData : s_Threads)
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadData->Index << ",\"args\":{\"name\":\""
+                << EscapeJSONString(threadData->Name) << "\"}}";
+    }
+
+    for (uint32_t i = 0; i < s_GPUQueues.size(); ++i)
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":\""
+            << EscapeJSONString(s_GPUQueues[i].Name) << "\"}}";
+
+    for (size_t i = 0; i < s_CaptureFrameStarts.size(); ++i)
+        out << ",\n{\"name\":\"Frame " << i << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":"
+            << toMicroseconds(s_CaptureFrameStarts[i]) << "}";
+
+    for (const auto& zone : s_Capture.Zones)
+        out << ",\n{\"name\":\"" << EscapeJSONString(zone.Name) << "\",\"cat\":\"CPU\",\"ph\":\"X\",\"pid\":0,\"tid\":" << zone.ThreadIndex
+            << ",\"ts\":" << toMicroseconds(zone.Start) << ",\"dur\":" << (zone.End - zone.Start) * 1000000.0 << "}";
+
+    for (const auto& zone : s_Capture.GPUZones)
+        out << ",\n{\"name\":\"" << EscapeJSONString(zone.Name) << "\",\"cat\":\"GPU\",\"ph\":\"X\",\"pid\":1,\"tid\":" << zone.QueueIndex
+            << ",\"ts\":" << toMicroseconds(zone.Start) << ",\"dur\":" << (zone.End - zone.Start) * 1000000.0 << "}";
+
+    out << "\n]}\n";
+    out.close();
+
+    LOG_INFO("Profiler capture of %zu frames written to: %s", s_CaptureFrameStarts.size(), s_CaptureFilePath.data());
+
+    s_Capture.Zones.clear();
+    s_Capture.GPUZones.clear();
+}
+
+}  // namespace Gauntlet
+
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Gauntlet/Core/Core.h"
+
+// Instrumentation compiles out completely in release, macros expand to nothing.
+#if GNT_RELEASE
+#define GNT_PROFILING 0
+#else
+#define GNT_PROFILING 1
+#endif
+
+#if GNT_PROFILING
+
+#define GNT_PROFILER_CONCAT_IMPL(x, y) x##y
+#define GNT_PROFILER_CONCAT(x, y) GNT_PROFILER_CONCAT_IMPL(x, y)
+
+// Zone names should outlive the frame, e.g. string literals.
+#define GNT_PROFILE_SCOPE(name) Gauntlet::ProfilerScope GNT_PROFILER_CONCAT(profilerScope, __LINE__)(name)
+#define GNT_PROFILE_FUNCTION() GNT_PROFILE_SCOPE(__FUNCTION__)
+#define GNT_PROFILE_THREAD(name) Gauntlet::Profiler::SetThreadName(name)
+#define GNT_PROFILE_FRAME() Gauntlet::Profiler::NewFrame()
+#define GNT_PROFILE_GPU_MARKERS(queueName, markers, submitTime) Gauntlet::Profiler::SubmitGPUMarkers(queueName, markers, submitTime)
+
+#else
+
+#define GNT_PROFILE_SCOPE(name)
+#define GNT_PROFILE_FUNCTION()
+#define GNT_PROFILE_THREAD(name)
+#define GNT_PROFILE_FRAME()
+#define GNT_PROFILE_GPU_MARKERS(queueName, markers, submitTime)
+
+#endif
+
+#if GNT_PROFILING
+
+namespace Gauntlet
+{
+
+struct GPUMarker;
+
+struct ProfilerZone
+{
+    const char* Name     = nullptr;
+    double Start         = 0.0;  // (s) Timer::Now()
+    double End           = 0.0;
+    uint32_t ThreadIndex = 0;
+    uint32_t Depth       = 0;
+};
+
+struct ProfilerGPUZone
+{
+    std::string Name;
+    double Start        = 0.0;  // (s) On CPU timeline, frame's first marker is placed at its submit time.
+    double End          = 0.0;
+    uint32_t QueueIndex = 0;
+    uint32_t Depth      = 0;
+};
+
+struct ProfilerFrame
+{
+    double Start = 0.0;
+    double End   = 0.0;
+    std::vector<ProfilerZone> Zones;
+    std::vector<ProfilerGPUZone> GPUZones;  // Latest GPU results, they're frames in flight behind CPU ones.
+};
+
+/*
+ * CPU zones are collected into per thread buffers, so recording them from job system workers doesn't contend.
+ * Buffers are drained on NewFrame(), last frame is kept for the editor && a capture of N frames is exported to
+ * Chrome trace format(chrome://tracing, ui.perfetto.dev).
+ */
+class Profiler final : private Uncopyable, private Unmovable
+{
+  public:
+    static void NewFrame();
+
+    static void SetThreadName(const std::string& name);
+    static void SubmitGPUMarkers(const std::string& queueName, const std::vector<GPUMarker>& markers, const double submitTime);
+
+    static void RequestCapture(const uint32_t frameCount, const std::string& filePath);
+    FORCEINLINE static bool IsCapturing() { return s_CaptureFramesLeft > 0; }
+
+    FORCEINLINE static const auto& GetLastFrame() { return s_LastFrame; }
+    static std::string GetThreadName(const uint32_t threadIndex);
+    static std::string GetGPUQueueName(const uint32_t queueIndex);
+
+  private:
+    friend class ProfilerScope;
+
+    inline static ProfilerFrame s_LastFrame;
+    inline static ProfilerFrame s_Capture;
+    inline static uint32_t s_CaptureFramesLeft = 0;
+    inline static std::string s_CaptureFilePath;
+
+    static void BeginZone();
+    static void EndZone(const char* name, const double start);
+
+    static void WriteCapture();
+};
+
+class ProfilerScope final : private Uncopyable, private Unmovable
+{
+  public:
+    ProfilerScope(const char* name);
+    ~ProfilerScope() { Profiler::EndZone(m_Name, m_Start); }
+
+  private:
+    const char* m_Name = nullptr;
+    double m_Start     = 0.0;
+};
+
+}  // namespace Gauntlet
+
+#endif
@@ -1,24 +1,51 @@
 #include "GauntletPCH.h"
 #include "Thread.h"
 
+#include "Profiler.h"
+
 #ifdef GNT_PLATFORM_WINDOWS
 #include <Windows.h>
+#elif defined(GNT_PLATFORM_LINUX)
+#include <pthread.h>
+#include <sched.h>
 #endif
 
 namespace Gauntlet
 {
 
-void Thread::Start()
+// Called from the thread itself, so debuggers && profilers see it under the name it was started with.
+static void SetCurrentThreadName(const std::string& name)
+{
+#ifdef GNT_PLATFORM_WINDOWS
+
+    const std::wstring wideName(name.begin(), name.end());
+    const HRESULT hr = SetThreadDescription(GetCurrentThread(), wideName.data());
+    GNT_ASSERT(SUCCEEDED(hr), "Failed to set thread name!");
+
+#elif defined(GNT_PLATFORM_LINUX)
+
+    // Names are limited to 16 chars including null terminator.
+    const std::string threadName = name.substr(0, 15);
+    const int32_t nameResult     = pthread_setname_np(pthread_self(), threadName.data());
+    GNT_ASSERT(nameResult == 0, "Failed to set thread name!");
+
+#endif
+}
+
+void Thread::Start(const std::string& name)
 {
     m_Handle = std::thread(
-        [&]
+        [&, name]
         {
+            SetCurrentThreadName(name);
+            GNT_PROFILE_THREAD(name);
+
             while (true)
             {
                 Job job;
                 {
-                    m_ThreadState = EThreadState::IDLE;
                     std::unique_lock<std::mutex> Lock(m_QueueMutex);
+                    if (m_Jobs.empty()) m_ThreadState = EThreadState::IDLE;
 
                     // Wait until we want to shutdown or we got some jobs.
                     m_CondVar.wait(Lock, [this] { return !m_Jobs.empty() || m_bIsShutdownRequested; });
@@ -26,15 +53,16 @@ void Thread::Start()
                     if (m_Jobs.empty() && m_bIsShutdownRequested) break;
 
                     job = m_Jobs.front();
+                }
 
-                    m_ThreadState = EThreadState::WORKING;
-                    job();
+                // Job runs outside of the lock, so submitting to a busy thread doesn't block the caller until the job is done.
+                job();
 
-                    m_Jobs.pop();
-                    if (m_Jobs.empty())
-                        m_CondVar.notify_one();  // In case we were waiting, and done everything. Also it won't affect the "wait" above,
-                                                 // since conditions weren't changed, it's gonna get back waiting.
-                }
+                std::unique_lock<std::mutex> Lock(m_QueueMutex);
+                m_Jobs.pop();
+                if (m_Jobs.empty())
+                    m_CondVar.notify_all();  // In case we were waiting, and done everything. Also it won't affect the "wait" above,
+                                             // since conditions weren't changed, it's gonna get back waiting.
             }
         });
 }
@@ -44,7 +72,7 @@ void Thread::Shutdown()
     {
         std::unique_lock<std::mutex> Lock(m_QueueMutex);
         m_bIsShutdownRequested = true;
-        m_CondVar.notify_one();
+        m_CondVar.notify_all();
     }
 
     Join();
@@ -67,10 +95,17 @@ void Thread::SetThreadAffinity(const uint32_t threadID)
     const BOOL PriorityResult = SetThreadPriority(NativeHandle, THREAD_PRIORITY_HIGHEST);
     GNT_ASSERT(PriorityResult != 0, "Failed to set thread priority to THREAD_PRIORITY_HIGHEST");
 
-    std::wstringstream wss;
-    wss << "JobSystem_" << threadID;
-    HRESULT hr = SetThreadDescription(NativeHandle, wss.str().data());
-    GNT_ASSERT(SUCCEEDED(hr));
+#elif defined(GNT_PLATFORM_LINUX)
+
+    // Attaching thread to specific CPU
+    const pthread_t NativeHandle = m_Handle.native_handle();
+    cpu_set_t AffinityMask;
+    CPU_ZERO(&AffinityMask);
+    CPU_SET(threadID, &AffinityMask);
+    const int32_t AffinityResult = pthread_setaffinity_np(NativeHandle, sizeof(cpu_set_t), &AffinityMask);
+    GNT_ASSERT(AffinityResult == 0, "Failed to attach the thread to specific CPU core!");
+
+    // Priority is left as is, raising it above SCHED_OTHER requires CAP_SYS_NICE.
 
 #endif
 }
@@ -19,7 +19,7 @@ class Thread final : private Uncopyable, private Unmovable
     Thread()  = default;
     ~Thread() = default;
 
-    void Start();
+    void Start(const std::string& name);
     void Shutdown();
 
     FORCEINLINE void Join()
@@ -31,25 +31,34 @@ class Thread final : private Uncopyable, private Unmovable
     {
         std::unique_lock<std::mutex> Lock(m_QueueMutex);
         m_Jobs.push(job);
-        m_CondVar.notify_one();
+        m_ThreadState = EThreadState::WORKING;  // Set here rather than once worker wakes up, so a burst of jobs is spread across threads.
+        m_CondVar.notify_all();  // Condition variable is shared by worker && waiters, notify_one() could wake a waiter instead.
+    }
+
+    // Queue is popped by the worker itself, so it's read under the lock.
+    FORCEINLINE const size_t GetJobsCount() const
+    {
+        std::unique_lock<std::mutex> Lock(m_QueueMutex);
+        return m_Jobs.size();
     }
 
-    FORCEINLINE const size_t GetJobsCount() const { return m_Jobs.size(); }
     FORCEINLINE const bool IsIdle() const { return m_ThreadState == EThreadState::IDLE; }
 
+    // Blocks until every submitted job is done.
+    void Wait();
+
   private:
     std::thread m_Handle;
     std::queue<Job> m_Jobs;
-    std::mutex m_QueueMutex;
+    mutable std::mutex m_QueueMutex;
     std::condition_variable m_CondVar;
 
-    EThreadState m_ThreadState  = EThreadState::IDLE;
-    bool m_bIsShutdownRequested = false;
+    std::atomic<EThreadState> m_ThreadState = EThreadState::IDLE;  // Read by submitters without the lock.
+    bool m_bIsShutdownRequested             = false;
 
     friend class JobSystem;
 
     // Should be called only once on init
     void SetThreadAffinity(const uint32_t threadID);
-    void Wait();
 };
 }  // namespace Gauntlet
\ No newline at end of file
@@ -1,14 +1,14 @@
 #include "GauntletPCH.h"
 #include "Timer.h"
 
-#include <GLFW/glfw3.h>
-
 namespace Gauntlet
 {
 
+// Doesn't depend on GLFW being initialized, headless applications don't create a window.
 double Timer::Now()
 {
-    return glfwGetTime();
+    static const auto s_StartTime = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - s_StartTime).count();
 }
 
 }  // namespace Gauntlet
\ No newline at end of file
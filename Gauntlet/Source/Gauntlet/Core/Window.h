@@ -21,6 +21,7 @@ struct WindowSpecification
     std::string_view Title;
     uint32_t Width;
     uint32_t Height;
+    bool bHeadless = false;
 };
 
 class Window : private Unmovable, private Uncopyable
@@ -7,11 +7,12 @@
 #include "Gauntlet/Event/WindowEvent.h"
 
 #include "Gauntlet/Renderer/RendererAPI.h"
-#include "Gauntlet/Renderer/Renderer.h"
 #include "Gauntlet/Renderer/GraphicsContext.h"
 #include "Gauntlet/Renderer/Image.h"
 #include "Gauntlet/Core/Input.h"
 
+#include "Gauntlet/Platform/Headless/HeadlessWindow.h"
+
 #include <GLFW/glfw3.h>
 
 #pragma warning(disable : 4834)
@@ -28,6 +29,8 @@ static void GLFWErrorCallback(int error, const char* description)
 
 Window* Window::Create(const WindowSpecification& windowSpec)
 {
+    if (windowSpec.bHeadless) return new HeadlessWindow(windowSpec);
+
     return new GLFWWindow(windowSpec);
 }
 
@@ -181,14 +184,14 @@ void GLFWWindow::SetPositionCentered()
 
 void GLFWWindow::OnUpdate()
 {
-    glfwPollEvents();
-
     if (!IsMinimized())
     {
         auto& Context = GraphicsContext::Get();
         Context.SwapBuffers();
-        SetVSync(Renderer::GetSettings().VSync);
     }
+
+    // Polled after presenting, so input is sampled after low latency mode's wait.
+    glfwPollEvents();
 }
 
 void GLFWWindow::HandleMinimized()
@@ -219,13 +222,10 @@ void GLFWWindow::SetWindowLogo(const std::string_view& filePath)
     ImageUtils::UnloadImage(Pixels);
 }
 
+// Swapchain is recreated by graphics context at the beginning of the frame, so it's only touched by the thread that acquires && presents.
 void GLFWWindow::SetVSync(bool bIsVsync)
 {
-    if (m_bIsVSync == bIsVsync) return;
     m_bIsVSync = bIsVsync;
-
-    auto& gc = GraphicsContext::Get();
-    gc.SetVSync(bIsVsync);
 }
 
 void GLFWWindow::SetWindowTitle(const std::string_view& title)
@@ -0,0 +1,20 @@
+#include <GauntletPCH.h>
+#include "HeadlessWindow.h"
+
+#include "Gauntlet/Renderer/GraphicsContext.h"
+
+namespace Gauntlet
+{
+
+HeadlessWindow::HeadlessWindow(const WindowSpecification& windowSpec) : Window(windowSpec)
+{
+    LOG_INFO("Creating headless window %s (%u, %u)", m_WindowSpec.Title.data(), m_WindowSpec.Width, m_WindowSpec.Height);
+    m_bIsRunning = true;
+}
+
+void HeadlessWindow::OnUpdate()
+{
+    GraphicsContext::Get().SwapBuffers();
+}
+
+}  // namespace Gauntlet
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Gauntlet/Core/Window.h>
+
+namespace Gauntlet
+{
+
+// No native window && no events, graphics context renders into offscreen images instead of the swapchain ones.
+class HeadlessWindow final : public Window
+{
+  public:
+    HeadlessWindow() = delete;
+    HeadlessWindow(const WindowSpecification& windowSpec);
+
+    ~HeadlessWindow() = default;
+
+    void OnUpdate() final override;
+    void HandleMinimized() final override {}
+
+    void SetWindowLogo(const std::string_view& filePath) final override {}
+    void SetWindowTitle(const std::string_view& title) final override {}
+    void SetVSync(bool bIsVsync) final override {}  // Nothing is presented.
+    FORCEINLINE void SetWindowCallback(const EventCallbackFn& fnCallback) final override { m_CallbackFn = fnCallback; }
+
+    FORCEINLINE void* GetNativeWindow() const final override { return nullptr; }
+
+  private:
+    EventCallbackFn m_CallbackFn;
+};
+
+}  // namespace Gauntlet
@@ -0,0 +1,57 @@
+#include "GauntletPCH.h"
+#include "Gauntlet/Utils/PlatformUtils.h"
+
+#include <cstdio>
+
+namespace Gauntlet
+{
+
+// Windows style filter "Name\0*.ext\0...\0" into zenity's "--file-filter='Name | *.ext'" arguments.
+static std::string BuildZenityFilters(const std::string_view& filter)
+{
+    std::string result;
+    const char* current = filter.data();
+    while (current && *current)
+    {
+        const std::string name = current;
+        current += name.size() + 1;
+        if (!*current) break;
+
+        std::string pattern = current;
+        current += pattern.size() + 1;
+
+        std::replace(pattern.begin(), pattern.end(), ';', ' ');
+        result += " --file-filter='" + name + " | " + pattern + "'";
+    }
+    return result;
+}
+
+static std::string RunFileDialog(const std::string& arguments)
+{
+    FILE* pipe = popen(("zenity --file-selection" + arguments + " 2>/dev/null").data(), "r");
+    if (!pipe)
+    {
+        LOG_WARN("Failed to open file dialog, zenity is missing?");
+        return std::string();
+    }
+
+    char szFile[4096] = {0};
+    std::string result;
+    if (fgets(szFile, sizeof(szFile), pipe)) result = szFile;
+    pclose(pipe);
+
+    if (!result.empty() && result.back() == '\n') result.pop_back();
+    return result;
+}
+
+std::string FileDialogs::OpenFile(const std::string_view& filter)
+{
+    return RunFileDialog(BuildZenityFilters(filter));
+}
+
+std::string FileDialogs::SaveFile(const std::string_view& filter)
+{
+    return RunFileDialog(" --save --confirm-overwrite" + BuildZenityFilters(filter));
+}
+
+}  // namespace Gauntlet
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Gauntlet/Core/Core.h"
+#include "Gauntlet/Renderer/CoreRendererTypes.h"
 #include <GLFW/glfw3.h>
 
 namespace Gauntlet
@@ -71,18 +72,37 @@ struct SwapchainSupportDetails final
         return availableFormats[0];
     }
 
-    static VkPresentModeKHR ChooseBestPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes, bool bIsVSync)
+    static VkPresentModeKHR ChooseBestPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes, bool bIsVSync,
+                                                  EPresentMode preferredPresentMode)
     {
         if (bIsVSync) return VK_PRESENT_MODE_FIFO_KHR;
 
-        for (const auto& PresentMode : availablePresentModes)
-        {
-            if (PresentMode == VK_PRESENT_MODE_MAILBOX_KHR) return PresentMode;  // Battery-drain mode on mobile devices
-        }
+        const auto IsAvailable = [&](const VkPresentModeKHR presentMode)
+        { return std::find(availablePresentModes.begin(), availablePresentModes.end(), presentMode) != availablePresentModes.end(); };
+
+        // Battery-drain modes on mobile devices
+        const VkPresentModeKHR PreferredMode = preferredPresentMode == EPresentMode::PRESENT_MODE_IMMEDIATE ? VK_PRESENT_MODE_IMMEDIATE_KHR
+                                                                                                            : VK_PRESENT_MODE_MAILBOX_KHR;
+        const VkPresentModeKHR FallbackMode =
+            PreferredMode == VK_PRESENT_MODE_MAILBOX_KHR ? VK_PRESENT_MODE_IMMEDIATE_KHR : VK_PRESENT_MODE_MAILBOX_KHR;
+        if (IsAvailable(PreferredMode)) return PreferredMode;
+        if (IsAvailable(FallbackMode)) return FallbackMode;
 
         return VK_PRESENT_MODE_FIFO_KHR;
     }
 
+    // Mailbox only helps with an image free for rendering while one is queued && one is displayed.
+    static uint32_t ChooseImageCount(const VkSurfaceCapabilitiesKHR& surfaceCapabilities, const VkPresentModeKHR presentMode,
+                                     const uint32_t framesInFlight)
+    {
+        uint32_t ImageCount = std::max(surfaceCapabilities.minImageCount, framesInFlight + 1);
+        if (presentMode == VK_PRESENT_MODE_MAILBOX_KHR) ImageCount = std::max(ImageCount, 3u);
+
+        // Zero max image count means there's no limit.
+        if (surfaceCapabilities.maxImageCount > 0) ImageCount = std::min(ImageCount, surfaceCapabilities.maxImageCount);
+        return ImageCount;
+    }
+
     static VkExtent2D ChooseBestExtent(const VkSurfaceCapabilitiesKHR& surfaceCapabilities, GLFWwindow* window)
     {
         if (surfaceCapabilities.currentExtent.width != std::numeric_limits<uint32_t>::max())
@@ -115,6 +115,52 @@ void VulkanAllocator::DestroyImage(VkImage& image, VmaAllocation& allocation) co
     --rendererStats.AllocatedImages;
 }
 
+VmaAllocation VulkanAllocator::AllocateMemory(const VkMemoryRequirements& memoryRequirements) const
+{
+    VmaAllocationCreateInfo allocationCreateInfo = {};
+    allocationCreateInfo.usage                   = VMA_MEMORY_USAGE_GPU_ONLY;
+    allocationCreateInfo.requiredFlags           = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VK_CHECK(vmaAllocateMemory(m_Allocator, &memoryRequirements, &allocationCreateInfo, &allocation, nullptr),
+             "Failed to allocate memory via VMA!");
+
+    VmaAllocationInfo allocationInfo = {};
+    QueryAllocationInfo(allocationInfo, allocation);
+
+    auto& context       = (VulkanContext&)VulkanContext::Get();
+    auto& rendererStats = Renderer::GetStats();
+    if (IsAllocatedOnGPU(context.GetDevice(), allocationInfo))
+        rendererStats.GPUMemoryAllocated += allocationInfo.size;
+    else
+        rendererStats.RAMMemoryAllocated += allocationInfo.size;
+
+    ++rendererStats.Allocations;
+    return allocation;
+}
+
+void VulkanAllocator::BindImageMemory(const VmaAllocation& allocation, const VkDeviceSize offset, VkImage& image) const
+{
+    VK_CHECK(vmaBindImageMemory2(m_Allocator, allocation, offset, image, nullptr), "Failed to bind image memory via VMA!");
+}
+
+void VulkanAllocator::FreeMemory(VmaAllocation& allocation) const
+{
+    VmaAllocationInfo allocationInfo = {};
+    QueryAllocationInfo(allocationInfo, allocation);
+
+    auto& context       = (VulkanContext&)VulkanContext::Get();
+    auto& rendererStats = Renderer::GetStats();
+    if (IsAllocatedOnGPU(context.GetDevice(), allocationInfo))
+        rendererStats.GPUMemoryAllocated -= allocationInfo.size;
+    else
+        rendererStats.RAMMemoryAllocated -= allocationInfo.size;
+
+    vmaFreeMemory(m_Allocator, allocation);
+    allocation = VK_NULL_HANDLE;
+    --rendererStats.Allocations;
+}
+
 VmaAllocation VulkanAllocator::CreateBuffer(const VkBufferCreateInfo& bufferCreateInfo, VkBuffer* outBuffer,
                                             VmaMemoryUsage memoryUsage) const
 {
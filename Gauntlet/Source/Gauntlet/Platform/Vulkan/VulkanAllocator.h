@@ -19,6 +19,11 @@ class VulkanAllocator final : private Uncopyable, private Unmovable
     VmaAllocation CreateImage(const VkImageCreateInfo& imageCreateInfo, VkImage* outImage) const;
     void DestroyImage(VkImage& image, VmaAllocation& allocation) const;
 
+    // Raw device memory, render graph binds transient images into it at offsets, so images with disjoint lifetimes alias.
+    VmaAllocation AllocateMemory(const VkMemoryRequirements& memoryRequirements) const;
+    void BindImageMemory(const VmaAllocation& allocation, const VkDeviceSize offset, VkImage& image) const;
+    void FreeMemory(VmaAllocation& allocation) const;
+
     VmaAllocation CreateBuffer(const VkBufferCreateInfo& bufferCreateInfo, VkBuffer* outBuffer,
                                VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_AUTO) const;
     void DestroyBuffer(VkBuffer& buffer, VmaAllocation& allocation) const;
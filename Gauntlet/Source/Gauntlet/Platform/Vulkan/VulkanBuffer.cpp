@@ -22,6 +22,7 @@ VkBufferUsageFlags GauntletBufferUsageToVulkan(const EBufferUsage bufferUsage)
     if (bufferUsage & EBufferUsageFlags::TRANSFER_DST) BufferUsageFlags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
     if (bufferUsage & EBufferUsageFlags::STAGING_BUFFER) BufferUsageFlags |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     if (bufferUsage & EBufferUsageFlags::STORAGE_BUFFER) BufferUsageFlags |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    if (bufferUsage & EBufferUsageFlags::INDIRECT_BUFFER) BufferUsageFlags |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
 
     GNT_ASSERT(BufferUsageFlags != 0, "Unknown buffer usage flag!");
     return BufferUsageFlags;
@@ -81,6 +82,8 @@ void CopyDataToBuffer(VulkanBuffer& vulkanBuffer, const VkDeviceSize dataSize, c
 
 VulkanVertexBuffer::VulkanVertexBuffer(BufferSpecification& bufferSpec) : m_BufferUsage(bufferSpec.Usage), m_VertexCount(bufferSpec.Count)
 {
+    // Buffers written on GPU(e.g. skinning output) are allocated up front, the rest on their first upload.
+    if (bufferSpec.Size > 0) BufferUtils::CreateBuffer(m_BufferUsage, bufferSpec.Size, m_Handle, VMA_MEMORY_USAGE_GPU_ONLY);
 }
 
 void VulkanVertexBuffer::SetData(const void* data, const size_t size)
@@ -90,6 +93,7 @@ void VulkanVertexBuffer::SetData(const void* data, const size_t size)
         BufferUtils::DestroyBuffer(m_Handle);
     }
 
+    UPLOAD_HEAP_GUARD_LOCK;
     auto& stagingBuffer = Renderer::GetStorageData().UploadHeap;
     stagingBuffer->SetData(data, size);
 
@@ -142,6 +146,7 @@ VulkanIndexBuffer::VulkanIndexBuffer(BufferSpecification& bufferSpec) : m_Indice
 {
     GNT_ASSERT(bufferSpec.Data && bufferSpec.Size > 0);
 
+    UPLOAD_HEAP_GUARD_LOCK;
     auto& stagingBuffer = Renderer::GetStorageData().UploadHeap;
     stagingBuffer->SetData(bufferSpec.Data, bufferSpec.Size);
 
@@ -282,6 +287,7 @@ void VulkanStorageBuffer::SetData(const void* data, const uint64_t dataSize)
             BufferUtils::CreateBuffer(m_Specification.Usage, m_Specification.Size, m_Handle);
     }
 
+    UPLOAD_HEAP_GUARD_LOCK;
     auto& stagingBuffer = Renderer::GetStorageData().UploadHeap;
     stagingBuffer->SetData(data, dataSize);
 
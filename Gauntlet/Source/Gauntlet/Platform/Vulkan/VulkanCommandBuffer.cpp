@@ -9,8 +9,6 @@
 namespace Gauntlet
 {
 
-static constexpr uint32_t s_MaxTimestampQueries = 16;
-
 static VkCommandBufferLevel GauntletCommandBufferLevelToVulkan(ECommandBufferLevel level)
 {
     switch (level)
@@ -24,60 +22,38 @@ static VkCommandBufferLevel GauntletCommandBufferLevelToVulkan(ECommandBufferLev
     return VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 }
 
-VulkanCommandBuffer::VulkanCommandBuffer(ECommandBufferType type, ECommandBufferLevel level) : m_Type(type), m_Level(level)
+VulkanCommandBuffer::VulkanCommandBuffer(ECommandBufferType type, ECommandBufferLevel level, VkCommandPool commandPool)
+    : m_CommandPool(commandPool), m_Level(level), m_Type(type)
 {
     auto& context = (VulkanContext&)VulkanContext::Get();
-    context.GetDevice()->AllocateCommandBuffer(m_CommandBuffer, type, GauntletCommandBufferLevelToVulkan(m_Level));
+    if (m_CommandPool)
+    {
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+        commandBufferAllocateInfo.level                       = GauntletCommandBufferLevelToVulkan(m_Level);
+        commandBufferAllocateInfo.commandBufferCount          = 1;
+        commandBufferAllocateInfo.commandPool                 = m_CommandPool;
+        VK_CHECK(vkAllocateCommandBuffers(context.GetDevice()->GetLogicalDevice(), &commandBufferAllocateInfo, &m_CommandBuffer),
+                 "Failed to allocate command buffer!");
+    }
+    else
+        context.GetDevice()->AllocateCommandBuffer(m_CommandBuffer, type, GauntletCommandBufferLevelToVulkan(m_Level));
 
-    CreateSyncResourcesAndQueries();
+    // Secondary command buffers are never submitted.
+    if (m_Level == ECommandBufferLevel::COMMAND_BUFFER_LEVEL_PRIMARY) CreateSyncResources();
 }
 
-void VulkanCommandBuffer::CreateSyncResourcesAndQueries()
+void VulkanCommandBuffer::CreateSyncResources()
 {
     auto& context                     = (VulkanContext&)VulkanContext::Get();
     VkFenceCreateInfo fenceCreateInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
     VK_CHECK(vkCreateFence(context.GetDevice()->GetLogicalDevice(), &fenceCreateInfo, VK_NULL_HANDLE, &m_SubmitFence),
              "Failed to create fence!");
-
-    VkQueryPoolCreateInfo queryPoolCreateInfo = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
-    queryPoolCreateInfo.queryType             = VK_QUERY_TYPE_PIPELINE_STATISTICS;
-    queryPoolCreateInfo.pipelineStatistics    = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |   // Input assembly vertices
-                                             VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |    // Input assembly primitives
-                                             VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |    // Vertex shader invocations
-                                             VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |  // Fragment shader invocations
-                                             VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |         // Clipping invocations
-                                             VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |          // Clipped primitives
-                                             VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_INVOCATIONS_BIT |  //  Geometry Shader
-                                             VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_PRIMITIVES_BIT |   //
-                                             VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_CONTROL_SHADER_PATCHES_BIT |  // Tesselation
-                                             VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_EVALUATION_SHADER_INVOCATIONS_BIT |
-                                             VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT  // Compute shader invocations
-#if VK_MESH_SHADING
-                                             | VK_QUERY_PIPELINE_STATISTIC_TASK_SHADER_INVOCATIONS_BIT_EXT |  // MESH SHADING
-                                             VK_QUERY_PIPELINE_STATISTIC_MESH_SHADER_INVOCATIONS_BIT_EXT
-#endif
-        ;
-
-    // compute only case
-    if (m_Type == ECommandBufferType::COMMAND_BUFFER_TYPE_COMPUTE)
-        queryPoolCreateInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
-
-    queryPoolCreateInfo.queryCount = 1;
-    m_PipelineStatsResults.resize(VK_MESH_SHADING ? 13 : 11);
-    VK_CHECK(vkCreateQueryPool(context.GetDevice()->GetLogicalDevice(), &queryPoolCreateInfo, nullptr, &m_PipelineStatisticsQueryPool),
-             "Failed to create query pools!");
-
-    queryPoolCreateInfo.queryCount         = s_MaxTimestampQueries;
-    queryPoolCreateInfo.queryType          = VK_QUERY_TYPE_TIMESTAMP;
-    queryPoolCreateInfo.pipelineStatistics = 0;
-
-    m_TimestampResults.resize(s_MaxTimestampQueries);
-    VK_CHECK(vkCreateQueryPool(context.GetDevice()->GetLogicalDevice(), &queryPoolCreateInfo, nullptr, &m_TimestampQueryPool),
-             "Failed to create query pools!");
 }
 
 void VulkanCommandBuffer::BeginRecording(bool bOneTimeSubmit, const void* inheritanceInfo)
 {
+    if (m_bIsSubmitPending) WaitForSubmit();
+
     VkCommandBufferBeginInfo commandBufferBeginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 
     if (m_Level == ECommandBufferLevel::COMMAND_BUFFER_LEVEL_SECONDARY)
@@ -91,14 +67,41 @@ void VulkanCommandBuffer::BeginRecording(bool bOneTimeSubmit, const void* inheri
     commandBufferBeginInfo.pInheritanceInfo = (VkCommandBufferInheritanceInfo*)inheritanceInfo;
     VK_CHECK(vkBeginCommandBuffer(m_CommandBuffer, &commandBufferBeginInfo), "Failed to begin command buffer recording!");
 
-    m_TimestampIndex = 0;
+    m_BoundPipeline = nullptr;
+}
+
+void VulkanCommandBuffer::ExecuteCommands(const std::vector<Ref<CommandBuffer>>& secondaryCommandBuffers)
+{
+    GNT_ASSERT(m_Level == ECommandBufferLevel::COMMAND_BUFFER_LEVEL_PRIMARY, "Only primary command buffers can execute secondary ones!");
+    if (secondaryCommandBuffers.empty()) return;
+
+    std::vector<VkCommandBuffer> commandBuffers;
+    commandBuffers.reserve(secondaryCommandBuffers.size());
+    for (const auto& secondaryCommandBuffer : secondaryCommandBuffers)
+    {
+        GNT_ASSERT(secondaryCommandBuffer->GetLevel() == ECommandBufferLevel::COMMAND_BUFFER_LEVEL_SECONDARY,
+                   "Command buffer is not secondary!");
+        commandBuffers.push_back(std::static_pointer_cast<VulkanCommandBuffer>(secondaryCommandBuffer)->Get());
+    }
+
+    vkCmdExecuteCommands(m_CommandBuffer, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+
+    // Secondary command buffers leave pipeline state undefined.
+    m_BoundPipeline = nullptr;
 }
 
 void VulkanCommandBuffer::Submit(bool bWaitAfterSubmit)
 {
-    VkSubmitInfo submitInfo       = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers    = &m_CommandBuffer;
+    GNT_ASSERT(m_WaitSemaphores.size() == m_WaitStageMasks.size(), "Each wait semaphore should have its stage mask!");
+
+    VkSubmitInfo submitInfo         = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount   = 1;
+    submitInfo.pCommandBuffers      = &m_CommandBuffer;
+    submitInfo.waitSemaphoreCount   = static_cast<uint32_t>(m_WaitSemaphores.size());
+    submitInfo.pWaitSemaphores      = m_WaitSemaphores.data();
+    submitInfo.pWaitDstStageMask    = m_WaitStageMasks.data();
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(m_SignalSemaphores.size());
+    submitInfo.pSignalSemaphores    = m_SignalSemaphores.data();
 
     auto& context = (VulkanContext&)VulkanContext::Get();
     VkQueue queue = VK_NULL_HANDLE;
@@ -123,101 +126,39 @@ void VulkanCommandBuffer::Submit(bool bWaitAfterSubmit)
 
     VK_CHECK(vkQueueSubmit(queue, 1, &submitInfo, m_SubmitFence), "Failed to submit command buffer!");
 
-    if (bWaitAfterSubmit)
-    {
-        VK_CHECK(vkWaitForFences(context.GetDevice()->GetLogicalDevice(), 1, &m_SubmitFence, VK_TRUE, UINT64_MAX),
-                 "Failed to wait for fence!");
-        VK_CHECK(vkResetFences(context.GetDevice()->GetLogicalDevice(), 1, &m_SubmitFence), "Failed to reset fence!");
-    }
-
-    // A note on the flags used:
-    //	VK_QUERY_RESULT_64_BIT: Results will have 64 bits. As time stamp values are on nano-seconds, this flag should always be used to
-    // avoid 32 bit overflows
-    //  VK_QUERY_RESULT_WAIT_BIT: Since we want to immediately display the results, we use this flag to have the CPU wait until the
-    //  results are available (it stalls my cpu)
-    {
-        vkGetQueryPoolResults(context.GetDevice()->GetLogicalDevice(), m_PipelineStatisticsQueryPool, 0, 1,
-                              m_PipelineStatsResults.size() * sizeof(m_PipelineStatsResults[0]), m_PipelineStatsResults.data(),
-                              sizeof(m_PipelineStatsResults[0]), VK_QUERY_RESULT_64_BIT);
+    m_WaitSemaphores.clear();
+    m_WaitStageMasks.clear();
+    m_SignalSemaphores.clear();
 
-        vkGetQueryPoolResults(context.GetDevice()->GetLogicalDevice(), m_TimestampQueryPool, 0, s_MaxTimestampQueries,
-                              m_TimestampResults.size() * sizeof(m_TimestampResults[0]), m_TimestampResults.data(),
-                              sizeof(m_TimestampResults[0]), VK_QUERY_RESULT_64_BIT);
-    }
+    m_bIsSubmitPending = true;
+    if (bWaitAfterSubmit) WaitForSubmit();
 }
 
-const std::vector<std::string> VulkanCommandBuffer::GetPipelineStatisticsStrings() const
+void VulkanCommandBuffer::WaitForSubmit()
 {
-    const std::vector<std::string> pipelineStatisticsStrings = {
-        "Input assembly vertex count         ",
-        "Input assembly primitives count     ",
-        "Vertex shader invocations           ",
-        "Geometry Shader Invocations         ",
-        "Geometry Shader Primitives          ",
-        "Clipping stage primitives processed ",
-        "Clipping stage primitives output    ",
-        "Fragment shader invocations         ",
-        "Tess. control shader patches        ",
-        "Tess. eval. shader invocations      ",
-        "Compute shader invocations          ",
-#if VK_MESH_SHADING
-        "Task shader invocations             ",
-        "Mesh shader invocations             ",
-#endif
-    };
-
-    return pipelineStatisticsStrings;
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    VK_CHECK(vkWaitForFences(context.GetDevice()->GetLogicalDevice(), 1, &m_SubmitFence, VK_TRUE, UINT64_MAX), "Failed to wait for fence!");
+    VK_CHECK(vkResetFences(context.GetDevice()->GetLogicalDevice(), 1, &m_SubmitFence), "Failed to reset fence!");
+    m_bIsSubmitPending = false;
 }
 
 void VulkanCommandBuffer::Destroy()
 {
     if (!m_CommandBuffer) return;
+    if (m_bIsSubmitPending) WaitForSubmit();
 
     auto& context = (VulkanContext&)VulkanContext::Get();
 
-    context.GetDevice()->FreeCommandBuffer(m_CommandBuffer, m_Type);
+    if (m_CommandPool)
+        vkFreeCommandBuffers(context.GetDevice()->GetLogicalDevice(), m_CommandPool, 1, &m_CommandBuffer);
+    else
+        context.GetDevice()->FreeCommandBuffer(m_CommandBuffer, m_Type);
 
     vkDestroyFence(context.GetDevice()->GetLogicalDevice(), m_SubmitFence, VK_NULL_HANDLE);
-    vkDestroyQueryPool(context.GetDevice()->GetLogicalDevice(), m_TimestampQueryPool, VK_NULL_HANDLE);
-    vkDestroyQueryPool(context.GetDevice()->GetLogicalDevice(), m_PipelineStatisticsQueryPool, VK_NULL_HANDLE);
 
     m_CommandBuffer = nullptr;
 }
 
-void VulkanCommandBuffer::BeginTimestamp(bool bStatisticsQuery)
-{
-    if (bStatisticsQuery)
-    {
-        vkCmdResetQueryPool(m_CommandBuffer, m_PipelineStatisticsQueryPool, 0, 1);
-        vkCmdBeginQuery(m_CommandBuffer, m_PipelineStatisticsQueryPool, 0, 0);
-        return;
-    }
-
-    if (m_TimestampIndex == 0)
-    {
-        vkCmdResetQueryPool(m_CommandBuffer, m_TimestampQueryPool, 0, static_cast<uint32_t>(m_TimestampResults.size()));
-    }
-
-    vkCmdWriteTimestamp(m_CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_TimestampQueryPool, m_TimestampIndex);
-
-    if (m_TimestampIndex + 1 > s_MaxTimestampQueries) GNT_ASSERT(false);
-    ++m_TimestampIndex;
-}
-
-void VulkanCommandBuffer::EndTimestamp(bool bStatisticsQuery)
-{
-    if (bStatisticsQuery)
-    {
-        vkCmdEndQuery(m_CommandBuffer, m_PipelineStatisticsQueryPool, 0);
-        return;
-    }
-
-    vkCmdWriteTimestamp(m_CommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampQueryPool, m_TimestampIndex);
-
-    if (m_TimestampIndex + 1 > s_MaxTimestampQueries) GNT_ASSERT(false);
-    ++m_TimestampIndex;
-}
-
 void VulkanCommandBuffer::BeginDebugLabel(const char* commandBufferLabelName, const glm::vec4& labelColor) const
 {
     if (!s_bEnableValidationLayers && !VK_FORCE_VALIDATION) return;
@@ -248,7 +189,7 @@ void VulkanCommandBuffer::BindDescriptorSets(Ref<VulkanPipeline>& pipeline, cons
                             dynamicOffsetCount, dynamicOffsets);
 }
 
-void VulkanCommandBuffer::BindPipeline(Ref<VulkanPipeline>& pipeline) const
+void VulkanCommandBuffer::BindPipeline(Ref<VulkanPipeline>& pipeline)
 {
     auto& context         = (VulkanContext&)VulkanContext::Get();
     const auto& swapchain = context.GetSwapchain();
@@ -266,11 +207,14 @@ void VulkanCommandBuffer::BindPipeline(Ref<VulkanPipeline>& pipeline) const
     VkRect2D scissor = {{0, 0}, swapchain->GetImageExtent()};
     if (auto& targetFramebuffer = pipeline->GetSpecification().TargetFramebuffer[context.GetCurrentFrameIndex()])
     {
-        scissor.extent = VkExtent2D{targetFramebuffer->GetWidth(), targetFramebuffer->GetHeight()};
-
-        viewport.y      = static_cast<float>(scissor.extent.height);
-        viewport.width  = static_cast<float>(scissor.extent.width);
-        viewport.height = -static_cast<float>(scissor.extent.height);
+        const auto& renderArea = targetFramebuffer->GetRenderArea();
+        scissor.offset         = VkOffset2D{static_cast<int32_t>(renderArea.x), static_cast<int32_t>(renderArea.y)};
+        scissor.extent         = VkExtent2D{renderArea.z, renderArea.w};
+
+        viewport.x      = static_cast<float>(renderArea.x);
+        viewport.y      = static_cast<float>(renderArea.y + renderArea.w);
+        viewport.width  = static_cast<float>(renderArea.z);
+        viewport.height = -static_cast<float>(renderArea.w);
     }
 
     if (pipeline->GetSpecification().bDynamicPolygonMode && !RENDERDOC_DEBUG)
@@ -285,6 +229,7 @@ void VulkanCommandBuffer::BindPipeline(Ref<VulkanPipeline>& pipeline) const
     }
 
     vkCmdBindPipeline(m_CommandBuffer, pipelineBindPoint, pipeline->Get());
+    m_BoundPipeline = pipeline.get();
 
     if (pipelineBindPoint != VK_PIPELINE_BIND_POINT_COMPUTE)
     {
@@ -295,7 +240,8 @@ void VulkanCommandBuffer::BindPipeline(Ref<VulkanPipeline>& pipeline) const
 
 void VulkanCommandBuffer::SetPipelinePolygonMode(Ref<VulkanPipeline>& pipeline, const EPolygonMode polygonMode) const
 {
-    pipeline->GetSpecification().PolygonMode = polygonMode;
+    // Pipelines are shared by threads that record secondary command buffers, so they only read it unless it changes.
+    if (pipeline->GetSpecification().PolygonMode != polygonMode) pipeline->GetSpecification().PolygonMode = polygonMode;
 }
 
 }  // namespace Gauntlet
\ No newline at end of file
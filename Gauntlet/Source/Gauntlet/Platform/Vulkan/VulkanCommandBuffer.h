@@ -8,12 +8,15 @@
 namespace Gauntlet
 {
 
+class Pipeline;
 class VulkanPipeline;
 
 class VulkanCommandBuffer final : public CommandBuffer
 {
   public:
-    VulkanCommandBuffer(ECommandBufferType type, ECommandBufferLevel level = ECommandBufferLevel::COMMAND_BUFFER_LEVEL_PRIMARY);
+    // Command buffers without explicit pool are allocated from device's pool of their type.
+    VulkanCommandBuffer(ECommandBufferType type, ECommandBufferLevel level = ECommandBufferLevel::COMMAND_BUFFER_LEVEL_PRIMARY,
+                        VkCommandPool commandPool = VK_NULL_HANDLE);
     VulkanCommandBuffer() = delete;
     ~VulkanCommandBuffer() { Destroy(); }
 
@@ -22,16 +25,9 @@ class VulkanCommandBuffer final : public CommandBuffer
 
     FORCEINLINE ECommandBufferLevel GetLevel() const final override { return m_Level; }
 
-    FORCEINLINE const std::vector<size_t>& GetTimestampResults() const final override { return m_TimestampResults; }
-    FORCEINLINE const std::vector<size_t>& GetPipelineStatisticsResults() const final override { return m_PipelineStatsResults; }
-    const std::vector<std::string> GetPipelineStatisticsStrings() const final override;
-
     FORCEINLINE void Reset() final override { VK_CHECK(vkResetCommandBuffer(m_CommandBuffer, 0), "Failed to reset command buffer!"); }
     void Destroy() final override;
 
-    void BeginTimestamp(bool bStatisticsQuery = false) final override;
-    void EndTimestamp(bool bStatisticsQuery = false) final override;
-
     void BeginDebugLabel(const char* commandBufferLabelName, const glm::vec4& labelColor) const final override;
     FORCEINLINE void EndDebugLabel() const final override
     {
@@ -45,8 +41,19 @@ class VulkanCommandBuffer final : public CommandBuffer
         VK_CHECK(vkEndCommandBuffer(m_CommandBuffer), "Failed to end recording command buffer");
     }
 
+    void ExecuteCommands(const std::vector<Ref<CommandBuffer>>& secondaryCommandBuffers) final override;
+
+    // Non-waiting submit defers fence wait to the next BeginRecording().
     void Submit(bool bWaitAfterSubmit = true) final override;
 
+    // GPU-GPU synchronization for the next Submit(), e.g. between async compute && graphics queues.
+    FORCEINLINE void AddWaitSemaphore(const VkSemaphore& semaphore, const VkPipelineStageFlags waitStageMask)
+    {
+        m_WaitSemaphores.push_back(semaphore);
+        m_WaitStageMasks.push_back(waitStageMask);
+    }
+    FORCEINLINE void AddSignalSemaphore(const VkSemaphore& semaphore) { m_SignalSemaphores.push_back(semaphore); }
+
     FORCEINLINE void InsertBarrier(const VkPipelineStageFlags srcStageMask, const VkPipelineStageFlags dstStageMask,
                                    const VkDependencyFlags dependencyFlags, const uint32_t memoryBarrierCount,
                                    const VkMemoryBarrier* pMemoryBarriers, const uint32_t bufferMemoryBarrierCount,
@@ -67,7 +74,9 @@ class VulkanCommandBuffer final : public CommandBuffer
                             VkDescriptorSet* descriptorSets = VK_NULL_HANDLE, const uint32_t dynamicOffsetCount = 0,
                             uint32_t* dynamicOffsets = nullptr) const;
 
-    void BindPipeline(Ref<VulkanPipeline>& pipeline) const;
+    // Pipelines are tracked per command buffer, so secondary command buffers recorded on different threads don't share the state.
+    FORCEINLINE bool IsPipelineBound(const Ref<Pipeline>& pipeline) const { return m_BoundPipeline == pipeline.get(); }
+    void BindPipeline(Ref<VulkanPipeline>& pipeline);
     void SetPipelinePolygonMode(Ref<VulkanPipeline>& pipeline,
                                 const EPolygonMode polygonMode) const;  // Invoke before binding actual pipeline
 
@@ -88,6 +97,12 @@ class VulkanCommandBuffer final : public CommandBuffer
         vkCmdDrawIndexedIndirect(m_CommandBuffer, buffer, offset, drawCount, stride);
     }
 
+    FORCEINLINE void DrawIndirect(const VkBuffer& buffer, const VkDeviceSize offset, const uint32_t drawCount = 1,
+                                  const uint32_t stride = sizeof(VkDrawIndirectCommand))
+    {
+        vkCmdDrawIndirect(m_CommandBuffer, buffer, offset, drawCount, stride);
+    }
+
     FORCEINLINE void BindVertexBuffers(const uint32_t firstBinding = 0, const uint32_t bindingCount = 1, VkBuffer* buffers = VK_NULL_HANDLE,
                                        VkDeviceSize* offsets = VK_NULL_HANDLE) const
     {
@@ -100,6 +115,11 @@ class VulkanCommandBuffer final : public CommandBuffer
         vkCmdDispatch(m_CommandBuffer, groupCountX, groupCountY, groupCountZ);
     }
 
+    FORCEINLINE void DispatchIndirect(const VkBuffer& buffer, const VkDeviceSize offset)
+    {
+        vkCmdDispatchIndirect(m_CommandBuffer, buffer, offset);
+    }
+
     FORCEINLINE
     void BindIndexBuffer(const VkBuffer& buffer, const VkDeviceSize offset = 0, VkIndexType indexType = VK_INDEX_TYPE_UINT32) const
     {
@@ -147,18 +167,19 @@ class VulkanCommandBuffer final : public CommandBuffer
 
   private:
     VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+    VkCommandPool m_CommandPool     = VK_NULL_HANDLE;  // Null if allocated from device's pool.
     ECommandBufferLevel m_Level     = ECommandBufferLevel::COMMAND_BUFFER_LEVEL_PRIMARY;
     ECommandBufferType m_Type       = ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS;
     VkFence m_SubmitFence           = VK_NULL_HANDLE;
+    bool m_bIsSubmitPending         = false;
+    const Pipeline* m_BoundPipeline = nullptr;
 
-    VkQueryPool m_TimestampQueryPool = VK_NULL_HANDLE;
-    std::vector<size_t> m_TimestampResults;
-
-    VkQueryPool m_PipelineStatisticsQueryPool = VK_NULL_HANDLE;
-    std::vector<size_t> m_PipelineStatsResults;
+    std::vector<VkSemaphore> m_WaitSemaphores;
+    std::vector<VkPipelineStageFlags> m_WaitStageMasks;
+    std::vector<VkSemaphore> m_SignalSemaphores;
 
-    uint32_t m_TimestampIndex = 0;
-    void CreateSyncResourcesAndQueries();
+    void CreateSyncResources();
+    void WaitForSubmit();
 };
 
 }  // namespace Gauntlet
\ No newline at end of file
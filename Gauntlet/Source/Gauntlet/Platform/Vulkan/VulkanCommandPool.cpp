@@ -0,0 +1,62 @@
+#include "GauntletPCH.h"
+#include "VulkanCommandPool.h"
+
+#include "VulkanContext.h"
+#include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+
+namespace Gauntlet
+{
+
+VulkanCommandPool::VulkanCommandPool(ECommandBufferType type) : m_Type(type)
+{
+    auto& context             = (VulkanContext&)VulkanContext::Get();
+    const auto& queueFamilies = context.GetDevice()->GetQueueFamilyIndices();
+    uint32_t queueFamilyIndex = queueFamilies.GraphicsFamily;
+    switch (m_Type)
+    {
+        case ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS: queueFamilyIndex = queueFamilies.GraphicsFamily; break;
+        case ECommandBufferType::COMMAND_BUFFER_TYPE_COMPUTE: queueFamilyIndex = queueFamilies.ComputeFamily; break;
+        case ECommandBufferType::COMMAND_BUFFER_TYPE_TRANSFER: queueFamilyIndex = queueFamilies.TransferFamily; break;
+    }
+
+    // Command buffers are never reset one by one, the whole pool is reset at once which is cheaper.
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    commandPoolCreateInfo.flags                   = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    commandPoolCreateInfo.queueFamilyIndex        = queueFamilyIndex;
+    VK_CHECK(vkCreateCommandPool(context.GetDevice()->GetLogicalDevice(), &commandPoolCreateInfo, VK_NULL_HANDLE, &m_CommandPool),
+             "Failed to create command pool!");
+}
+
+const Ref<CommandBuffer>& VulkanCommandPool::AcquireSecondaryCommandBuffer()
+{
+    if (m_AcquiredSecondaryCount == m_SecondaryCommandBuffers.size())
+        m_SecondaryCommandBuffers.emplace_back(
+            MakeRef<VulkanCommandBuffer>(m_Type, ECommandBufferLevel::COMMAND_BUFFER_LEVEL_SECONDARY, m_CommandPool));
+
+    return m_SecondaryCommandBuffers[m_AcquiredSecondaryCount++];
+}
+
+void VulkanCommandPool::Reset()
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    VK_CHECK(vkResetCommandPool(context.GetDevice()->GetLogicalDevice(), m_CommandPool, 0), "Failed to reset command pool!");
+
+    m_AcquiredSecondaryCount = 0;
+}
+
+void VulkanCommandPool::Destroy()
+{
+    if (!m_CommandPool) return;
+
+    // Command buffers are freed back into the pool, so they go first.
+    for (auto& commandBuffer : m_SecondaryCommandBuffers)
+        commandBuffer->Destroy();
+    m_SecondaryCommandBuffers.clear();
+
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    vkDestroyCommandPool(context.GetDevice()->GetLogicalDevice(), m_CommandPool, VK_NULL_HANDLE);
+    m_CommandPool = VK_NULL_HANDLE;
+}
+
+}  // namespace Gauntlet
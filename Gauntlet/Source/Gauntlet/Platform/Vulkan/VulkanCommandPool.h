@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Gauntlet/Renderer/CommandPool.h"
+
+#include <volk/volk.h>
+
+namespace Gauntlet
+{
+
+class VulkanCommandBuffer;
+
+class VulkanCommandPool final : public CommandPool
+{
+  public:
+    VulkanCommandPool(ECommandBufferType type);
+    VulkanCommandPool() = delete;
+    ~VulkanCommandPool() { Destroy(); }
+
+    FORCEINLINE const auto& Get() const { return m_CommandPool; }
+
+    const Ref<CommandBuffer>& AcquireSecondaryCommandBuffer() final override;
+
+    void Reset() final override;
+    void Destroy() final override;
+
+  private:
+    VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+    ECommandBufferType m_Type   = ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS;
+
+    std::vector<Ref<CommandBuffer>> m_SecondaryCommandBuffers;
+    uint32_t m_AcquiredSecondaryCount = 0;
+};
+
+}  // namespace Gauntlet
@@ -10,27 +10,39 @@
 
 #include "Gauntlet/Core/Application.h"
 #include "Gauntlet/Core/Window.h"
+#include "Gauntlet/Core/Profiler.h"
 #include <GLFW/glfw3.h>
 
 namespace Gauntlet
 {
 
+static constexpr uint64_t s_PresentWaitTimeout = 100 * 1000 * 1000;  // (ns) Frame isn't delayed further if presentation takes longer.
+static constexpr double s_LatencySleepMargin   = 0.001;              // (s) Absorbs CPU time jitter && OS sleep granularity.
+
+static double SmoothLatencyTime(const double smoothed, const double sample)
+{
+    return smoothed == 0.0 ? sample : glm::mix(smoothed, sample, 0.1);
+}
+
 VulkanContext::VulkanContext(Scoped<Window>& window) : GraphicsContext(window)
 {
     GNT_ASSERT(!s_Context, "Graphics context already initialized!");
-    s_Context = this;
+    s_Context     = this;
+    m_bIsHeadless = Application::Get().GetSpecification().bHeadless;
 
     CreateInstance();
     CreateDebugMessenger();
-    CreateSurface();
+    if (!m_bIsHeadless) CreateSurface();
 
     m_Device                             = MakeScoped<VulkanDevice>(m_Instance, m_Surface);
     Renderer::GetStats().RenderingDevice = m_Device->GetGPUProperties().deviceName;
 
+    // Headless swapchain allocates its offscreen images, so allocator goes first.
+    m_Allocator = MakeScoped<VulkanAllocator>(m_Instance, m_Device);
+
     m_Swapchain = MakeScoped<VulkanSwapchain>(m_Device, m_Surface);
     CreateSyncObjects();
 
-    m_Allocator           = MakeScoped<VulkanAllocator>(m_Instance, m_Device);
     m_DescriptorAllocator = MakeScoped<VulkanDescriptorAllocator>(m_Device);
 }
 
@@ -148,6 +160,9 @@ bool VulkanContext::CheckVulkanAPISupport() const
     }
 #endif
 
+    // GLFW isn't initialized without a window, there's no surface to create anyway.
+    if (m_bIsHeadless) return true;
+
     uint32_t glfwExtensionCount = 0;
     const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
     GNT_ASSERT(glfwExtensionCount != 0, "glfwExtensions are empty!");
@@ -230,11 +245,15 @@ bool VulkanContext::CheckValidationLayerSupport()
 
 const std::vector<const char*> VulkanContext::GetRequiredExtensions()
 {
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-    GNT_ASSERT(glfwExtensionCount != 0, "Failed to retrieve glfwExtensions");
+    std::vector<const char*> Extensions;
+    if (!m_bIsHeadless)
+    {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        GNT_ASSERT(glfwExtensionCount != 0, "Failed to retrieve glfwExtensions");
 
-    std::vector<const char*> Extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        Extensions.insert(Extensions.end(), glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
 
     if (s_bEnableValidationLayers || VK_FORCE_VALIDATION)
     {
@@ -253,11 +272,11 @@ void VulkanContext::CreateSyncObjects()
     FenceCreateInfo.sType             = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     FenceCreateInfo.flags             = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    m_InFlightFences.resize(FRAMES_IN_FLIGHT);
-    m_RenderFinishedSemaphores.resize(FRAMES_IN_FLIGHT);
-    m_ImageAcquiredSemaphores.resize(FRAMES_IN_FLIGHT);
+    m_InFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    m_RenderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
+    m_ImageAcquiredSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
 
-    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; ++i)
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
     {
         vkCreateFence(m_Device->GetLogicalDevice(), &FenceCreateInfo, nullptr, &m_InFlightFences[i]);
         vkCreateSemaphore(m_Device->GetLogicalDevice(), &SemaphoreCreateInfo, nullptr, &m_RenderFinishedSemaphores[i]);
@@ -267,6 +286,10 @@ void VulkanContext::CreateSyncObjects()
 
 void VulkanContext::BeginRender()
 {
+    GNT_PROFILE_FUNCTION();
+
+    ApplyFrameSettings();
+
     m_CurrentCommandBuffer = m_Swapchain->GetCommandBuffers()[m_Swapchain->GetCurrentFrameIndex()];
     GNT_ASSERT(m_CurrentCommandBuffer.lock(), "Failed to retrieve graphics command buffer!");
 
@@ -289,6 +312,14 @@ void VulkanContext::BeginRender()
 
 void VulkanContext::EndRender()
 {
+    GNT_PROFILE_FUNCTION();
+
+    if (m_bIsHeadless)
+    {
+        EndRenderHeadless();
+        return;
+    }
+
     // As far as I understand this stage doesn't block vertex shader, fragment shaders, but only blocks outputting color to the framebuffer
     // Combining this stage with wait semaphore we make sure to not apply new color until we acquired swapchain image
     std::vector<VkPipelineStageFlags> WaitStages{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
@@ -310,24 +341,113 @@ void VulkanContext::EndRender()
     submitInfo.pSignalSemaphores =
         &m_RenderFinishedSemaphores[m_Swapchain->GetCurrentFrameIndex()];  // Signal semaphore when render finished
 
+    m_SubmitTime = Timer::Now();
+
     // InFlightFence will now block until the graphic commands finish execution
-    VK_CHECK(vkQueueSubmit(m_Device->GetGraphicsQueue(), 1, &submitInfo, m_InFlightFences[m_Swapchain->GetCurrentFrameIndex()]),
-             "Failed to submit command buffes to the queue.");
+    {
+        // Streaming threads may upload resources at the same time, queues must be externally synchronized.
+        GRAPHICS_GUARD_LOCK;
+        VK_CHECK(vkQueueSubmit(m_Device->GetGraphicsQueue(), 1, &submitInfo, m_InFlightFences[m_Swapchain->GetCurrentFrameIndex()]),
+                 "Failed to submit command buffes to the queue.");
+    }
+
+    Renderer::GetStats().GPUWaitTime = static_cast<float>(Timer::Now() - m_LastGPUWaitTime);
+}
+
+// There's no UI to record the swapchain pass && no image to wait for or present, frame's fence is the only sync.
+void VulkanContext::EndRenderHeadless()
+{
+    auto commandBuffer = m_CurrentCommandBuffer.lock();
+    GNT_ASSERT(commandBuffer, "Failed to submit general command buffer!");
+
+    commandBuffer->BeginRecording();
+    m_Swapchain->BeginRenderPass(commandBuffer->Get());
+    m_Swapchain->EndRenderPass(commandBuffer->Get());
+    commandBuffer->EndRecording();
+
+    VkSubmitInfo submitInfo       = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers    = &commandBuffer->Get();
+    {
+        GRAPHICS_GUARD_LOCK;
+        VK_CHECK(vkQueueSubmit(m_Device->GetGraphicsQueue(), 1, &submitInfo, m_InFlightFences[m_Swapchain->GetCurrentFrameIndex()]),
+                 "Failed to submit command buffes to the queue.");
+    }
 
     Renderer::GetStats().GPUWaitTime = static_cast<float>(Timer::Now() - m_LastGPUWaitTime);
 }
 
 void VulkanContext::SwapBuffers()
 {
-    m_Swapchain->PresentImage(m_RenderFinishedSemaphores[m_Swapchain->GetCurrentFrameIndex()]);
+    const uint32_t frameIndex = m_Swapchain->GetCurrentFrameIndex();
+    m_Swapchain->PresentImage(m_RenderFinishedSemaphores[frameIndex]);
+
+    if (Renderer::GetSettings().LowLatency && !m_bIsHeadless)
+        WaitForLowLatency(frameIndex);
+    else
+        Renderer::GetStats().LatencyWait = 0.0f;
+
+    m_FrameWorkBegin = Timer::Now();
 }
 
-void VulkanContext::SetVSync(bool bIsVSync)
+/*
+ * Waiting for the frame's fence leaves one frame in flight && measures its GPU time, since GPU was idle when it was submitted.
+ * With VSync the next frame is also delayed until its CPU && GPU work would finish right before the vblank following the
+ * presentation of this one, so input is sampled as late as possible instead of frames queueing up.
+ */
+void VulkanContext::WaitForLowLatency(const uint32_t frameIndex)
 {
-    WaitDeviceOnFinish();
+    GNT_PROFILE_FUNCTION();
+
+    const double waitBegin = Timer::Now();
+    VK_CHECK(vkWaitForFences(m_Device->GetLogicalDevice(), 1, &m_InFlightFences[frameIndex], VK_TRUE, UINT64_MAX),
+             "Failed to wait for fences!");
+
+    const double gpuEnd = Timer::Now();
+    m_LatencyGPUTime    = SmoothLatencyTime(m_LatencyGPUTime, gpuEnd - m_SubmitTime);
+    m_LatencyCPUTime    = SmoothLatencyTime(m_LatencyCPUTime, m_SubmitTime - m_FrameWorkBegin);
+
+    if (m_Window->IsVSync() && m_Swapchain->WaitForPresent(m_Swapchain->GetLastPresentID(), s_PresentWaitTimeout))
+    {
+        GLFWmonitor* monitor       = glfwGetPrimaryMonitor();
+        const GLFWvidmode* vidMode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+        const double refreshRate   = vidMode && vidMode->refreshRate > 0 ? static_cast<double>(vidMode->refreshRate) : 60.0;
+        const double sleepTime     = 1.0 / refreshRate - m_LatencyCPUTime - m_LatencyGPUTime - s_LatencySleepMargin;
+        if (sleepTime > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
+    }
 
+    Renderer::GetStats().LatencyWait = static_cast<float>(Timer::Now() - waitBegin);
+}
+
+// Frames in flight change reindexes per frame resources, so unlike present mode changes it still needs the device to be idle.
+void VulkanContext::ApplyFrameSettings()
+{
+    auto& settings          = Renderer::GetSettings();
+    settings.FramesInFlight = std::clamp(settings.FramesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+    if (settings.FramesInFlight != m_Swapchain->GetFramesInFlight())
+    {
+        WaitDeviceOnFinish();
+        m_Swapchain->SetFramesInFlight(settings.FramesInFlight);
+        LOG_INFO("Frames in flight set to: %u", settings.FramesInFlight);
+    }
+
+    if (m_bIsHeadless) return;
+
+    // Window only stores it, swapchain is recreated here, before the image is acquired.
+    if (settings.VSync != m_Window->IsVSync())
+    {
+        m_Window->SetVSync(settings.VSync);
+        SetVSync(settings.VSync);
+    }
+    else if (settings.PresentMode != m_Swapchain->GetPresentModeSetting())
+        m_Swapchain->Invalidate(true);
+}
+
+// Nothing is acquired at this point, so old swapchain is retired instead of waiting for the device to finish.
+void VulkanContext::SetVSync(bool bIsVSync)
+{
     float SwapchainRecreationStartTime = static_cast<float>(Timer::Now());
-    m_Swapchain->Invalidate();
+    m_Swapchain->Invalidate(true);
     float SwapchainRecreationEndTime = static_cast<float>(Timer::Now());
     LOG_INFO("Time took to set vsync(invalidate swapchain): (%0.2f)ms",
              (SwapchainRecreationEndTime - SwapchainRecreationStartTime) * 1000.0f);
@@ -338,7 +458,7 @@ void VulkanContext::Destroy()
     WaitDeviceOnFinish();
 
     m_DescriptorAllocator->Destroy();
-    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; ++i)
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
     {
         vkDestroyFence(m_Device->GetLogicalDevice(), m_InFlightFences[i], nullptr);
         vkDestroySemaphore(m_Device->GetLogicalDevice(), m_RenderFinishedSemaphores[i], nullptr);
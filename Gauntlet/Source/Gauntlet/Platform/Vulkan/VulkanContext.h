@@ -47,6 +47,8 @@ class VulkanContext final : public GraphicsContext
     FORCEINLINE const auto& GetAllocator() const { return m_Allocator; }
     FORCEINLINE auto& GetAllocator() { return m_Allocator; }
 
+    FORCEINLINE bool IsHeadless() const { return m_bIsHeadless; }
+
     FORCEINLINE const auto& GetDescriptorAllocator() const { return m_DescriptorAllocator; }
     FORCEINLINE auto& GetDescriptorAllocator() { return m_DescriptorAllocator; }
 
@@ -56,7 +58,8 @@ class VulkanContext final : public GraphicsContext
   private:
     VkInstance m_Instance                     = VK_NULL_HANDLE;
     VkDebugUtilsMessengerEXT m_DebugMessenger = VK_NULL_HANDLE;
-    VkSurfaceKHR m_Surface                    = VK_NULL_HANDLE;
+    VkSurfaceKHR m_Surface                    = VK_NULL_HANDLE;  // Stays null in headless mode.
+    bool m_bIsHeadless                        = false;
 
     Scoped<VulkanDevice> m_Device                           = nullptr;
     Scoped<VulkanAllocator> m_Allocator                     = nullptr;
@@ -71,12 +74,22 @@ class VulkanContext final : public GraphicsContext
     std::vector<VkFence> m_InFlightFences;
     float m_LastGPUWaitTime = 0.0f;
 
+    // Low latency mode, (s) smoothed over frames.
+    double m_FrameWorkBegin = 0.0;  // After the low latency wait, input is sampled right after.
+    double m_SubmitTime     = 0.0;
+    double m_LatencyCPUTime = 0.0;
+    double m_LatencyGPUTime = 0.0;
+
     Weak<VulkanCommandBuffer> m_CurrentCommandBuffer;
 
     void CreateInstance();
     void CreateDebugMessenger();
     void CreateSurface();
     void CreateSyncObjects();
+    void EndRenderHeadless();
+
+    void ApplyFrameSettings();
+    void WaitForLowLatency(const uint32_t frameIndex);
 
     bool CheckVulkanAPISupport() const;
     bool CheckValidationLayerSupport();
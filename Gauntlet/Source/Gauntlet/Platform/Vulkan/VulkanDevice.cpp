@@ -42,7 +42,7 @@ static const char* GetDeviceTypeCString(VkPhysicalDeviceType deviceType)
 VulkanDevice::VulkanDevice(const VkInstance& instance, const VkSurfaceKHR& surface)
 {
     PickPhysicalDevice(instance, surface);
-    CreateLogicalDevice();
+    CreateLogicalDevice(surface);
     CreateCommandPools();
 }
 
@@ -124,7 +124,21 @@ void VulkanDevice::PickPhysicalDevice(const VkInstance& instance, const VkSurfac
              VK_API_VERSION_MINOR(m_GPUInfo.GPUProperties.apiVersion), VK_API_VERSION_PATCH(m_GPUInfo.GPUProperties.apiVersion));
 }
 
-void VulkanDevice::CreateLogicalDevice()
+static bool IsDeviceExtensionAvailable(const VkPhysicalDevice& physicalDevice, const char* extensionName)
+{
+    uint32_t ExtensionCount{0};
+    VK_CHECK(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &ExtensionCount, nullptr),
+             "Failed to retrieve number of device extensions.");
+
+    std::vector<VkExtensionProperties> AvailableExtensions(ExtensionCount);
+    VK_CHECK(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &ExtensionCount, AvailableExtensions.data()),
+             "Failed to retrieve device extensions.");
+
+    return std::find_if(AvailableExtensions.begin(), AvailableExtensions.end(), [&](const auto& ext)
+                        { return strcmp(ext.extensionName, extensionName) == 0; }) != AvailableExtensions.end();
+}
+
+void VulkanDevice::CreateLogicalDevice(const VkSurfaceKHR& surface)
 {
     const float QueuePriority = 1.0f;  // [0.0, 1.0]
 
@@ -202,17 +216,43 @@ void VulkanDevice::CreateLogicalDevice()
     ppNext  = &meshShaderFeaturesEXT.pNext;
 #endif
 
+    // Optional, low latency mode waits for presentation of the last frame when both are available.
+    auto enabledExtensions                                     = s_DeviceExtensions;
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures     = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR};
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR};
+    if (surface != VK_NULL_HANDLE && IsDeviceExtensionAvailable(m_GPUInfo.PhysicalDevice, VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        IsDeviceExtensionAvailable(m_GPUInfo.PhysicalDevice, VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+    {
+        VkPhysicalDeviceFeatures2 GPUFeatures2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+        GPUFeatures2.pNext                     = &presentIdFeatures;
+        presentIdFeatures.pNext                = &presentWaitFeatures;
+        vkGetPhysicalDeviceFeatures2(m_GPUInfo.PhysicalDevice, &GPUFeatures2);
+
+        m_GPUInfo.bIsPresentWaitSupported = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+    }
+
+    if (m_GPUInfo.bIsPresentWaitSupported)
+    {
+        enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+
+        presentIdFeatures.pNext = &presentWaitFeatures;
+        *ppNext                 = &presentIdFeatures;
+        ppNext                  = &presentWaitFeatures.pNext;
+    }
+
     // Required gpu features
-    VkPhysicalDeviceFeatures PhysicalDeviceFeatures = {};
-    PhysicalDeviceFeatures.samplerAnisotropy        = VK_TRUE;
-    PhysicalDeviceFeatures.fillModeNonSolid         = VK_TRUE;
-    PhysicalDeviceFeatures.pipelineStatisticsQuery  = VK_TRUE;
+    VkPhysicalDeviceFeatures PhysicalDeviceFeatures          = {};
+    PhysicalDeviceFeatures.samplerAnisotropy                 = VK_TRUE;
+    PhysicalDeviceFeatures.fillModeNonSolid                  = VK_TRUE;
+    PhysicalDeviceFeatures.pipelineStatisticsQuery           = VK_TRUE;
+    PhysicalDeviceFeatures.shaderStorageImageExtendedFormats = VK_TRUE;  // R8 storage images for compute SSAO.
     GNT_ASSERT(m_GPUInfo.GPUFeatures.pipelineStatisticsQuery && m_GPUInfo.GPUFeatures.fillModeNonSolid &&
-               m_GPUInfo.GPUFeatures.textureCompressionBC);
+               m_GPUInfo.GPUFeatures.textureCompressionBC && m_GPUInfo.GPUFeatures.shaderStorageImageExtendedFormats);
 
     deviceCI.pEnabledFeatures        = &PhysicalDeviceFeatures;
-    deviceCI.enabledExtensionCount   = static_cast<uint32_t>(s_DeviceExtensions.size());
-    deviceCI.ppEnabledExtensionNames = s_DeviceExtensions.data();
+    deviceCI.enabledExtensionCount   = static_cast<uint32_t>(enabledExtensions.size());
+    deviceCI.ppEnabledExtensionNames = enabledExtensions.data();
 
     {
         const auto result = vkCreateDevice(m_GPUInfo.PhysicalDevice, &deviceCI, nullptr, &m_GPUInfo.LogicalDevice);
@@ -410,11 +450,16 @@ bool VulkanDevice::IsDeviceSuitable(GPUInfo& gpuInfo, const VkSurfaceKHR& surfac
     const bool bAreDeviceExtensionsSupported = CheckDeviceExtensionSupport(gpuInfo.PhysicalDevice);
     if (!bAreDeviceExtensionsSupported) return false;
 
-    // Check if device can create swapchain
-    SwapchainSupportDetails Details = SwapchainSupportDetails::QuerySwapchainSupportDetails(gpuInfo.PhysicalDevice, surface);
-    if (Details.ImageFormats.empty() || Details.PresentModes.empty()) return false;
+    // Check if device can create swapchain, headless one renders offscreen.
+    if (surface != VK_NULL_HANDLE)
+    {
+        SwapchainSupportDetails Details = SwapchainSupportDetails::QuerySwapchainSupportDetails(gpuInfo.PhysicalDevice, surface);
+        if (Details.ImageFormats.empty() || Details.PresentModes.empty()) return false;
+    }
 
-    if (VK_PREFER_IGPU && gpuInfo.GPUProperties.deviceType != VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) return false;
+    // Headless runs should work on any ICD(e.g. lavapipe in CI), so the preference only applies to windowed ones.
+    if (VK_PREFER_IGPU && surface != VK_NULL_HANDLE && gpuInfo.GPUProperties.deviceType != VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU)
+        return false;
 
     GNT_ASSERT(gpuInfo.GPUProperties.limits.maxSamplerAnisotropy > 0, "GPU has not valid Max Sampler Anisotropy!");
     return gpuInfo.GPUFeatures.samplerAnisotropy && gpuInfo.GPUFeatures.geometryShader;
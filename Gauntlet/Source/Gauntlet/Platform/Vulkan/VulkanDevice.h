@@ -49,7 +49,10 @@ struct QueueFamilyIndices
                 Indices.TransferFamily = i;
             }
 
-            if (Indices.GraphicsFamily == i)
+            // Nothing is presented without surface(headless), graphics queue stands in for present one.
+            if (Indices.GraphicsFamily == i && surface == VK_NULL_HANDLE)
+                Indices.PresentFamily = i;
+            else if (Indices.GraphicsFamily == i)
             {
                 VkBool32 bPresentSupport{VK_FALSE};
                 {
@@ -102,6 +105,7 @@ struct QueueFamilyIndices
             }
 
             VkBool32 bPresentSupport{VK_FALSE};
+            if (surface != VK_NULL_HANDLE)
             {
                 const auto result = vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &bPresentSupport);
                 GNT_ASSERT(result == VK_SUCCESS, "Failed to check if current GPU supports image presenting.");
@@ -197,6 +201,7 @@ class VulkanDevice final : private Uncopyable, private Unmovable
     FORCEINLINE const auto& GetMemoryProperties() const { return m_GPUInfo.GPUMemoryProperties; }
     FORCEINLINE const auto& GetGPUProperties() const { return m_GPUInfo.GPUProperties; }
     FORCEINLINE const auto& GetGPUFeatures() const { return m_GPUInfo.GPUFeatures; }
+    FORCEINLINE bool IsPresentWaitSupported() const { return m_GPUInfo.bIsPresentWaitSupported; }
 
     void AllocateCommandBuffer(VkCommandBuffer& inOutCommandBuffer, ECommandBufferType type, VkCommandBufferLevel level);
     void FreeCommandBuffer(const VkCommandBuffer& commandBuffer, ECommandBufferType type);
@@ -242,10 +247,12 @@ class VulkanDevice final : private Uncopyable, private Unmovable
             VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
 
         VkPhysicalDeviceMeshShaderPropertiesEXT MSProperties = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_PROPERTIES_EXT};
+
+        bool bIsPresentWaitSupported = false;  // VK_KHR_present_id && VK_KHR_present_wait enabled.
     } m_GPUInfo;
 
     void PickPhysicalDevice(const VkInstance& instance, const VkSurfaceKHR& surface);
-    void CreateLogicalDevice();
+    void CreateLogicalDevice(const VkSurfaceKHR& surface);
     void CreateCommandPools();
 
     uint32_t RateDeviceSuitability(GPUInfo& gpuInfo, const VkSurfaceKHR& surface);
@@ -7,6 +7,7 @@
 #include "VulkanImage.h"
 #include "VulkanDevice.h"
 #include "VulkanCommandBuffer.h"
+#include "VulkanGPUQueryRing.h"
 
 #include "Gauntlet/Core/Application.h"
 #include "Gauntlet/Core/Window.h"
@@ -61,6 +62,9 @@ void VulkanFramebuffer::Invalidate()
     if (!m_Specification.Attachments.empty())
         GNT_ASSERT(m_Specification.ExistingAttachments.empty(), "You want to create attachments and you specified existing?");
 
+    if (m_Specification.AliasedAttachments)
+        GNT_ASSERT(m_Specification.ManagedByRenderGraph, "Aliased attachments have no valid layout outside of render graph!");
+
     // Don't destroy what you don't own
     if (m_Specification.ExistingAttachments.empty())
     {
@@ -73,6 +77,7 @@ void VulkanFramebuffer::Invalidate()
     }
 
     m_AttachmentInfos.clear();
+    m_RenderArea = glm::uvec4(0, 0, m_Specification.Width, m_Specification.Height);
 
     // In case we wanna be owners
     if (m_Attachments.empty() && !m_Specification.Attachments.empty())
@@ -88,7 +93,9 @@ void VulkanFramebuffer::Invalidate()
             imageSpec.CreateTextureID = true;
             imageSpec.Height          = m_Specification.Height;
             imageSpec.Width           = m_Specification.Width;
+            imageSpec.Layers          = m_Specification.Layers;
             imageSpec.Usage           = EImageUsage::Attachment;
+            imageSpec.Aliased         = m_Specification.AliasedAttachments;
 
             newfbAttachment.Attachment    = Image::Create(imageSpec);
             newfbAttachment.Specification = fbAttchament;  // copy the whole framebuffer attachment specification
@@ -99,6 +106,7 @@ void VulkanFramebuffer::Invalidate()
 
     m_DepthStencilAttachmentInfo                  = {VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
     VkRenderingAttachmentInfo depthAttachmentInfo = {VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO};
+    bool bHasDepthAttachment                      = false;  // Aliased images get their views only once memory is bound.
     // TODO: Revisit with stenciling.
 
     // In case we got existing
@@ -109,6 +117,7 @@ void VulkanFramebuffer::Invalidate()
 
         if (ImageUtils::IsDepthFormat(fbAttachment.Specification.Format))
         {
+            bHasDepthAttachment                         = true;
             depthAttachmentInfo.imageView               = vulkanImage->GetView();
             depthAttachmentInfo.storeOp                 = GauntletStoreOpToVulkan(m_Specification.StoreOp);
             depthAttachmentInfo.loadOp                  = GauntletLoadOpToVulkan(m_Specification.LoadOp);
@@ -135,6 +144,7 @@ void VulkanFramebuffer::Invalidate()
 
         if (ImageUtils::IsDepthFormat(fbAttachment.Specification.Format))
         {
+            bHasDepthAttachment                         = true;
             depthAttachmentInfo.imageView               = vulkanImage->GetView();
             depthAttachmentInfo.storeOp                 = GauntletStoreOpToVulkan(fbAttachment.Specification.StoreOp);
             depthAttachmentInfo.loadOp                  = GauntletLoadOpToVulkan(fbAttachment.Specification.LoadOp);
@@ -154,7 +164,7 @@ void VulkanFramebuffer::Invalidate()
     }
 
     // Easy to handle them if depth is the last attachment
-    if (depthAttachmentInfo.imageView) m_AttachmentInfos.push_back(depthAttachmentInfo);
+    if (bHasDepthAttachment) m_AttachmentInfos.push_back(depthAttachmentInfo);
 }
 
 void VulkanFramebuffer::Destroy()
@@ -173,7 +183,8 @@ void VulkanFramebuffer::Destroy()
     m_AttachmentInfos.clear();
 }
 
-void VulkanFramebuffer::BeginPass(const Ref<CommandBuffer>& commandBuffer)
+void VulkanFramebuffer::BeginPass(const Ref<CommandBuffer>& commandBuffer, const uint32_t layer, const glm::uvec4& renderArea,
+                                  const bool bSecondaryContents)
 {
     auto vulkanCommandBuffer = static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
     GNT_ASSERT(vulkanCommandBuffer, "Failed to cast CommandBuffer to VulkanCommandBuffer");
@@ -190,6 +201,13 @@ void VulkanFramebuffer::BeginPass(const Ref<CommandBuffer>& commandBuffer)
                                                                                      : m_Specification.ExistingAttachments[i].Attachment);
         GNT_ASSERT(vulkanImage, "Failed to cast Imaage to VulkanImage");
 
+        // Layers that aren't rendered this pass keep their contents, since we never transition from undefined layout here.
+        m_AttachmentInfos[i].imageView = vulkanImage->GetLayerView(layer);
+        if (ImageUtils::IsDepthFormat(vulkanImage->GetSpecification().Format)) depthAttachmentInfo = m_AttachmentInfos[i];
+
+        // Render graph has already transitioned attachments.
+        if (m_Specification.ManagedByRenderGraph) continue;
+
         VkImageMemoryBarrier imageBarrier            = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
         imageBarrier.image                           = vulkanImage->Get();
         imageBarrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
@@ -205,7 +223,6 @@ void VulkanFramebuffer::BeginPass(const Ref<CommandBuffer>& commandBuffer)
         imageBarrier.srcAccessMask = 0;
         if (ImageUtils::IsDepthFormat(vulkanImage->GetSpecification().Format))
         {
-            depthAttachmentInfo    = m_AttachmentInfos[i];
             imageBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
             vulkanImage->SetLayout(imageBarrier.newLayout);
 
@@ -230,10 +247,14 @@ void VulkanFramebuffer::BeginPass(const Ref<CommandBuffer>& commandBuffer)
     }
 
     VkRenderingInfo renderingInfo = {VK_STRUCTURE_TYPE_RENDERING_INFO};
-    if (vulkanCommandBuffer->GetLevel() == ECommandBufferLevel::COMMAND_BUFFER_LEVEL_SECONDARY)
-        renderingInfo.flags |= VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+    if (bSecondaryContents) renderingInfo.flags |= VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+
+    m_RenderArea = renderArea.z == 0 || renderArea.w == 0 ? glm::uvec4(0, 0, m_Specification.Width, m_Specification.Height) : renderArea;
+    GNT_ASSERT(m_RenderArea.x + m_RenderArea.z <= m_Specification.Width && m_RenderArea.y + m_RenderArea.w <= m_Specification.Height,
+               "Render area is out of framebuffer bounds!");
 
-    renderingInfo.renderArea           = {0, 0, m_Specification.Width, m_Specification.Height};
+    renderingInfo.renderArea           = {{static_cast<int32_t>(m_RenderArea.x), static_cast<int32_t>(m_RenderArea.y)},
+                                          {m_RenderArea.z, m_RenderArea.w}};
     renderingInfo.layerCount           = 1;
     renderingInfo.colorAttachmentCount = static_cast<uint32_t>(m_AttachmentInfos.size()) - (depthAttachmentInfo.imageView ? 1 : 0);
     renderingInfo.pColorAttachments    = m_AttachmentInfos.data();
@@ -241,6 +262,66 @@ void VulkanFramebuffer::BeginPass(const Ref<CommandBuffer>& commandBuffer)
     // renderingInfo.pStencilAttachment   = &m_DepthStencilAttachmentInfo;
 
     vkCmdBeginRendering(vulkanCommandBuffer->Get(), &renderingInfo);
+
+    // Pipeline may already be bound from the previous pass(e.g. rendering atlas tiles), so update viewport here as well.
+    // Secondary command buffers don't inherit dynamic state, they set their own.
+    if (!bSecondaryContents) SetViewportAndScissor(vulkanCommandBuffer->Get());
+}
+
+void VulkanFramebuffer::BeginSecondaryPass(const Ref<CommandBuffer>& secondaryCommandBuffer) const
+{
+    auto vulkanCommandBuffer = static_pointer_cast<VulkanCommandBuffer>(secondaryCommandBuffer);
+    GNT_ASSERT(vulkanCommandBuffer, "Failed to cast CommandBuffer to VulkanCommandBuffer");
+    GNT_ASSERT(vulkanCommandBuffer->GetLevel() == ECommandBufferLevel::COMMAND_BUFFER_LEVEL_SECONDARY, "Command buffer is not secondary!");
+
+    // Formats must match the ones the pass was begun with, depth goes last in both attachment lists.
+    std::vector<VkFormat> colorFormats;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    for (uint32_t i = 0; i < m_AttachmentInfos.size(); ++i)
+    {
+        auto vulkanImage = static_pointer_cast<VulkanImage>(m_Attachments.size() > 0 ? m_Attachments[i].Attachment
+                                                                                     : m_Specification.ExistingAttachments[i].Attachment);
+        if (ImageUtils::IsDepthFormat(vulkanImage->GetSpecification().Format))
+            depthFormat = vulkanImage->GetFormat();
+        else
+            colorFormats.push_back(vulkanImage->GetFormat());
+    }
+
+    VkCommandBufferInheritanceRenderingInfo inheritanceRenderingInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO};
+    inheritanceRenderingInfo.colorAttachmentCount                    = static_cast<uint32_t>(colorFormats.size());
+    inheritanceRenderingInfo.pColorAttachmentFormats                 = colorFormats.data();
+    inheritanceRenderingInfo.depthAttachmentFormat                   = depthFormat;
+    inheritanceRenderingInfo.rasterizationSamples                    = VK_SAMPLE_COUNT_1_BIT;
+
+    // Frame's pipeline statistics query stays active while secondary command buffers are executed.
+    VkCommandBufferInheritanceInfo inheritanceInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+    inheritanceInfo.pNext                          = &inheritanceRenderingInfo;
+    inheritanceInfo.pipelineStatistics             =
+        VulkanGPUQueryRing::GetPipelineStatisticFlags(ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS);
+
+    vulkanCommandBuffer->BeginRecording(true, &inheritanceInfo);
+    SetViewportAndScissor(vulkanCommandBuffer->Get());
+}
+
+void VulkanFramebuffer::EndSecondaryPass(const Ref<CommandBuffer>& secondaryCommandBuffer) const
+{
+    secondaryCommandBuffer->EndRecording();
+}
+
+void VulkanFramebuffer::SetViewportAndScissor(const VkCommandBuffer& commandBuffer) const
+{
+    VkViewport viewport = {};
+    viewport.x          = static_cast<float>(m_RenderArea.x);
+    viewport.y          = static_cast<float>(m_RenderArea.y + m_RenderArea.w);
+    viewport.width      = static_cast<float>(m_RenderArea.z);
+    viewport.height     = -static_cast<float>(m_RenderArea.w);
+    viewport.minDepth   = 0.0f;
+    viewport.maxDepth   = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    const VkRect2D scissor = {{static_cast<int32_t>(m_RenderArea.x), static_cast<int32_t>(m_RenderArea.y)},
+                              {m_RenderArea.z, m_RenderArea.w}};
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 }
 
 void VulkanFramebuffer::EndPass(const Ref<CommandBuffer>& commandBuffer)
@@ -251,6 +332,7 @@ void VulkanFramebuffer::EndPass(const Ref<CommandBuffer>& commandBuffer)
     vkCmdEndRendering(vulkanCommandBuffer->Get());
 
     vulkanCommandBuffer->EndDebugLabel();
+    if (m_Specification.ManagedByRenderGraph) return;
 
     for (uint32_t i = 0; i < m_AttachmentInfos.size(); ++i)
     {
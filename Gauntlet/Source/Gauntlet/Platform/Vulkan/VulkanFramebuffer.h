@@ -22,9 +22,13 @@ class VulkanFramebuffer final : public Framebuffer
 
     FORCEINLINE FramebufferSpecification& GetSpecification() final override { return m_Specification; }
 
-    void BeginPass(const Ref<CommandBuffer>& commandBuffer) final override;
+    void BeginPass(const Ref<CommandBuffer>& commandBuffer, const uint32_t layer = 0, const glm::uvec4& renderArea = glm::uvec4(0),
+                   const bool bSecondaryContents = false) final override;
     void EndPass(const Ref<CommandBuffer>& commandBuffer) final override;
 
+    void BeginSecondaryPass(const Ref<CommandBuffer>& secondaryCommandBuffer) const final override;
+    void EndSecondaryPass(const Ref<CommandBuffer>& secondaryCommandBuffer) const final override;
+
     FORCEINLINE void Resize(uint32_t width, uint32_t height)
     {
         m_Specification.Width  = width;
@@ -37,12 +41,16 @@ class VulkanFramebuffer final : public Framebuffer
 
     FORCEINLINE const uint32_t GetWidth() const final override { return m_Specification.Width; }
     FORCEINLINE const uint32_t GetHeight() const final override { return m_Specification.Height; }
+    FORCEINLINE const glm::uvec4& GetRenderArea() const final override { return m_RenderArea; }
 
   private:
     FramebufferSpecification m_Specification;
     std::vector<VkRenderingAttachmentInfo> m_AttachmentInfos;
     VkRenderingAttachmentInfo m_DepthStencilAttachmentInfo;
+    glm::uvec4 m_RenderArea = glm::uvec4(0);  // Area of the current pass, used by pipelines for viewport & scissor.
 
     std::vector<FramebufferAttachment> m_Attachments;
+
+    void SetViewportAndScissor(const VkCommandBuffer& commandBuffer) const;
 };
 }  // namespace Gauntlet
\ No newline at end of file
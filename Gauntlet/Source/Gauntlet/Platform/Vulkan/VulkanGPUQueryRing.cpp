@@ -0,0 +1,239 @@
+#include "GauntletPCH.h"
+#include "VulkanGPUQueryRing.h"
+
+#include "VulkanContext.h"
+#include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+
+namespace Gauntlet
+{
+
+static constexpr uint32_t s_INVALID_QUERY = UINT32_MAX;
+
+VulkanGPUQueryRing::VulkanGPUQueryRing(ECommandBufferType type, const uint32_t maxMarkers) : GPUQueryRing(maxMarkers), m_Type(type)
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    for (auto& frameQueries : m_FrameQueries)
+    {
+        VkQueryPoolCreateInfo queryPoolCreateInfo = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+        queryPoolCreateInfo.queryType             = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolCreateInfo.queryCount            = m_MaxMarkers * 2;
+        VK_CHECK(vkCreateQueryPool(context.GetDevice()->GetLogicalDevice(), &queryPoolCreateInfo, VK_NULL_HANDLE,
+                                   &frameQueries.TimestampQueryPool),
+                 "Failed to create timestamp query pool!");
+
+        queryPoolCreateInfo.queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        queryPoolCreateInfo.queryCount         = 1;
+        queryPoolCreateInfo.pipelineStatistics = GetPipelineStatisticFlags(m_Type);
+        VK_CHECK(vkCreateQueryPool(context.GetDevice()->GetLogicalDevice(), &queryPoolCreateInfo, VK_NULL_HANDLE,
+                                   &frameQueries.StatisticsQueryPool),
+                 "Failed to create pipeline statistics query pool!");
+
+        frameQueries.Markers.reserve(m_MaxMarkers);
+    }
+
+    m_PipelineStatistics.resize(GetPipelineStatisticsNames().size());
+    m_ResultData.resize(std::max<size_t>(m_MaxMarkers * 2 * 2, m_PipelineStatistics.size() + 1));
+}
+
+VkQueryPipelineStatisticFlags VulkanGPUQueryRing::GetPipelineStatisticFlags(ECommandBufferType type)
+{
+    // Compute only case.
+    if (type == ECommandBufferType::COMMAND_BUFFER_TYPE_COMPUTE) return VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+    return VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |                     // Input assembly vertices
+           VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |                   // Input assembly primitives
+           VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |                   // Vertex shader invocations
+           VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |                 // Fragment shader invocations
+           VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |                        // Clipping invocations
+           VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |                         // Clipped primitives
+           VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_INVOCATIONS_BIT |                 // Geometry Shader
+           VK_QUERY_PIPELINE_STATISTIC_GEOMETRY_SHADER_PRIMITIVES_BIT |                  //
+           VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_CONTROL_SHADER_PATCHES_BIT |         // Tesselation
+           VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_EVALUATION_SHADER_INVOCATIONS_BIT |  //
+           VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT                    // Compute shader invocations
+#if VK_MESH_SHADING
+           | VK_QUERY_PIPELINE_STATISTIC_TASK_SHADER_INVOCATIONS_BIT_EXT |  // MESH SHADING
+           VK_QUERY_PIPELINE_STATISTIC_MESH_SHADER_INVOCATIONS_BIT_EXT
+#endif
+        ;
+}
+
+void VulkanGPUQueryRing::BeginFrame(const Ref<CommandBuffer>& commandBuffer, const bool bProfile)
+{
+    GNT_ASSERT(m_OpenMarkers.empty(), "Not all GPU markers of the previous frame were closed!");
+
+    // Queries of this frame slot were submitted frames in flight ago.
+    m_CurrentFrame     = GraphicsContext::Get().GetCurrentFrameIndex();
+    auto& frameQueries = m_FrameQueries[m_CurrentFrame];
+    if (frameQueries.bIsProfiled) ReadResults(frameQueries);
+
+    frameQueries.Markers.clear();
+    frameQueries.UsedMarkers            = 0;
+    frameQueries.bHasPipelineStatistics = false;
+    frameQueries.bIsProfiled            = bProfile;
+    if (!bProfile) return;
+
+    auto vulkanCommandBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
+    vkCmdResetQueryPool(vulkanCommandBuffer->Get(), frameQueries.TimestampQueryPool, 0, m_MaxMarkers * 2);
+    vkCmdResetQueryPool(vulkanCommandBuffer->Get(), frameQueries.StatisticsQueryPool, 0, 1);
+}
+
+void VulkanGPUQueryRing::ReadResults(FrameQueries& frameQueries)
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+
+    // No VK_QUERY_RESULT_WAIT_BIT: if GPU hasn't finished the frame yet, previous results are kept instead of stalling CPU.
+    constexpr VkQueryResultFlags queryResultFlags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+    if (frameQueries.UsedMarkers > 0)
+    {
+        const VkResult result = vkGetQueryPoolResults(context.GetDevice()->GetLogicalDevice(), frameQueries.TimestampQueryPool, 0,
+                                                      frameQueries.UsedMarkers * 2, m_ResultData.size() * sizeof(m_ResultData[0]),
+                                                      m_ResultData.data(), 2 * sizeof(m_ResultData[0]), queryResultFlags);
+        if (result == VK_SUCCESS)
+        {
+            // Markers are allocated in order they begin, so the first one is the earliest.
+            const float timestampPeriod   = context.GetTimestampPeriod();
+            const uint64_t frameTimestamp = m_ResultData[0];
+            m_Markers.resize(frameQueries.Markers.size());
+            for (size_t i = 0; i < frameQueries.Markers.size(); ++i)
+            {
+                const auto& pendingMarker = frameQueries.Markers[i];
+                m_Markers[i].Name         = pendingMarker.Name;
+                m_Markers[i].Depth        = pendingMarker.Depth;
+                m_Markers[i].Start        = 0.0f;
+                m_Markers[i].Time         = 0.0f;
+                if (pendingMarker.FirstQuery == s_INVALID_QUERY) continue;
+
+                const uint64_t beginTimestamp = m_ResultData[pendingMarker.FirstQuery * 2];
+                const uint64_t endTimestamp   = m_ResultData[(pendingMarker.FirstQuery + 1) * 2];
+                m_Markers[i].Start = static_cast<float>(beginTimestamp - frameTimestamp) * timestampPeriod / 1000000.0f;
+                m_Markers[i].Time  = static_cast<float>(endTimestamp - beginTimestamp) * timestampPeriod / 1000000.0f;
+            }
+            m_MarkersSubmitTime = frameQueries.SubmitTime;
+        }
+        else if (result != VK_NOT_READY)
+            VK_CHECK(result, "Failed to get timestamp query results!");
+    }
+
+    if (frameQueries.bHasPipelineStatistics)
+    {
+        // Statistics are followed by availability value.
+        const size_t statisticCount = m_PipelineStatistics.size();
+        const VkResult result       = vkGetQueryPoolResults(context.GetDevice()->GetLogicalDevice(), frameQueries.StatisticsQueryPool, 0, 1,
+                                                            (statisticCount + 1) * sizeof(m_ResultData[0]), m_ResultData.data(),
+                                                            (statisticCount + 1) * sizeof(m_ResultData[0]), queryResultFlags);
+        if (result == VK_SUCCESS)
+            std::copy(m_ResultData.begin(), m_ResultData.begin() + statisticCount, m_PipelineStatistics.begin());
+        else if (result != VK_NOT_READY)
+            VK_CHECK(result, "Failed to get pipeline statistics query results!");
+    }
+}
+
+void VulkanGPUQueryRing::BeginMarker(const Ref<CommandBuffer>& commandBuffer, const std::string& name)
+{
+    commandBuffer->BeginDebugLabel(name.data(), glm::vec4(0.8f, 0.8f, 0.2f, 1.0f));
+
+    auto& frameQueries = m_FrameQueries[m_CurrentFrame];
+    m_OpenMarkers.push_back(static_cast<uint32_t>(frameQueries.Markers.size()));
+
+    auto& marker      = frameQueries.Markers.emplace_back();
+    marker.Name       = name;
+    marker.Depth      = static_cast<uint32_t>(m_OpenMarkers.size() - 1);
+    marker.FirstQuery = s_INVALID_QUERY;
+    if (!frameQueries.bIsProfiled) return;
+
+    if (frameQueries.UsedMarkers == m_MaxMarkers)
+    {
+        if (!m_bWarnedOutOfMarkers) LOG_WARN("Out of GPU marker queries(%u), the rest of markers won't be timed!", m_MaxMarkers);
+        m_bWarnedOutOfMarkers = true;
+        return;
+    }
+
+    marker.FirstQuery = frameQueries.UsedMarkers * 2;
+    ++frameQueries.UsedMarkers;
+
+    auto vulkanCommandBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
+    vkCmdWriteTimestamp(vulkanCommandBuffer->Get(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frameQueries.TimestampQueryPool, marker.FirstQuery);
+}
+
+void VulkanGPUQueryRing::EndMarker(const Ref<CommandBuffer>& commandBuffer)
+{
+    GNT_ASSERT(!m_OpenMarkers.empty(), "No GPU marker to end!");
+
+    auto& frameQueries  = m_FrameQueries[m_CurrentFrame];
+    const auto& marker  = frameQueries.Markers[m_OpenMarkers.back()];
+    m_OpenMarkers.pop_back();
+
+    if (marker.FirstQuery != s_INVALID_QUERY)
+    {
+        auto vulkanCommandBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
+        vkCmdWriteTimestamp(vulkanCommandBuffer->Get(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frameQueries.TimestampQueryPool,
+                            marker.FirstQuery + 1);
+    }
+
+    commandBuffer->EndDebugLabel();
+}
+
+void VulkanGPUQueryRing::BeginPipelineStatistics(const Ref<CommandBuffer>& commandBuffer)
+{
+    auto& frameQueries = m_FrameQueries[m_CurrentFrame];
+    if (!frameQueries.bIsProfiled) return;
+
+    GNT_ASSERT(!frameQueries.bHasPipelineStatistics, "Pipeline statistics query can be used once per frame!");
+    frameQueries.bHasPipelineStatistics = true;
+
+    auto vulkanCommandBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
+    vkCmdBeginQuery(vulkanCommandBuffer->Get(), frameQueries.StatisticsQueryPool, 0, 0);
+}
+
+void VulkanGPUQueryRing::EndPipelineStatistics(const Ref<CommandBuffer>& commandBuffer)
+{
+    const auto& frameQueries = m_FrameQueries[m_CurrentFrame];
+    if (!frameQueries.bHasPipelineStatistics) return;
+
+    auto vulkanCommandBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
+    vkCmdEndQuery(vulkanCommandBuffer->Get(), frameQueries.StatisticsQueryPool, 0);
+}
+
+const std::vector<std::string>& VulkanGPUQueryRing::GetPipelineStatisticsNames() const
+{
+    // In order of VkQueryPipelineStatisticFlagBits, that's how results are written.
+    static const std::vector<std::string> s_GraphicsPipelineStatisticsNames = {
+        "Input assembly vertex count         ",
+        "Input assembly primitives count     ",
+        "Vertex shader invocations           ",
+        "Geometry Shader Invocations         ",
+        "Geometry Shader Primitives          ",
+        "Clipping stage primitives processed ",
+        "Clipping stage primitives output    ",
+        "Fragment shader invocations         ",
+        "Tess. control shader patches        ",
+        "Tess. eval. shader invocations      ",
+        "Compute shader invocations          ",
+#if VK_MESH_SHADING
+        "Task shader invocations             ",
+        "Mesh shader invocations             ",
+#endif
+    };
+    static const std::vector<std::string> s_ComputePipelineStatisticsNames = {"Compute shader invocations          "};
+
+    return m_Type == ECommandBufferType::COMMAND_BUFFER_TYPE_COMPUTE ? s_ComputePipelineStatisticsNames
+                                                                     : s_GraphicsPipelineStatisticsNames;
+}
+
+void VulkanGPUQueryRing::Destroy()
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    for (auto& frameQueries : m_FrameQueries)
+    {
+        if (!frameQueries.TimestampQueryPool) continue;
+
+        vkDestroyQueryPool(context.GetDevice()->GetLogicalDevice(), frameQueries.TimestampQueryPool, VK_NULL_HANDLE);
+        vkDestroyQueryPool(context.GetDevice()->GetLogicalDevice(), frameQueries.StatisticsQueryPool, VK_NULL_HANDLE);
+        frameQueries.TimestampQueryPool  = VK_NULL_HANDLE;
+        frameQueries.StatisticsQueryPool = VK_NULL_HANDLE;
+    }
+}
+
+}  // namespace Gauntlet
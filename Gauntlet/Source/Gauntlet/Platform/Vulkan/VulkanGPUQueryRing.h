@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Gauntlet/Renderer/GPUQueryRing.h"
+
+#include <volk/volk.h>
+
+namespace Gauntlet
+{
+
+class VulkanGPUQueryRing final : public GPUQueryRing
+{
+  public:
+    VulkanGPUQueryRing(ECommandBufferType type, const uint32_t maxMarkers);
+    VulkanGPUQueryRing() = delete;
+    ~VulkanGPUQueryRing() { Destroy(); }
+
+    // Secondary command buffers executed while statistics query is active have to inherit the same flags.
+    static VkQueryPipelineStatisticFlags GetPipelineStatisticFlags(ECommandBufferType type);
+
+    void BeginFrame(const Ref<CommandBuffer>& commandBuffer, const bool bProfile = true) final override;
+    FORCEINLINE void EndFrame() final override { m_FrameQueries[m_CurrentFrame].SubmitTime = Timer::Now(); }
+
+    void BeginMarker(const Ref<CommandBuffer>& commandBuffer, const std::string& name) final override;
+    void EndMarker(const Ref<CommandBuffer>& commandBuffer) final override;
+
+    void BeginPipelineStatistics(const Ref<CommandBuffer>& commandBuffer) final override;
+    void EndPipelineStatistics(const Ref<CommandBuffer>& commandBuffer) final override;
+
+    void Destroy() final override;
+
+    const std::vector<std::string>& GetPipelineStatisticsNames() const final override;
+
+  private:
+    struct PendingMarker
+    {
+        std::string Name;
+        uint32_t Depth      = 0;
+        uint32_t FirstQuery = 0;  // Begin && end timestamps are adjacent queries, UINT32_MAX if marker wasn't timed.
+    };
+
+    // Everything recorded by a single frame in flight.
+    struct FrameQueries
+    {
+        VkQueryPool TimestampQueryPool  = VK_NULL_HANDLE;
+        VkQueryPool StatisticsQueryPool = VK_NULL_HANDLE;
+        std::vector<PendingMarker> Markers;
+        uint32_t UsedMarkers        = 0;
+        double SubmitTime           = 0.0;
+        bool bIsProfiled            = false;
+        bool bHasPipelineStatistics = false;
+    };
+
+    ECommandBufferType m_Type = ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS;
+    std::array<FrameQueries, MAX_FRAMES_IN_FLIGHT> m_FrameQueries;
+    uint32_t m_CurrentFrame = 0;
+
+    std::vector<uint32_t> m_OpenMarkers;  // Indices into current frame's markers, innermost last.
+    std::vector<uint64_t> m_ResultData;   // (value, availability) pairs.
+    bool m_bWarnedOutOfMarkers = false;
+
+    void ReadResults(FrameQueries& frameQueries);
+};
+
+}  // namespace Gauntlet
@@ -13,7 +13,7 @@ namespace Gauntlet
 namespace ImageUtils
 {
 void CreateImage(AllocatedImage* image, const uint32_t width, const uint32_t height, VkImageUsageFlags imageUsageFlags, VkFormat format,
-                 VkImageTiling imageTiling, const uint32_t mipLevels, const uint32_t arrayLayers)
+                 VkImageTiling imageTiling, const uint32_t mipLevels, const uint32_t arrayLayers, const bool bAllocateMemory)
 {
     auto& Context = (VulkanContext&)VulkanContext::Get();
     GNT_ASSERT(Context.GetDevice()->IsValid(), "Vulkan device is not valid!");
@@ -36,11 +36,18 @@ void CreateImage(AllocatedImage* image, const uint32_t width, const uint32_t hei
     imageCreateInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
     imageCreateInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
 
+    if (!bAllocateMemory)
+    {
+        VK_CHECK(vkCreateImage(Context.GetDevice()->GetLogicalDevice(), &imageCreateInfo, nullptr, &image->Image),
+                 "Failed to create vulkan image!");
+        return;
+    }
+
     image->Allocation = Context.GetAllocator()->CreateImage(imageCreateInfo, &image->Image);
 }
 
 void CreateImageView(const VkDevice& device, const VkImage& image, VkImageView* imageView, VkFormat format, VkImageAspectFlags aspectFlags,
-                     VkImageViewType imageViewType, const uint32_t mipLevels)
+                     VkImageViewType imageViewType, const uint32_t mipLevels, const uint32_t baseArrayLayer, const uint32_t layerCount)
 {
     VkImageViewCreateInfo imageViewCreateInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
     imageViewCreateInfo.viewType              = imageViewType;
@@ -53,8 +60,8 @@ void CreateImageView(const VkDevice& device, const VkImage& image, VkImageView*
 
     imageViewCreateInfo.subresourceRange.baseMipLevel   = 0;
     imageViewCreateInfo.subresourceRange.levelCount     = mipLevels;
-    imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
-    imageViewCreateInfo.subresourceRange.layerCount     = imageViewType == VK_IMAGE_VIEW_TYPE_CUBE ? 6 : 1;
+    imageViewCreateInfo.subresourceRange.baseArrayLayer = baseArrayLayer;
+    imageViewCreateInfo.subresourceRange.layerCount     = imageViewType == VK_IMAGE_VIEW_TYPE_CUBE ? 6 : layerCount;
 
     // We don't need to swizzle ( swap around ) any of the
     // color channels
@@ -87,6 +94,7 @@ VkFormat GauntletImageFormatToVulkan(EImageFormat imageFormat)
         case EImageFormat::R16F: return VK_FORMAT_R16_SFLOAT;
         case EImageFormat::R32F: return VK_FORMAT_R32_SFLOAT;
         case EImageFormat::R11G11B10: return VK_FORMAT_B10G11R11_UFLOAT_PACK32;
+        case EImageFormat::RGB10A2: return VK_FORMAT_A2B10G10R10_UNORM_PACK32;
         case EImageFormat::DEPTH32F: return VK_FORMAT_D32_SFLOAT;
         case EImageFormat::DEPTH24STENCIL8: return VK_FORMAT_D24_UNORM_S8_UINT;
     }
@@ -96,13 +104,13 @@ VkFormat GauntletImageFormatToVulkan(EImageFormat imageFormat)
 }
 
 void TransitionImageLayout(VkImage& image, VkImageLayout oldLayout, VkImageLayout newLayout, EImageFormat format, const uint32_t mipLevels,
-                           const bool bIsCubeMap)
+                           const bool bIsCubeMap, const uint32_t layerCount)
 {
     GRAPHICS_GUARD_LOCK;
 
     VkImageSubresourceRange SubresourceRange = {};
     SubresourceRange.aspectMask              = IsDepthFormat(format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
-    SubresourceRange.layerCount              = bIsCubeMap ? 6 : 1;
+    SubresourceRange.layerCount              = bIsCubeMap ? 6 : layerCount;
     SubresourceRange.levelCount              = mipLevels;
 
     VkImageMemoryBarrier imageMemoryBarrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
@@ -163,6 +171,14 @@ void TransitionImageLayout(VkImage& image, VkImageLayout oldLayout, VkImageLayou
         imageMemoryBarrier.srcAccessMask = 0;
         imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
     }
+    else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_GENERAL)
+    {
+        PipelineSourceStageFlags      = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;  // The very beginning of pipeline
+        PipelineDestinationStageFlags = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+        imageMemoryBarrier.srcAccessMask = 0;
+        imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    }
     else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL)
     {
         PipelineSourceStageFlags      = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
@@ -369,6 +385,11 @@ void VulkanImage::Invalidate()
     {
         ImageUsageFlags |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
     }
+    else if (m_Specification.Usage == EImageUsage::STORAGE)
+    {
+        GNT_ASSERT(!ImageUtils::IsDepthFormat(m_Specification.Format), "Depth formats can't be used as storage images!");
+        ImageUsageFlags |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
 
     if (ImageUtils::IsDepthFormat(m_Specification.Format)) GNT_ASSERT(m_Specification.Mips == 1, "Depth image cannot have mips!");
 
@@ -380,21 +401,85 @@ void VulkanImage::Invalidate()
     }
 
     ImageUtils::CreateImage(&m_Image, m_Specification.Width, m_Specification.Height, ImageUsageFlags, ImageFormat, VK_IMAGE_TILING_OPTIMAL,
-                            m_Specification.Mips, m_Specification.Layers);
-    ImageUtils::CreateImageView(context.GetDevice()->GetLogicalDevice(), m_Image.Image, &m_Image.ImageView, ImageFormat,
-                                ImageUtils::IsDepthFormat(m_Specification.Format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT,
-                                m_Specification.Layers == 6 ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D, m_Specification.Mips);
+                            m_Specification.Mips, m_Specification.Layers, !m_Specification.Aliased);
+    SetLayout(VK_IMAGE_LAYOUT_UNDEFINED);
+    if (m_Specification.Aliased) return;
+
+    CreateViews();
+
+    // Storage images are both written && sampled, so they never leave general layout.
+    const bool bIsLayered = m_Specification.Layers > 1 && m_Specification.Layers != 6;
+    const VkImageLayout initialLayout =
+        m_Specification.Usage == EImageUsage::STORAGE ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    ImageUtils::TransitionImageLayout(m_Image.Image, VK_IMAGE_LAYOUT_UNDEFINED, initialLayout, m_Specification.Format, m_Specification.Mips,
+                                      false, bIsLayered ? m_Specification.Layers : 1);
+
+    SetLayout(initialLayout);
+
+    /*if (m_Specification.Usage == EImageUsage::Attachment)
+    {
+        const bool bIsDepthFormat = ImageUtils::IsDepthFormat(m_Specification.Format);
+        ImageUtils::TransitionImageLayout(m_Image.Image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                          bIsDepthFormat ? VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL
+                                                         : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                          m_Specification.Format, m_Specification.Mips);
+
+        SetLayout(bIsDepthFormat ? VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    }*/
+}
+
+void VulkanImage::BindMemory(const VmaAllocation& allocation, const VkDeviceSize offset)
+{
+    GNT_ASSERT(m_Specification.Aliased && !IsMemoryBound(), "Only aliased images without memory can be bound!");
+
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    context.GetAllocator()->BindImageMemory(allocation, offset, m_Image.Image);
+
+    CreateViews();
+}
+
+VkMemoryRequirements VulkanImage::GetMemoryRequirements() const
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+
+    VkMemoryRequirements memoryRequirements = {};
+    vkGetImageMemoryRequirements(context.GetDevice()->GetLogicalDevice(), m_Image.Image, &memoryRequirements);
+    return memoryRequirements;
+}
+
+void VulkanImage::CreateViews()
+{
+    auto& context                       = (VulkanContext&)VulkanContext::Get();
+    const auto ImageFormat              = ImageUtils::GauntletImageFormatToVulkan(m_Specification.Format);
+    const VkImageAspectFlags aspectMask =
+        ImageUtils::IsDepthFormat(m_Specification.Format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+    const bool bIsLayered = m_Specification.Layers > 1 && m_Specification.Layers != 6;
+
+    VkImageViewType imageViewType = VK_IMAGE_VIEW_TYPE_2D;
+    if (m_Specification.Layers == 6)
+        imageViewType = VK_IMAGE_VIEW_TYPE_CUBE;
+    else if (bIsLayered)
+        imageViewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+
+    ImageUtils::CreateImageView(context.GetDevice()->GetLogicalDevice(), m_Image.Image, &m_Image.ImageView, ImageFormat, aspectMask,
+                                imageViewType, m_Specification.Mips, 0, m_Specification.Layers);
+
+    // Dynamic rendering can only target a single layer view.
+    if (bIsLayered && m_Specification.Usage == EImageUsage::Attachment)
+    {
+        m_LayerViews.resize(m_Specification.Layers);
+        for (uint32_t layer = 0; layer < m_Specification.Layers; ++layer)
+        {
+            ImageUtils::CreateImageView(context.GetDevice()->GetLogicalDevice(), m_Image.Image, &m_LayerViews[layer], ImageFormat,
+                                        aspectMask, VK_IMAGE_VIEW_TYPE_2D, m_Specification.Mips, layer);
+        }
+    }
 
     CreateSampler();
 
     m_DescriptorImageInfo.imageView = m_Image.ImageView;
     m_DescriptorImageInfo.sampler   = m_Sampler;
 
-    ImageUtils::TransitionImageLayout(m_Image.Image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                                      m_Specification.Format, m_Specification.Mips);
-
-    SetLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
     if (m_Specification.CreateTextureID)
     {
         if (!m_DescriptorSet.Handle)  // Preventing allocating on image resizing, just simply update descriptor set
@@ -404,21 +489,14 @@ void VulkanImage::Invalidate()
                        "Failed to allocate texture/image descriptor set!");
         }
 
+        // ImGui samples texture IDs as sampler2D, so layered images show their first layer.
+        VkDescriptorImageInfo textureIDImageInfo = m_DescriptorImageInfo;
+        if (!m_LayerViews.empty()) textureIDImageInfo.imageView = m_LayerViews[0];
+
         auto TextureWriteDescriptorSet =
-            Utility::GetWriteDescriptorSet(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, m_DescriptorSet.Handle, 1, &m_DescriptorImageInfo);
+            Utility::GetWriteDescriptorSet(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, m_DescriptorSet.Handle, 1, &textureIDImageInfo);
         vkUpdateDescriptorSets(context.GetDevice()->GetLogicalDevice(), 1, &TextureWriteDescriptorSet, 0, nullptr);
     }
-
-    /*if (m_Specification.Usage == EImageUsage::Attachment)
-    {
-        const bool bIsDepthFormat = ImageUtils::IsDepthFormat(m_Specification.Format);
-        ImageUtils::TransitionImageLayout(m_Image.Image, VK_IMAGE_LAYOUT_UNDEFINED,
-                                          bIsDepthFormat ? VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL
-                                                         : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                                          m_Specification.Format, m_Specification.Mips);
-
-        SetLayout(bIsDepthFormat ? VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-    }*/
 }
 
 void VulkanImage::CreateSampler()
@@ -448,12 +526,23 @@ void VulkanImage::Destroy()
         context.WaitDeviceOnFinish();
     }
 
-    SamplerStorage::DecrementSamplerRef(m_Sampler);
+    if (m_Sampler) SamplerStorage::DecrementSamplerRef(m_Sampler);
     if (m_DescriptorSet.Handle) context.GetDescriptorAllocator()->ReleaseDescriptorSets(&m_DescriptorSet, 1);
 
-    context.GetAllocator()->DestroyImage(m_Image.Image, m_Image.Allocation);
+    // Memory of aliased images belongs to the render graph.
+    if (m_Specification.Aliased)
+        vkDestroyImage(context.GetDevice()->GetLogicalDevice(), m_Image.Image, nullptr);
+    else
+        context.GetAllocator()->DestroyImage(m_Image.Image, m_Image.Allocation);
 
     vkDestroyImageView(context.GetDevice()->GetLogicalDevice(), m_Image.ImageView, nullptr);
+    for (auto& layerView : m_LayerViews)
+        vkDestroyImageView(context.GetDevice()->GetLogicalDevice(), layerView, nullptr);
+
+    m_LayerViews.clear();
+    m_Image.Image     = VK_NULL_HANDLE;
+    m_Image.ImageView = VK_NULL_HANDLE;
+    m_Sampler         = VK_NULL_HANDLE;
 }
 
 void VulkanSamplerStorage::InitializeImpl()
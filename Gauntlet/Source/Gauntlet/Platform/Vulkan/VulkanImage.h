@@ -25,15 +25,17 @@ namespace ImageUtils
 {
 
 void CreateImage(AllocatedImage* image, const uint32_t width, const uint32_t height, VkImageUsageFlags imageUsageFlags, VkFormat format,
-                 VkImageTiling imageTiling = VK_IMAGE_TILING_OPTIMAL, const uint32_t mipLevels = 1, const uint32_t arrayLayers = 1);
+                 VkImageTiling imageTiling = VK_IMAGE_TILING_OPTIMAL, const uint32_t mipLevels = 1, const uint32_t arrayLayers = 1,
+                 const bool bAllocateMemory = true);
 
 void CreateImageView(const VkDevice& device, const VkImage& image, VkImageView* imageView, VkFormat format, VkImageAspectFlags aspectFlags,
-                     VkImageViewType imageViewType = VK_IMAGE_VIEW_TYPE_2D, const uint32_t mipLevels = 1);
+                     VkImageViewType imageViewType = VK_IMAGE_VIEW_TYPE_2D, const uint32_t mipLevels = 1, const uint32_t baseArrayLayer = 0,
+                     const uint32_t layerCount = 1);
 
 VkFormat GauntletImageFormatToVulkan(EImageFormat imageFormat);
 
 void TransitionImageLayout(VkImage& image, VkImageLayout oldLayout, VkImageLayout newLayout, EImageFormat format,
-                           const uint32_t mipLevels = 1, const bool bIsCubeMap = false);
+                           const uint32_t mipLevels = 1, const bool bIsCubeMap = false, const uint32_t layerCount = 1);
 
 void CopyBufferDataToImage(const VkBuffer& sourceBuffer, VkImage& destinationImage, const VkExtent3D& imageExtent,
                            const bool bIsCubeMap = false);
@@ -56,8 +58,22 @@ class VulkanImage final : public Image
     void Invalidate() final override;
     void Destroy() final override;
 
+    // Aliased images only, views && descriptors are created once memory is bound, layout stays undefined until first use.
+    void BindMemory(const VmaAllocation& allocation, const VkDeviceSize offset);
+    VkMemoryRequirements GetMemoryRequirements() const;
+    FORCEINLINE bool IsMemoryBound() const { return m_Image.ImageView != VK_NULL_HANDLE; }
+
     FORCEINLINE auto& Get() { return m_Image.Image; }
     FORCEINLINE auto& GetView() { return m_Image.ImageView; }
+
+    // Per-layer views of layered attachments(e.g. shadow cascades), so each layer can be rendered separately.
+    FORCEINLINE auto& GetLayerView(const uint32_t layer)
+    {
+        if (m_LayerViews.empty()) return m_Image.ImageView;
+
+        GNT_ASSERT(layer < m_LayerViews.size(), "Image layer out of range!");
+        return m_LayerViews[layer];
+    }
     FORCEINLINE auto& GetSampler() { return m_Sampler; }
     FORCEINLINE auto GetFormat() { return ImageUtils::GauntletImageFormatToVulkan(m_Specification.Format); }
     FORCEINLINE ImageSpecification& GetSpecification() final override { return m_Specification; }
@@ -88,12 +104,14 @@ class VulkanImage final : public Image
     ImageSpecification m_Specification;
 
     AllocatedImage m_Image;
+    std::vector<VkImageView> m_LayerViews;
     VkSampler m_Sampler    = VK_NULL_HANDLE;
     VkImageLayout m_Layout = VK_IMAGE_LAYOUT_UNDEFINED;
     VkDescriptorImageInfo m_DescriptorImageInfo;
     DescriptorSet m_DescriptorSet;
 
     void CreateSampler();
+    void CreateViews();
 };
 
 class VulkanSamplerStorage final : public SamplerStorage
@@ -56,7 +56,7 @@ void VulkanMaterial::Invalidate()
     //               "Failed to allocate descriptor sets!");
     //}
 
-    for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
     {
         auto WhiteImageInfo = static_pointer_cast<VulkanTexture2D>(RendererStorageData.WhiteTexture)->GetImageDescriptorInfo();
         auto WhiteTextureWriteSet =
@@ -26,6 +26,6 @@ class VulkanMaterial final : public Material
     FORCEINLINE void* GetDescriptorSet() final override { return m_DescriptorSet[GraphicsContext::Get().GetCurrentFrameIndex()].Handle; }
 
   private:
-    std::array<DescriptorSet, FRAMES_IN_FLIGHT> m_DescriptorSet;
+    std::array<DescriptorSet, MAX_FRAMES_IN_FLIGHT> m_DescriptorSet;
 };
 }  // namespace Gauntlet
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include <GauntletPCH.h>
+#include "VulkanParticleSystem.h"
+
+#include "VulkanContext.h"
+#include "VulkanDevice.h"
+#include "VulkanCommandBuffer.h"
+
+#include "Gauntlet/Renderer/Renderer.h"
+#include "Gauntlet/Renderer/Pipeline.h"
+#include "Gauntlet/Renderer/Buffer.h"
+#include "Gauntlet/Renderer/Framebuffer.h"
+#include "Gauntlet/Renderer/GPUQueryRing.h"
+
+#include "Gauntlet/Core/Profiler.h"
+
+namespace Gauntlet
+{
+
+VulkanParticleSystem::VulkanParticleSystem() : ParticleSystem()
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+
+    const auto& queueFamilyIndices = context.GetDevice()->GetQueueFamilyIndices();
+    m_bIsAsyncCompute              = queueFamilyIndices.ComputeFamily != queueFamilyIndices.GraphicsFamily;
+    LOG_TRACE("Particle simulation runs on %s queue.", m_bIsAsyncCompute ? "async compute" : "graphics family");
+
+    CreateSemaphores();
+}
+
+void VulkanParticleSystem::Destroy()
+{
+    ParticleSystem::Destroy();
+
+    DestroySemaphores();
+}
+
+void VulkanParticleSystem::CreateSemaphores()
+{
+    auto& context      = (VulkanContext&)VulkanContext::Get();
+    const auto& device = context.GetDevice()->GetLogicalDevice();
+
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        VK_CHECK(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &m_SimulationFinishedSemaphores[i]),
+                 "Failed to create simulation semaphore!");
+        VK_CHECK(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &m_ParticlesReleasedSemaphores[i]),
+                 "Failed to create particles release semaphore!");
+
+        m_bIsReleasedToCompute[i] = false;
+    }
+}
+
+void VulkanParticleSystem::DestroySemaphores()
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        vkDestroySemaphore(context.GetDevice()->GetLogicalDevice(), m_SimulationFinishedSemaphores[i], nullptr);
+        vkDestroySemaphore(context.GetDevice()->GetLogicalDevice(), m_ParticlesReleasedSemaphores[i], nullptr);
+    }
+}
+
+void VulkanParticleSystem::InsertOwnershipBarrier(const Ref<VulkanCommandBuffer>& commandBuffer, const bool bToCompute,
+                                                  const bool bAcquire) const
+{
+    auto& context                  = (VulkanContext&)VulkanContext::Get();
+    const auto& queueFamilyIndices = context.GetDevice()->GetQueueFamilyIndices();
+
+    // Release makes writes available, acquire makes them visible, the other access mask is ignored.
+    // Acquire's source stage matches the semaphore wait stage, so the barrier chains with the wait.
+    const VkPipelineStageFlags graphicsStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+    const VkPipelineStageFlags computeStage  = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    VkPipelineStageFlags srcStageMask        = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    VkPipelineStageFlags dstStageMask        = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    VkAccessFlags srcAccessMask              = 0;
+    VkAccessFlags dstAccessMask              = 0;
+    if (bAcquire)
+    {
+        srcStageMask  = bToCompute ? computeStage : graphicsStage;
+        dstStageMask  = bToCompute ? computeStage : graphicsStage;
+        dstAccessMask = bToCompute ? VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+                                   : VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    }
+    else
+    {
+        srcStageMask  = bToCompute ? graphicsStage : computeStage;
+        srcAccessMask = bToCompute ? 0 : VK_ACCESS_SHADER_WRITE_BIT;
+    }
+
+    std::array<VkBufferMemoryBarrier, 3> bufferMemoryBarriers = {};
+    const std::array<Ref<StorageBuffer>, 3> buffers           = {m_ParticlesBuffer, m_SortListBuffer, m_IndirectArgsBuffer};
+    for (size_t i = 0; i < buffers.size(); ++i)
+    {
+        bufferMemoryBarriers[i]                     = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
+        bufferMemoryBarriers[i].srcQueueFamilyIndex = bToCompute ? queueFamilyIndices.GraphicsFamily : queueFamilyIndices.ComputeFamily;
+        bufferMemoryBarriers[i].dstQueueFamilyIndex = bToCompute ? queueFamilyIndices.ComputeFamily : queueFamilyIndices.GraphicsFamily;
+        bufferMemoryBarriers[i].srcAccessMask       = srcAccessMask;
+        bufferMemoryBarriers[i].dstAccessMask       = dstAccessMask;
+        bufferMemoryBarriers[i].buffer              = (VkBuffer)buffers[i]->Get();
+        bufferMemoryBarriers[i].offset              = 0;
+        bufferMemoryBarriers[i].size                = VK_WHOLE_SIZE;
+    }
+
+    commandBuffer->InsertBarrier(srcStageMask, dstStageMask, 0, 0, nullptr, static_cast<uint32_t>(bufferMemoryBarriers.size()),
+                                 bufferMemoryBarriers.data(), 0, nullptr);
+}
+
+void VulkanParticleSystem::InsertSimulationBarrier(const Ref<CommandBuffer>& computeCommandBuffer) const
+{
+    auto vulkanCommandBuffer = std::static_pointer_cast<VulkanCommandBuffer>(computeCommandBuffer);
+
+    // Counters && lists are read back as indirect arguments, so a global barrier is simpler than tracking every buffer.
+    VkMemoryBarrier memoryBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    memoryBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+    vulkanCommandBuffer->InsertBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &memoryBarrier, 0,
+                                       nullptr, 0, nullptr);
+}
+
+void VulkanParticleSystem::OnCompute(const uint32_t poolSize)
+{
+    GNT_PROFILE_FUNCTION();
+
+    const uint32_t currentFrame = GraphicsContext::Get().GetCurrentFrameIndex();
+    auto computeCommandBuffer   = std::static_pointer_cast<VulkanCommandBuffer>(m_ComputeCommandBuffer[currentFrame]);
+
+    // Waits for the simulation submitted frames in flight ago, it has been consumed by its frame long before, so it's free.
+    computeCommandBuffer->BeginRecording(true);
+
+    // Results are frames in flight late, but reading them doesn't stall.
+    m_QueryRing->BeginFrame(computeCommandBuffer, Renderer::GetSettings().GPUProfiling);
+
+    if (ReservePool(poolSize))
+    {
+        // Device is idle, semaphores that were signaled but not waited on are dropped along with buffer ownership.
+        DestroySemaphores();
+        CreateSemaphores();
+        m_bIsSimulationPending = false;
+    }
+
+    // Previous output wasn't rendered, its semaphore has to be unsignaled before reuse, pool contents are kept as is.
+    if (m_bIsSimulationPending)
+        computeCommandBuffer->AddWaitSemaphore(m_SimulationFinishedSemaphores[m_PendingFrame], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    // Pool is shared by frames, so it's overwritten only once the previous frame has rendered it.
+    bool bIsAcquired = false;
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
+    {
+        if (!m_bIsReleasedToCompute[frame]) continue;
+
+        computeCommandBuffer->AddWaitSemaphore(m_ParticlesReleasedSemaphores[frame],
+                                               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
+        if (m_bIsAsyncCompute && !bIsAcquired) InsertOwnershipBarrier(computeCommandBuffer, true, true);
+
+        bIsAcquired                   = true;
+        m_bIsReleasedToCompute[frame] = false;
+    }
+
+    RecordSimulation(computeCommandBuffer);
+
+    if (m_bIsAsyncCompute) InsertOwnershipBarrier(computeCommandBuffer, false, false);
+
+    computeCommandBuffer->AddSignalSemaphore(m_SimulationFinishedSemaphores[currentFrame]);
+    computeCommandBuffer->EndRecording();
+    {
+        GRAPHICS_GUARD_LOCK;
+        computeCommandBuffer->Submit(false);
+    }
+    m_QueryRing->EndFrame();
+
+    m_bIsSimulationPending = true;
+    m_PendingFrame         = currentFrame;
+}
+
+void VulkanParticleSystem::OnRender(const Ref<CommandBuffer>& renderCommandBuffer, void* pushConstants)
+{
+    if (!m_bIsSimulationPending) return;
+
+    const uint32_t currentFrame = GraphicsContext::Get().GetCurrentFrameIndex();
+    const auto& framebuffer     = m_RenderingPipeline->GetSpecification().TargetFramebuffer[currentFrame];
+    GNT_ASSERT(framebuffer, "Nowhere to render particle system!");
+
+    auto vulkanCommandBuffer = std::static_pointer_cast<VulkanCommandBuffer>(renderCommandBuffer);
+
+    // Simulation was submitted before the frame's deferred passes, so by the time this frame reaches particles it's usually done.
+    vulkanCommandBuffer->AddWaitSemaphore(m_SimulationFinishedSemaphores[m_PendingFrame],
+                                          VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+    if (m_bIsAsyncCompute) InsertOwnershipBarrier(vulkanCommandBuffer, false, true);
+
+    renderCommandBuffer->BeginDebugLabel("GPU Rendering Computed Particles", glm::vec4(0.5f, 0.95f, 0.0f, 1.0f));
+
+    auto& renderingShader = m_RenderingPipeline->GetSpecification().Shader;
+    renderingShader->Set("s_Particles", m_ParticlesBuffer);
+    renderingShader->Set("s_SortList", m_SortListBuffer);
+
+    framebuffer->BeginPass(renderCommandBuffer);
+    Renderer::SubmitParticleSystem(renderCommandBuffer, m_RenderingPipeline, m_IndirectArgsBuffer, s_DRAW_ARGS_OFFSET, pushConstants);
+    framebuffer->EndPass(renderCommandBuffer);
+
+    renderCommandBuffer->EndDebugLabel();
+
+    if (m_bIsAsyncCompute) InsertOwnershipBarrier(vulkanCommandBuffer, true, false);
+
+    vulkanCommandBuffer->AddSignalSemaphore(m_ParticlesReleasedSemaphores[currentFrame]);
+    m_bIsReleasedToCompute[currentFrame] = true;
+    m_bIsSimulationPending               = false;
+}
+
+}  // namespace Gauntlet
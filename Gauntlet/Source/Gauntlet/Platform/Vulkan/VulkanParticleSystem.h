@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Gauntlet/Renderer/ParticleSystem.h"
+
+#include <volk/volk.h>
+
+namespace Gauntlet
+{
+
+class VulkanCommandBuffer;
+
+class VulkanParticleSystem final : public ParticleSystem
+{
+  public:
+    VulkanParticleSystem();
+    ~VulkanParticleSystem() = default;
+
+    void Destroy() final override;
+
+    void OnCompute(const uint32_t poolSize) final override;
+    void OnRender(const Ref<CommandBuffer>& renderCommandBuffer, void* pushConstants = nullptr) final override;
+
+  protected:
+    void InsertSimulationBarrier(const Ref<CommandBuffer>& computeCommandBuffer) const final override;
+
+  private:
+    // Signaled by the simulation, waited by the frame that renders its output.
+    std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> m_SimulationFinishedSemaphores = {VK_NULL_HANDLE};
+    // Signaled by the frame that rendered particles, waited by the next simulation, since the pool is shared by frames.
+    std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> m_ParticlesReleasedSemaphores = {VK_NULL_HANDLE};
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> m_bIsReleasedToCompute               = {false};
+
+    bool m_bIsAsyncCompute      = false;  // Separate compute queue family requires buffer ownership transfers.
+    bool m_bIsSimulationPending = false;  // Simulation was submitted, but its output hasn't been rendered yet.
+    uint32_t m_PendingFrame     = 0;
+
+    void CreateSemaphores();
+    void DestroySemaphores();
+
+    // Transfers buffers read by graphics queue(particles, sort list && indirect args).
+    void InsertOwnershipBarrier(const Ref<VulkanCommandBuffer>& commandBuffer, const bool bToCompute, const bool bAcquire) const;
+};
+
+}  // namespace Gauntlet
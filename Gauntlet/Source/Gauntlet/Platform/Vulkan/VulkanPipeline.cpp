@@ -8,6 +8,8 @@
 #include "VulkanSwapchain.h"
 #include "VulkanImage.h"
 
+#include "Gauntlet/Core/Profiler.h"
+
 namespace Gauntlet
 {
 
@@ -18,6 +20,8 @@ VulkanPipeline::VulkanPipeline(const PipelineSpecification& pipelineSpecificatio
 
 void VulkanPipeline::Invalidate()
 {
+    GNT_PROFILE_FUNCTION();
+
     if (m_Handle) Destroy();
 
     CreateLayout();
@@ -191,7 +195,13 @@ void VulkanPipeline::Create()
 
             auto vulkanFramebuffer = std::static_pointer_cast<VulkanFramebuffer>(
                 m_Specification.TargetFramebuffer[context.GetCurrentFrameIndex()]);  // it doesn't matter which framebuffer to take
-            uint32_t attachmentCount = (uint32_t)vulkanFramebuffer->GetAttachments().size();
+
+            // Framebuffers that render into attachments of others don't own any, formats come from the existing ones.
+            std::vector<FramebufferAttachmentSpecification> attachmentSpecs = vulkanFramebuffer->GetSpecification().Attachments;
+            for (const auto& existingAttachment : vulkanFramebuffer->GetSpecification().ExistingAttachments)
+                attachmentSpecs.push_back(existingAttachment.Specification);
+
+            uint32_t attachmentCount = (uint32_t)attachmentSpecs.size();
             if (vulkanFramebuffer->GetDepthAttachment()) --attachmentCount;
 
             for (uint32_t i = 0; i < attachmentCount; ++i)
@@ -286,7 +296,7 @@ void VulkanPipeline::Create()
             std::vector<VkFormat> colorAttachmentFormats;
             VkFormat depthAttachmentFormat   = VK_FORMAT_UNDEFINED;
             VkFormat stencilAttachmentFormat = VK_FORMAT_UNDEFINED;  // TODO: Fill stencil
-            for (auto& attachment : m_Specification.TargetFramebuffer[context.GetCurrentFrameIndex()]->GetSpecification().Attachments)
+            for (auto& attachment : attachmentSpecs)
             {
                 depthAttachmentFormat = depthAttachmentFormat == VK_FORMAT_UNDEFINED && ImageUtils::IsDepthFormat(attachment.Format)
                                             ? ImageUtils::GauntletImageFormatToVulkan(attachment.Format)
@@ -0,0 +1,187 @@
+#include "GauntletPCH.h"
+#include "VulkanRenderGraph.h"
+
+#include "VulkanContext.h"
+#include "VulkanAllocator.h"
+#include "VulkanImage.h"
+#include "VulkanCommandBuffer.h"
+
+#include "Gauntlet/Renderer/Renderer.h"
+
+namespace Gauntlet
+{
+
+struct VulkanResourceState
+{
+    VkPipelineStageFlags Stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    VkAccessFlags Access       = 0;
+    VkImageLayout Layout       = VK_IMAGE_LAYOUT_UNDEFINED;
+};
+
+// Storage images never leave general layout, since they're both written && sampled.
+static VulkanResourceState GetVulkanResourceState(const ERenderGraphResourceState state, const bool bIsStorageImage)
+{
+    const VkImageLayout shaderReadLayout = bIsStorageImage ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    switch (state)
+    {
+        case ERenderGraphResourceState::UNDEFINED: return {VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED};
+        case ERenderGraphResourceState::COLOR_ATTACHMENT:
+            return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+        case ERenderGraphResourceState::DEPTH_ATTACHMENT:
+            return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL};
+        case ERenderGraphResourceState::FRAGMENT_SHADER_READ:
+            return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, shaderReadLayout};
+        case ERenderGraphResourceState::COMPUTE_SHADER_READ:
+            return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, shaderReadLayout};
+        case ERenderGraphResourceState::COMPUTE_SHADER_WRITE:
+            return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL};
+    }
+
+    GNT_ASSERT(false, "Unknown render graph resource state!");
+    return {};
+}
+
+bool VulkanRenderGraph::IsAllocated(const Ref<Image>& image) const
+{
+    auto vulkanImage = std::static_pointer_cast<VulkanImage>(image);
+    GNT_ASSERT(vulkanImage, "Failed to cast Image to VulkanImage!");
+
+    return vulkanImage->IsMemoryBound();
+}
+
+RenderGraph::MemoryRequirements VulkanRenderGraph::GetMemoryRequirements(const Ref<Image>& image) const
+{
+    auto vulkanImage = std::static_pointer_cast<VulkanImage>(image);
+    GNT_ASSERT(vulkanImage, "Failed to cast Image to VulkanImage!");
+
+    const auto vulkanMemoryRequirements = vulkanImage->GetMemoryRequirements();
+
+    MemoryRequirements memoryRequirements = {};
+    memoryRequirements.Size               = vulkanMemoryRequirements.size;
+    memoryRequirements.Alignment          = vulkanMemoryRequirements.alignment;
+    memoryRequirements.MemoryTypeBits     = vulkanMemoryRequirements.memoryTypeBits;
+    return memoryRequirements;
+}
+
+void VulkanRenderGraph::AllocateTransientMemory(const std::vector<MemoryBlock>& memoryBlocks)
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    for (const auto& memoryBlock : memoryBlocks)
+    {
+        VkMemoryRequirements memoryRequirements = {};
+        memoryRequirements.size                 = memoryBlock.Requirements.Size;
+        memoryRequirements.alignment            = memoryBlock.Requirements.Alignment;
+        memoryRequirements.memoryTypeBits       = memoryBlock.Requirements.MemoryTypeBits;
+
+        const auto allocation = context.GetAllocator()->AllocateMemory(memoryRequirements);
+        m_MemoryBlocks.push_back(allocation);
+
+        for (const auto resourceIndex : memoryBlock.Resources)
+        {
+            auto vulkanImage = std::static_pointer_cast<VulkanImage>(m_Resources[resourceIndex].Image);
+            vulkanImage->BindMemory(allocation, 0);
+
+            m_BoundImages.push_back(m_Resources[resourceIndex].Image);
+        }
+    }
+}
+
+void VulkanRenderGraph::ReleaseTransientMemory()
+{
+    if (m_MemoryBlocks.empty()) return;
+
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    {
+        GRAPHICS_GUARD_LOCK;
+        context.WaitDeviceOnFinish();
+    }
+
+    // Vulkan images can't be rebound, so they're recreated without memory.
+    for (auto& image : m_BoundImages)
+    {
+        if (IsAllocated(image)) image->Invalidate();
+    }
+
+    for (auto& memoryBlock : m_MemoryBlocks)
+        context.GetAllocator()->FreeMemory(memoryBlock);
+
+    m_BoundImages.clear();
+    m_MemoryBlocks.clear();
+}
+
+void VulkanRenderGraph::Destroy()
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    context.WaitDeviceOnFinish();
+
+    for (auto& memoryBlock : m_MemoryBlocks)
+        context.GetAllocator()->FreeMemory(memoryBlock);
+
+    m_BoundImages.clear();
+    m_MemoryBlocks.clear();
+    Reset();
+}
+
+void VulkanRenderGraph::InsertBarriers(const Ref<CommandBuffer>& commandBuffer, const std::vector<ResourceTransition>& transitions)
+{
+    auto vulkanCommandBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
+    GNT_ASSERT(vulkanCommandBuffer, "Failed to cast CommandBuffer to VulkanCommandBuffer");
+
+    VkPipelineStageFlags srcStageMask = 0;
+    VkPipelineStageFlags dstStageMask = 0;
+
+    // Buffers don't have layouts, so a single global barrier covers all of them.
+    VkMemoryBarrier memoryBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    for (const auto& transition : transitions)
+    {
+        const auto& resource       = m_Resources[transition.Resource];
+        const bool bIsStorageImage = resource.Image && resource.Image->GetSpecification().Usage == EImageUsage::STORAGE;
+
+        const auto oldState = GetVulkanResourceState(transition.OldState, bIsStorageImage);
+        const auto newState = GetVulkanResourceState(transition.NewState, bIsStorageImage);
+
+        // Memory is taken over from aliased image, its last accesses should finish first.
+        const auto aliasState = GetVulkanResourceState(transition.AliasState, false);
+
+        srcStageMask |= oldState.Stage | aliasState.Stage;
+        dstStageMask |= newState.Stage;
+
+        if (!resource.Image)
+        {
+            memoryBarrier.srcAccessMask |= oldState.Access;
+            memoryBarrier.dstAccessMask |= newState.Access;
+            continue;
+        }
+
+        auto vulkanImage = std::static_pointer_cast<VulkanImage>(resource.Image);
+        GNT_ASSERT(vulkanImage, "Failed to cast Image to VulkanImage!");
+
+        VkImageMemoryBarrier imageBarrier            = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+        imageBarrier.image                           = vulkanImage->Get();
+        imageBarrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.oldLayout                       = oldState.Layout;
+        imageBarrier.newLayout                       = newState.Layout;
+        imageBarrier.srcAccessMask                   = oldState.Access | aliasState.Access;
+        imageBarrier.dstAccessMask                   = newState.Access;
+        imageBarrier.subresourceRange.baseArrayLayer = 0;
+        imageBarrier.subresourceRange.baseMipLevel   = 0;
+        imageBarrier.subresourceRange.levelCount     = vulkanImage->GetSpecification().Mips;
+        imageBarrier.subresourceRange.layerCount     = vulkanImage->GetSpecification().Layers;
+        imageBarrier.subresourceRange.aspectMask =
+            ImageUtils::IsDepthFormat(vulkanImage->GetSpecification().Format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBarriers.push_back(imageBarrier);
+
+        vulkanImage->SetLayout(newState.Layout);
+    }
+
+    const bool bHasMemoryBarrier = memoryBarrier.srcAccessMask != 0 || memoryBarrier.dstAccessMask != 0;
+    vulkanCommandBuffer->InsertBarrier(srcStageMask, dstStageMask, 0, bHasMemoryBarrier ? 1 : 0, &memoryBarrier, 0, nullptr,
+                                       static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+}
+
+}  // namespace Gauntlet
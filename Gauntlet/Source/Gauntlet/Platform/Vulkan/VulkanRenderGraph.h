@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Gauntlet/Renderer/RenderGraph.h"
+
+#include <volk/volk.h>
+#include <vma/vk_mem_alloc.h>
+
+namespace Gauntlet
+{
+
+class VulkanRenderGraph final : public RenderGraph
+{
+  public:
+    VulkanRenderGraph()  = default;
+    ~VulkanRenderGraph() = default;
+
+    bool IsAllocated(const Ref<Image>& image) const final override;
+    void Destroy() final override;
+
+  private:
+    std::vector<VmaAllocation> m_MemoryBlocks;
+    std::vector<Ref<Image>> m_BoundImages;
+
+    MemoryRequirements GetMemoryRequirements(const Ref<Image>& image) const final override;
+    void AllocateTransientMemory(const std::vector<MemoryBlock>& memoryBlocks) final override;
+    void ReleaseTransientMemory() final override;
+
+    void InsertBarriers(const Ref<CommandBuffer>& commandBuffer, const std::vector<ResourceTransition>& transitions) final override;
+};
+
+}  // namespace Gauntlet
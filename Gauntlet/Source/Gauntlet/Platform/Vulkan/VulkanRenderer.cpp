@@ -42,26 +42,19 @@ VulkanRenderer::~VulkanRenderer()
     vkDestroyDescriptorSetLayout(m_Context.GetDevice()->GetLogicalDevice(), s_Data.ImageDescriptorSetLayout, nullptr);
 }
 
-void VulkanRenderer::BeginImpl()
-{
-    s_Data.CurrentPipelineToBind.reset();
-}
-
-void VulkanRenderer::SubmitParticleSystemImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, Ref<StorageBuffer>& ssbo,
-                                              uint32_t particleCount, void* pushConstants)
+void VulkanRenderer::SubmitParticleSystemImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline,
+                                              const Ref<StorageBuffer>& drawArgsBuffer, const uint64_t drawArgsOffset, void* pushConstants)
 {
     GNT_ASSERT(commandBuffer);
     auto cmdBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
 
     // Prevent same pipeline binding
     auto vulkanPipeline = std::static_pointer_cast<VulkanPipeline>(pipeline);
-    if (!s_Data.CurrentPipelineToBind.lock() || s_Data.CurrentPipelineToBind.lock() != pipeline)
+    if (!cmdBuffer->IsPipelineBound(pipeline))
     {
         cmdBuffer->SetPipelinePolygonMode(vulkanPipeline,
                                           GetSettings().ShowWireframes ? EPolygonMode::POLYGON_MODE_LINE : EPolygonMode::POLYGON_MODE_FILL);
         cmdBuffer->BindPipeline(vulkanPipeline);
-
-        s_Data.CurrentPipelineToBind = pipeline;
     }
 
     if (pushConstants)
@@ -76,25 +69,17 @@ void VulkanRenderer::SubmitParticleSystemImpl(const Ref<CommandBuffer>& commandB
     if (!shaderDescriptorSets.empty())
         cmdBuffer->BindDescriptorSets(vulkanPipeline, 0, static_cast<uint32_t>(shaderDescriptorSets.size()), shaderDescriptorSets.data());
 
-    VkDeviceSize offset = 0;
-    VkBuffer vb         = (VkBuffer)ssbo->Get();
-    cmdBuffer->BindVertexBuffers(0, 1, &vb, &offset);
-
-    cmdBuffer->Draw(particleCount);
+    // Particles are pulled from storage buffers in vertex shader, so no vertex buffers bound.
+    cmdBuffer->DrawIndirect((VkBuffer)drawArgsBuffer->Get(), drawArgsOffset);
     ++Renderer::GetStats().DrawCalls;
 }
 
-void VulkanRenderer::DispatchImpl(Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, void* pushConstants,
-                                  const uint32_t groupCountX, const uint32_t groupCountY, const uint32_t groupCountZ)
+void VulkanRenderer::BindComputeState(const Ref<VulkanCommandBuffer>& cmdBuffer, Ref<Pipeline>& pipeline, void* pushConstants)
 {
-    auto cmdBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
-
     auto vulkanPipeline = std::static_pointer_cast<VulkanPipeline>(pipeline);
-    if (!s_Data.CurrentPipelineToBind.lock() || s_Data.CurrentPipelineToBind.lock() != pipeline)
+    if (!cmdBuffer->IsPipelineBound(pipeline))
     {
         cmdBuffer->BindPipeline(vulkanPipeline);
-
-        s_Data.CurrentPipelineToBind = pipeline;
     }
 
     if (pushConstants)
@@ -108,38 +93,66 @@ void VulkanRenderer::DispatchImpl(Ref<CommandBuffer>& commandBuffer, Ref<Pipelin
 
     if (!shaderDescriptorSets.empty())
         cmdBuffer->BindDescriptorSets(vulkanPipeline, 0, static_cast<uint32_t>(shaderDescriptorSets.size()), shaderDescriptorSets.data());
+}
+
+void VulkanRenderer::DispatchImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, void* pushConstants,
+                                  const uint32_t groupCountX, const uint32_t groupCountY, const uint32_t groupCountZ)
+{
+    auto cmdBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
+    BindComputeState(cmdBuffer, pipeline, pushConstants);
 
     cmdBuffer->Dispatch(groupCountX, groupCountY, groupCountZ);
 }
 
-void VulkanRenderer::SubmitMeshImpl(Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer, Ref<IndexBuffer>& indexBuffer,
-                                    Ref<Material>& material, void* pushConstants)
+void VulkanRenderer::DispatchIndirectImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline,
+                                          const Ref<StorageBuffer>& dispatchArgsBuffer, const uint64_t dispatchArgsOffset,
+                                          void* pushConstants)
+{
+    auto cmdBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
+    BindComputeState(cmdBuffer, pipeline, pushConstants);
+
+    cmdBuffer->DispatchIndirect((VkBuffer)dispatchArgsBuffer->Get(), dispatchArgsOffset);
+}
+
+void VulkanRenderer::SubmitMeshImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer,
+                                    Ref<IndexBuffer>& indexBuffer, Ref<Material>& material, void* pushConstants, const int32_t vertexOffset)
 {
     if (material)
     {
         VkDescriptorSet ds = (VkDescriptorSet)material->GetDescriptorSet();
-        DrawIndexedInternal(pipeline, indexBuffer, vertexBuffer, pushConstants, &ds, 1);
+        DrawIndexedInternal(commandBuffer, pipeline, indexBuffer, vertexBuffer, pushConstants, &ds, 1, vertexOffset);
     }
     else
-        DrawIndexedInternal(pipeline, indexBuffer, vertexBuffer, pushConstants);
+        DrawIndexedInternal(commandBuffer, pipeline, indexBuffer, vertexBuffer, pushConstants, nullptr, 0, vertexOffset);
 }
 
-void VulkanRenderer::DrawIndexedInternal(Ref<Pipeline>& pipeline, const Ref<IndexBuffer>& indexBuffer,
-                                         const Ref<VertexBuffer>& vertexBuffer, void* pushConstants, VkDescriptorSet* descriptorSets,
-                                         const uint32_t descriptorCount)
+void VulkanRenderer::InsertComputeToVertexInputBarrierImpl(const Ref<CommandBuffer>& commandBuffer)
 {
-    GNT_ASSERT(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
-    auto cmdBuffer = std::static_pointer_cast<VulkanCommandBuffer>(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+    auto cmdBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
+
+    // Global barrier, vertices written by compute are fetched by every following pass.
+    VkMemoryBarrier memoryBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    memoryBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask   = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+    cmdBuffer->InsertBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
+                             nullptr);
+}
+
+void VulkanRenderer::DrawIndexedInternal(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline,
+                                         const Ref<IndexBuffer>& indexBuffer, const Ref<VertexBuffer>& vertexBuffer, void* pushConstants,
+                                         VkDescriptorSet* descriptorSets, const uint32_t descriptorCount, const int32_t vertexOffset)
+{
+    GNT_ASSERT(commandBuffer);
+    auto cmdBuffer = std::static_pointer_cast<VulkanCommandBuffer>(commandBuffer);
 
     // Prevent same pipeline binding
     auto vulkanPipeline = std::static_pointer_cast<VulkanPipeline>(pipeline);
-    if (!s_Data.CurrentPipelineToBind.lock() || s_Data.CurrentPipelineToBind.lock() != pipeline)
+    if (!cmdBuffer->IsPipelineBound(pipeline))
     {
         cmdBuffer->SetPipelinePolygonMode(vulkanPipeline,
                                           GetSettings().ShowWireframes ? EPolygonMode::POLYGON_MODE_LINE : EPolygonMode::POLYGON_MODE_FILL);
         cmdBuffer->BindPipeline(vulkanPipeline);
-
-        s_Data.CurrentPipelineToBind = pipeline;
     }
 
     if (pushConstants)
@@ -168,7 +181,7 @@ void VulkanRenderer::DrawIndexedInternal(Ref<Pipeline>& pipeline, const Ref<Inde
 
     VkBuffer ib = (VkBuffer)indexBuffer->Get();
     cmdBuffer->BindIndexBuffer(ib);
-    cmdBuffer->DrawIndexed(static_cast<uint32_t>(indexBuffer->GetCount()));
+    cmdBuffer->DrawIndexed(static_cast<uint32_t>(indexBuffer->GetCount()), 1, 0, vertexOffset);
     ++Renderer::GetStats().DrawCalls;
 }
 
@@ -178,11 +191,9 @@ void VulkanRenderer::SubmitFullscreenQuadImpl(Ref<Pipeline>& pipeline, void* pus
     auto cmdBuffer = std::static_pointer_cast<VulkanCommandBuffer>(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
 
     auto vulkanPipeline = std::static_pointer_cast<VulkanPipeline>(pipeline);
-    if (!s_Data.CurrentPipelineToBind.lock() || s_Data.CurrentPipelineToBind.lock() != pipeline)
+    if (!cmdBuffer->IsPipelineBound(pipeline))
     {
         cmdBuffer->BindPipeline(vulkanPipeline);
-
-        s_Data.CurrentPipelineToBind = pipeline;
     }
 
     if (pushConstants)
@@ -207,14 +218,12 @@ void VulkanRenderer::DrawQuadImpl(Ref<Pipeline>& pipeline, Ref<VertexBuffer>& ve
     auto cmdBuffer = std::static_pointer_cast<VulkanCommandBuffer>(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
 
     auto vulkanPipeline = std::static_pointer_cast<VulkanPipeline>(pipeline);
-    if (!s_Data.CurrentPipelineToBind.lock() || s_Data.CurrentPipelineToBind.lock() != pipeline)
+    if (!cmdBuffer->IsPipelineBound(pipeline))
     {
 
         cmdBuffer->SetPipelinePolygonMode(vulkanPipeline, Renderer::GetSettings().ShowWireframes ? EPolygonMode::POLYGON_MODE_LINE
                                                                                                  : EPolygonMode::POLYGON_MODE_FILL);
         cmdBuffer->BindPipeline(vulkanPipeline);
-
-        s_Data.CurrentPipelineToBind = pipeline;
     }
 
     VkDeviceSize Offset = 0;
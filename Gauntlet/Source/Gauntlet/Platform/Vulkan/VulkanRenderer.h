@@ -10,6 +10,7 @@ namespace Gauntlet
 {
 
 class VulkanContext;
+class VulkanCommandBuffer;
 
 class VulkanRenderer final : public Renderer
 {
@@ -18,9 +19,6 @@ class VulkanRenderer final : public Renderer
     {
         // UI
         VkDescriptorSetLayout ImageDescriptorSetLayout = VK_NULL_HANDLE;
-
-        // Misc
-        Weak<Pipeline> CurrentPipelineToBind;
     };
 
   public:
@@ -28,15 +26,20 @@ class VulkanRenderer final : public Renderer
     ~VulkanRenderer();
 
     // TODO: mb simply submit the whole particle system class?
-    void SubmitParticleSystemImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, Ref<StorageBuffer>& ssbo,
-                                  uint32_t particleCount, void* pushConstants = nullptr) final override;
+    void SubmitParticleSystemImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline,
+                                  const Ref<StorageBuffer>& drawArgsBuffer, const uint64_t drawArgsOffset,
+                                  void* pushConstants = nullptr) final override;
 
-    void BeginImpl() final override;
-    void DispatchImpl(Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, void* pushConstants = nullptr,
+    void DispatchImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, void* pushConstants = nullptr,
                       const uint32_t groupCountX = 1, const uint32_t groupCountY = 1, const uint32_t groupCountZ = 1) final override;
-
-    void SubmitMeshImpl(Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer, Ref<IndexBuffer>& indexBuffer, Ref<Material>& material,
-                        void* pushConstants = nullptr) final override;
+    void DispatchIndirectImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline,
+                              const Ref<StorageBuffer>& dispatchArgsBuffer, const uint64_t dispatchArgsOffset,
+                              void* pushConstants = nullptr) final override;
+
+    void SubmitMeshImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer,
+                        Ref<IndexBuffer>& indexBuffer, Ref<Material>& material, void* pushConstants = nullptr,
+                        const int32_t vertexOffset = 0) final override;
+    void InsertComputeToVertexInputBarrierImpl(const Ref<CommandBuffer>& commandBuffer) final override;
     void SubmitFullscreenQuadImpl(Ref<Pipeline>& pipeline, void* pushConstants = nullptr) final override;
 
     void DrawQuadImpl(Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer, Ref<IndexBuffer>& indexBuffer, const uint32_t indicesCount,
@@ -49,9 +52,12 @@ class VulkanRenderer final : public Renderer
 
     inline static VulkanRendererStorage s_Data;
 
+    void BindComputeState(const Ref<VulkanCommandBuffer>& cmdBuffer, Ref<Pipeline>& pipeline, void* pushConstants);
+
     // TODO: In future this will be refactored since it assumes I'm not using offsets and multiple descriptor sets.
-    void DrawIndexedInternal(Ref<Pipeline>& pipeline, const Ref<IndexBuffer>& indexBuffer, const Ref<VertexBuffer>& vertexBuffer,
-                             void* pushConstants = nullptr, VkDescriptorSet* descriptorSets = nullptr, const uint32_t descriptorCount = 0);
+    void DrawIndexedInternal(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, const Ref<IndexBuffer>& indexBuffer,
+                             const Ref<VertexBuffer>& vertexBuffer, void* pushConstants = nullptr,
+                             VkDescriptorSet* descriptorSets = nullptr, const uint32_t descriptorCount = 0, const int32_t vertexOffset = 0);
 };
 
 }  // namespace Gauntlet
\ No newline at end of file
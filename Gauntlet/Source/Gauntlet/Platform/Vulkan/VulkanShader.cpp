@@ -11,6 +11,7 @@
 #include "Gauntlet/Renderer/CoreRendererTypes.h"
 
 #include "Gauntlet/Core/Timer.h"
+#include "Gauntlet/Core/Profiler.h"
 
 // For compiling
 #include <shaderc/shaderc.hpp>
@@ -138,6 +139,8 @@ void PrintDescriptorSet(const SpvReflectDescriptorSet& obj)
 std::vector<uint8_t> VulkanShader::CompileOrGetSpvBinaries(const std::string& shaderExt, const std::string& filePath,
                                                            const std::string& shaderSourcePath, const std::string& shaderCachePathStr)
 {
+    GNT_PROFILE_FUNCTION();
+
     std::vector<uint8_t> spvData;
     std::filesystem::path shaderCachePath(shaderCachePathStr + '.' + shaderExt + '.' + "spv");
 
@@ -285,7 +288,7 @@ VulkanShader::VulkanShader(const std::string_view& filePath)
     for (uint32_t i = 0; i < m_DescriptorSetLayouts.size(); ++i)
     {
         auto& descriptorSets = m_DescriptorSets.emplace_back();
-        for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+        for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
         {
             GNT_ASSERT(context.GetDescriptorAllocator()->Allocate(descriptorSets[frame], m_DescriptorSetLayouts[i]),
                        "Failed to allocate descriptor set for shader needs!");
@@ -613,6 +616,18 @@ void VulkanShader::Set(const std::string& name, const Ref<StorageBuffer>& ssbo,
     UpdateDescriptorSets(name, writeDescriptorSet);
 }
 
+void VulkanShader::Set(const std::string& name, const Ref<VertexBuffer>& vertexBuffer)
+{
+    GNT_ASSERT(!name.empty() && vertexBuffer, "Invalid parameters! VulkanShader::Set()");
+
+    auto descriptorBufferInfo = Utility::GetDescriptorBufferInfo((VkBuffer)vertexBuffer->Get(), VK_WHOLE_SIZE);
+
+    VkWriteDescriptorSet writeDescriptorSet = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    writeDescriptorSet.pBufferInfo          = &descriptorBufferInfo;
+
+    UpdateDescriptorSets(name, writeDescriptorSet);
+}
+
 void VulkanShader::UpdateDescriptorSets(const std::string& name, VkWriteDescriptorSet& writeDescriptorSet)
 {
     GNT_ASSERT(!m_DescriptorSets.empty(), "m_DescriptorSets.size() == 0!");
@@ -52,6 +52,7 @@ class VulkanShader final : public Shader
     void Set(const std::string& name, const std::vector<Ref<Texture2D>>& textures) final override;
     void Set(const std::string& name, const Ref<UniformBuffer>& uniformBuffer, const uint64_t offset = 0) final override;
     void Set(const std::string& name, const Ref<StorageBuffer>& ssbo, const uint64_t offset = 0) final override;
+    void Set(const std::string& name, const Ref<VertexBuffer>& vertexBuffer) final override;
 
     FORCEINLINE const auto& GetDescriptorSets() const { return m_DescriptorSets; }
 
@@ -62,7 +63,7 @@ class VulkanShader final : public Shader
 
     std::vector<VkPushConstantRange> m_PushConstants;
     std::vector<VkDescriptorSetLayout> m_DescriptorSetLayouts;
-    std::vector<std::array<DescriptorSet, FRAMES_IN_FLIGHT>> m_DescriptorSets;  // For each descriptor set layout
+    std::vector<std::array<DescriptorSet, MAX_FRAMES_IN_FLIGHT>> m_DescriptorSets;  // For each descriptor set layout
 
     VkShaderModule LoadShaderModule(const std::vector<uint8_t>& shaderCode);
     void Reflect(const std::vector<uint8_t>& shaderCode);
@@ -11,15 +11,17 @@
 #include "SwapchainSupportDetails.h"
 
 #include "Gauntlet/Core/Timer.h"
+#include "Gauntlet/Core/Profiler.h"
 
 namespace Gauntlet
 {
 
 VulkanSwapchain::VulkanSwapchain(Scoped<VulkanDevice>& device, VkSurfaceKHR& surface) : m_Device(device), m_Surface(surface)
 {
+    m_FramesInFlight = std::clamp(Renderer::GetSettings().FramesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
     Invalidate();
 
-    m_CommandBuffers.resize(FRAMES_IN_FLIGHT);
+    m_CommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
     for (auto& commandBuffer : m_CommandBuffers)
     {
         commandBuffer = MakeRef<VulkanCommandBuffer>(ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS);
@@ -48,6 +50,15 @@ void VulkanSwapchain::BeginRenderPass(const VkCommandBuffer& commandBuffer)
 
 bool VulkanSwapchain::TryAcquireNextImage(const VkSemaphore& imageAcquiredSemaphore, const VkFence& fence)
 {
+    // Context has waited for this frame's fence, so frames that could reference retired resources are done.
+    DestroyRetiredResources(false);
+
+    if (IsHeadless())
+    {
+        m_ImageIndex = m_FrameIndex;
+        return true;
+    }
+
     const auto result =
         vkAcquireNextImageKHR(m_Device->GetLogicalDevice(), m_Swapchain, UINT64_MAX, imageAcquiredSemaphore, fence, &m_ImageIndex);
     if (result == VK_SUCCESS) return true;
@@ -65,6 +76,16 @@ bool VulkanSwapchain::TryAcquireNextImage(const VkSemaphore& imageAcquiredSemaph
 
 void VulkanSwapchain::PresentImage(const VkSemaphore& renderFinishedSemaphore)
 {
+    GNT_PROFILE_FUNCTION();
+
+    if (IsHeadless())
+    {
+        Renderer::GetStats().PresentTime = 0.0f;
+        m_FrameIndex                     = (m_FrameIndex + 1) % m_FramesInFlight;
+        ++m_FrameCounter;
+        return;
+    }
+
     VkPresentInfoKHR presentInfo   = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
     presentInfo.waitSemaphoreCount = 1;
     presentInfo.pWaitSemaphores    = &renderFinishedSemaphore;
@@ -72,38 +93,91 @@ void VulkanSwapchain::PresentImage(const VkSemaphore& renderFinishedSemaphore)
     presentInfo.swapchainCount     = 1;
     presentInfo.pSwapchains        = &m_Swapchain;
 
+    const uint64_t presentID    = m_PresentID + 1;
+    VkPresentIdKHR presentIdKHR = {VK_STRUCTURE_TYPE_PRESENT_ID_KHR};
+    if (m_Device->IsPresentWaitSupported())
+    {
+        presentIdKHR.swapchainCount = 1;
+        presentIdKHR.pPresentIds    = &presentID;
+        presentInfo.pNext           = &presentIdKHR;
+    }
+
     const float imagePresentBegin = static_cast<float>(Timer::Now());
 
-    const auto result = vkQueuePresentKHR(m_Device->GetPresentQueue(), &presentInfo);
+    VkResult result = VK_SUCCESS;
+    {
+        // Present queue may be the one streaming threads upload through.
+        GRAPHICS_GUARD_LOCK;
+        result = vkQueuePresentKHR(m_Device->GetPresentQueue(), &presentInfo);
+    }
 
     const float imagePresentEnd      = static_cast<float>(Timer::Now());
     Renderer::GetStats().PresentTime = imagePresentEnd - imagePresentBegin;
 
     if (result == VK_SUCCESS)
     {
-        m_FrameIndex = (m_FrameIndex + 1) % FRAMES_IN_FLIGHT;
+        m_FrameIndex = (m_FrameIndex + 1) % m_FramesInFlight;
+        m_PresentID  = presentID;
+        ++m_FrameCounter;
         return;
     }
 
     Recreate();
 }
 
-void VulkanSwapchain::Invalidate()
+bool VulkanSwapchain::WaitForPresent(const uint64_t presentID, const uint64_t timeout) const
+{
+    if (IsHeadless() || !m_Device->IsPresentWaitSupported() || presentID < m_FirstPresentID) return false;
+
+    // Out of date && surface lost are handled by the next acquire/present, frame just isn't delayed.
+    return vkWaitForPresentKHR(m_Device->GetLogicalDevice(), m_Swapchain, presentID, timeout) == VK_SUCCESS;
+}
+
+void VulkanSwapchain::SetFramesInFlight(const uint32_t framesInFlight)
+{
+    m_FramesInFlight = framesInFlight;
+
+    // Image count depends on frames in flight.
+    if (IsHeadless())
+    {
+        m_ImageIndex = 0;
+        m_FrameIndex = 0;
+    }
+    else
+        Invalidate();
+}
+
+void VulkanSwapchain::Invalidate(const bool bRetireOldResources)
 {
     auto& Context = (VulkanContext&)VulkanContext::Get();
     GNT_ASSERT(Context.GetDevice()->IsValid(), "Vulkan device is not valid!");
 
+    m_PresentModeSetting = Renderer::GetSettings().PresentMode;
+    if (IsHeadless())
+    {
+        InvalidateOffscreen();
+        return;
+    }
+
     const auto OldSwapchain = m_Swapchain;
-    if (OldSwapchain)
+    if (OldSwapchain && bRetireOldResources)
+        RetireResources();
+    else if (OldSwapchain)
     {
+        DestroyRetiredResources(true);
         for (auto& ImageView : m_SwapchainImageViews)
         {
             vkDestroyImageView(m_Device->GetLogicalDevice(), ImageView, nullptr);
         }
     }
 
-    m_ImageIndex = 0;
-    m_FrameIndex = 0;
+    // Retired path keeps frame indices, fences && per frame resources of frames in flight stay consistent.
+    if (!bRetireOldResources)
+    {
+        m_ImageIndex = 0;
+        m_FrameIndex = 0;
+    }
+    m_FirstPresentID = m_PresentID + 1;
 
     VkSwapchainCreateInfoKHR SwapchainCreateInfo = {VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR};
     SwapchainCreateInfo.compositeAlpha           = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
@@ -119,12 +193,11 @@ void VulkanSwapchain::Invalidate()
     SwapchainCreateInfo.imageColorSpace = m_SwapchainImageFormat.colorSpace;
     SwapchainCreateInfo.imageFormat     = m_SwapchainImageFormat.format;
 
-    m_CurrentPresentMode            = Details.ChooseBestPresentMode(Details.PresentModes, Application::Get().GetWindow()->IsVSync());
+    m_CurrentPresentMode =
+        Details.ChooseBestPresentMode(Details.PresentModes, Application::Get().GetWindow()->IsVSync(), m_PresentModeSetting);
     SwapchainCreateInfo.presentMode = m_CurrentPresentMode;
 
-    GNT_ASSERT(Details.SurfaceCapabilities.maxImageCount > 0, "Swapchain max image count less than zero!");
-    m_SwapchainImageCount             = std::clamp(Details.SurfaceCapabilities.minImageCount + 1, Details.SurfaceCapabilities.minImageCount,
-                                                   Details.SurfaceCapabilities.maxImageCount);
+    m_SwapchainImageCount             = Details.ChooseImageCount(Details.SurfaceCapabilities, m_CurrentPresentMode, m_FramesInFlight);
     SwapchainCreateInfo.minImageCount = m_SwapchainImageCount;
 
     m_SwapchainImageExtent =
@@ -150,7 +223,7 @@ void VulkanSwapchain::Invalidate()
     VK_CHECK(vkCreateSwapchainKHR(m_Device->GetLogicalDevice(), &SwapchainCreateInfo, nullptr, &m_Swapchain),
              "Failed to create vulkan swapchain!");
 
-    if (OldSwapchain) vkDestroySwapchainKHR(m_Device->GetLogicalDevice(), OldSwapchain, nullptr);
+    if (OldSwapchain && !bRetireOldResources) vkDestroySwapchainKHR(m_Device->GetLogicalDevice(), OldSwapchain, nullptr);
 
     VK_CHECK(vkGetSwapchainImagesKHR(m_Device->GetLogicalDevice(), m_Swapchain, &m_SwapchainImageCount, nullptr),
              "Failed to retrieve swapchain images !");
@@ -172,11 +245,18 @@ void VulkanSwapchain::Invalidate()
 
 void VulkanSwapchain::Destroy()
 {
-    vkDestroySwapchainKHR(m_Device->GetLogicalDevice(), m_Swapchain, nullptr);
+    DestroyRetiredResources(true);
 
-    for (auto& ImageView : m_SwapchainImageViews)
+    if (IsHeadless())
+        DestroyOffscreen();
+    else
     {
-        vkDestroyImageView(m_Device->GetLogicalDevice(), ImageView, nullptr);
+        vkDestroySwapchainKHR(m_Device->GetLogicalDevice(), m_Swapchain, nullptr);
+
+        for (auto& ImageView : m_SwapchainImageViews)
+        {
+            vkDestroyImageView(m_Device->GetLogicalDevice(), ImageView, nullptr);
+        }
     }
 
     DestroyRenderPass();
@@ -198,7 +278,7 @@ void VulkanSwapchain::InvalidateRenderPass()
         ColorAttachmentDesc.stencilLoadOp           = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         ColorAttachmentDesc.stencilStoreOp          = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         ColorAttachmentDesc.initialLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
-        ColorAttachmentDesc.finalLayout             = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        ColorAttachmentDesc.finalLayout             = IsHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
         VkAttachmentReference ColorAttachmentRef = {};
         ColorAttachmentRef.attachment            = 0;
@@ -259,6 +339,90 @@ void VulkanSwapchain::DestroyRenderPass()
         vkDestroyFramebuffer(m_Device->GetLogicalDevice(), Framebuffer, nullptr);
 }
 
+// Command buffers of frames in flight may still reference them && presentation engine may still hold old images.
+void VulkanSwapchain::RetireResources()
+{
+    RetiredResources retiredResources = {};
+    retiredResources.Swapchain        = m_Swapchain;
+    retiredResources.RenderPass       = m_RenderPass;
+    retiredResources.Framebuffers     = std::move(m_Framebuffers);
+    retiredResources.ImageViews       = std::move(m_SwapchainImageViews);
+    retiredResources.RetiredFrame     = m_FrameCounter;
+    m_RetiredResources.push_back(std::move(retiredResources));
+
+    m_RenderPass = VK_NULL_HANDLE;
+    m_Framebuffers.clear();
+    m_SwapchainImageViews.clear();
+}
+
+void VulkanSwapchain::DestroyRetiredResources(const bool bForce)
+{
+    const auto& logicalDevice = m_Device->GetLogicalDevice();
+    for (auto it = m_RetiredResources.begin(); it != m_RetiredResources.end();)
+    {
+        // Frames in flight may have been changed since, so the max is waited out.
+        if (!bForce && m_FrameCounter - it->RetiredFrame <= MAX_FRAMES_IN_FLIGHT)
+        {
+            ++it;
+            continue;
+        }
+
+        for (auto& framebuffer : it->Framebuffers)
+            vkDestroyFramebuffer(logicalDevice, framebuffer, nullptr);
+
+        for (auto& imageView : it->ImageViews)
+            vkDestroyImageView(logicalDevice, imageView, nullptr);
+
+        vkDestroyRenderPass(logicalDevice, it->RenderPass, nullptr);
+        vkDestroySwapchainKHR(logicalDevice, it->Swapchain, nullptr);
+        it = m_RetiredResources.erase(it);
+    }
+}
+
+// Same format && extent the window would get, so headless frames match windowed ones in cost.
+void VulkanSwapchain::InvalidateOffscreen()
+{
+    DestroyOffscreen();
+
+    m_ImageIndex = 0;
+    m_FrameIndex = 0;
+
+    m_SwapchainImageFormat = {VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+    m_CurrentPresentMode   = VK_PRESENT_MODE_IMMEDIATE_KHR;
+    m_SwapchainImageExtent = {Application::Get().GetWindow()->GetWidth(), Application::Get().GetWindow()->GetHeight()};
+    m_SwapchainImageCount  = MAX_FRAMES_IN_FLIGHT;
+
+    m_OffscreenImages.resize(m_SwapchainImageCount);
+    m_SwapchainImages.resize(m_SwapchainImageCount);
+    m_SwapchainImageViews.resize(m_SwapchainImageCount);
+    for (uint32_t i = 0; i < m_SwapchainImageCount; ++i)
+    {
+        ImageUtils::CreateImage(&m_OffscreenImages[i], m_SwapchainImageExtent.width, m_SwapchainImageExtent.height,
+                                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, m_SwapchainImageFormat.format);
+        ImageUtils::CreateImageView(m_Device->GetLogicalDevice(), m_OffscreenImages[i].Image, &m_OffscreenImages[i].ImageView,
+                                    m_SwapchainImageFormat.format, VK_IMAGE_ASPECT_COLOR_BIT);
+
+        m_SwapchainImages[i]     = m_OffscreenImages[i].Image;
+        m_SwapchainImageViews[i] = m_OffscreenImages[i].ImageView;
+    }
+
+    InvalidateRenderPass();
+}
+
+void VulkanSwapchain::DestroyOffscreen()
+{
+    auto& context = (VulkanContext&)VulkanContext::Get();
+    for (auto& offscreenImage : m_OffscreenImages)
+    {
+        vkDestroyImageView(m_Device->GetLogicalDevice(), offscreenImage.ImageView, nullptr);
+        context.GetAllocator()->DestroyImage(offscreenImage.Image, offscreenImage.Allocation);
+    }
+
+    m_OffscreenImages.clear();
+    m_SwapchainImages.clear();
+    m_SwapchainImageViews.clear();
+}
+
 void VulkanSwapchain::Recreate()
 {
     if (Application::Get().GetWindow()->IsMinimized()) return;
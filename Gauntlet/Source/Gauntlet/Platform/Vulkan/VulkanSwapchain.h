@@ -5,6 +5,7 @@
 #include <volk/volk.h>
 
 #include "VulkanFramebuffer.h"
+#include "VulkanImage.h"
 
 namespace Gauntlet
 {
@@ -20,7 +21,8 @@ class VulkanSwapchain final : private Uncopyable, private Unmovable
     VulkanSwapchain(Scoped<VulkanDevice>& device, VkSurfaceKHR& surface);
     ~VulkanSwapchain() = default;
 
-    FORCEINLINE bool IsValid() const { return m_Swapchain && m_SwapchainImages.size() > 0; }
+    FORCEINLINE bool IsValid() const { return (m_Swapchain || IsHeadless()) && m_SwapchainImages.size() > 0; }
+    FORCEINLINE bool IsHeadless() const { return m_Surface == VK_NULL_HANDLE; }
     FORCEINLINE const auto& GetImageFormat() const { return m_SwapchainImageFormat.format; }
 
     FORCEINLINE const float GetAspectRatio() const
@@ -34,6 +36,9 @@ class VulkanSwapchain final : private Uncopyable, private Unmovable
     FORCEINLINE auto GetCurrentImageIndex() const { return m_ImageIndex; }
     FORCEINLINE auto GetCurrentFrameIndex() const { return m_FrameIndex; }
     FORCEINLINE auto GetImageCount() const { return m_SwapchainImageCount; }
+    FORCEINLINE auto GetFramesInFlight() const { return m_FramesInFlight; }
+    FORCEINLINE auto GetPresentModeSetting() const { return m_PresentModeSetting; }
+    FORCEINLINE auto GetLastPresentID() const { return m_PresentID; }
 
     FORCEINLINE const auto& GetRenderPass() { return m_RenderPass; }
 
@@ -45,13 +50,29 @@ class VulkanSwapchain final : private Uncopyable, private Unmovable
     bool TryAcquireNextImage(const VkSemaphore& imageAcquiredSemaphore, const VkFence& fence = VK_NULL_HANDLE);
     void PresentImage(const VkSemaphore& renderFinishedSemaphore);
 
-    void Invalidate();
+    // Returns false if presentation can't be waited for(VK_KHR_present_wait), ID belongs to an old swapchain or it timed out.
+    bool WaitForPresent(const uint64_t presentID, const uint64_t timeout) const;
+
+    // Device should be idle, frame indices start over.
+    void SetFramesInFlight(const uint32_t framesInFlight);
+
+    // Old swapchain && its resources are either destroyed right away(device should be idle) or retired until frames in flight are done.
+    void Invalidate(const bool bRetireOldResources = false);
     void Destroy();
 
     FORCEINLINE void AddResizeCallback(const std::function<void()>& resizeCallback) { m_ResizeCallbacks.push_back(resizeCallback); }
     FORCEINLINE const auto& GetCommandBuffers() const { return m_CommandBuffers; }
 
   private:
+    struct RetiredResources
+    {
+        VkSwapchainKHR Swapchain = VK_NULL_HANDLE;
+        VkRenderPass RenderPass  = VK_NULL_HANDLE;
+        std::vector<VkFramebuffer> Framebuffers;
+        std::vector<VkImageView> ImageViews;
+        uint64_t RetiredFrame = 0;
+    };
+
     std::vector<ResizeCallback> m_ResizeCallbacks;
     VkSwapchainKHR m_Swapchain = VK_NULL_HANDLE;
 
@@ -69,15 +90,29 @@ class VulkanSwapchain final : private Uncopyable, private Unmovable
 
     std::vector<VkImage> m_SwapchainImages;
     std::vector<VkImageView> m_SwapchainImageViews;
+    std::vector<AllocatedImage> m_OffscreenImages;  // Headless only, they stand in for swapchain images.
 
     uint32_t m_ImageIndex{0};
     uint32_t m_FrameIndex{0};
+    uint32_t m_FramesInFlight{2};
+    EPresentMode m_PresentModeSetting{EPresentMode::PRESENT_MODE_MAILBOX};
+
+    uint64_t m_FrameCounter{0};    // Frames presented so far.
+    uint64_t m_PresentID{0};       // Last presented, IDs are used only if present wait is supported.
+    uint64_t m_FirstPresentID{1};  // First ID presented by current swapchain.
+    std::vector<RetiredResources> m_RetiredResources;
 
     std::vector<Ref<VulkanCommandBuffer>> m_CommandBuffers;
 
     void InvalidateRenderPass();
     void DestroyRenderPass();
 
+    void InvalidateOffscreen();
+    void DestroyOffscreen();
+
+    void RetireResources();
+    void DestroyRetiredResources(const bool bForce);
+
     void Recreate();
 };
 }  // namespace Gauntlet
\ No newline at end of file
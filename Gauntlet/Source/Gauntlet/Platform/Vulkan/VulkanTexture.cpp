@@ -47,6 +47,7 @@ void VulkanTexture2D::Create(const TextureCreateInfo& textureCreateInfo)
     GNT_ASSERT(textureCreateInfo.Data && textureCreateInfo.DataSize > 0, "Not valid texture create info data!");
     auto& Context = (VulkanContext&)VulkanContext::Get();
 
+    UPLOAD_HEAP_GUARD_LOCK;
     auto& stagingBuffer = Renderer::GetStorageData().UploadHeap;
     stagingBuffer->SetData(textureCreateInfo.Data, textureCreateInfo.DataSize);
 
@@ -0,0 +1,484 @@
+#include "GauntletPCH.h"
+#include "Animation.h"
+
+#include <assimp/scene.h>
+
+namespace Gauntlet
+{
+
+// Assimp matrices are row-major, glm ones are column-major.
+static glm::mat4 ToGLMMatrix(const aiMatrix4x4& matrix)
+{
+    glm::mat4 result(1.0f);
+    for (uint32_t row = 0; row < 4; ++row)
+    {
+        for (uint32_t column = 0; column < 4; ++column)
+            result[column][row] = matrix[row][column];
+    }
+    return result;
+}
+
+static NodePose ToNodePose(const aiMatrix4x4& matrix)
+{
+    aiVector3D scale, position;
+    aiQuaternion rotation;
+    matrix.Decompose(scale, rotation, position);
+
+    return {glm::vec3(position.x, position.y, position.z), glm::quat(rotation.w, rotation.x, rotation.y, rotation.z),
+            glm::vec3(scale.x, scale.y, scale.z)};
+}
+
+static glm::mat4 ToMatrix(const NodePose& pose)
+{
+    // Translation * Rotation * Scale
+    glm::mat4 transform = glm::mat4_cast(pose.Rotation);
+    transform[0] *= pose.Scale.x;
+    transform[1] *= pose.Scale.y;
+    transform[2] *= pose.Scale.z;
+    transform[3] = glm::vec4(pose.Translation, 1.0f);
+    return transform;
+}
+
+void Skeleton::Build(const aiNode* rootNode)
+{
+    GNT_ASSERT(rootNode);
+
+    std::vector<std::pair<const aiNode*, int32_t>> stack = {{rootNode, -1}};
+    while (!stack.empty())
+    {
+        const auto [node, parentIndex] = stack.back();
+        stack.pop_back();
+
+        const auto nodeIndex = static_cast<int32_t>(GetNodeCount());
+        NodeNames.emplace_back(node->mName.C_Str());
+        ParentIndices.push_back(parentIndex);
+        BindPoses.push_back(ToNodePose(node->mTransformation));
+        BoneIndices.push_back(-1);
+        NodeIndices.emplace(NodeNames.back(), static_cast<uint32_t>(nodeIndex));
+
+        // Pushed from the last one, so children are visited in their order.
+        for (uint32_t i = node->mNumChildren; i > 0; --i)
+            stack.push_back({node->mChildren[i - 1], nodeIndex});
+    }
+}
+
+int32_t Skeleton::FindNode(const std::string& name) const
+{
+    const auto it = NodeIndices.find(name);
+    return it != NodeIndices.end() ? static_cast<int32_t>(it->second) : -1;
+}
+
+int32_t Skeleton::FindBone(const std::string& name) const
+{
+    const int32_t nodeIndex = FindNode(name);
+    return nodeIndex != -1 ? BoneIndices[nodeIndex] : -1;
+}
+
+int32_t Skeleton::AddBone(const std::string& name, const glm::mat4& offset)
+{
+    const int32_t nodeIndex = FindNode(name);
+    if (nodeIndex == -1)
+    {
+        LOG_WARN("Bone \"%s\" has no node in hierarchy!", name.data());
+        return -1;
+    }
+
+    if (BoneIndices[nodeIndex] == -1)
+    {
+        BoneIndices[nodeIndex] = static_cast<int32_t>(GetBoneCount());
+        BoneOffsets.push_back(offset);
+    }
+
+    return BoneIndices[nodeIndex];
+}
+
+static glm::vec3 Interpolate(const glm::vec3& lhs, const glm::vec3& rhs, const float factor)
+{
+    return glm::mix(lhs, rhs, factor);
+}
+
+// Nlerp is cheaper than slerp && close enough for neighbouring keys, key reduction measures its error against nlerp as well.
+static glm::quat Interpolate(const glm::quat& lhs, const glm::quat& rhs, const float factor)
+{
+    return glm::normalize(lhs * (1.0f - factor) + rhs * factor);
+}
+
+static float KeyError(const glm::vec3& lhs, const glm::vec3& rhs)
+{
+    return glm::distance(lhs, rhs);
+}
+
+// Angle between rotations.
+static float KeyError(const glm::quat& lhs, const glm::quat& rhs)
+{
+    return 2.0f * std::acos(std::min(std::abs(glm::dot(lhs, rhs)), 1.0f));
+}
+
+// Drops keys that interpolation between kept neighbours reproduces within tolerance, constant tracks collapse to a single key.
+template <typename T> static void ReduceKeys(std::vector<float>& times, std::vector<T>& values, const float tolerance)
+{
+    if (values.size() <= 1) return;
+
+    if (std::all_of(values.begin(), values.end(), [&](const T& value) { return KeyError(value, values[0]) <= tolerance; }))
+    {
+        times.resize(1);
+        values.resize(1);
+        return;
+    }
+
+    std::vector<float> reducedTimes = {times[0]};
+    std::vector<T> reducedValues    = {values[0]};
+
+    size_t anchor = 0;
+    for (size_t i = 1; i + 1 < values.size(); ++i)
+    {
+        // Key can go if segment from the last kept key to the next one still passes through every key in between.
+        const float frameLength = times[i + 1] - times[anchor];
+        bool bCanDrop           = true;
+        for (size_t k = anchor + 1; k <= i && bCanDrop; ++k)
+        {
+            const float factor = frameLength > 0.0f ? (times[k] - times[anchor]) / frameLength : 0.0f;
+            bCanDrop           = KeyError(Interpolate(values[anchor], values[i + 1], factor), values[k]) <= tolerance;
+        }
+
+        if (bCanDrop) continue;
+
+        anchor = i;
+        reducedTimes.push_back(times[i]);
+        reducedValues.push_back(values[i]);
+    }
+
+    reducedTimes.push_back(times.back());
+    reducedValues.push_back(values.back());
+
+    times  = std::move(reducedTimes);
+    values = std::move(reducedValues);
+}
+
+static QuantizedVec3Track QuantizeTrack(std::vector<float>&& times, const std::vector<glm::vec3>& values)
+{
+    QuantizedVec3Track track = {};
+    track.Min                = values[0];
+    glm::vec3 max            = values[0];
+    for (const auto& value : values)
+    {
+        track.Min = glm::min(track.Min, value);
+        max       = glm::max(max, value);
+    }
+    track.Extent = max - track.Min;
+    track.Times  = std::move(times);
+
+    track.Values.reserve(values.size());
+    for (const auto& value : values)
+    {
+        auto& key = track.Values.emplace_back();
+        for (glm::length_t i = 0; i < 3; ++i)
+        {
+            const float normalized = track.Extent[i] > 0.0f ? (value[i] - track.Min[i]) / track.Extent[i] : 0.0f;
+            key[i]                 = static_cast<uint16_t>(std::round(glm::clamp(normalized, 0.0f, 1.0f) * 65535.0f));
+        }
+    }
+
+    return track;
+}
+
+static QuantizedQuatTrack QuantizeTrack(std::vector<float>&& times, const std::vector<glm::quat>& values)
+{
+    QuantizedQuatTrack track = {};
+    track.Times              = std::move(times);
+
+    track.Values.reserve(values.size());
+    for (const auto& value : values)
+    {
+        const glm::vec4 components(value.w, value.x, value.y, value.z);
+        auto& key = track.Values.emplace_back();
+        for (glm::length_t i = 0; i < 4; ++i)
+            key[i] = static_cast<int16_t>(std::round(glm::clamp(components[i], -1.0f, 1.0f) * 32767.0f));
+    }
+
+    return track;
+}
+
+template <typename Track> static size_t GetTrackMemorySize(const Track& track)
+{
+    return track.Times.size() * sizeof(track.Times[0]) + track.Values.size() * sizeof(track.Values[0]);
+}
+
+Animation::Animation(const aiAnimation* animation, const Skeleton& skeleton, const AnimationImportSettings& settings)
+    : m_Name(animation->mName.C_Str()), m_Duration(static_cast<float>(animation->mDuration))
+{
+    if (animation->mTicksPerSecond > 0.0) m_TicksPerSecond = static_cast<float>(animation->mTicksPerSecond);
+
+    m_Channels.reserve(animation->mNumChannels);
+    for (uint32_t i = 0; i < animation->mNumChannels; ++i)
+    {
+        const aiNodeAnim* nodeAnim = animation->mChannels[i];
+        const int32_t nodeIndex    = skeleton.FindNode(nodeAnim->mNodeName.C_Str());
+        if (nodeIndex == -1)
+        {
+            LOG_WARN("Animation \"%s\" channel targets unknown node \"%s\"!", m_Name.data(), nodeAnim->mNodeName.C_Str());
+            continue;
+        }
+
+        // Keys are gathered in full precision, reduced && only then quantized.
+        std::vector<float> translationTimes, rotationTimes, scaleTimes;
+        std::vector<glm::vec3> translations, scales;
+        std::vector<glm::quat> rotations;
+
+        translationTimes.reserve(nodeAnim->mNumPositionKeys);
+        translations.reserve(nodeAnim->mNumPositionKeys);
+        for (uint32_t k = 0; k < nodeAnim->mNumPositionKeys; ++k)
+        {
+            const auto& key = nodeAnim->mPositionKeys[k];
+            translationTimes.push_back(static_cast<float>(key.mTime));
+            translations.emplace_back(key.mValue.x, key.mValue.y, key.mValue.z);
+        }
+
+        rotationTimes.reserve(nodeAnim->mNumRotationKeys);
+        rotations.reserve(nodeAnim->mNumRotationKeys);
+        for (uint32_t k = 0; k < nodeAnim->mNumRotationKeys; ++k)
+        {
+            const auto& key = nodeAnim->mRotationKeys[k];
+            rotationTimes.push_back(static_cast<float>(key.mTime));
+            rotations.emplace_back(key.mValue.w, key.mValue.x, key.mValue.y, key.mValue.z);
+
+            // Neighbours are kept in the same hemisphere, so nlerp between them takes the short path.
+            if (k > 0 && glm::dot(rotations[k - 1], rotations[k]) < 0.0f) rotations[k] = -rotations[k];
+        }
+
+        scaleTimes.reserve(nodeAnim->mNumScalingKeys);
+        scales.reserve(nodeAnim->mNumScalingKeys);
+        for (uint32_t k = 0; k < nodeAnim->mNumScalingKeys; ++k)
+        {
+            const auto& key = nodeAnim->mScalingKeys[k];
+            scaleTimes.push_back(static_cast<float>(key.mTime));
+            scales.emplace_back(key.mValue.x, key.mValue.y, key.mValue.z);
+        }
+
+        // Sampling expects at least one key per track.
+        if (translations.empty())
+        {
+            translationTimes.push_back(0.0f);
+            translations.emplace_back(0.0f);
+        }
+
+        if (rotations.empty())
+        {
+            rotationTimes.push_back(0.0f);
+            rotations.emplace_back(1.0f, 0.0f, 0.0f, 0.0f);
+        }
+
+        if (scales.empty())
+        {
+            scaleTimes.push_back(0.0f);
+            scales.emplace_back(1.0f);
+        }
+
+        ReduceKeys(translationTimes, translations, settings.TranslationTolerance);
+        ReduceKeys(rotationTimes, rotations, settings.RotationTolerance);
+        ReduceKeys(scaleTimes, scales, settings.ScaleTolerance);
+
+        auto& channel        = m_Channels.emplace_back();
+        channel.NodeIndex    = static_cast<uint32_t>(nodeIndex);
+        channel.Translations = QuantizeTrack(std::move(translationTimes), translations);
+        channel.Rotations    = QuantizeTrack(std::move(rotationTimes), rotations);
+        channel.Scales       = QuantizeTrack(std::move(scaleTimes), scales);
+
+        m_KeyCount += channel.Translations.Values.size() + channel.Rotations.Values.size() + channel.Scales.Values.size();
+        m_MemorySize +=
+            GetTrackMemorySize(channel.Translations) + GetTrackMemorySize(channel.Rotations) + GetTrackMemorySize(channel.Scales);
+    }
+
+    // Local poses are written in node order then.
+    std::sort(m_Channels.begin(), m_Channels.end(), [](const auto& lhs, const auto& rhs) { return lhs.NodeIndex < rhs.NodeIndex; });
+}
+
+// Returns index of the first key of the interval containing time. Cursor only moves forward, unless playback jumped back.
+static uint32_t SeekKeyframe(const std::vector<float>& times, uint32_t cursor, const float time)
+{
+    const auto lastKey = static_cast<uint32_t>(times.size() - 1);
+    if (cursor >= lastKey || times[cursor] > time)
+    {
+        const auto it = std::upper_bound(times.begin(), times.end(), time);
+        cursor        = it == times.begin() ? 0 : static_cast<uint32_t>(std::distance(times.begin(), it) - 1);
+        return std::min(cursor, lastKey - 1);
+    }
+
+    while (cursor + 1 < lastKey && times[cursor + 1] <= time)
+        ++cursor;
+
+    return cursor;
+}
+
+template <typename Track> static auto SampleTrack(const Track& track, uint32_t& cursor, const float time)
+{
+    if (track.Values.size() == 1) return track.Decode(0);
+
+    cursor                  = SeekKeyframe(track.Times, cursor, time);
+    const float frameLength = track.Times[cursor + 1] - track.Times[cursor];
+    const float factor      = frameLength > 0.0f ? glm::clamp((time - track.Times[cursor]) / frameLength, 0.0f, 1.0f) : 0.0f;
+
+    return Interpolate(track.Decode(cursor), track.Decode(cursor + 1), factor);
+}
+
+static NodePose BlendPoses(const NodePose& from, const NodePose& to, const float weight)
+{
+    // Clips are sampled independently, so their rotations may end up in opposite hemispheres.
+    const glm::quat toRotation = glm::dot(from.Rotation, to.Rotation) < 0.0f ? -to.Rotation : to.Rotation;
+    return {glm::mix(from.Translation, to.Translation, weight), Interpolate(from.Rotation, toRotation, weight),
+            glm::mix(from.Scale, to.Scale, weight)};
+}
+
+Animator::Animator(const Ref<Skeleton>& skeleton, const Ref<Animation>& animation) : m_Skeleton(skeleton)
+{
+    GNT_ASSERT(m_Skeleton, "Animator requires a skeleton!");
+
+    m_LocalPoses.resize(m_Skeleton->GetNodeCount());
+    m_GlobalTransforms.resize(m_Skeleton->GetNodeCount(), glm::mat4(1.0f));
+    m_FinalBoneMatrices.resize(m_Skeleton->GetBoneCount(), glm::mat4(1.0f));
+
+    PlayAnimation(animation);
+}
+
+void Animator::PlayAnimation(const Ref<Animation>& animation)
+{
+    m_Previous     = {};
+    m_FadeDuration = 0.0f;
+    m_FadeTime     = 0.0f;
+
+    m_Current.Animation = animation;
+    m_Current.Time      = 0.0f;
+    m_Current.Cursors.assign(animation ? animation->GetChannels().size() : 0, KeyframeCursor{});
+}
+
+void Animator::CrossFade(const Ref<Animation>& animation, const float duration)
+{
+    if (duration <= 0.0f || !m_Current.Animation || !animation)
+    {
+        PlayAnimation(animation);
+        return;
+    }
+
+    // Interrupting a cross fade drops the animation that was fading out.
+    std::swap(m_Previous, m_Current);
+    m_Current.Animation = animation;
+    m_Current.Time      = 0.0f;
+    m_Current.Cursors.assign(animation->GetChannels().size(), KeyframeCursor{});
+
+    m_FadeDuration = duration;
+    m_FadeTime     = 0.0f;
+    if (m_PreviousLocalPoses.empty()) m_PreviousLocalPoses.resize(m_Skeleton->GetNodeCount());
+}
+
+void Animator::AdvanceAndSample(PlaybackState& state, const float deltaTime, std::vector<NodePose>& poses) const
+{
+    const float duration = state.Animation->GetDuration();
+    state.Time += state.Animation->GetTicksPerSecond() * deltaTime;
+    state.Time = duration > 0.0f ? std::fmod(state.Time, duration) : 0.0f;
+    if (state.Time < 0.0f) state.Time += duration;
+
+    // Nodes without a channel stay in bind pose.
+    std::copy(m_Skeleton->BindPoses.begin(), m_Skeleton->BindPoses.end(), poses.begin());
+
+    const auto& channels = state.Animation->GetChannels();
+    for (size_t i = 0; i < channels.size(); ++i)
+    {
+        const auto& channel = channels[i];
+        auto& cursor        = state.Cursors[i];
+        auto& pose          = poses[channel.NodeIndex];
+
+        pose.Translation = SampleTrack(channel.Translations, cursor.Translation, state.Time);
+        pose.Rotation    = SampleTrack(channel.Rotations, cursor.Rotation, state.Time);
+        pose.Scale       = SampleTrack(channel.Scales, cursor.Scale, state.Time);
+    }
+}
+
+void Animator::UpdateAnimation(const float deltaTime)
+{
+    if (!m_Current.Animation) return;
+
+    AdvanceAndSample(m_Current, deltaTime, m_LocalPoses);
+    if (m_Previous.Animation)
+    {
+        m_FadeTime += std::abs(deltaTime);
+        const float weight = GetCrossFadeWeight();
+        if (weight < 1.0f)
+        {
+            AdvanceAndSample(m_Previous, deltaTime, m_PreviousLocalPoses);
+            for (size_t i = 0; i < m_LocalPoses.size(); ++i)
+                m_LocalPoses[i] = BlendPoses(m_PreviousLocalPoses[i], m_LocalPoses[i], weight);
+        }
+        else
+            m_Previous = {};
+    }
+
+    // Parents precede their children, so their global transforms are ready by the time children are reached.
+    for (uint32_t i = 0; i < m_Skeleton->GetNodeCount(); ++i)
+    {
+        const int32_t parentIndex = m_Skeleton->ParentIndices[i];
+        const glm::mat4 local     = ToMatrix(m_LocalPoses[i]);
+        m_GlobalTransforms[i]     = parentIndex == -1 ? local : m_GlobalTransforms[parentIndex] * local;
+
+        const int32_t boneIndex = m_Skeleton->BoneIndices[i];
+        if (boneIndex != -1) m_FinalBoneMatrices[boneIndex] = m_GlobalTransforms[i] * m_Skeleton->BoneOffsets[boneIndex];
+    }
+}
+
+void AnimationLibrary::Shutdown()
+{
+    std::scoped_lock lock(s_Mutex);
+    s_LoadedModels.clear();
+}
+
+ModelAnimations AnimationLibrary::Load(const std::string& filePath, const aiScene* scene)
+{
+    AnimationImportSettings settings = {};
+    {
+        std::scoped_lock lock(s_Mutex);
+        if (const auto it = s_LoadedModels.find(filePath); it != s_LoadedModels.end()) return it->second;
+
+        settings = s_ImportSettings;
+    }
+
+    ModelAnimations model = {};
+    model.Skeleton        = MakeRef<Skeleton>();
+    model.Skeleton->Build(scene->mRootNode);
+
+    // Bones of every mesh are gathered up front, so their indices don't depend on how vertices are processed.
+    for (uint32_t i = 0; i < scene->mNumMeshes; ++i)
+    {
+        const aiMesh* mesh = scene->mMeshes[i];
+        for (uint32_t boneIndex = 0; boneIndex < mesh->mNumBones; ++boneIndex)
+            model.Skeleton->AddBone(mesh->mBones[boneIndex]->mName.C_Str(), ToGLMMatrix(mesh->mBones[boneIndex]->mOffsetMatrix));
+    }
+
+    for (uint32_t i = 0; i < scene->mNumAnimations; ++i)
+    {
+        const auto& clip = model.Clips.emplace_back(MakeRef<Animation>(scene->mAnimations[i], *model.Skeleton, settings));
+        LOG_TRACE("Loaded animation: %s, %zu keys, %0.2f KB", clip->GetName().data(), clip->GetKeyCount(),
+                  clip->GetMemorySize() / 1024.0f);
+    }
+
+    // Another worker may have imported the same file meanwhile, the first one wins, so all instances share a single skeleton.
+    std::scoped_lock lock(s_Mutex);
+    return s_LoadedModels.try_emplace(filePath, std::move(model)).first->second;
+}
+
+Ref<Animation> AnimationLibrary::Get(const std::string& filePath, const std::string& clipName)
+{
+    std::scoped_lock lock(s_Mutex);
+    const auto it = s_LoadedModels.find(filePath);
+    if (it == s_LoadedModels.end()) return nullptr;
+
+    const auto& clips = it->second.Clips;
+    const auto clipIt = std::find_if(clips.begin(), clips.end(), [&](const auto& clip) { return clip->GetName() == clipName; });
+    return clipIt != clips.end() ? *clipIt : nullptr;
+}
+
+void AnimationLibrary::SetImportSettings(const AnimationImportSettings& settings)
+{
+    std::scoped_lock lock(s_Mutex);
+    s_ImportSettings = settings;
+}
+
+}  // namespace Gauntlet
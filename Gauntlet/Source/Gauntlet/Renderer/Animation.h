@@ -1,157 +1,193 @@
 #pragma once
 
 #include "Gauntlet/Core/Core.h"
-#include "Mesh.h"
-#include <map>
+#include "Gauntlet/Core/Math.h"
 
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
+struct aiNode;
+struct aiScene;
+struct aiAnimation;
 
 namespace Gauntlet
 {
 
-struct AssimpNodeData
+// Local transform decomposed, so poses of different clips can be blended.
+struct NodePose
 {
-    glm::mat4 Transformation;
-    std::string Name;
-    int32_t ChildrenCount;
-    std::vector<AssimpNodeData> Children;
+    glm::vec3 Translation{0.0f};
+    glm::quat Rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 Scale{1.0f};
 };
 
-class Animation final
+// Node tree flattened once at load, parents come before their children, so poses are built in a single forward pass.
+struct Skeleton
 {
-  public:
-    Animation() = default;
+    std::vector<std::string> NodeNames;
+    std::vector<int32_t> ParentIndices;  // -1 for root.
+    std::vector<NodePose> BindPoses;     // Local, used by nodes that have no animation channel.
+    std::vector<int32_t> BoneIndices;    // Into final bone matrices, -1 for nodes that don't deform vertices.
+    std::vector<glm::mat4> BoneOffsets;  // Per bone, transforms vertex from model space to bone space.
+    std::unordered_map<std::string, uint32_t> NodeIndices;  // Names are resolved to indices at load only.
+
+    FORCEINLINE uint32_t GetNodeCount() const { return static_cast<uint32_t>(NodeNames.size()); }
+    FORCEINLINE uint32_t GetBoneCount() const { return static_cast<uint32_t>(BoneOffsets.size()); }
+
+    void Build(const aiNode* rootNode);
+    int32_t FindNode(const std::string& name) const;
+    int32_t FindBone(const std::string& name) const;
+
+    // Returns bone index, node becomes a bone on its first lookup.
+    int32_t AddBone(const std::string& name, const glm::mat4& offset);
+};
 
-    Animation(const aiScene* scene)
-    {
-        GNT_ASSERT(scene && scene->mRootNode);
-        auto animation = scene->mAnimations[0];
+// Keys that interpolation of their neighbours reproduces within these errors are dropped on import.
+struct AnimationImportSettings
+{
+    float TranslationTolerance = 0.0001f;  // (model units)
+    float RotationTolerance    = 0.0005f;  // (radians)
+    float ScaleTolerance       = 0.0001f;
+};
 
-        LOG_WARN("Loading animation: %s", animation->mName.C_Str());
+// Keys are quantized to 16 bits per component inside bounds of the track.
+struct QuantizedVec3Track
+{
+    glm::vec3 Min{0.0f};
+    glm::vec3 Extent{0.0f};  // Max - Min
+    std::vector<float> Times;
+    std::vector<std::array<uint16_t, 3>> Values;
 
-        m_Duration       = animation->mDuration;
-        m_TicksPerSecond = animation->mTicksPerSecond;
-        ReadHeirarchyData(m_RootNode, scene->mRootNode);
+    FORCEINLINE glm::vec3 Decode(const uint32_t key) const
+    {
+        return Min + glm::vec3(Values[key][0], Values[key][1], Values[key][2]) * (Extent / 65535.0f);
     }
+};
 
-    ~Animation() {}
+// Keys are stored as signed normalized 16 bit quaternions, neighbours are kept in the same hemisphere, so they are nlerped as is.
+struct QuantizedQuatTrack
+{
+    std::vector<float> Times;
+    std::vector<std::array<int16_t, 4>> Values;  // w, x, y, z
 
-    Bone* FindBone(const std::string& name)
+    FORCEINLINE glm::quat Decode(const uint32_t key) const
     {
-        auto iter = std::find_if(m_Bones.begin(), m_Bones.end(), [&](const Bone& Bone) { return Bone.GetName() == name; });
-        if (iter == m_Bones.end())
-            return nullptr;
-        else
-            return &(*iter);
+        return glm::normalize(glm::quat(Values[key][0], Values[key][1], Values[key][2], Values[key][3]));
     }
+};
 
-    inline float GetTicksPerSecond() { return m_TicksPerSecond; }
+// Keyframes of a single node, every track has at least one key.
+struct AnimationChannel
+{
+    uint32_t NodeIndex = 0;
 
-    inline float GetDuration() { return m_Duration; }
+    QuantizedVec3Track Translations;
+    QuantizedQuatTrack Rotations;
+    QuantizedVec3Track Scales;
+};
 
-    inline const AssimpNodeData& GetRootNode() { return m_RootNode; }
+class Animation final : private Uncopyable, private Unmovable
+{
+  public:
+    // Channels are remapped to skeleton's node indices, ones targeting unknown nodes are dropped.
+    Animation(const aiAnimation* animation, const Skeleton& skeleton, const AnimationImportSettings& settings = {});
+    ~Animation() = default;
 
-    FORCEINLINE const std::map<std::string, BoneInfo>& GetBoneIDMap() { return m_BoneMap; }
+    FORCEINLINE const auto& GetName() const { return m_Name; }
+    FORCEINLINE float GetDuration() const { return m_Duration; }  // (ticks)
+    FORCEINLINE float GetTicksPerSecond() const { return m_TicksPerSecond; }
+    FORCEINLINE const auto& GetChannels() const { return m_Channels; }
+    FORCEINLINE size_t GetKeyCount() const { return m_KeyCount; }
+    FORCEINLINE size_t GetMemorySize() const { return m_MemorySize; }  // (bytes)
 
   private:
-    float m_Duration         = 0.0f;
-    int32_t m_TicksPerSecond = 0;
-    std::vector<Bone> m_Bones;
-    AssimpNodeData m_RootNode;
-    std::map<std::string, BoneInfo> m_BoneMap;
-
-    friend class Mesh;
-
-    void ReadHeirarchyData(AssimpNodeData& dest, const aiNode* src)
-    {
-        GNT_ASSERT(src);
-
-        dest.Name = src->mName.data;
-        for (uint32_t i = 0; i < 4; ++i)
-        {
-            for (uint32_t j = 0; j < 4; ++j)
-            {
-                dest.Transformation[i][j] = src->mTransformation[i][j];
-            }
-        }
-        dest.ChildrenCount = src->mNumChildren;
-
-        for (int i = 0; i < src->mNumChildren; i++)
-        {
-            AssimpNodeData newData;
-            ReadHeirarchyData(newData, src->mChildren[i]);
-            dest.Children.push_back(newData);
-        }
-    }
+    std::string m_Name;
+    float m_Duration       = 0.0f;
+    float m_TicksPerSecond = 25.0f;
+    std::vector<AnimationChannel> m_Channels;
+    size_t m_KeyCount   = 0;
+    size_t m_MemorySize = 0;
 };
 
-class Animator final
+/*
+ * Playback state of a single instance, skeletons && animations are shared between instances && never written here.
+ * Every channel keeps cursors to keyframes it sampled last time, playback mostly moves forward, so sampling is amortized O(1).
+ * Animators don't share anything, so many of them can be updated on job system workers at once.
+ */
+class Animator final : private Uncopyable, private Unmovable
 {
   public:
-    Animator(Animation* animation)
-    {
-        m_CurrentTime      = 0.0;
-        m_CurrentAnimation = animation;
+    Animator(const Ref<Skeleton>& skeleton, const Ref<Animation>& animation = nullptr);
+    ~Animator() = default;
 
-        m_FinalBoneMatrices.reserve(100);
+    void PlayAnimation(const Ref<Animation>& animation);
 
-        for (int i = 0; i < 100; i++)
-            m_FinalBoneMatrices.push_back(glm::mat4(1.0f));
-    }
+    // Current animation keeps playing && fades out over duration, while the new one fades in from its start.
+    void CrossFade(const Ref<Animation>& animation, const float duration);
+    void UpdateAnimation(const float deltaTime);
 
-    void UpdateAnimation(float dt)
-    {
-        m_DeltaTime = dt;
-        if (m_CurrentAnimation)
-        {
-            m_CurrentTime += m_CurrentAnimation->GetTicksPerSecond() * dt;
-            m_CurrentTime = fmod(m_CurrentTime, m_CurrentAnimation->GetDuration());
-            CalculateBoneTransform(&m_CurrentAnimation->GetRootNode(), glm::mat4(1.0f));
-        }
-    }
+    FORCEINLINE const auto& GetFinalBoneMatrices() const { return m_FinalBoneMatrices; }
+    FORCEINLINE const auto& GetSkeleton() const { return m_Skeleton; }
+    FORCEINLINE const auto& GetAnimation() const { return m_Current.Animation; }
+    FORCEINLINE float GetCurrentTime() const { return m_Current.Time; }
+    FORCEINLINE bool IsCrossFading() const { return m_Previous.Animation != nullptr; }
+    FORCEINLINE float GetCrossFadeWeight() const { return m_FadeDuration > 0.0f ? std::min(m_FadeTime / m_FadeDuration, 1.0f) : 1.0f; }
 
-    void PlayAnimation(Animation* pAnimation)
+  private:
+    struct KeyframeCursor
     {
-        m_CurrentAnimation = pAnimation;
-        m_CurrentTime      = 0.0f;
-    }
+        uint32_t Translation = 0;
+        uint32_t Rotation    = 0;
+        uint32_t Scale       = 0;
+    };
 
-    void CalculateBoneTransform(const AssimpNodeData* node, glm::mat4 parentTransform)
+    struct PlaybackState
     {
-        std::string nodeName    = node->Name;
-        glm::mat4 nodeTransform = node->Transformation;
+        Ref<Gauntlet::Animation> Animation = nullptr;
+        float Time                         = 0.0f;  // (ticks)
 
-        Bone* bone = m_CurrentAnimation->FindBone(nodeName);
+        std::vector<KeyframeCursor> Cursors;  // Per channel of animation.
+    };
 
-        if (bone)
-        {
-            bone->Update(m_CurrentTime);
-            nodeTransform = bone->GetLocalTransform();
-        }
+    Ref<Skeleton> m_Skeleton = nullptr;
+    PlaybackState m_Current;
+    PlaybackState m_Previous;     // Fading out, empty unless cross fading.
+    float m_FadeDuration = 0.0f;  // (seconds)
+    float m_FadeTime     = 0.0f;
 
-        glm::mat4 globalTransformation = parentTransform * nodeTransform;
+    std::vector<NodePose> m_LocalPoses;
+    std::vector<NodePose> m_PreviousLocalPoses;  // Allocated on the first cross fade only.
+    std::vector<glm::mat4> m_GlobalTransforms;
+    std::vector<glm::mat4> m_FinalBoneMatrices;
 
-        auto boneInfoMap = m_CurrentAnimation->GetBoneIDMap();
-        if (boneInfoMap.find(nodeName) != boneInfoMap.end())
-        {
-            int index                  = boneInfoMap[nodeName].ID;
-            glm::mat4 offset           = boneInfoMap[nodeName].Offset;
-            m_FinalBoneMatrices[index] = globalTransformation * offset;
-        }
+    void AdvanceAndSample(PlaybackState& state, const float deltaTime, std::vector<NodePose>& poses) const;
+};
 
-        for (int i = 0; i < node->ChildrenCount; i++)
-            CalculateBoneTransform(&node->Children[i], globalTransformation);
-    }
+// Skeleton && clips of a single model file.
+struct ModelAnimations
+{
+    Ref<Gauntlet::Skeleton> Skeleton = nullptr;
+    std::vector<Ref<Animation>> Clips;
+};
+
+/*
+ * Skeletons && clips keyed by model file, so every mesh instance of the same model shares them instead of importing its own.
+ * Meshes are loaded on job system workers, lookups && insertions are guarded, import itself runs outside of the lock.
+ */
+class AnimationLibrary final : private Uncopyable, private Unmovable
+{
+  public:
+    static void Init() {}
+    static void Shutdown();
 
-    std::vector<glm::mat4> GetFinalBoneMatrices() { return m_FinalBoneMatrices; }
+    // Imports skeleton && clips of the scene on the first request for the file, later ones get the cached ones.
+    static ModelAnimations Load(const std::string& filePath, const aiScene* scene);
+    static Ref<Animation> Get(const std::string& filePath, const std::string& clipName);
+
+    // Applies to models imported afterwards, cached ones are kept as is.
+    static void SetImportSettings(const AnimationImportSettings& settings);
 
   private:
-    std::vector<glm::mat4> m_FinalBoneMatrices;
-    Animation* m_CurrentAnimation;
-    float m_CurrentTime;
-    float m_DeltaTime;
+    static inline std::mutex s_Mutex;
+    static inline std::unordered_map<std::string, ModelAnimations> s_LoadedModels;
+    static inline AnimationImportSettings s_ImportSettings;
 };
 
-}  // namespace Gauntlet
\ No newline at end of file
+}  // namespace Gauntlet
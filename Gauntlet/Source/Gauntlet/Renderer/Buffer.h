@@ -127,13 +127,14 @@ class BufferLayout final
 
 enum EBufferUsageFlags
 {
-    NONE           = BIT(0),
-    STAGING_BUFFER = BIT(1),  // Means transfer source
-    TRANSFER_DST   = BIT(2),
-    UNIFORM_BUFFER = BIT(4),
-    INDEX_BUFFER   = BIT(6),
-    VERTEX_BUFFER  = BIT(7),
-    STORAGE_BUFFER = BIT(8),
+    NONE            = BIT(0),
+    STAGING_BUFFER  = BIT(1),  // Means transfer source
+    TRANSFER_DST    = BIT(2),
+    UNIFORM_BUFFER  = BIT(4),
+    INDEX_BUFFER    = BIT(6),
+    VERTEX_BUFFER   = BIT(7),
+    STORAGE_BUFFER  = BIT(8),
+    INDIRECT_BUFFER = BIT(9),
 };
 
 typedef uint32_t EBufferUsage;
@@ -29,6 +29,8 @@ class Camera : private Uncopyable, private Unmovable
     FORCEINLINE const auto& GetProjectionMatrix() const { return m_ProjectionMatrix; }
     FORCEINLINE const auto& GetRotation() const { return m_Rotation; }
     FORCEINLINE const auto GetAspectRatio() const { return m_AspectRatio; }
+    FORCEINLINE const auto GetNearClip() const { return m_ZNear; }
+    FORCEINLINE const auto GetFarClip() const { return m_ZFar; }
 
     FORCEINLINE void SetPosition(const glm::vec3& position)
     {
@@ -58,6 +60,8 @@ class Camera : private Uncopyable, private Unmovable
     glm::vec3 m_Rotation = {0.f, 0.f, 0.f};
 
     float m_AspectRatio            = 1.0f;
+    float m_ZNear                  = 0.01f;
+    float m_ZFar                   = 1000.0f;
     float m_CameraTranslationSpeed = 1.0f;
     float m_CameraRotationSpeed    = 180.0f;
 
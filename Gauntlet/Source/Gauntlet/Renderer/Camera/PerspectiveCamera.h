@@ -59,6 +59,8 @@ class PerspectiveCamera : public Camera
 
     void SetProjection(const float zNear = 0.01f, const float zFar = 1000.0f)
     {
+        m_ZNear            = zNear;
+        m_ZFar             = zFar;
         m_ProjectionMatrix = glm::perspective(glm::radians(m_FOV), m_AspectRatio, zNear, zFar);
     }
 
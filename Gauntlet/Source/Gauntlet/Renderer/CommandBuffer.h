@@ -30,15 +30,11 @@ class CommandBuffer : private Uncopyable, private Unmovable
     virtual void BeginRecording(bool bOneTimeSubmit = false, const void* inheritanceInfo = nullptr) = 0;
     virtual void EndRecording()                                                                     = 0;
 
-    virtual void BeginTimestamp(bool bStatisticsQuery = false) = 0;
-    virtual void EndTimestamp(bool bStatisticsQuery = false)   = 0;
-
     virtual void BeginDebugLabel(const char* commandBufferLabelName = "NONAME", const glm::vec4& labelColor = glm::vec4(1.0f)) const = 0;
     virtual void EndDebugLabel() const                                                                                               = 0;
 
-    virtual const std::vector<size_t>& GetTimestampResults() const              = 0;
-    virtual const std::vector<size_t>& GetPipelineStatisticsResults() const     = 0;
-    virtual const std::vector<std::string> GetPipelineStatisticsStrings() const = 0;
+    // Secondary command buffers are executed in order, pass they were recorded for should be currently open.
+    virtual void ExecuteCommands(const std::vector<Ref<CommandBuffer>>& secondaryCommandBuffers) = 0;
 
     virtual void Submit(bool bWaitAfterSubmit = true) = 0;
     virtual void Reset()                              = 0;
@@ -0,0 +1,27 @@
+#include "GauntletPCH.h"
+#include "CommandPool.h"
+
+#include "RendererAPI.h"
+#include "Gauntlet/Platform/Vulkan/VulkanCommandPool.h"
+
+namespace Gauntlet
+{
+Ref<CommandPool> CommandPool::Create(ECommandBufferType type)
+{
+    switch (RendererAPI::Get())
+    {
+        case RendererAPI::EAPI::Vulkan:
+        {
+            return MakeRef<VulkanCommandPool>(type);
+        }
+        case RendererAPI::EAPI::None:
+        {
+            LOG_ERROR("RendererAPI::EAPI::None!");
+            GNT_ASSERT(false, "Unknown RendererAPI!");
+            break;
+        }
+    }
+
+    return nullptr;
+}
+}  // namespace Gauntlet
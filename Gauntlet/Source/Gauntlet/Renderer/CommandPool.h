@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Gauntlet/Core/Core.h"
+#include "CommandBuffer.h"
+
+namespace Gauntlet
+{
+
+/*
+ * Command buffers of a pool can't be recorded by multiple threads at once, so each recording thread owns a pool.
+ * Command buffers handed out since the last Reset() are reused after it, pool grows only when more of them are needed.
+ */
+class CommandPool : private Uncopyable, private Unmovable
+{
+  public:
+    CommandPool()          = default;
+    virtual ~CommandPool() = default;
+
+    virtual const Ref<CommandBuffer>& AcquireSecondaryCommandBuffer() = 0;
+
+    // Invalidates all command buffers acquired from this pool, GPU shouldn't be using them anymore.
+    virtual void Reset()   = 0;
+    virtual void Destroy() = 0;
+
+    static Ref<CommandPool> Create(ECommandBufferType type);
+};
+
+}  // namespace Gauntlet
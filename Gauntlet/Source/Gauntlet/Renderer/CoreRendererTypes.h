@@ -38,6 +38,19 @@ struct AnimatedVertex
     glm::vec3 Tangent;
 };
 
+// Compute pre-skinning, keep in sync with Skinning.comp
+static constexpr uint32_t s_SKINNING_WORKGROUP_SIZE           = 64;
+static constexpr uint32_t s_MAX_SKINNING_DISPATCHES_PER_BATCH = 65535;  // Dispatches go along Y, group count of which is limited.
+
+// Skins a single submesh instance, source && output vertices are packed into shared buffers.
+struct SkinningDispatch
+{
+    uint32_t SourceOffset = 0;  // First vertex in source buffer.
+    uint32_t OutputOffset = 0;  // First vertex in output buffer, also vertex offset of the instance's draws.
+    uint32_t VertexCount  = 0;
+    uint32_t BoneOffset   = 0;  // First matrix of the instance's bone palette.
+};
+
 struct Vertex
 {
     Vertex(const glm::vec3& position) : Position(position) {}
@@ -55,16 +68,25 @@ struct UBCamera
 };
 
 // Lighting
-static constexpr uint32_t s_MAX_POINT_LIGHTS = 16;
-static constexpr uint32_t s_MAX_SPOT_LIGHTS  = 8;
-static constexpr uint32_t s_MAX_DIR_LIGHTS   = 4;
+static constexpr uint32_t s_MAX_DIR_LIGHTS = 4;
+
+// Point & spot lights have no fixed limits, they're stored in SSBOs and binned into clusters(froxels) by LightCulling.comp.
+// Keep in sync with LightCulling.comp && Lighting.frag
+static constexpr uint32_t s_LIGHT_CLUSTERS_X             = 16;
+static constexpr uint32_t s_LIGHT_CLUSTERS_Y             = 9;
+static constexpr uint32_t s_LIGHT_CLUSTERS_Z             = 24;
+static constexpr uint32_t s_LIGHT_CLUSTER_COUNT          = s_LIGHT_CLUSTERS_X * s_LIGHT_CLUSTERS_Y * s_LIGHT_CLUSTERS_Z;
+static constexpr uint32_t s_MAX_LIGHTS_PER_CLUSTER       = 128;
+static constexpr float s_LIGHT_ATTENUATION_THRESHOLD     = 1.0f / 256.0f;  // Radiance below which light is considered to be culled.
+static constexpr uint32_t s_LIGHT_CULLING_WORKGROUP_SIZE = 128;
 
 struct PointLight
 {
-    glm::vec4 Position = glm::vec4(0.0f);
-    glm::vec4 Color    = glm::vec4(0.0f);
-    float Intensity    = 1.0f;
-    float IsActive     = 0;
+    glm::vec4 Position  = glm::vec4(0.0f);  // w - radius of influence
+    glm::vec4 Color     = glm::vec4(0.0f);
+    float Intensity     = 1.0f;
+    float IsActive      = 0;
+    int32_t ShadowIndex = -1;  // First of 6 cube face entries in local shadows buffer, -1 - no shadow.
 };
 
 struct DirectionalLight
@@ -77,39 +99,82 @@ struct DirectionalLight
 
 struct SpotLight
 {
-    glm::vec4 Position  = glm::vec4(0.0f);
+    glm::vec4 Position  = glm::vec4(0.0f);  // w - radius of influence
     glm::vec4 Color     = glm::vec4(0.0f);
     glm::vec3 Direction = glm::vec3(0.0f);
     float CutOff        = 0.0f;
     float OuterCutOff   = 0.0f;
 
-    float Intensity = 1.0f;
-    float IsActive  = 0;
+    float Intensity     = 1.0f;
+    float IsActive      = 0;
+    int32_t ShadowIndex = -1;  // Entry in local shadows buffer, -1 - no shadow.
 };
 
 struct UBLighting
 {
     DirectionalLight DirLights[s_MAX_DIR_LIGHTS];
-    SpotLight SpotLights[s_MAX_SPOT_LIGHTS];
-    PointLight PointLights[s_MAX_POINT_LIGHTS];
 
     float Gamma;
     float Exposure;
+    glm::mat4 InvViewProjection;  // World position is reconstructed from GBuffer depth.
+};
+
+struct UBLightClusters
+{
+    glm::mat4 Projection     = glm::mat4(1.0f);
+    glm::mat4 InvProjection  = glm::mat4(1.0f);
+    glm::mat4 View           = glm::mat4(1.0f);
+    float zNear              = 0.01f;
+    float zFar               = 1000.0f;
+    uint32_t PointLightCount = 0;
+    uint32_t SpotLightCount  = 0;
 };
 
+// Point light indices go first, then spot light indices.
+struct LightCluster
+{
+    uint32_t PointLightCount = 0;
+    uint32_t SpotLightCount  = 0;
+    uint32_t LightIndices[s_MAX_LIGHTS_PER_CLUSTER];
+};
+
+// Cascaded shadow maps, cascades are stored as layers of a single depth image.
+static constexpr uint32_t s_MAX_SHADOW_CASCADES        = 4;
+static constexpr float s_SHADOW_CASTER_DISTANCE        = 50.0f;  // Extra depth towards the light, so casters outside of slice still cast.
+static constexpr float s_SHADOW_CASCADE_REUSE_DISTANCE = 0.1f;   // Cached cascade is re-rendered once slice moved by this part of radius.
 struct UBShadows
 {
-    glm::mat4 LightSpaceMatrix = glm::mat4(1.0f);
+    glm::mat4 LightSpaceMatrices[s_MAX_SHADOW_CASCADES];
+    glm::vec4 CascadeSplits = glm::vec4(0.0f);  // View space far distance of each cascade.
+    uint32_t CascadeCount   = 0;                // 0 - shadows disabled.
+    uint32_t SoftShadows    = 0;
+    uint32_t LightIndex     = 0;  // Directional light that casts shadows.
 };
 
-static constexpr uint32_t s_SSAO_KERNEL_SIZE = 16;
+// Point and spot light shadows share a single depth atlas, tiles are power of two sized.
+static constexpr uint32_t s_LOCAL_SHADOW_ATLAS_SIZE    = 4096;
+static constexpr uint32_t s_LOCAL_SHADOW_MAX_TILE_SIZE = 1024;
+static constexpr uint32_t s_LOCAL_SHADOW_MIN_TILE_SIZE = 128;
+static constexpr float s_LOCAL_SHADOW_NEAR_PLANE       = 0.05f;
+struct LocalLightShadow
+{
+    glm::mat4 ViewProjection = glm::mat4(1.0f);
+    glm::vec4 AtlasRect      = glm::vec4(0.0f);  // xy - uv offset, zw - uv size, zero size - no shadow this frame.
+};
+
+static constexpr uint32_t s_SSAO_KERNEL_SIZE             = 16;
+static constexpr uint32_t s_SSAO_WORKGROUP_SIZE          = 8;   // Keep in sync with SSAOCompute.comp && SSAODepthDownsample.comp
+static constexpr uint32_t s_SSAO_UPSAMPLE_WORKGROUP_SIZE = 16;  // Keep in sync with SSAOUpsample.comp
 struct UBSSAO
 {
     glm::mat4 CameraProjection  = glm::mat4(1.0f);
     glm::mat4 InvViewProjection = glm::mat4(1.0f);  // glm::lookAt returns inverse view matrix
+    glm::mat4 InvProjection     = glm::mat4(1.0f);  // Compute path reconstructs view position from depth.
     float Radius                = 0.5f;
     float Bias                  = 0.025f;
     int32_t Magnitude           = 1;
+    int32_t BlurRadius          = 2;  // Bilateral upsample radius in low resolution texels.
+    int32_t ResolutionScale     = 2;  // Full resolution / AO resolution.
 };
 
 struct PBRMaterial
@@ -137,9 +202,11 @@ struct alignas(16) MatrixPushConstants
 
 // USEFUL DEFINES
 
-using UniformBufferPerFrame       = std::array<Ref<class UniformBuffer>, FRAMES_IN_FLIGHT>;
-using FramebufferPerFrame         = std::array<Ref<class Framebuffer>, FRAMES_IN_FLIGHT>;
-using RenderCommandBufferPerFrame = std::array<Ref<class CommandBuffer>, FRAMES_IN_FLIGHT>;
+using UniformBufferPerFrame       = std::array<Ref<class UniformBuffer>, MAX_FRAMES_IN_FLIGHT>;
+using StorageBufferPerFrame       = std::array<Ref<class StorageBuffer>, MAX_FRAMES_IN_FLIGHT>;
+using VertexBufferPerFrame        = std::array<Ref<class VertexBuffer>, MAX_FRAMES_IN_FLIGHT>;
+using FramebufferPerFrame         = std::array<Ref<class Framebuffer>, MAX_FRAMES_IN_FLIGHT>;
+using RenderCommandBufferPerFrame = std::array<Ref<class CommandBuffer>, MAX_FRAMES_IN_FLIGHT>;
 
 enum class ECompareOp : uint8_t
 {
@@ -153,6 +220,13 @@ enum class ECompareOp : uint8_t
     COMPARE_OP_ALWAYS           = 7,
 };
 
+// Used when VSync is off, falls back to the other one && then to FIFO if not supported by the surface.
+enum class EPresentMode : uint8_t
+{
+    PRESENT_MODE_MAILBOX = 0,  // Latest frame replaces the queued one, no tearing.
+    PRESENT_MODE_IMMEDIATE,    // Lowest latency, may tear.
+};
+
 #if MESH_SHADING_TEST
 
 // NVIDIA advice
@@ -49,7 +49,12 @@ struct FramebufferSpecification
 
     uint32_t Width   = 0;
     uint32_t Height  = 0;
+    uint32_t Layers  = 1;  // Layered attachments are rendered one layer per pass.
     std::string Name = "None";
+
+    // Attachment layouts are transitioned by RenderGraph, owned attachments can be aliased images(see ImageSpecification::Aliased).
+    bool ManagedByRenderGraph = false;
+    bool AliasedAttachments   = false;
 };
 
 class CommandBuffer;
@@ -66,13 +71,21 @@ class Framebuffer : private Uncopyable, private Unmovable
     virtual void Destroy()                               = 0;
     virtual void Resize(uint32_t width, uint32_t height) = 0;
 
-    virtual void BeginPass(const Ref<CommandBuffer>& commandBuffer) = 0;
-    virtual void EndPass(const Ref<CommandBuffer>& commandBuffer)   = 0;
+    // Render area is (x, y, width, height), zero extent means the whole framebuffer.
+    // Passes with secondary contents accept only ExecuteCommands() until EndPass(), draws are recorded between Begin/EndSecondaryPass().
+    virtual void BeginPass(const Ref<CommandBuffer>& commandBuffer, const uint32_t layer = 0, const glm::uvec4& renderArea = glm::uvec4(0),
+                           const bool bSecondaryContents = false) = 0;
+    virtual void EndPass(const Ref<CommandBuffer>& commandBuffer) = 0;
+
+    // Can be called from any thread while the pass is open, each secondary command buffer by a single thread.
+    virtual void BeginSecondaryPass(const Ref<CommandBuffer>& secondaryCommandBuffer) const = 0;
+    virtual void EndSecondaryPass(const Ref<CommandBuffer>& secondaryCommandBuffer) const   = 0;
 
     FORCEINLINE virtual const std::vector<FramebufferAttachment>& GetAttachments() const = 0;
 
     virtual const uint32_t GetWidth() const  = 0;
     virtual const uint32_t GetHeight() const = 0;
+    FORCEINLINE virtual const glm::uvec4& GetRenderArea() const = 0;
 };
 
 }  // namespace Gauntlet
\ No newline at end of file
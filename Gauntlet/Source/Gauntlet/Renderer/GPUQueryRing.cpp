@@ -0,0 +1,27 @@
+#include "GauntletPCH.h"
+#include "GPUQueryRing.h"
+
+#include "RendererAPI.h"
+#include "Gauntlet/Platform/Vulkan/VulkanGPUQueryRing.h"
+
+namespace Gauntlet
+{
+Ref<GPUQueryRing> GPUQueryRing::Create(ECommandBufferType type, const uint32_t maxMarkers)
+{
+    switch (RendererAPI::Get())
+    {
+        case RendererAPI::EAPI::Vulkan:
+        {
+            return MakeRef<VulkanGPUQueryRing>(type, maxMarkers);
+        }
+        case RendererAPI::EAPI::None:
+        {
+            LOG_ERROR("RendererAPI::EAPI::None!");
+            GNT_ASSERT(false, "Unknown RendererAPI!");
+            break;
+        }
+    }
+
+    return nullptr;
+}
+}  // namespace Gauntlet
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Gauntlet/Core/Core.h"
+#include "CommandBuffer.h"
+
+namespace Gauntlet
+{
+
+struct GPUMarker
+{
+    std::string Name;
+    uint32_t Depth = 0;     // Nesting level, top level markers are 0.
+    float Start    = 0.0f;  // (ms) Since the first marker of the frame.
+    float Time     = 0.0f;  // (ms)
+};
+
+/*
+ * Timestamp && pipeline statistics queries, one query pool per frame in flight.
+ * Frame's queries are read back when the same frame index comes around again, so results are frames in flight late,
+ * but CPU never waits for them: results that aren't available yet are skipped && the previous ones are kept.
+ */
+class GPUQueryRing : private Uncopyable, private Unmovable
+{
+  public:
+    GPUQueryRing(const uint32_t maxMarkers) : m_MaxMarkers(maxMarkers) {}
+    virtual ~GPUQueryRing() = default;
+
+    static Ref<GPUQueryRing> Create(ECommandBufferType type, const uint32_t maxMarkers = 128);
+
+    // Reads back results of the current frame's pool && resets it, command buffer should have just begun recording.
+    // Without profiling markers emit debug labels only.
+    virtual void BeginFrame(const Ref<CommandBuffer>& commandBuffer, const bool bProfile = true) = 0;
+
+    // Call right after the frame's command buffer is submitted, its markers are placed on CPU timeline from there.
+    virtual void EndFrame() = 0;
+
+    // Query slots are allocated on the fly, markers beyond the capacity are still labeled but not timed.
+    virtual void BeginMarker(const Ref<CommandBuffer>& commandBuffer, const std::string& name) = 0;
+    virtual void EndMarker(const Ref<CommandBuffer>& commandBuffer)                            = 0;
+
+    // Single statistics query per frame, it can't be nested.
+    virtual void BeginPipelineStatistics(const Ref<CommandBuffer>& commandBuffer) = 0;
+    virtual void EndPipelineStatistics(const Ref<CommandBuffer>& commandBuffer)   = 0;
+
+    virtual void Destroy() = 0;
+
+    virtual const std::vector<std::string>& GetPipelineStatisticsNames() const = 0;
+    FORCEINLINE const auto& GetPipelineStatistics() const { return m_PipelineStatistics; }
+    FORCEINLINE const auto& GetMarkers() const { return m_Markers; }
+    FORCEINLINE double GetMarkersSubmitTime() const { return m_MarkersSubmitTime; }
+
+  protected:
+    uint32_t m_MaxMarkers = 0;
+
+    // Latest available results.
+    std::vector<GPUMarker> m_Markers;
+    std::vector<uint64_t> m_PipelineStatistics;
+    double m_MarkersSubmitTime = 0.0;  // (s) Timer::Now()
+};
+
+// Marker for the lifetime of the scope.
+class GPUMarkerScope final : private Uncopyable, private Unmovable
+{
+  public:
+    GPUMarkerScope(Ref<GPUQueryRing> queryRing, Ref<CommandBuffer> commandBuffer, const std::string& name)
+        : m_QueryRing(std::move(queryRing)), m_CommandBuffer(std::move(commandBuffer))
+    {
+        m_QueryRing->BeginMarker(m_CommandBuffer, name);
+    }
+
+    ~GPUMarkerScope() { m_QueryRing->EndMarker(m_CommandBuffer); }
+
+  private:
+    Ref<GPUQueryRing> m_QueryRing;
+    Ref<CommandBuffer> m_CommandBuffer;
+};
+
+}  // namespace Gauntlet
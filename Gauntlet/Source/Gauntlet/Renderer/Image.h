@@ -23,6 +23,7 @@ enum class EImageFormat : uint8_t
     R32F,
 
     R11G11B10,
+    RGB10A2,
 
     DEPTH32F,
     DEPTH24STENCIL8
@@ -40,7 +41,8 @@ enum class EImageUsage : uint8_t
 {
     NONE = 0,
     TEXTURE,
-    Attachment
+    Attachment,
+    STORAGE  // Written by compute shaders, stays in general layout.
 };
 
 enum class ELoadImageType : uint8_t
@@ -92,6 +94,7 @@ struct ImageSpecification
     bool Comparable      = false;
     bool FlipOnLoad      = false;
     bool CreateTextureID = false;
+    bool Aliased         = false;  // Created without memory, RenderGraph binds it into memory shared with other transient images.
 };
 
 class Image
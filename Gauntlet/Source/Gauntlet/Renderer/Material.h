@@ -40,7 +40,7 @@ class Material : private Unmovable
     std::vector<Ref<Texture2D>> m_AOTextures;
 
     PBRMaterial m_Data;
-    std::array<Ref<UniformBuffer>, FRAMES_IN_FLIGHT> m_UBMaterial;
+    std::array<Ref<UniformBuffer>, MAX_FRAMES_IN_FLIGHT> m_UBMaterial;
 
     friend class Mesh;
 };
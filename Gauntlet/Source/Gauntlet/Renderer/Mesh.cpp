@@ -7,6 +7,7 @@
 
 #include "Gauntlet/Renderer/Renderer.h"
 #include "Gauntlet/Core/JobSystem.h"
+#include "Gauntlet/Core/Profiler.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -19,114 +20,174 @@
 namespace Gauntlet
 {
 
-Bone::Bone(const std::string& name, int32_t ID, const aiNodeAnim* channel) : m_Name(name), m_ID(ID), m_LocalTransform(1.0f)
+Ref<Mesh> Mesh::Create(const std::string& filePath)
 {
-    m_NumPositions = channel->mNumPositionKeys;
+    Ref<Mesh> mesh = MakeRef<Mesh>();
 
-    for (int32_t positionIndex = 0; positionIndex < m_NumPositions; ++positionIndex)
+    // Known up front, so scene can be serialized && shown in editor while the mesh is still streaming.
+    mesh->m_Directory = std::string(filePath.substr(0, filePath.find_last_of('/'))) + std::string("/");
     {
-        aiVector3D aiPosition = channel->mPositionKeys[positionIndex].mValue;
-        KeyPosition data;
-        data.Position = glm::vec3(aiPosition.x, aiPosition.y, aiPosition.z);
-        data.Timetamp = channel->mPositionKeys[positionIndex].mTime;
-        m_Positions.push_back(data);
+        size_t pos = filePath.find("Models/");
+        GNT_ASSERT(pos != std::string::npos);
+
+        mesh->m_Name = filePath.substr(pos + 7, filePath.size() - pos);
     }
 
-    m_NumRotations = channel->mNumRotationKeys;
-    for (int32_t rotationIndex = 0; rotationIndex < m_NumRotations; ++rotationIndex)
     {
-        aiQuaternion aiOrientation = channel->mRotationKeys[rotationIndex].mValue;
-        KeyRotation data;
-        data.Orientation = glm::quat(aiOrientation.w, aiOrientation.x, aiOrientation.y, aiOrientation.z);
-        data.Timestamp   = channel->mRotationKeys[rotationIndex].mTime;
-        m_Rotations.push_back(data);
+        std::scoped_lock<std::mutex> Lock(s_StreamingMutex);
+        s_StreamingMeshes.push_back(mesh);
+        ++s_StreamingBatchSize;
     }
 
-    m_NumScalings = channel->mNumScalingKeys;
-    for (int32_t keyIndex = 0; keyIndex < m_NumScalings; ++keyIndex)
+    // Job holds its own reference, so scene can be closed while the mesh is still streaming.
+    JobSystem::SubmitBackground([mesh, filePath] { mesh->Stream(filePath); });
+    return mesh;
+}
+
+void Mesh::Stream(const std::string& meshPath)
+{
+    LoadMesh(meshPath);
+
+    BufferSpecification vbInfo = {};
+    vbInfo.Usage               = EBufferUsageFlags::VERTEX_BUFFER | EBufferUsageFlags::TRANSFER_DST;
+
+    BufferSpecification ibInfo = {};
+    ibInfo.Usage               = EBufferUsageFlags::INDEX_BUFFER | EBufferUsageFlags::TRANSFER_DST;
+
+#if MESH_SHADING_TEST
+
+    BufferSpecification sbInfo = {};
+    sbInfo.Usage               = EBufferUsageFlags::STORAGE_BUFFER | EBufferUsageFlags::TRANSFER_DST;
+
+#endif
+
+    for (auto& submesh : m_Submeshes)
     {
-        aiVector3D scale = channel->mScalingKeys[keyIndex].mValue;
-        KeyScale data;
-        data.Scale     = glm::vec3(scale.x, scale.y, scale.z);
-        data.Timestamp = channel->mScalingKeys[keyIndex].mTime;
-        m_Scales.push_back(data);
+        // Animated vertices stay on CPU as skinning source, vertex buffer holds bind pose for instances without animator.
+        if (m_bIsAnimated)
+        {
+            submesh.Vertices.reserve(submesh.AnimatedVertices.size());
+            for (const auto& animatedVertex : submesh.AnimatedVertices)
+                submesh.Vertices.push_back({animatedVertex.Position, glm::vec4(1.0f), animatedVertex.TexCoord,
+                                            animatedVertex.Normal, animatedVertex.Tangent});
+        }
+
+        vbInfo.Count                             = submesh.Vertices.size();
+        Ref<Gauntlet::VertexBuffer> vertexBuffer = Gauntlet::VertexBuffer::Create(vbInfo);
+
+        vertexBuffer->SetData(submesh.Vertices.data(), submesh.Vertices.size() * sizeof(submesh.Vertices[0]));
+        submesh.Vertices.clear();
+
+        m_VertexBuffers.emplace_back(vertexBuffer);
+
+        ibInfo.Count = submesh.Indices.size();
+        ibInfo.Data  = submesh.Indices.data();
+        ibInfo.Size  = submesh.Indices.size() * sizeof(submesh.Indices[0]);
+
+        m_IndexBuffers.emplace_back(Gauntlet::IndexBuffer::Create(ibInfo));
+        submesh.Indices.clear();
     }
+
+    // Geometry is visible from here on, each submesh keeps its placeholder material until its textures follow.
+    m_bIsGeometryStreamed.store(true, std::memory_order_release);
+    StreamTextures();
 }
 
-void Bone::Update(float animationTime)
+void Mesh::StreamTextures()
 {
-    glm::mat4 translation = InterpolatePosition(animationTime);
-    glm::mat4 rotation    = InterpolateRotation(animationTime);
-    glm::mat4 scale       = InterpolateScaling(animationTime);
-    m_LocalTransform      = translation * rotation * scale;
+    for (size_t i = 0; i < m_Submeshes.size(); ++i)
+    {
+        auto& submesh = m_Submeshes[i];
+        if (!submesh.TexturePaths.IsEmpty())
+        {
+            // Placeholder is only read by the main thread, so the streamed material is built aside && swapped on publish.
+            Ref<Gauntlet::Material> material = Material::Create();
+            material->m_AlbedoTextures       = LoadMaterialTextures(submesh.TexturePaths.Albedo);
+            material->m_NormalTextures       = LoadMaterialTextures(submesh.TexturePaths.Normal);
+            material->m_MetallicTextures     = LoadMaterialTextures(submesh.TexturePaths.Metallic);
+            material->m_RougnessTextures     = LoadMaterialTextures(submesh.TexturePaths.Roughness);
+            material->m_AOTextures           = LoadMaterialTextures(submesh.TexturePaths.AO);
+            material->Invalidate();
+
+            submesh.StreamedMaterial = material;
+        }
+
+        m_StreamedMaterialCount.store(static_cast<uint32_t>(i + 1), std::memory_order_release);
+    }
 }
 
-Ref<Mesh> Mesh::Create(const std::string& filePath)
+void Mesh::Publish()
 {
-    return Ref<Mesh>(new Mesh(filePath));
+    if (!m_bIsLoaded)
+    {
+        if (!m_bIsGeometryStreamed.load(std::memory_order_acquire)) return;
+
+        m_bIsLoaded = true;
+    }
+
+    const uint32_t streamedMaterialCount = m_StreamedMaterialCount.load(std::memory_order_acquire);
+    for (; m_PublishedMaterialCount < streamedMaterialCount; ++m_PublishedMaterialCount)
+    {
+        auto& submesh = m_Submeshes[m_PublishedMaterialCount];
+        if (!submesh.StreamedMaterial) continue;
+
+        // Parameters may have been tweaked in editor meanwhile.
+        submesh.StreamedMaterial->m_Data = submesh.Material->m_Data;
+        m_RetiredMaterials.emplace_back(std::move(submesh.Material));
+        submesh.Material = std::move(submesh.StreamedMaterial);
+    }
 }
 
-Mesh::Mesh(const std::string& meshPath)
+float Mesh::GetLoadProgress() const
 {
-    JobSystem::Submit(
-        [this, meshPath]
-        {
-            LoadMesh(meshPath);
+    if (!m_bIsLoaded) return 0.0f;
+    if (m_Submeshes.empty()) return 1.0f;
 
-            BufferSpecification vbInfo = {};
-            vbInfo.Usage               = EBufferUsageFlags::VERTEX_BUFFER | EBufferUsageFlags::TRANSFER_DST;
+    // Geometry && textures weigh the same, textures are usually the bigger half on disk, but geometry is what makes mesh visible.
+    return 0.5f + 0.5f * static_cast<float>(m_PublishedMaterialCount) / static_cast<float>(m_Submeshes.size());
+}
 
-            BufferSpecification ibInfo = {};
-            ibInfo.Usage               = EBufferUsageFlags::INDEX_BUFFER | EBufferUsageFlags::TRANSFER_DST;
+void Mesh::PublishStreamedMeshes()
+{
+    GNT_PROFILE_FUNCTION();
 
-#if MESH_SHADING_TEST
+    std::scoped_lock<std::mutex> Lock(s_StreamingMutex);
 
-            BufferSpecification sbInfo = {};
-            sbInfo.Usage               = EBufferUsageFlags::STORAGE_BUFFER | EBufferUsageFlags::TRANSFER_DST;
+    float pendingProgress = 0.0f;
+    for (size_t i = 0; i < s_StreamingMeshes.size();)
+    {
+        auto& mesh = s_StreamingMeshes[i];
+        mesh->Publish();
+        if (mesh->m_bIsLoaded && mesh->m_PublishedMaterialCount == mesh->m_Submeshes.size())
+        {
+            // Order doesn't matter, last one fills the gap.
+            mesh = std::move(s_StreamingMeshes.back());
+            s_StreamingMeshes.pop_back();
+            continue;
+        }
 
-#endif
+        pendingProgress += mesh->GetLoadProgress();
+        ++i;
+    }
 
-            for (auto& submesh : m_Submeshes)
-            {
-                if (m_bIsAnimated)
-                    vbInfo.Count = submesh.AnimatedVertices.size();
-                else
-                    vbInfo.Count = submesh.Vertices.size();
-
-                Ref<Gauntlet::VertexBuffer> vertexBuffer = Gauntlet::VertexBuffer::Create(vbInfo);
-
-                if (m_bIsAnimated)
-                {
-                    vertexBuffer->SetData(submesh.AnimatedVertices.data(),
-                                          submesh.AnimatedVertices.size() * sizeof(submesh.AnimatedVertices[0]));
-                    submesh.AnimatedVertices.clear();
-                }
-                else
-                {
-                    vertexBuffer->SetData(submesh.Vertices.data(), submesh.Vertices.size() * sizeof(submesh.Vertices[0]));
-                    submesh.Vertices.clear();
-                }
-
-                m_VertexBuffers.emplace_back(vertexBuffer);
-
-                ibInfo.Count = submesh.Indices.size();
-                ibInfo.Data  = submesh.Indices.data();
-                ibInfo.Size  = submesh.Indices.size() * sizeof(submesh.Indices[0]);
-
-                m_IndexBuffers.emplace_back(Gauntlet::IndexBuffer::Create(ibInfo));
-                submesh.Indices.clear();
-            }
-        });
+    s_StreamingMeshCount = static_cast<uint32_t>(s_StreamingMeshes.size());
+    if (s_StreamingMeshCount == 0)
+    {
+        s_StreamingBatchSize = 0;
+        s_StreamingProgress  = 1.0f;
+        return;
+    }
+
+    const uint32_t streamedMeshCount = s_StreamingBatchSize - s_StreamingMeshCount;
+    s_StreamingProgress              = (static_cast<float>(streamedMeshCount) + pendingProgress) / static_cast<float>(s_StreamingBatchSize);
 }
 
-void Mesh::LoadAnimation(const aiScene* scene)
+void Mesh::LoadAnimations(const std::string& meshPath, const aiScene* scene)
 {
-    m_Animation       = MakeRef<Animation>(scene);
-    aiAnimation* anim = scene->mAnimations[0];
-    LOG_WARN("Loading animation: %s", anim->mName.C_Str());
-
-    m_Animation->m_Duration       = anim->mDuration;
-    m_Animation->m_TicksPerSecond = anim->mTicksPerSecond;
+    // Every instance of the model shares skeleton && clips imported by the first one.
+    const auto modelAnimations = AnimationLibrary::Load(meshPath, scene);
+    m_Skeleton                 = modelAnimations.Skeleton;
+    m_Animations               = modelAnimations.Clips;
 }
 
 void Mesh::LoadMesh(const std::string& meshPath)
@@ -134,7 +195,8 @@ void Mesh::LoadMesh(const std::string& meshPath)
     Assimp::Importer importer;
     const auto importFlags = aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_OptimizeGraph | aiProcess_RemoveRedundantMaterials |
                              aiProcess_ImproveCacheLocality | aiProcess_GenUVCoords | aiProcess_SortByPType | aiProcess_FindInstances |
-                             aiProcess_ValidateDataStructure | aiProcess_FindDegenerates | aiProcess_FindInvalidData;
+                             aiProcess_ValidateDataStructure | aiProcess_FindDegenerates | aiProcess_FindInvalidData |
+                             aiProcess_LimitBoneWeights;
     const aiScene* scene = importer.ReadFile(meshPath.data(), importFlags);
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
@@ -143,16 +205,9 @@ void Mesh::LoadMesh(const std::string& meshPath)
         return;
     }
 
-    m_Directory = std::string(meshPath.substr(0, meshPath.find_last_of('/'))) + std::string("/");
-    {
-        size_t pos = meshPath.find("Models/");
-        GNT_ASSERT(pos != std::string::npos);
-
-        m_Name = meshPath.substr(pos + 7, meshPath.size() - pos);
-    }
-
-    // m_bIsAnimated = scene->HasAnimations();
-    if (m_bIsAnimated) LoadAnimation(scene);
+    // Meshes without bones have nothing to skin, so they're loaded as static ones.
+    if (scene->HasAnimations()) LoadAnimations(meshPath, scene);
+    m_bIsAnimated = m_Skeleton && m_Skeleton->GetBoneCount() > 0;
 
     LOG_TRACE("Loading mesh: %s...", m_Name.data());
     ProcessNode(scene->mRootNode, scene);
@@ -270,6 +325,27 @@ template <> void Mesh::OptimizeMesh<MeshVertex>(Submesh& submesh)
 #endif
 }
 
+// Sphere around vertices AABB, not the tightest one, but good enough for culling.
+template <typename VertexType> static glm::vec4 ComputeBoundingSphere(const std::vector<VertexType>& vertices)
+{
+    if (vertices.empty()) return glm::vec4(0.0f);
+
+    glm::vec3 min = vertices[0].Position;
+    glm::vec3 max = vertices[0].Position;
+    for (const auto& vertex : vertices)
+    {
+        min = glm::min(min, vertex.Position);
+        max = glm::max(max, vertex.Position);
+    }
+
+    const glm::vec3 center = (min + max) * 0.5f;
+    float radius           = 0.0f;
+    for (const auto& vertex : vertices)
+        radius = glm::max(radius, glm::length(vertex.Position - center));
+
+    return glm::vec4(center, radius);
+}
+
 void Mesh::ProcessNode(aiNode* node, const aiScene* scene)
 {
     for (unsigned int i = 0; i < node->mNumMeshes; ++i)
@@ -281,11 +357,13 @@ void Mesh::ProcessNode(aiNode* node, const aiScene* scene)
         {
             submesh = ProcessAnimatedSubmesh(mesh, scene);
             OptimizeMesh<AnimatedVertex>(submesh);
+            submesh.BoundingSphere = ComputeBoundingSphere(submesh.AnimatedVertices);
         }
         else
         {
             submesh = ProcessSubmesh(mesh, scene);
             OptimizeMesh<MeshVertex>(submesh);
+            submesh.BoundingSphere = ComputeBoundingSphere(submesh.Vertices);
         }
 
         m_Submeshes.push_back(submesh);
@@ -327,72 +405,25 @@ Submesh Mesh::ProcessAnimatedSubmesh(aiMesh* mesh, const aiScene* scene)
             Indices.push_back(face.mIndices[j]);
     }
 
-    // Materials
-    std::vector<Ref<Texture2D>> albedoTextures;
-    std::vector<Ref<Texture2D>> normalTextures;
-    std::vector<Ref<Texture2D>> metallicTextures;
-    std::vector<Ref<Texture2D>> roughnessTextures;
-    std::vector<Ref<Texture2D>> aoTextures;
-    if (mesh->mMaterialIndex >= 0)
-    {
-        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-
-        const auto baseColor = LoadMaterialTextures(material, aiTextureType_BASE_COLOR);
-
-        const auto albedos = LoadMaterialTextures(material, aiTextureType_DIFFUSE);
-        albedoTextures.insert(albedoTextures.end(), albedos.begin(), albedos.end());
-
-        const auto normalMaps = LoadMaterialTextures(material, aiTextureType_NORMALS);
-        normalTextures.insert(normalTextures.end(), normalMaps.begin(), normalMaps.end());
-
-        const auto metallic = LoadMaterialTextures(material, aiTextureType_METALNESS);
-        metallicTextures.insert(metallicTextures.end(), metallic.begin(), metallic.end());
-
-        const auto rougnhess = LoadMaterialTextures(material, aiTextureType_DIFFUSE_ROUGHNESS);
-        roughnessTextures.insert(roughnessTextures.end(), rougnhess.begin(), rougnhess.end());
-
-        const auto ao = LoadMaterialTextures(material, aiTextureType_AMBIENT_OCCLUSION);
-        aoTextures.insert(aoTextures.end(), ao.begin(), ao.end());
-    }
-
+    // Placeholder material(default textures) is drawn until textures of the submesh are streamed.
     Ref<Gauntlet::Material> Material = Material::Create();
-    Material->m_AlbedoTextures       = albedoTextures;
-    Material->m_NormalTextures       = normalTextures;
-    Material->m_MetallicTextures     = metallicTextures;
-    Material->m_RougnessTextures     = roughnessTextures;
-    Material->m_AOTextures           = aoTextures;
     Material->Invalidate();
 
-    return Submesh(mesh->mName.C_Str(), Vertices, Indices, Material);
+    Submesh submesh(mesh->mName.C_Str(), Vertices, Indices, Material);
+    if (mesh->mMaterialIndex >= 0) GatherTexturePaths(scene->mMaterials[mesh->mMaterialIndex], submesh.TexturePaths);
+
+    return submesh;
 }
 
 void Mesh::ExtractBoneWeightForVertices(std::vector<AnimatedVertex>& vertices, aiMesh* mesh, const aiScene* scene)
 {
+    GNT_ASSERT(m_Skeleton, "Skeleton should be loaded before vertices!");
+
     for (uint32_t boneIndex = 0; boneIndex < mesh->mNumBones; ++boneIndex)
     {
-        int32_t boneID       = -1;
-        std::string boneName = mesh->mBones[boneIndex]->mName.C_Str();
+        const int32_t boneID = m_Skeleton->FindBone(mesh->mBones[boneIndex]->mName.C_Str());
+        if (boneID == -1) continue;
 
-        if (m_BoneMap.find(boneName) == m_BoneMap.end())
-        {
-            LOG_DEBUG("BoneInfoMap adding: %s", boneName.c_str());
-
-            BoneInfo newBoneInfo;
-            newBoneInfo.ID = m_BoneMap.size();
-            for (uint32_t i = 0; i < 4; ++i)
-            {
-                for (uint32_t j = 0; j < 4; ++j)
-                {
-                    newBoneInfo.Offset[i][j] = mesh->mBones[boneIndex]->mOffsetMatrix[i][j];
-                }
-            }
-            m_BoneMap[boneName] = newBoneInfo;
-            boneID              = newBoneInfo.ID;
-        }
-        else
-            boneID = m_BoneMap[boneName].ID;
-
-        GNT_ASSERT(boneID != -1);
         const auto weights       = mesh->mBones[boneIndex]->mWeights;
         const int32_t numWeights = mesh->mBones[boneIndex]->mNumWeights;
         for (int32_t weightIndex = 0; weightIndex < numWeights; ++weightIndex)
@@ -443,62 +474,54 @@ Submesh Mesh::ProcessSubmesh(aiMesh* mesh, const aiScene* scene)
             Indices.push_back(face.mIndices[j]);
     }
 
-    // Materials
-    std::vector<Ref<Texture2D>> albedoTextures;
-    std::vector<Ref<Texture2D>> normalTextures;
-    std::vector<Ref<Texture2D>> metallicTextures;
-    std::vector<Ref<Texture2D>> roughnessTextures;
-    std::vector<Ref<Texture2D>> aoTextures;
-    if (mesh->mMaterialIndex >= 0)
-    {
-        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-
-        const auto albedos = LoadMaterialTextures(material, aiTextureType_DIFFUSE);
-        albedoTextures.insert(albedoTextures.end(), albedos.begin(), albedos.end());
-
-        const auto normalMaps = LoadMaterialTextures(material, aiTextureType_NORMALS);
-        normalTextures.insert(normalTextures.end(), normalMaps.begin(), normalMaps.end());
+    // Placeholder material(default textures) is drawn until textures of the submesh are streamed.
+    Ref<Gauntlet::Material> Material = Material::Create();
+    Material->Invalidate();
 
-        const auto metallic = LoadMaterialTextures(material, aiTextureType_METALNESS);
-        metallicTextures.insert(metallicTextures.end(), metallic.begin(), metallic.end());
+    Submesh submesh(mesh->mName.C_Str(), Vertices, Indices, Material);
+    if (mesh->mMaterialIndex >= 0) GatherTexturePaths(scene->mMaterials[mesh->mMaterialIndex], submesh.TexturePaths);
 
-        const auto rougnhess = LoadMaterialTextures(material, aiTextureType_DIFFUSE_ROUGHNESS);
-        roughnessTextures.insert(roughnessTextures.end(), rougnhess.begin(), rougnhess.end());
+    return submesh;
+}
 
-        const auto ao = LoadMaterialTextures(material, aiTextureType_AMBIENT_OCCLUSION);
-        aoTextures.insert(aoTextures.end(), ao.begin(), ao.end());
-    }
+void Mesh::GatherTexturePaths(aiMaterial* material, MaterialTexturePaths& outPaths)
+{
+    const auto gatherPaths = [material](const aiTextureType type, std::vector<std::string>& outTypePaths)
+    {
+        const uint32_t textureCount = material->GetTextureCount(type);
+        for (uint32_t i = 0; i < textureCount; ++i)
+        {
+            aiString str;
+            if (material->GetTexture(type, i, &str) != aiReturn_SUCCESS)
+            {
+                LOG_WARN("Failed to load texture %s", str.C_Str());
+                continue;
+            }
 
-    Ref<Gauntlet::Material> Material = Material::Create();
-    Material->m_AlbedoTextures       = albedoTextures;
-    Material->m_NormalTextures       = normalTextures;
-    Material->m_MetallicTextures     = metallicTextures;
-    Material->m_RougnessTextures     = roughnessTextures;
-    Material->m_AOTextures           = aoTextures;
-    Material->Invalidate();
+            outTypePaths.emplace_back(str.C_Str());
+        }
+    };
 
-    return Submesh(mesh->mName.C_Str(), Vertices, Indices, Material);
+    gatherPaths(aiTextureType_DIFFUSE, outPaths.Albedo);
+    gatherPaths(aiTextureType_NORMALS, outPaths.Normal);
+    gatherPaths(aiTextureType_METALNESS, outPaths.Metallic);
+    gatherPaths(aiTextureType_DIFFUSE_ROUGHNESS, outPaths.Roughness);
+    gatherPaths(aiTextureType_AMBIENT_OCCLUSION, outPaths.AO);
 }
 
-std::vector<Ref<Texture2D>> Mesh::LoadMaterialTextures(aiMaterial* mat, aiTextureType type)
+std::vector<Ref<Texture2D>> Mesh::LoadMaterialTextures(const std::vector<std::string>& texturePaths)
 {
     std::vector<Ref<Texture2D>> Textures;
-    const uint32_t TextureCount = mat->GetTextureCount(type);
-    for (uint32_t i = 0; i < TextureCount; ++i)
+    for (const auto& LocalTexturePath : texturePaths)
     {
-        aiString str;
-        aiReturn res = mat->GetTexture(type, i, &str);
-        if (res != aiReturn_SUCCESS) LOG_WARN("Failed to load texture %s", str.C_Str());
-
-        const bool bIsLoaded = m_LoadedTextures.contains(str.C_Str());
+        const bool bIsLoaded = m_LoadedTextures.contains(LocalTexturePath);
         if (bIsLoaded)
         {
-            Textures.push_back(m_LoadedTextures[str.C_Str()]);
+            Textures.push_back(m_LoadedTextures[LocalTexturePath]);
             continue;
         }
 
         // Hasn't loaded, so lets load it.
-        const std::string LocalTexturePath(str.C_Str());
         const auto TexturePath           = m_Directory + LocalTexturePath;
         TextureSpecification textureSpec = {};
         textureSpec.CreateTextureID      = true;
@@ -530,7 +553,13 @@ void Mesh::Destroy()
         IndexBuffer->Destroy();
 
     for (auto& submesh : m_Submeshes)
+    {
         submesh.Material->Destroy();
+        if (submesh.StreamedMaterial) submesh.StreamedMaterial->Destroy();
+    }
+
+    for (auto& material : m_RetiredMaterials)
+        material->Destroy();
 
     for (auto& LoadedTexture : m_LoadedTextures)
         LoadedTexture.second->Destroy();
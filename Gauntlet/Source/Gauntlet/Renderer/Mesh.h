@@ -9,8 +9,6 @@ struct aiNode;
 struct aiScene;
 struct aiMesh;
 struct aiMaterial;
-struct aiNodeAnim;
-enum aiTextureType;
 
 namespace Gauntlet
 {
@@ -18,138 +16,16 @@ namespace Gauntlet
 class Material;
 class Texture2D;
 
-struct KeyPosition
+// Material textures are streamed after geometry, so import only gathers their paths(relative to mesh directory).
+struct MaterialTexturePaths
 {
-    glm::vec3 Position;
-    float Timetamp;
-};
-
-struct KeyRotation
-{
-    glm::quat Orientation;
-    float Timestamp;
-};
-
-struct KeyScale
-{
-    glm::vec3 Scale;
-    float Timestamp;
-};
-
-class Bone final : private Unmovable, private Uncopyable
-{
-  public:
-    Bone(const std::string& name, int32_t ID, const aiNodeAnim* channel);
-
-    /*
-    interpolates  bones /w positions,rotations & scaling keys based on the current time of
-  the animation and prepares the local transformation matrix by combining all keys
-  tranformations
-  */
-    void Update(float animationTime);
-
-    /* Gets the current index on mKeyPositions to interpolate to based on
-    the current animation time*/
-    int32_t GetPositionIndex(float animationTime)
-    {
-        for (int32_t index = 0; index < m_NumPositions - 1; ++index)
-        {
-            if (animationTime < m_Positions[index + 1].Timetamp) return index;
-        }
-        GNT_ASSERT(0);
-    }
-
-    /* Gets the current index on mKeyRotations to interpolate to based on the
-    current animation time*/
-    int32_t GetRotationIndex(float animationTime)
-    {
-        for (int32_t index = 0; index < m_NumRotations - 1; ++index)
-        {
-            if (animationTime < m_Rotations[index + 1].Timestamp) return index;
-        }
-        GNT_ASSERT(0);
-    }
-
-    /* Gets the current index on mKeyScalings to interpolate to based on the
-    current animation time */
-    int32_t GetScaleIndex(float animationTime)
-    {
-        for (int32_t index = 0; index < m_NumScalings - 1; ++index)
-        {
-            if (animationTime < m_Scales[index + 1].Timestamp) return index;
-        }
-        GNT_ASSERT(0);
-    }
-
-    FORCEINLINE glm::mat4 GetLocalTransform() { return m_LocalTransform; }
-    FORCEINLINE std::string GetName() const { return m_Name; }
-    FORCEINLINE int32_t GetID() { return m_ID; }
-
-  private:
-    std::vector<KeyPosition> m_Positions;
-    std::vector<KeyRotation> m_Rotations;
-    std::vector<KeyScale> m_Scales;
-    int32_t m_NumPositions = 0;
-    int32_t m_NumRotations = 0;
-    int32_t m_NumScalings  = 0;
-
-    glm::mat4 m_LocalTransform = glm::mat4(1.0f);
-    std::string m_Name;
-    int32_t m_ID = 0;
-
-    /* Gets normalized value for Lerp & Slerp */
-    float GetScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime)
-    {
-        float scaleFactor  = 0.0f;
-        float midWayLength = animationTime - lastTimeStamp;
-        float framesDiff   = nextTimeStamp - lastTimeStamp;
-        scaleFactor        = midWayLength / framesDiff;
-        return scaleFactor;
-    }
-
-    /*figures out which position keys to interpolate b/w and performs the interpolation
-    and returns the translation matrix*/
-    glm::mat4 InterpolatePosition(float animationTime)
-    {
-        if (1 == m_NumPositions) return glm::translate(glm::mat4(1.0f), m_Positions[0].Position);
-
-        int32_t p0Index         = GetPositionIndex(animationTime);
-        int32_t p1Index         = p0Index + 1;
-        float scaleFactor       = GetScaleFactor(m_Positions[p0Index].Timetamp, m_Positions[p1Index].Timetamp, animationTime);
-        glm::vec3 finalPosition = glm::mix(m_Positions[p0Index].Position, m_Positions[p1Index].Position, scaleFactor);
-        return glm::translate(glm::mat4(1.0f), finalPosition);
-    }
-
-    /*figures out which rotations keys to interpolate b/w and performs the interpolation
-    and returns the rotation matrix*/
-    glm::mat4 InterpolateRotation(float animationTime)
-    {
-        if (1 == m_NumRotations)
-        {
-            auto rotation = glm::normalize(m_Rotations[0].Orientation);
-            return glm::toMat4(rotation);
-        }
-
-        int32_t p0Index         = GetRotationIndex(animationTime);
-        int32_t p1Index         = p0Index + 1;
-        float scaleFactor       = GetScaleFactor(m_Rotations[p0Index].Timestamp, m_Rotations[p1Index].Timestamp, animationTime);
-        glm::quat finalRotation = glm::slerp(m_Rotations[p0Index].Orientation, m_Rotations[p1Index].Orientation, scaleFactor);
-        finalRotation           = glm::normalize(finalRotation);
-        return glm::toMat4(finalRotation);
-    }
+    std::vector<std::string> Albedo;
+    std::vector<std::string> Normal;
+    std::vector<std::string> Metallic;
+    std::vector<std::string> Roughness;
+    std::vector<std::string> AO;
 
-    /*figures out which scaling keys to interpolate b/w and performs the interpolation
-    and returns the scale matrix*/
-    glm::mat4 InterpolateScaling(float animationTime)
-    {
-        if (1 == m_NumScalings) return glm::scale(glm::mat4(1.0f), m_Scales[0].Scale);
-
-        int32_t p0Index      = GetScaleIndex(animationTime);
-        int32_t p1Index      = p0Index + 1;
-        float scaleFactor    = GetScaleFactor(m_Scales[p0Index].Timestamp, m_Scales[p1Index].Timestamp, animationTime);
-        glm::vec3 finalScale = glm::mix(m_Scales[p0Index].Scale, m_Scales[p1Index].Scale, scaleFactor);
-        return glm::scale(glm::mat4(1.0f), finalScale);
-    }
+    FORCEINLINE bool IsEmpty() const { return Albedo.empty() && Normal.empty() && Metallic.empty() && Roughness.empty() && AO.empty(); }
 };
 
 class Submesh final
@@ -174,16 +50,14 @@ class Submesh final
     std::vector<AnimatedVertex> AnimatedVertices;
     std::vector<uint32_t> Indices;
     Ref<Gauntlet::Material> Material;
+    Ref<Gauntlet::Material> StreamedMaterial;  // Built by streaming job, replaces placeholder material once published.
+    MaterialTexturePaths TexturePaths;
     std::string Name;
-};
-
-struct BoneInfo
-{
-    int32_t ID;        // index in finalBoneMatrices
-    glm::mat4 Offset;  // offset matrix transforms vertex from model space to bone space
+    glm::vec4 BoundingSphere = glm::vec4(0.0f);  // Object space, xyz - center, w - radius
 };
 
 class Animation;
+struct Skeleton;
 
 class Mesh final
 {
@@ -203,23 +77,51 @@ class Mesh final
     FORCEINLINE const auto& GetMeshNameWithDirectory() { return m_Name; }
 
     FORCEINLINE const Ref<Gauntlet::Material>& GetMaterial(const uint32_t meshIndex) { return m_Submeshes[meshIndex].Material; }
+    FORCEINLINE const auto& GetBoundingSphere(const uint32_t meshIndex) const { return m_Submeshes[meshIndex].BoundingSphere; }
+    FORCEINLINE const auto& GetAnimatedVertices(const uint32_t meshIndex) const { return m_Submeshes[meshIndex].AnimatedVertices; }
     FORCEINLINE bool IsAnimated() const { return m_bIsAnimated; }
-    FORCEINLINE Ref<Animation>& GetAnimation() { return m_Animation; }
+    FORCEINLINE const Ref<Skeleton>& GetSkeleton() const { return m_Skeleton; }
+    FORCEINLINE const auto& GetAnimations() const { return m_Animations; }
+
+    // Geometry is published, mesh can be drawn, its textures may still be streaming. Nothing but the name can be read before.
+    FORCEINLINE bool IsLoaded() const { return m_bIsLoaded; }
 
+    // Mesh is returned right away, it's loaded on a background thread && published by PublishStreamedMeshes().
     static Ref<Mesh> Create(const std::string& modelPath);
 
+    // Called at frame boundary on the main thread, while render thread is idle.
+    static void PublishStreamedMeshes();
+
+    FORCEINLINE static uint32_t GetStreamingMeshCount() { return s_StreamingMeshCount; }
+
+    // [0, 1], covers every mesh requested since the last time nothing was streaming.
+    FORCEINLINE static float GetStreamingProgress() { return s_StreamingProgress; }
+
   private:
     std::string m_Name{"None"};
     std::string m_Directory;
     std::vector<Submesh> m_Submeshes;
 
-    bool m_bIsAnimated         = false;
-    Ref<Animation> m_Animation = nullptr;
-    std::map<std::string, BoneInfo> m_BoneMap;
+    bool m_bIsAnimated          = false;
+    Ref<Skeleton> m_Skeleton    = nullptr;  // Shared by all animations && animators of this mesh.
+    std::vector<Ref<Animation>> m_Animations;
 
     // Optimization to prevent loading the same textures.
     std::unordered_map<std::string, Ref<Texture2D>> m_LoadedTextures;
 
+    // Written by streaming job, read on the main thread, which publishes the results.
+    std::atomic<bool> m_bIsGeometryStreamed       = false;
+    std::atomic<uint32_t> m_StreamedMaterialCount = 0;  // Submeshes whose textures are done, in submesh order.
+    bool m_bIsLoaded                              = false;
+    uint32_t m_PublishedMaterialCount             = 0;
+    std::vector<Ref<Gauntlet::Material>> m_RetiredMaterials;  // Placeholders, in-flight frames may still reference them.
+
+    static inline std::mutex s_StreamingMutex;
+    static inline std::vector<Ref<Mesh>> s_StreamingMeshes;  // Keep meshes alive until their streaming is done.
+    static inline uint32_t s_StreamingBatchSize = 0;
+    static inline uint32_t s_StreamingMeshCount = 0;
+    static inline float s_StreamingProgress     = 1.0f;
+
 #if MESH_SHADING_TEST
     std::vector<Meshlet> m_Meshlets;
     std::vector<Ref<StorageBuffer>> m_MeshletBuffers;
@@ -228,11 +130,15 @@ class Mesh final
     std::vector<Ref<VertexBuffer>> m_VertexBuffers;
     std::vector<Ref<IndexBuffer>> m_IndexBuffers;
 
-    Mesh(const std::string& meshPath);
     void Destroy();
 
+    void Stream(const std::string& meshPath);
+    void StreamTextures();
+    void Publish();
+    float GetLoadProgress() const;
+
     void LoadMesh(const std::string& meshPath);
-    void LoadAnimation(const aiScene* scene);
+    void LoadAnimations(const std::string& meshPath, const aiScene* scene);
 
     void ProcessNode(aiNode* node, const aiScene* scene);
     Submesh ProcessSubmesh(aiMesh* mesh, const aiScene* scene);
@@ -240,7 +146,8 @@ class Mesh final
     template <typename VertexType> void OptimizeMesh(Submesh& submesh);
 
     Submesh ProcessAnimatedSubmesh(aiMesh* mesh, const aiScene* scene);
-    std::vector<Ref<Texture2D>> LoadMaterialTextures(aiMaterial* mat, aiTextureType type);
+    void GatherTexturePaths(aiMaterial* material, MaterialTexturePaths& outPaths);
+    std::vector<Ref<Texture2D>> LoadMaterialTextures(const std::vector<std::string>& texturePaths);
 
     void ExtractBoneWeightForVertices(std::vector<AnimatedVertex>& vertices, aiMesh* mesh, const aiScene* scene);
 
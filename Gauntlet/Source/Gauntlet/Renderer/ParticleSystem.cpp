@@ -2,149 +2,353 @@
 #include "ParticleSystem.h"
 
 #include "Renderer.h"
+#include "RendererAPI.h"
 #include "Pipeline.h"
 #include "Buffer.h"
 #include "CommandBuffer.h"
+#include "GPUQueryRing.h"
 #include "Framebuffer.h"
 
 #include "Gauntlet/Core/Random.h"
 #include "Gauntlet/Core/Application.h"
 
+#include "Gauntlet/Platform/Vulkan/VulkanParticleSystem.h"
+
+#include <numeric>
+
 namespace Gauntlet
 {
 
-// TODO: Make ParticleEmitter component?
-ParticleSystem::ParticleSystem()
+// Keep in sync with ParticleSimulation.comp
+enum class EParticleSimulationStage : uint32_t
+{
+    EMITTERS = 0,
+    EMIT,
+    SIMULATE,
+    FINALIZE
+};
+
+// Keep in sync with ParticleSort.comp
+enum class EParticleSortMode : uint32_t
+{
+    LOCAL_SORT = 0,
+    GLOBAL_STEP,
+    LOCAL_MERGE
+};
+
+Ref<ParticleSystem> ParticleSystem::Create()
 {
-    std::vector<Particle> particles(m_BaseParticleCount);
-    for (auto& particle : particles)
+    switch (RendererAPI::Get())
     {
-        const float r     = 0.25f * sqrt(Random::GetInRange0To1());
-        const float theta = Random::GetInRange0To1() * 2 * 3.14159265358979323846;
-        const float x     = r * cos(theta);
-        const float y     = r * sin(theta);
-        const float z     = r;
-
-        particle.position = glm::vec3(x, y, z);
-        particle.velocity = glm::normalize(particle.position) * 0.00025f;
-        particle.color    = glm::vec4(Random::GetInRange0To1(), Random::GetInRange0To1(), Random::GetInRange0To1(), 1.0f);
+        case RendererAPI::EAPI::Vulkan:
+        {
+            return MakeRef<VulkanParticleSystem>();
+        }
+        case RendererAPI::EAPI::None:
+        {
+            LOG_ERROR("RendererAPI::EAPI::None!");
+            GNT_ASSERT(false, "Unknown RendererAPI!");
+            break;
+        }
     }
 
-    BufferSpecification ssboVertBufferInfo = {};
-    ssboVertBufferInfo.Usage = EBufferUsageFlags::STORAGE_BUFFER | EBufferUsageFlags::VERTEX_BUFFER | EBufferUsageFlags::TRANSFER_DST;
-    for (auto& buffer : m_SSBOVertexBuffer)
+    return nullptr;
+}
+
+ParticleSystem::ParticleSystem()
+{
+    ReservePool(Renderer::GetSettings().ParticlePoolSize);
+
+    for (auto& computeCommandBuffer : m_ComputeCommandBuffer)
+        computeCommandBuffer = CommandBuffer::Create(ECommandBufferType::COMMAND_BUFFER_TYPE_COMPUTE);
+    m_QueryRing = GPUQueryRing::Create(ECommandBufferType::COMMAND_BUFFER_TYPE_COMPUTE, 4);
+
+    BufferSpecification emittersBufferSpec = {};
+    emittersBufferSpec.Usage               = EBufferUsageFlags::STORAGE_BUFFER | EBufferUsageFlags::TRANSFER_DST;
+    emittersBufferSpec.Size                = 256 * sizeof(GPUParticleEmitter);  // Grows on demand.
+    for (auto& emittersBuffer : m_EmittersBuffer)
+        emittersBuffer = StorageBuffer::Create(emittersBufferSpec);
+
+    for (auto& simulationUB : m_SimulationUniformBuffer)
     {
-        buffer = StorageBuffer::Create(ssboVertBufferInfo);
-        buffer->SetData(particles.data(), particles.size() * sizeof(particles[0]));
+        simulationUB = UniformBuffer::Create(sizeof(UBParticleSimulation));
+        simulationUB->Map(true);
     }
 
-    PipelineSpecification psComputePipelineSpec = {};
-    psComputePipelineSpec.Name                  = "GPU-Based_Compute_ParticleSystem";
-    psComputePipelineSpec.Shader                = ShaderLibrary::Load("ParticleSystem");
-    psComputePipelineSpec.PipelineType          = EPipelineType::PIPELINE_TYPE_COMPUTE;
-
-    m_ComputePipeline = Pipeline::Create(psComputePipelineSpec);
-
-    PipelineSpecification psRenderingPipelineSpec = {};
-    psRenderingPipelineSpec.Name                  = "GPU-Based_Rendering_ParticleSystem";
-    psRenderingPipelineSpec.PolygonMode           = EPolygonMode::POLYGON_MODE_FILL;
-    psRenderingPipelineSpec.PrimitiveTopology     = EPrimitiveTopology::PRIMITIVE_TOPOLOGY_POINT_LIST;
-    psRenderingPipelineSpec.FrontFace             = EFrontFace::FRONT_FACE_COUNTER_CLOCKWISE;
-    psRenderingPipelineSpec.CullMode              = ECullMode::CULL_MODE_BACK;
-    psRenderingPipelineSpec.Shader                = ShaderLibrary::Get("ParticleSystem");
-    psRenderingPipelineSpec.PipelineType          = EPipelineType::PIPELINE_TYPE_GRAPHICS;
-    psRenderingPipelineSpec.TargetFramebuffer     = Renderer::GetStorageData().GeometryFramebuffer;
-    psRenderingPipelineSpec.DepthCompareOp        = ECompareOp::COMPARE_OP_LESS;
-    psRenderingPipelineSpec.bDepthTest            = true;
-    psRenderingPipelineSpec.bDepthWrite           = true;
-
-    m_RenderingPipeline = Pipeline::Create(psRenderingPipelineSpec);
+    PipelineSpecification simulationPipelineSpec = {};
+    simulationPipelineSpec.Name                  = "ParticleSimulation";
+    simulationPipelineSpec.Shader                = ShaderLibrary::Load("ParticleSimulation");
+    simulationPipelineSpec.PipelineType          = EPipelineType::PIPELINE_TYPE_COMPUTE;
+
+    m_SimulationPipeline = Pipeline::Create(simulationPipelineSpec);
+
+    PipelineSpecification sortPipelineSpec = {};
+    sortPipelineSpec.Name                  = "ParticleSort";
+    sortPipelineSpec.Shader                = ShaderLibrary::Load("ParticleSort");
+    sortPipelineSpec.PipelineType          = EPipelineType::PIPELINE_TYPE_COMPUTE;
+
+    m_SortPipeline = Pipeline::Create(sortPipelineSpec);
+
+    // Alpha blended on top of the lit image, tested but not written against GBuffer depth.
+    PipelineSpecification renderingPipelineSpec = {};
+    renderingPipelineSpec.Name                  = "ParticleRendering";
+    renderingPipelineSpec.PolygonMode           = EPolygonMode::POLYGON_MODE_FILL;
+    renderingPipelineSpec.PrimitiveTopology     = EPrimitiveTopology::PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    renderingPipelineSpec.FrontFace             = EFrontFace::FRONT_FACE_COUNTER_CLOCKWISE;
+    renderingPipelineSpec.CullMode              = ECullMode::CULL_MODE_NONE;
+    renderingPipelineSpec.Shader                = ShaderLibrary::Load("ParticleSystem");
+    renderingPipelineSpec.PipelineType          = EPipelineType::PIPELINE_TYPE_GRAPHICS;
+    renderingPipelineSpec.TargetFramebuffer     = Renderer::GetStorageData().ParticleFramebuffer;
+    renderingPipelineSpec.DepthCompareOp        = ECompareOp::COMPARE_OP_LESS;
+    renderingPipelineSpec.bDepthTest            = true;
+    renderingPipelineSpec.bDepthWrite           = false;
+    renderingPipelineSpec.bBlendEnable          = true;
+
+    m_RenderingPipeline = Pipeline::Create(renderingPipelineSpec);
 }
 
 void ParticleSystem::Destroy()
 {
-    for (auto& Buffer : m_SSBOVertexBuffer)
-        Buffer->Destroy();
+    for (auto& computeCommandBuffer : m_ComputeCommandBuffer)
+        computeCommandBuffer->Destroy();
+    m_QueryRing->Destroy();
+
+    DestroyPool();
+
+    for (auto& emittersBuffer : m_EmittersBuffer)
+        emittersBuffer->Destroy();
+
+    for (auto& simulationUB : m_SimulationUniformBuffer)
+    {
+        simulationUB->Unmap();
+        simulationUB->Destroy();
+    }
 
     m_RenderingPipeline->Destroy();
-    m_ComputePipeline->Destroy();
+    m_SortPipeline->Destroy();
+    m_SimulationPipeline->Destroy();
 }
 
-void ParticleSystem::OnUpdate()
+void ParticleSystem::SubmitEmitter(const ParticleEmitter& emitter)
 {
-    m_ComputePipeline->GetSpecification().Shader->Set(
-        "s_ParticleSSBOIn", m_SSBOVertexBuffer[(GraphicsContext::Get().GetCurrentFrameIndex() - 1) % FRAMES_IN_FLIGHT]);
+    auto slotIt = m_EmitterSlots.find(emitter.ID);
+    if (slotIt == m_EmitterSlots.end())
+    {
+        uint32_t slot = static_cast<uint32_t>(m_Emitters.size());
+        if (!m_FreeEmitterSlots.empty())
+        {
+            slot = m_FreeEmitterSlots.back();
+            m_FreeEmitterSlots.pop_back();
+        }
+        else
+        {
+            m_Emitters.emplace_back();
+            m_EmitterSlotIDs.emplace_back();
+            m_bIsEmitterSubmitted.emplace_back();
+        }
+
+        slotIt = m_EmitterSlots.emplace(emitter.ID, slot).first;
+    }
+
+    const uint32_t slot          = slotIt->second;
+    auto& gpuEmitter             = m_Emitters[slot];
+    gpuEmitter.Transform         = emitter.Transform;
+    gpuEmitter.StartColor        = emitter.StartColor;
+    gpuEmitter.EndColor          = emitter.EndColor;
+    gpuEmitter.Velocity          = emitter.Velocity;
+    gpuEmitter.VelocityVariation = emitter.VelocityVariation;
+    gpuEmitter.BoundsExtent      = emitter.BoundsExtent;
+    gpuEmitter.Lifetime          = emitter.Lifetime;
+    gpuEmitter.StartSize         = emitter.StartSize;
+    gpuEmitter.EndSize           = emitter.EndSize;
+    gpuEmitter.SpawnCount        = emitter.SpawnCount;
+    gpuEmitter.IsActive          = 1;
 
-    m_ComputePipeline->GetSpecification().Shader->Set("s_ParticleSSBOOut",
-                                                      m_SSBOVertexBuffer[GraphicsContext::Get().GetCurrentFrameIndex()]);
+    m_EmitterSlotIDs[slot]      = emitter.ID;
+    m_bIsEmitterSubmitted[slot] = true;
 }
 
-void ParticleSystem::OnCompute(uint32_t particleCount)
+void ParticleSystem::PrepareEmitters(UBParticleSimulation& simulationData)
 {
-    m_CurrentParticleCount = particleCount;
+    // Slots of emitters that weren't submitted this frame are released, their alive particles are left to die.
+    uint32_t spawnOffset = 0;
+    for (uint32_t slot = 0; slot < m_Emitters.size(); ++slot)
+    {
+        auto& gpuEmitter = m_Emitters[slot];
+        if (!m_bIsEmitterSubmitted[slot] && gpuEmitter.IsActive)
+        {
+            gpuEmitter.IsActive   = 0;
+            gpuEmitter.SpawnCount = 0;
+            m_EmitterSlots.erase(m_EmitterSlotIDs[slot]);
+            m_FreeEmitterSlots.push_back(slot);
+        }
+
+        gpuEmitter.SpawnOffset = spawnOffset;
+        spawnOffset += gpuEmitter.SpawnCount;
+        m_bIsEmitterSubmitted[slot] = false;
+    }
 
-    Ref<CommandBuffer> computeCommandBuffer = CommandBuffer::Create(ECommandBufferType::COMMAND_BUFFER_TYPE_COMPUTE);
-    computeCommandBuffer->BeginRecording(true);
-    computeCommandBuffer->BeginDebugLabel("GPU-Based Particle System", glm::vec4(0, 1, 0, 1));
+    simulationData.EmitterCount = static_cast<uint32_t>(m_Emitters.size());
+    simulationData.SpawnCount   = spawnOffset;
+}
 
-    computeCommandBuffer->BeginTimestamp(true);
-    computeCommandBuffer->BeginTimestamp();
+void ParticleSystem::DestroyPool()
+{
+    for (auto& buffer : {m_ParticlesBuffer, m_DeadListBuffer, m_AliveListsBuffer, m_SortListBuffer, m_CountersBuffer, m_IndirectArgsBuffer})
+        buffer->Destroy();
+}
 
-    struct PushConstants
+bool ParticleSystem::ReservePool(const uint32_t poolSize)
+{
+    if (poolSize == m_PoolSize) return false;
+
+    // Buffers are in use by both queues.
+    if (m_PoolSize != 0)
     {
-        float DeltaTime;
-        uint32_t ParticleCount;
-    } u_ParticleSystemData;
+        {
+            GRAPHICS_GUARD_LOCK;
+            GraphicsContext::Get().WaitDeviceOnFinish();
+        }
+
+        // Destroying buffers takes the lock itself.
+        DestroyPool();
+    }
 
-    u_ParticleSystemData.ParticleCount = m_CurrentParticleCount;
-    u_ParticleSystemData.DeltaTime     = Application::Get().GetDeltaTime();
-    Renderer::Dispatch(computeCommandBuffer, m_ComputePipeline, &u_ParticleSystemData, m_CurrentParticleCount / 256, 1, 1);
+    m_PoolSize       = poolSize;
+    m_SortCapacity   = s_SORT_ELEMENTS_PER_WORKGROUP;
+    m_AliveListIndex = 0;
+    while (m_SortCapacity < m_PoolSize)
+        m_SortCapacity <<= 1;
 
-    computeCommandBuffer->EndTimestamp();
-    computeCommandBuffer->EndTimestamp(true);
+    BufferSpecification poolBufferSpec = {};
+    poolBufferSpec.Usage               = EBufferUsageFlags::STORAGE_BUFFER | EBufferUsageFlags::TRANSFER_DST;
 
-    computeCommandBuffer->EndDebugLabel();
-    computeCommandBuffer->EndRecording();
-    computeCommandBuffer->Submit();
+    // Pool starts empty, every particle is dead.
+    poolBufferSpec.Size = static_cast<size_t>(m_PoolSize) * sizeof(GPUParticle);
+    m_ParticlesBuffer   = StorageBuffer::Create(poolBufferSpec);
 
-    Renderer::GetStats().PipelineStatisticsResults[10] += computeCommandBuffer->GetPipelineStatisticsResults()[0];
+    std::vector<uint32_t> deadList(m_PoolSize);
+    std::iota(deadList.begin(), deadList.end(), 0);
+    m_DeadListBuffer = StorageBuffer::Create(poolBufferSpec);
+    m_DeadListBuffer->SetData(deadList.data(), deadList.size() * sizeof(deadList[0]));
 
-    auto& timestampResults = computeCommandBuffer->GetTimestampResults();
-    const float time =
-        static_cast<float>(timestampResults[1] - timestampResults[0]) * GraphicsContext::Get().GetTimestampPeriod() / 1000000.0f;
-    const std::string str = "ParticleCompute Pass: " + std::to_string(time) + " (ms)";
-    Renderer::GetStats().PassStatistsics.push_back(str);
+    poolBufferSpec.Size = 2 * static_cast<size_t>(m_PoolSize) * sizeof(uint32_t);
+    m_AliveListsBuffer  = StorageBuffer::Create(poolBufferSpec);
+
+    poolBufferSpec.Size = static_cast<size_t>(m_SortCapacity) * sizeof(glm::uvec2);
+    m_SortListBuffer    = StorageBuffer::Create(poolBufferSpec);
+
+    // AliveCount[2], DeadCount, EmitCount, VisibleCount, SortCount
+    const std::array<uint32_t, 6> counters = {0, 0, m_PoolSize, 0, 0, s_SORT_ELEMENTS_PER_WORKGROUP};
+    poolBufferSpec.Size                    = sizeof(counters);
+    m_CountersBuffer                       = StorageBuffer::Create(poolBufferSpec);
+    m_CountersBuffer->SetData(counters.data(), sizeof(counters));
+
+    // Draw args are read by graphics queue even if the first simulation hasn't run, so nothing is drawn.
+    std::array<uint32_t, 13> indirectArgs = {};
+    indirectArgs[9]                       = 6;
+    poolBufferSpec.Usage |= EBufferUsageFlags::INDIRECT_BUFFER;
+    poolBufferSpec.Size  = sizeof(indirectArgs);
+    m_IndirectArgsBuffer = StorageBuffer::Create(poolBufferSpec);
+    m_IndirectArgsBuffer->SetData(indirectArgs.data(), sizeof(indirectArgs));
+
+    return true;
 }
 
-void ParticleSystem::OnRender(void* pushConstants)
+void ParticleSystem::RecordSimulation(const Ref<CommandBuffer>& computeCommandBuffer)
 {
-    GNT_ASSERT(m_RenderingPipeline->GetSpecification().TargetFramebuffer[GraphicsContext::Get().GetCurrentFrameIndex()],
-               "Nowhere to render particle system!");
+    const uint32_t currentFrame = GraphicsContext::Get().GetCurrentFrameIndex();
+
+    UBParticleSimulation simulationData = {};
+    PrepareEmitters(simulationData);
+
+    const auto& camera            = Renderer::GetStorageData().UBGlobalCamera;
+    simulationData.ViewProjection = camera.Projection * camera.View;
+    simulationData.CameraPosition = camera.Position;
+    simulationData.DeltaTime      = Application::Get().GetDeltaTime();
+    simulationData.PoolSize       = m_PoolSize;
+    simulationData.AliveListIndex = m_AliveListIndex;
+    simulationData.Seed           = static_cast<uint32_t>(Random::GetInRange0To1() * static_cast<float>(UINT32_MAX));
+    m_SimulationUniformBuffer[currentFrame]->SetData(&simulationData, sizeof(simulationData));
+
+    // Survivors are written into the other list, it's the input of the next frame.
+    m_AliveListIndex = 1 - m_AliveListIndex;
+
+    // SetData() grows buffers if needed, so descriptors are updated after it.
+    if (!m_Emitters.empty())
+        m_EmittersBuffer[currentFrame]->SetData(m_Emitters.data(), m_Emitters.size() * sizeof(m_Emitters[0]));
 
-    Ref<CommandBuffer> renderCommandBuffer = CommandBuffer::Create(ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS);
-    renderCommandBuffer->BeginRecording(true);
-    renderCommandBuffer->BeginDebugLabel("GPU Rendering Computed Particles", glm::vec4(0.5f, 0.95f, 0.0f, 1.0f));
-    renderCommandBuffer->BeginTimestamp();
+    auto& simulationShader = m_SimulationPipeline->GetSpecification().Shader;
+    simulationShader->Set("u_SimulationData", m_SimulationUniformBuffer[currentFrame]);
+    simulationShader->Set("s_Emitters", m_EmittersBuffer[currentFrame]);
+    simulationShader->Set("s_Particles", m_ParticlesBuffer);
+    simulationShader->Set("s_DeadList", m_DeadListBuffer);
+    simulationShader->Set("s_AliveLists", m_AliveListsBuffer);
+    simulationShader->Set("s_SortList", m_SortListBuffer);
+    simulationShader->Set("s_Counters", m_CountersBuffer);
+    simulationShader->Set("s_IndirectArgs", m_IndirectArgsBuffer);
 
-    m_RenderingPipeline->GetSpecification().TargetFramebuffer[GraphicsContext::Get().GetCurrentFrameIndex()]->BeginPass(
-        renderCommandBuffer);
+    GPUMarkerScope marker(m_QueryRing, computeCommandBuffer, "ParticleCompute Pass");
+    m_QueryRing->BeginPipelineStatistics(computeCommandBuffer);
 
-    Renderer::SubmitParticleSystem(renderCommandBuffer, m_RenderingPipeline,
-                                   m_SSBOVertexBuffer[GraphicsContext::Get().GetCurrentFrameIndex()], m_CurrentParticleCount,
-                                   pushConstants);
+    // Previous simulation on this queue might not have been consumed by graphics, when particles weren't rendered.
+    InsertSimulationBarrier(computeCommandBuffer);
 
-    m_RenderingPipeline->GetSpecification().TargetFramebuffer[GraphicsContext::Get().GetCurrentFrameIndex()]->EndPass(renderCommandBuffer);
+    auto stage = EParticleSimulationStage::EMITTERS;
+    Renderer::Dispatch(computeCommandBuffer, m_SimulationPipeline, &stage,
+                       std::max(1u, (simulationData.EmitterCount + s_WORKGROUP_SIZE - 1) / s_WORKGROUP_SIZE));
+    InsertSimulationBarrier(computeCommandBuffer);
 
-    renderCommandBuffer->EndTimestamp();
-    renderCommandBuffer->EndDebugLabel();
-    renderCommandBuffer->EndRecording();
-    renderCommandBuffer->Submit();
+    stage = EParticleSimulationStage::EMIT;
+    Renderer::DispatchIndirect(computeCommandBuffer, m_SimulationPipeline, m_IndirectArgsBuffer, s_EMIT_ARGS_OFFSET, &stage);
+    InsertSimulationBarrier(computeCommandBuffer);
 
-    auto& timestampResults = renderCommandBuffer->GetTimestampResults();
-    const float time =
-        static_cast<float>(timestampResults[1] - timestampResults[0]) * GraphicsContext::Get().GetTimestampPeriod() / 1000000.0f;
-    const std::string str = "ParticleRender Pass: " + std::to_string(time) + " (ms)";
-    Renderer::GetStats().PassStatistsics.push_back(str);
+    stage = EParticleSimulationStage::SIMULATE;
+    Renderer::DispatchIndirect(computeCommandBuffer, m_SimulationPipeline, m_IndirectArgsBuffer, s_SIMULATE_ARGS_OFFSET, &stage);
+    InsertSimulationBarrier(computeCommandBuffer);
+
+    stage = EParticleSimulationStage::FINALIZE;
+    Renderer::Dispatch(computeCommandBuffer, m_SimulationPipeline, &stage);
+    InsertSimulationBarrier(computeCommandBuffer);
+
+    if (Renderer::GetSettings().SortParticles) RecordSort(computeCommandBuffer);
+
+    m_QueryRing->EndPipelineStatistics(computeCommandBuffer);
+}
+
+void ParticleSystem::RecordSort(const Ref<CommandBuffer>& computeCommandBuffer)
+{
+    auto& sortShader = m_SortPipeline->GetSpecification().Shader;
+    sortShader->Set("s_SortList", m_SortListBuffer);
+    sortShader->Set("s_Counters", m_CountersBuffer);
+
+    struct PushConstants
+    {
+        EParticleSortMode Mode = EParticleSortMode::LOCAL_SORT;
+        uint32_t K             = s_SORT_ELEMENTS_PER_WORKGROUP;
+        uint32_t J             = 0;
+    } u_SortData;
+
+    // Bitonic network is recorded for the whole pool, steps bigger than this frame's visible count are skipped on GPU.
+    Renderer::DispatchIndirect(computeCommandBuffer, m_SortPipeline, m_IndirectArgsBuffer, s_SORT_ARGS_OFFSET, &u_SortData);
+    InsertSimulationBarrier(computeCommandBuffer);
+
+    for (uint32_t k = 2 * s_SORT_ELEMENTS_PER_WORKGROUP; k <= m_SortCapacity; k <<= 1)
+    {
+        u_SortData.K = k;
+
+        u_SortData.Mode = EParticleSortMode::GLOBAL_STEP;
+        for (uint32_t j = k / 2; j >= s_SORT_ELEMENTS_PER_WORKGROUP; j >>= 1)
+        {
+            u_SortData.J = j;
+            Renderer::DispatchIndirect(computeCommandBuffer, m_SortPipeline, m_IndirectArgsBuffer, s_SORT_ARGS_OFFSET, &u_SortData);
+            InsertSimulationBarrier(computeCommandBuffer);
+        }
+
+        u_SortData.Mode = EParticleSortMode::LOCAL_MERGE;
+        Renderer::DispatchIndirect(computeCommandBuffer, m_SortPipeline, m_IndirectArgsBuffer, s_SORT_ARGS_OFFSET, &u_SortData);
+        InsertSimulationBarrier(computeCommandBuffer);
+    }
 }
 
-}  // namespace Gauntlet
\ No newline at end of file
+}  // namespace Gauntlet
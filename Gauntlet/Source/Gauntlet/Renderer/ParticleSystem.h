@@ -3,42 +3,156 @@
 #include "Gauntlet/Core/Core.h"
 #include "Gauntlet/Core/Math.h"
 #include <array>
+#include <unordered_map>
 
 namespace Gauntlet
 {
 class Pipeline;
 class Framebuffer;
 class StorageBuffer;
+class UniformBuffer;
+class CommandBuffer;
+class GPUQueryRing;
 
-struct Particle
+// Submitted by scene each frame, emitters that weren't submitted are released along with their pool slots.
+struct ParticleEmitter
 {
-    glm::vec3 position;
-    glm::vec3 velocity;
-    glm::vec3 color;
+    uint64_t ID                 = 0;
+    glm::mat4 Transform         = glm::mat4(1.0f);
+    glm::vec4 StartColor        = glm::vec4(1.0f);
+    glm::vec4 EndColor          = glm::vec4(1.0f);
+    glm::vec3 Velocity          = glm::vec3(0.0f);
+    glm::vec3 VelocityVariation = glm::vec3(0.0f);
+    glm::vec3 BoundsExtent      = glm::vec3(1.0f);  // Half size of AABB around emitter that encloses its particles.
+    float Lifetime              = 1.0f;
+    float StartSize             = 0.1f;
+    float EndSize               = 0.1f;
+    uint32_t SpawnCount         = 0;  // Particles to spawn this frame.
 };
 
-class ParticleSystem final : private Uncopyable, private Unmovable
+// Keep in sync with ParticleSimulation.comp
+struct GPUParticleEmitter
+{
+    glm::mat4 Transform         = glm::mat4(1.0f);
+    glm::vec4 StartColor        = glm::vec4(1.0f);
+    glm::vec4 EndColor          = glm::vec4(1.0f);
+    glm::vec3 Velocity          = glm::vec3(0.0f);
+    float Lifetime              = 1.0f;
+    glm::vec3 VelocityVariation = glm::vec3(0.0f);
+    float StartSize             = 0.1f;
+    glm::vec3 BoundsExtent      = glm::vec3(1.0f);
+    float EndSize               = 0.1f;
+    uint32_t SpawnCount         = 0;
+    uint32_t SpawnOffset        = 0;
+    uint32_t IsActive           = 0;
+    uint32_t IsVisible          = 0;
+};
+
+// Keep in sync with ParticleSimulation.comp && ParticleSystem.vert
+struct GPUParticle
+{
+    glm::vec3 Position    = glm::vec3(0.0f);
+    float Age             = 0.0f;
+    glm::vec3 Velocity    = glm::vec3(0.0f);
+    float Lifetime        = 0.0f;
+    glm::vec4 StartColor  = glm::vec4(1.0f);
+    glm::vec4 EndColor    = glm::vec4(1.0f);
+    float StartSize       = 0.0f;
+    float EndSize         = 0.0f;
+    uint32_t EmitterIndex = 0;
+    float Padding         = 0.0f;
+};
+
+// Keep in sync with ParticleSimulation.comp
+struct UBParticleSimulation
+{
+    glm::mat4 ViewProjection = glm::mat4(1.0f);
+    glm::vec3 CameraPosition = glm::vec3(0.0f);
+    float DeltaTime          = 0.0f;
+    uint32_t PoolSize        = 0;
+    uint32_t EmitterCount    = 0;
+    uint32_t SpawnCount      = 0;
+    uint32_t AliveListIndex  = 0;
+    uint32_t Seed            = 0;
+};
+
+/*
+ * All emitters share a single GPU particle pool, so any number of them costs one dispatch chain:
+ * cull emitters -> emit from dead list -> simulate alive list -> sort visible particles -> draw indirect.
+ * Particle counts never leave GPU, dispatch && draw sizes are written by the chain itself.
+ * Simulation runs on the compute queue(async if device has a separate compute family) && is never waited on CPU,
+ * rendering is recorded into the frame command buffer, which waits on GPU for the simulation of the same frame.
+ */
+class ParticleSystem : private Uncopyable, private Unmovable
 {
   public:
     ParticleSystem();
-    ~ParticleSystem() = default;
+    virtual ~ParticleSystem() = default;
+
+    static Ref<ParticleSystem> Create();
+
+    virtual void Destroy();
 
-    void Destroy();
+    void SubmitEmitter(const ParticleEmitter& emitter);
 
-    void OnUpdate();
-    void OnCompute(uint32_t particleCount);
-    void OnRender(void* pushConstants = nullptr);
+    virtual void OnCompute(const uint32_t poolSize)                                                     = 0;
+    virtual void OnRender(const Ref<CommandBuffer>& renderCommandBuffer, void* pushConstants = nullptr) = 0;
 
     FORCEINLINE const auto& GetRenderingPipeline() const { return m_RenderingPipeline; }
-    FORCEINLINE const auto& GetSSBOBuffers() const { return m_SSBOVertexBuffer; }
+    FORCEINLINE uint32_t GetPoolSize() const { return m_PoolSize; }
+    FORCEINLINE uint32_t GetActiveEmitterCount() const { return static_cast<uint32_t>(m_EmitterSlots.size()); }
+    FORCEINLINE const auto& GetQueryRing() const { return m_QueryRing; }
 
-  private:
-    Ref<Pipeline> m_ComputePipeline = nullptr;
-    std::array<Ref<StorageBuffer>, FRAMES_IN_FLIGHT> m_SSBOVertexBuffer;
-    Ref<Pipeline> m_RenderingPipeline = nullptr;
+  protected:
+    // Keep in sync with ParticleSimulation.comp && ParticleSort.comp
+    static constexpr uint32_t s_WORKGROUP_SIZE              = 256;
+    static constexpr uint32_t s_SORT_ELEMENTS_PER_WORKGROUP = 512;
+
+    // Byte offsets of indirect commands in m_IndirectArgsBuffer.
+    static constexpr uint64_t s_EMIT_ARGS_OFFSET     = 0;
+    static constexpr uint64_t s_SIMULATE_ARGS_OFFSET = 3 * sizeof(uint32_t);
+    static constexpr uint64_t s_SORT_ARGS_OFFSET     = 6 * sizeof(uint32_t);
+    static constexpr uint64_t s_DRAW_ARGS_OFFSET     = 9 * sizeof(uint32_t);
+
+    Ref<Pipeline> m_SimulationPipeline = nullptr;
+    Ref<Pipeline> m_SortPipeline       = nullptr;
+    Ref<Pipeline> m_RenderingPipeline  = nullptr;
+    std::array<Ref<CommandBuffer>, MAX_FRAMES_IN_FLIGHT> m_ComputeCommandBuffer;
+    Ref<GPUQueryRing> m_QueryRing = nullptr;  // Timings of the compute queue, read back by renderer's statistics.
+
+    // Shared by frames, simulation of the next frame waits until current one has been rendered.
+    Ref<StorageBuffer> m_ParticlesBuffer    = nullptr;
+    Ref<StorageBuffer> m_DeadListBuffer     = nullptr;
+    Ref<StorageBuffer> m_AliveListsBuffer   = nullptr;
+    Ref<StorageBuffer> m_SortListBuffer     = nullptr;
+    Ref<StorageBuffer> m_CountersBuffer     = nullptr;
+    Ref<StorageBuffer> m_IndirectArgsBuffer = nullptr;
+
+    std::array<Ref<StorageBuffer>, MAX_FRAMES_IN_FLIGHT> m_EmittersBuffer;
+    std::array<Ref<UniformBuffer>, MAX_FRAMES_IN_FLIGHT> m_SimulationUniformBuffer;
 
-    uint32_t m_BaseParticleCount    = 2048;
-    uint32_t m_CurrentParticleCount = 0;
+    uint32_t m_PoolSize       = 0;
+    uint32_t m_SortCapacity   = 0;  // Power of two that fits the pool.
+    uint32_t m_AliveListIndex = 0;
+
+    // Emitters keep their slots while submitted, so particles can refer to them by index.
+    std::unordered_map<uint64_t, uint32_t> m_EmitterSlots;
+    std::vector<uint32_t> m_FreeEmitterSlots;
+    std::vector<uint64_t> m_EmitterSlotIDs;
+    std::vector<GPUParticleEmitter> m_Emitters;
+    std::vector<bool> m_bIsEmitterSubmitted;
+
+    // Recreates the pool if its size changed, returns true if buffers were recreated.
+    bool ReservePool(const uint32_t poolSize);
+    void RecordSimulation(const Ref<CommandBuffer>& computeCommandBuffer);
+
+    // Makes writes of the previous dispatch visible to the next one && to indirect commands.
+    virtual void InsertSimulationBarrier(const Ref<CommandBuffer>& computeCommandBuffer) const = 0;
+
+  private:
+    void DestroyPool();
+    void PrepareEmitters(UBParticleSimulation& simulationData);
+    void RecordSort(const Ref<CommandBuffer>& computeCommandBuffer);
 };
 
-}  // namespace Gauntlet
\ No newline at end of file
+}  // namespace Gauntlet
@@ -0,0 +1,332 @@
+#include "GauntletPCH.h"
+#include "RenderGraph.h"
+
+#include "RendererAPI.h"
+#include "Renderer.h"
+#include "Image.h"
+#include "CommandBuffer.h"
+#include "GPUQueryRing.h"
+
+#include "Gauntlet/Core/Profiler.h"
+
+#include "Gauntlet/Platform/Vulkan/VulkanRenderGraph.h"
+
+namespace Gauntlet
+{
+
+template <typename T> static void HashCombine(size_t& seed, const T& value)
+{
+    seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static bool IsWriteState(const ERenderGraphResourceState state)
+{
+    return state == ERenderGraphResourceState::COLOR_ATTACHMENT || state == ERenderGraphResourceState::DEPTH_ATTACHMENT ||
+           state == ERenderGraphResourceState::COMPUTE_SHADER_WRITE;
+}
+
+Ref<RenderGraph> RenderGraph::Create()
+{
+    switch (RendererAPI::Get())
+    {
+        case RendererAPI::EAPI::Vulkan:
+        {
+            return MakeRef<VulkanRenderGraph>();
+        }
+        case RendererAPI::EAPI::None:
+        {
+            LOG_ERROR("RendererAPI::EAPI::None!");
+            GNT_ASSERT(false, "Unknown RendererAPI!");
+            break;
+        }
+    }
+
+    return nullptr;
+}
+
+void RenderGraph::Reset()
+{
+    m_Resources.clear();
+    m_Passes.clear();
+}
+
+RenderGraphResource RenderGraph::ImportImage(const std::string& name, const Ref<Image>& image, const ERenderGraphResourceState state)
+{
+    GNT_ASSERT(image, "Importing invalid image into render graph!");
+
+    auto& resource    = m_Resources.emplace_back();
+    resource.Name     = name;
+    resource.Image    = image;
+    resource.State    = state;
+    resource.External = state;
+    return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::ImportBuffer(const std::string& name, const Ref<StorageBuffer>& buffer,
+                                              const ERenderGraphResourceState state)
+{
+    GNT_ASSERT(buffer, "Importing invalid buffer into render graph!");
+
+    auto& resource    = m_Resources.emplace_back();
+    resource.Name     = name;
+    resource.Buffer   = buffer;
+    resource.State    = state;
+    resource.External = state;
+    return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::ImportTransientImage(const std::string& name, const Ref<Image>& image)
+{
+    GNT_ASSERT(image && image->GetSpecification().Aliased, "Transient images should be created without memory!");
+
+    auto& resource      = m_Resources.emplace_back();
+    resource.Name       = name;
+    resource.Image      = image;
+    resource.bTransient = true;
+    return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+}
+
+void RenderGraph::AddPass(const std::string& name, const std::function<void(RenderGraphPass&)>& setup,
+                          const std::function<void(const Ref<CommandBuffer>&)>& execute)
+{
+    auto& pass = m_Passes.emplace_back(name);
+    setup(pass);
+    pass.m_Execute = execute;
+}
+
+void RenderGraph::MarkOutput(const RenderGraphResource resource)
+{
+    GNT_ASSERT(resource < m_Resources.size(), "Invalid render graph resource!");
+    m_Resources[resource].bOutput = true;
+}
+
+void RenderGraph::Compile()
+{
+    GNT_PROFILE_FUNCTION();
+
+    CullPasses();
+    ComputeLifetimes();
+    PlanTransientMemory();
+}
+
+void RenderGraph::CullPasses()
+{
+    for (auto& resource : m_Resources)
+        resource.bNeeded = resource.bOutput;
+
+    // Passes are added in execution order, so walking them backwards visits readers before writers.
+    for (auto pass = m_Passes.rbegin(); pass != m_Passes.rend(); ++pass)
+    {
+        pass->m_bIsCulled = true;
+        for (const auto& access : pass->m_Accesses)
+        {
+            if (access.bWrite && m_Resources[access.Resource].bNeeded) pass->m_bIsCulled = false;
+        }
+
+        if (pass->m_bIsCulled) continue;
+
+        for (const auto& access : pass->m_Accesses)
+        {
+            if (!access.bWrite) m_Resources[access.Resource].bNeeded = true;
+        }
+    }
+}
+
+void RenderGraph::ComputeLifetimes()
+{
+    for (auto& resource : m_Resources)
+    {
+        resource.FirstPass       = -1;
+        resource.LastPass        = -1;
+        resource.AliasedResource = s_INVALID_RENDER_GRAPH_RESOURCE;
+        resource.LastBlockImage  = nullptr;
+    }
+
+    for (int32_t passIndex = 0; passIndex < static_cast<int32_t>(m_Passes.size()); ++passIndex)
+    {
+        if (m_Passes[passIndex].m_bIsCulled) continue;
+
+        for (const auto& access : m_Passes[passIndex].m_Accesses)
+        {
+            auto& resource = m_Resources[access.Resource];
+            if (resource.FirstPass == -1) resource.FirstPass = passIndex;
+            resource.LastPass = passIndex;
+        }
+    }
+
+    // Outputs are used after the graph, nothing can take their memory.
+    for (auto& resource : m_Resources)
+    {
+        if (resource.bOutput && resource.FirstPass != -1) resource.LastPass = static_cast<int32_t>(m_Passes.size());
+    }
+}
+
+void RenderGraph::PlanTransientMemory()
+{
+    std::vector<RenderGraphResource> transientResources;
+    std::vector<MemoryRequirements> memoryRequirements(m_Resources.size());
+    size_t memoryLayoutHash     = std::hash<bool>()(m_bAliasingEnabled);
+    bool bIsMemoryLayoutInvalid = false;
+    uint64_t declaredMemorySize = 0;
+    for (RenderGraphResource resourceIndex = 0; resourceIndex < m_Resources.size(); ++resourceIndex)
+    {
+        const auto& resource = m_Resources[resourceIndex];
+        if (!resource.bTransient) continue;
+
+        memoryRequirements[resourceIndex] = GetMemoryRequirements(resource.Image);
+        declaredMemorySize += memoryRequirements[resourceIndex].Size;
+        if (resource.FirstPass == -1) continue;
+
+        transientResources.push_back(resourceIndex);
+        HashCombine(memoryLayoutHash, resource.Image.get());
+        HashCombine(memoryLayoutHash, resource.FirstPass);
+        HashCombine(memoryLayoutHash, resource.LastPass);
+
+        // Owner recreated image(e.g. on resize), so it has lost its memory.
+        if (!IsAllocated(resource.Image)) bIsMemoryLayoutInvalid = true;
+    }
+
+    // Biggest images first, each one goes into the first compatible block whose images are dead by the time it's used.
+    std::stable_sort(transientResources.begin(), transientResources.end(), [&](const auto& lhs, const auto& rhs)
+                     { return memoryRequirements[lhs].Size > memoryRequirements[rhs].Size; });
+
+    std::vector<MemoryBlock> memoryBlocks;
+    for (const auto resourceIndex : transientResources)
+    {
+        const auto& resource     = m_Resources[resourceIndex];
+        const auto& requirements = memoryRequirements[resourceIndex];
+
+        MemoryBlock* targetBlock = nullptr;
+        for (auto& memoryBlock : memoryBlocks)
+        {
+            if (!m_bAliasingEnabled) break;
+            if ((memoryBlock.Requirements.MemoryTypeBits & requirements.MemoryTypeBits) == 0) continue;
+
+            bool bLifetimesOverlap = false;
+            for (const auto blockResourceIndex : memoryBlock.Resources)
+            {
+                const auto& blockResource = m_Resources[blockResourceIndex];
+                if (blockResource.FirstPass <= resource.LastPass && resource.FirstPass <= blockResource.LastPass) bLifetimesOverlap = true;
+            }
+
+            if (!bLifetimesOverlap)
+            {
+                targetBlock = &memoryBlock;
+                break;
+            }
+        }
+
+        if (!targetBlock)
+        {
+            targetBlock                              = &memoryBlocks.emplace_back();
+            targetBlock->Requirements.MemoryTypeBits = requirements.MemoryTypeBits;
+        }
+
+        targetBlock->Requirements.Size      = std::max(targetBlock->Requirements.Size, requirements.Size);
+        targetBlock->Requirements.Alignment = std::max(targetBlock->Requirements.Alignment, requirements.Alignment);
+        targetBlock->Requirements.MemoryTypeBits &= requirements.MemoryTypeBits;
+        targetBlock->Resources.push_back(resourceIndex);
+    }
+
+    // The image that used block's memory right before, its accesses have to finish before memory is reused.
+    uint64_t allocatedMemorySize = 0;
+    for (auto& memoryBlock : memoryBlocks)
+    {
+        allocatedMemorySize += memoryBlock.Requirements.Size;
+
+        auto blockResources = memoryBlock.Resources;
+        std::sort(blockResources.begin(), blockResources.end(),
+                  [&](const auto& lhs, const auto& rhs) { return m_Resources[lhs].FirstPass < m_Resources[rhs].FirstPass; });
+
+        for (size_t i = 1; i < blockResources.size(); ++i)
+            m_Resources[blockResources[i]].AliasedResource = blockResources[i - 1];
+
+        // Block layout is the same every frame until memory is reallocated, so its last user is the same too.
+        m_Resources[blockResources.front()].LastBlockImage = m_Resources[blockResources.back()].Image.get();
+    }
+
+    auto& rendererStats                    = Renderer::GetStats();
+    rendererStats.TransientMemoryAllocated = allocatedMemorySize;
+    rendererStats.TransientMemorySaved     = declaredMemorySize - allocatedMemorySize;
+
+    if (!bIsMemoryLayoutInvalid && memoryLayoutHash == m_MemoryLayoutHash) return;
+
+    // Device is idle once memory is released, nothing is left to wait for.
+    ReleaseTransientMemory();
+    AllocateTransientMemory(memoryBlocks);
+    m_MemoryLayoutHash = memoryLayoutHash;
+    m_TransientFinalStates.clear();
+}
+
+void RenderGraph::Execute(const Ref<CommandBuffer>& commandBuffer, const Ref<GPUQueryRing>& queryRing)
+{
+    GNT_PROFILE_FUNCTION();
+
+    m_ExecutedPasses.clear();
+
+    std::vector<ResourceTransition> transitions;
+    for (int32_t passIndex = 0; passIndex < static_cast<int32_t>(m_Passes.size()); ++passIndex)
+    {
+        auto& pass = m_Passes[passIndex];
+        if (pass.m_bIsCulled) continue;
+
+        transitions.clear();
+        for (const auto& access : pass.m_Accesses)
+        {
+            auto& resource = m_Resources[access.Resource];
+
+            // Reads in the same state don't depend on each other.
+            if (resource.State == access.State && !IsWriteState(access.State)) continue;
+
+            ResourceTransition transition = {};
+            transition.Resource           = access.Resource;
+            transition.OldState           = resource.State;
+            transition.NewState           = access.State;
+            if (resource.FirstPass == passIndex && resource.AliasedResource != s_INVALID_RENDER_GRAPH_RESOURCE)
+                transition.AliasState = m_Resources[resource.AliasedResource].State;
+            else if (resource.FirstPass == passIndex && resource.LastBlockImage)
+            {
+                const auto finalStateIt = m_TransientFinalStates.find(resource.LastBlockImage);
+                if (finalStateIt != m_TransientFinalStates.end()) transition.AliasState = finalStateIt->second;
+            }
+
+            transitions.push_back(transition);
+            resource.State = access.State;
+        }
+
+        if (!transitions.empty()) InsertBarriers(commandBuffer, transitions);
+
+        if (queryRing)
+        {
+            GPUMarkerScope marker(queryRing, commandBuffer, pass.GetName());
+            pass.m_Execute(commandBuffer);
+        }
+        else
+            pass.m_Execute(commandBuffer);
+
+        m_ExecutedPasses.push_back(pass.GetName());
+    }
+
+    // Return imported resources to the state they came in.
+    transitions.clear();
+    for (RenderGraphResource resourceIndex = 0; resourceIndex < m_Resources.size(); ++resourceIndex)
+    {
+        auto& resource = m_Resources[resourceIndex];
+        if (resource.bTransient && resource.FirstPass != -1) m_TransientFinalStates[resource.Image.get()] = resource.State;
+
+        if (resource.bTransient || resource.External == ERenderGraphResourceState::UNDEFINED || resource.State == resource.External)
+            continue;
+
+        ResourceTransition transition = {};
+        transition.Resource           = resourceIndex;
+        transition.OldState           = resource.State;
+        transition.NewState           = resource.External;
+        transitions.push_back(transition);
+
+        resource.State = resource.External;
+    }
+
+    if (!transitions.empty()) InsertBarriers(commandBuffer, transitions);
+}
+
+}  // namespace Gauntlet
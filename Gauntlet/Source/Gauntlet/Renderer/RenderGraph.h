@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Gauntlet/Core/Core.h"
+
+#include <functional>
+
+namespace Gauntlet
+{
+
+class Image;
+class StorageBuffer;
+class CommandBuffer;
+class GPUQueryRing;
+
+// How a pass accesses resource, graph derives layouts && pipeline barriers from transitions between these.
+enum class ERenderGraphResourceState : uint8_t
+{
+    UNDEFINED = 0,  // Contents are discarded, transient resources start each frame in it.
+    COLOR_ATTACHMENT,
+    DEPTH_ATTACHMENT,
+    FRAGMENT_SHADER_READ,
+    COMPUTE_SHADER_READ,
+    COMPUTE_SHADER_WRITE
+};
+
+using RenderGraphResource = uint32_t;
+
+static constexpr RenderGraphResource s_INVALID_RENDER_GRAPH_RESOURCE = UINT32_MAX;
+
+class RenderGraphPass final
+{
+  public:
+    RenderGraphPass(const std::string& name) : m_Name(name) {}
+    ~RenderGraphPass() = default;
+
+    FORCEINLINE void Read(const RenderGraphResource resource, const ERenderGraphResourceState state)
+    {
+        GNT_ASSERT(resource != s_INVALID_RENDER_GRAPH_RESOURCE, "Invalid render graph resource!");
+        m_Accesses.push_back({resource, state, false});
+    }
+
+    FORCEINLINE void Write(const RenderGraphResource resource, const ERenderGraphResourceState state)
+    {
+        GNT_ASSERT(resource != s_INVALID_RENDER_GRAPH_RESOURCE, "Invalid render graph resource!");
+        m_Accesses.push_back({resource, state, true});
+    }
+
+    FORCEINLINE const auto& GetName() const { return m_Name; }
+
+  private:
+    struct ResourceAccess
+    {
+        RenderGraphResource Resource    = s_INVALID_RENDER_GRAPH_RESOURCE;
+        ERenderGraphResourceState State = ERenderGraphResourceState::UNDEFINED;
+        bool bWrite                     = false;
+    };
+
+    std::string m_Name;
+    std::vector<ResourceAccess> m_Accesses;
+    std::function<void(const Ref<CommandBuffer>&)> m_Execute;
+    bool m_bIsCulled = false;
+
+    friend class RenderGraph;
+};
+
+/*
+ * Rebuilt every frame: import resources, add passes in execution order, mark outputs, then Compile() && Execute().
+ * Passes that don't contribute to outputs are culled, barriers && layout transitions are inserted before each pass.
+ * Transient images are only valid while the graph executes, images whose lifetimes don't overlap share memory.
+ */
+class RenderGraph : private Uncopyable, private Unmovable
+{
+  public:
+    RenderGraph()          = default;
+    virtual ~RenderGraph() = default;
+
+    static Ref<RenderGraph> Create();
+
+    void Reset();
+
+    // Imported resources are in the state before graph execution && are returned to it afterwards.
+    RenderGraphResource ImportImage(const std::string& name, const Ref<Image>& image, const ERenderGraphResourceState state);
+    RenderGraphResource ImportBuffer(const std::string& name, const Ref<StorageBuffer>& buffer, const ERenderGraphResourceState state);
+
+    // Image should be created with ImageSpecification::Aliased, graph owns its memory.
+    RenderGraphResource ImportTransientImage(const std::string& name, const Ref<Image>& image);
+
+    void AddPass(const std::string& name, const std::function<void(RenderGraphPass&)>& setup,
+                 const std::function<void(const Ref<CommandBuffer>&)>& execute);
+    void MarkOutput(const RenderGraphResource resource);
+
+    void Compile();
+    // Each executed pass is wrapped into a GPU marker named after it, if query ring is given.
+    void Execute(const Ref<CommandBuffer>& commandBuffer, const Ref<GPUQueryRing>& queryRing = nullptr);
+
+    // Separate memory for each transient image, so they keep their contents(e.g. to inspect them in editor).
+    FORCEINLINE void SetAliasingEnabled(const bool bAliasingEnabled) { m_bAliasingEnabled = bAliasingEnabled; }
+
+    FORCEINLINE const auto& GetExecutedPasses() const { return m_ExecutedPasses; }
+    FORCEINLINE uint32_t GetPassCount() const { return static_cast<uint32_t>(m_Passes.size()); }
+
+    // Transient images are left without memory while their passes are culled.
+    virtual bool IsAllocated(const Ref<Image>& image) const = 0;
+    virtual void Destroy()                                  = 0;
+
+  protected:
+    struct Resource
+    {
+        std::string Name;
+        Ref<Gauntlet::Image> Image          = nullptr;
+        Ref<StorageBuffer> Buffer           = nullptr;
+        ERenderGraphResourceState State     = ERenderGraphResourceState::UNDEFINED;  // Current state while recording.
+        ERenderGraphResourceState External  = ERenderGraphResourceState::UNDEFINED;  // State before && after graph.
+        bool bTransient                     = false;
+        bool bOutput                        = false;
+        bool bNeeded                        = false;
+        int32_t FirstPass                   = -1;
+        int32_t LastPass                    = -1;
+        RenderGraphResource AliasedResource = s_INVALID_RENDER_GRAPH_RESOURCE;  // Previous user of the same memory.
+        Gauntlet::Image* LastBlockImage     = nullptr;                          // Last user of the same memory in the previous frame.
+    };
+
+    struct ResourceTransition
+    {
+        RenderGraphResource Resource         = s_INVALID_RENDER_GRAPH_RESOURCE;
+        ERenderGraphResourceState OldState   = ERenderGraphResourceState::UNDEFINED;
+        ERenderGraphResourceState NewState   = ERenderGraphResourceState::UNDEFINED;
+        ERenderGraphResourceState AliasState = ERenderGraphResourceState::UNDEFINED;  // Last state of aliased resource, if any.
+    };
+
+    struct MemoryRequirements
+    {
+        uint64_t Size           = 0;
+        uint64_t Alignment      = 0;
+        uint32_t MemoryTypeBits = 0;
+    };
+
+    // Transient images placed into one memory block, all at zero offset since their lifetimes don't overlap.
+    struct MemoryBlock
+    {
+        MemoryRequirements Requirements;
+        std::vector<RenderGraphResource> Resources;
+    };
+
+    std::vector<Resource> m_Resources;
+    std::vector<RenderGraphPass> m_Passes;
+    std::vector<std::string> m_ExecutedPasses;
+    bool m_bAliasingEnabled = true;
+
+    // Hash of transient images && their lifetimes the current memory layout was built for.
+    size_t m_MemoryLayoutHash = 0;
+
+    // States transient images were left in by the previous execution. Frames in flight share transient memory, so its first user
+    // in a frame waits for the previous frame's last accesses(e.g. lighting reading SSAO) rather than starting from top of pipe.
+    std::unordered_map<const Gauntlet::Image*, ERenderGraphResourceState> m_TransientFinalStates;
+
+    virtual MemoryRequirements GetMemoryRequirements(const Ref<Image>& image) const    = 0;
+    virtual void AllocateTransientMemory(const std::vector<MemoryBlock>& memoryBlocks) = 0;
+    virtual void ReleaseTransientMemory()                                              = 0;
+
+    virtual void InsertBarriers(const Ref<CommandBuffer>& commandBuffer, const std::vector<ResourceTransition>& transitions) = 0;
+
+    void CullPasses();
+    void ComputeLifetimes();
+    void PlanTransientMemory();
+};
+
+}  // namespace Gauntlet
@@ -11,10 +11,15 @@
 #include "Renderer2D.h"
 #include "GraphicsContext.h"
 #include "CommandBuffer.h"
+#include "CommandPool.h"
+#include "GPUQueryRing.h"
 
 #include "ParticleSystem.h"
+#include "RenderGraph.h"
 
 #include "Gauntlet/Core/Random.h"
+#include "Gauntlet/Core/JobSystem.h"
+#include "Gauntlet/Core/Profiler.h"
 #include "Animation.h"
 
 #include "Gauntlet/Platform/Vulkan/VulkanRenderer.h"
@@ -26,6 +31,7 @@ namespace Gauntlet
 // Static storage
 Renderer* Renderer::s_Renderer = nullptr;
 std::mutex Renderer::s_ResourceAccessMutex;
+std::mutex Renderer::s_UploadHeapMutex;
 
 Renderer::RendererStats Renderer::s_RendererStats;
 Renderer::RendererSettings Renderer::s_RendererSettings;
@@ -34,6 +40,7 @@ Renderer::RendererStorage* Renderer::s_RendererStorage = new Renderer::RendererS
 void Renderer::Init()
 {
     ShaderLibrary::Init();
+    AnimationLibrary::Init();
     SamplerStorage::Initialize();
 
     switch (RendererAPI::Get())
@@ -75,20 +82,17 @@ void Renderer::Init()
         attachment.ClearColor                         = glm::vec4(1.0f);
         attachment.Filter                             = ETextureFilter::NEAREST;
 
-        // Position
-        attachment.Format = EImageFormat::RGBA16F;
-        geometryFramebufferSpec.Attachments.push_back(attachment);
-
-        // Normal
-        attachment.Format = EImageFormat::RGBA16F;
+        // Compact layout(9 bytes of color per pixel), position is reconstructed from depth.
+        // Albedo && Metallic
+        attachment.Format = EImageFormat::RGBA;
         geometryFramebufferSpec.Attachments.push_back(attachment);
 
-        // Albedo
-        attachment.Format = EImageFormat::RGBA;
+        // Octahedral Normal && Roughness
+        attachment.Format = EImageFormat::RGB10A2;
         geometryFramebufferSpec.Attachments.push_back(attachment);
 
-        // Metallic Roughness AO
-        attachment.Format = EImageFormat::RGBA;
+        // Material AO
+        attachment.Format = EImageFormat::R8;
         geometryFramebufferSpec.Attachments.push_back(attachment);
 
         // Depth
@@ -125,11 +129,12 @@ void Renderer::Init()
         shadowMapAttachment.Format                             = EImageFormat::DEPTH32F;
         shadowMapAttachment.LoadOp                             = ELoadOp::CLEAR;
         shadowMapAttachment.StoreOp                            = EStoreOp::STORE;
-        shadowMapAttachment.Filter                             = ETextureFilter::LINEAR;
+        shadowMapAttachment.Filter                             = ETextureFilter::NEAREST;  // Depth is compared manually in shader.
         shadowMapAttachment.Wrap                               = ETextureWrap::CLAMP_TO_EDGE;
 
         shadowMapFramebufferSpec.Attachments = {shadowMapAttachment};
         shadowMapFramebufferSpec.Name        = "ShadowMap";
+        shadowMapFramebufferSpec.Layers      = s_MAX_SHADOW_CASCADES;
         shadowMapFramebufferSpec.Width       = shadowMapFramebufferSpec.Height =
             s_RendererSettings.Shadows.ShadowPresets[s_RendererSettings.Shadows.CurrentShadowPreset].second;
 
@@ -153,22 +158,66 @@ void Renderer::Init()
         for (auto& shadowsUB : s_RendererStorage->ShadowsUniformBuffer)
         {
             shadowsUB = UniformBuffer::Create(sizeof(UBShadows));
-            shadowsUB->Map();
+            shadowsUB->Map(true);
         }
     }
 
+    // Point && spot light shadow atlas
+    {
+        FramebufferSpecification atlasFramebufferSpec = {};
+
+        FramebufferAttachmentSpecification atlasAttachment = {};
+        atlasAttachment.ClearColor                         = glm::vec4(1.0f);
+        atlasAttachment.Format                             = EImageFormat::DEPTH32F;
+        atlasAttachment.LoadOp                             = ELoadOp::CLEAR;  // Clears only the tile being rendered.
+        atlasAttachment.StoreOp                            = EStoreOp::STORE;
+        atlasAttachment.Filter                             = ETextureFilter::NEAREST;
+        atlasAttachment.Wrap                               = ETextureWrap::CLAMP_TO_EDGE;
+
+        atlasFramebufferSpec.Attachments = {atlasAttachment};
+        atlasFramebufferSpec.Name        = "LocalShadowAtlas";
+        atlasFramebufferSpec.Width = atlasFramebufferSpec.Height = s_LOCAL_SHADOW_ATLAS_SIZE;
+
+        for (auto& fb : s_RendererStorage->LocalShadowAtlasFramebuffer)
+            fb = Framebuffer::Create(atlasFramebufferSpec);
+
+        PipelineSpecification atlasPipelineSpec = {};
+        atlasPipelineSpec.Name                  = "LocalShadowAtlas";
+        atlasPipelineSpec.PolygonMode           = EPolygonMode::POLYGON_MODE_FILL;
+        atlasPipelineSpec.FrontFace             = EFrontFace::FRONT_FACE_COUNTER_CLOCKWISE;
+        atlasPipelineSpec.CullMode              = ECullMode::CULL_MODE_FRONT;
+        atlasPipelineSpec.bDepthWrite           = true;
+        atlasPipelineSpec.bDepthTest            = true;
+        atlasPipelineSpec.DepthCompareOp        = ECompareOp::COMPARE_OP_LESS;
+        atlasPipelineSpec.TargetFramebuffer     = s_RendererStorage->LocalShadowAtlasFramebuffer;
+        atlasPipelineSpec.Layout                = s_RendererStorage->StaticMeshVertexBufferLayout;
+        atlasPipelineSpec.Shader                = ShaderLibrary::Load("DirShadowMap");  // Depth-only, takes any view projection.
+
+        s_RendererStorage->LocalShadowAtlasPipeline = Pipeline::Create(atlasPipelineSpec);
+
+        // Initial capacity of 256 entries, grows on demand in Flush().
+        BufferSpecification localShadowsBufferSpec = {};
+        localShadowsBufferSpec.Usage               = EBufferUsageFlags::STORAGE_BUFFER | EBufferUsageFlags::TRANSFER_DST;
+        localShadowsBufferSpec.Size                = 256 * sizeof(LocalLightShadow);
+        for (auto& ssbo : s_RendererStorage->LocalShadowsStorageBuffer)
+            ssbo = StorageBuffer::Create(localShadowsBufferSpec);
+    }
+
     // SSAO
     {
         FramebufferSpecification ssaoFramebufferSpec = {};
         ssaoFramebufferSpec.Name                     = "SSAO";
+        ssaoFramebufferSpec.ManagedByRenderGraph     = true;
+        ssaoFramebufferSpec.AliasedAttachments       = true;
 
         FramebufferAttachmentSpecification ssaoFramebufferAttachmentSpec = {};
         ssaoFramebufferAttachmentSpec.Format                             = EImageFormat::R8;
         ssaoFramebufferAttachmentSpec.Filter                             = ETextureFilter::NEAREST;
         ssaoFramebufferSpec.Attachments                                  = {ssaoFramebufferAttachmentSpec};
 
+        const auto ssaoFramebuffer = Framebuffer::Create(ssaoFramebufferSpec);
         for (auto& fb : s_RendererStorage->SSAOFramebuffer)
-            fb = Framebuffer::Create(ssaoFramebufferSpec);
+            fb = ssaoFramebuffer;
 
         PipelineSpecification ssaoPipelineSpec = {};
         ssaoPipelineSpec.Name                  = "SSAO";
@@ -189,14 +238,17 @@ void Renderer::Init()
     {
         FramebufferSpecification ssaoBlurFramebufferSpec = {};
         ssaoBlurFramebufferSpec.Name                     = "SSAO-Blur";
+        ssaoBlurFramebufferSpec.ManagedByRenderGraph     = true;
+        ssaoBlurFramebufferSpec.AliasedAttachments       = true;
 
         FramebufferAttachmentSpecification ssaoBlurFramebufferAttachmentSpec = {};
         ssaoBlurFramebufferAttachmentSpec.Format                             = EImageFormat::R8;
         ssaoBlurFramebufferAttachmentSpec.Filter                             = ETextureFilter::NEAREST;
         ssaoBlurFramebufferSpec.Attachments                                  = {ssaoBlurFramebufferAttachmentSpec};
 
+        const auto ssaoBlurFramebuffer = Framebuffer::Create(ssaoBlurFramebufferSpec);
         for (auto& fb : s_RendererStorage->SSAOBlurFramebuffer)
-            fb = Framebuffer::Create(ssaoBlurFramebufferSpec);
+            fb = ssaoBlurFramebuffer;
 
         PipelineSpecification ssaoBlurPipelineSpec = {};
         ssaoBlurPipelineSpec.Name                  = "SSAO-Blur";
@@ -223,6 +275,41 @@ void Renderer::Init()
             Texture2D::Create(ssaoNoise.data(), ssaoNoise.size() * sizeof(ssaoNoise[0]), 4, 4, ssaoNoiseTextureSpec);
     }
 
+    // Compute SSAO, images are sized lazily in Begin() since they depend on GBuffer size && quality preset.
+    {
+        PipelineSpecification ssaoComputePipelineSpec = {};
+        ssaoComputePipelineSpec.PipelineType          = EPipelineType::PIPELINE_TYPE_COMPUTE;
+
+        ssaoComputePipelineSpec.Name                   = "SSAODepthDownsample";
+        ssaoComputePipelineSpec.Shader                 = ShaderLibrary::Load("SSAODepthDownsample");
+        s_RendererStorage->SSAODepthDownsamplePipeline = Pipeline::Create(ssaoComputePipelineSpec);
+
+        ssaoComputePipelineSpec.Name           = "SSAOCompute";
+        ssaoComputePipelineSpec.Shader         = ShaderLibrary::Load("SSAOCompute");
+        s_RendererStorage->SSAOComputePipeline = Pipeline::Create(ssaoComputePipelineSpec);
+
+        ssaoComputePipelineSpec.Name            = "SSAOUpsample";
+        ssaoComputePipelineSpec.Shader          = ShaderLibrary::Load("SSAOUpsample");
+        s_RendererStorage->SSAOUpsamplePipeline = Pipeline::Create(ssaoComputePipelineSpec);
+
+        ImageSpecification ssaoImageSpec = {};
+        ssaoImageSpec.Usage              = EImageUsage::STORAGE;
+        ssaoImageSpec.Filter             = ETextureFilter::NEAREST;
+        ssaoImageSpec.Wrap               = ETextureWrap::CLAMP_TO_EDGE;
+        ssaoImageSpec.CreateTextureID    = true;
+        ssaoImageSpec.Aliased            = true;
+
+        ssaoImageSpec.Format = EImageFormat::R32F;  // Linear view depth.
+        for (auto& depthLevel : s_RendererStorage->SSAODepthPyramid)
+            depthLevel = Image::Create(ssaoImageSpec);
+
+        ssaoImageSpec.Format                = EImageFormat::R8;
+        s_RendererStorage->SSAOLowResImage  = Image::Create(ssaoImageSpec);
+        s_RendererStorage->SSAOComputeImage = Image::Create(ssaoImageSpec);
+    }
+
+    s_RendererStorage->DeferredRenderGraph = RenderGraph::Create();
+
     // Lighting
     {
         FramebufferSpecification lightingFramebufferSpec = {};
@@ -234,7 +321,8 @@ void Renderer::Init()
         attachment.StoreOp                            = EStoreOp::STORE;
         lightingFramebufferSpec.Attachments.push_back(attachment);
 
-        lightingFramebufferSpec.Name = "LightingDeferred";
+        lightingFramebufferSpec.Name                 = "LightingDeferred";
+        lightingFramebufferSpec.ManagedByRenderGraph = true;
         for (auto& fb : s_RendererStorage->LightingFramebuffer)
             fb = Framebuffer::Create(lightingFramebufferSpec);
 
@@ -254,6 +342,57 @@ void Renderer::Init()
         }
     }
 
+    // Particles
+    {
+        FramebufferSpecification particleFramebufferSpec = {};
+        particleFramebufferSpec.Name                     = "Particles";
+        particleFramebufferSpec.LoadOp                   = ELoadOp::LOAD;
+        particleFramebufferSpec.StoreOp                  = EStoreOp::STORE;
+        particleFramebufferSpec.ManagedByRenderGraph     = true;
+
+        // Depth goes last.
+        for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
+        {
+            particleFramebufferSpec.ExistingAttachments = {s_RendererStorage->LightingFramebuffer[frame]->GetAttachments()[0],
+                                                           s_RendererStorage->GeometryFramebuffer[frame]->GetAttachments()[3]};
+            s_RendererStorage->ParticleFramebuffer[frame] = Framebuffer::Create(particleFramebufferSpec);
+        }
+    }
+
+    // Clustered light culling
+    {
+        BufferSpecification lightsBufferSpec = {};
+        lightsBufferSpec.Usage               = EBufferUsageFlags::STORAGE_BUFFER | EBufferUsageFlags::TRANSFER_DST;
+
+        // Initial capacity of 1024 lights, grows on demand in Flush().
+        lightsBufferSpec.Size = 1024 * sizeof(PointLight);
+        for (auto& ssbo : s_RendererStorage->PointLightsStorageBuffer)
+            ssbo = StorageBuffer::Create(lightsBufferSpec);
+
+        lightsBufferSpec.Size = 1024 * sizeof(SpotLight);
+        for (auto& ssbo : s_RendererStorage->SpotLightsStorageBuffer)
+            ssbo = StorageBuffer::Create(lightsBufferSpec);
+
+        BufferSpecification clustersBufferSpec = {};
+        clustersBufferSpec.Usage               = EBufferUsageFlags::STORAGE_BUFFER;
+        clustersBufferSpec.Size                = s_LIGHT_CLUSTER_COUNT * sizeof(LightCluster);
+        for (auto& ssbo : s_RendererStorage->LightClustersStorageBuffer)
+            ssbo = StorageBuffer::Create(clustersBufferSpec);
+
+        for (auto& clustersUB : s_RendererStorage->LightClustersUniformBuffer)
+        {
+            clustersUB = UniformBuffer::Create(sizeof(UBLightClusters));
+            clustersUB->Map(true);
+        }
+
+        PipelineSpecification lightCullingPipelineSpec = {};
+        lightCullingPipelineSpec.Name                  = "LightCulling";
+        lightCullingPipelineSpec.Shader                = ShaderLibrary::Load("LightCulling");
+        lightCullingPipelineSpec.PipelineType          = EPipelineType::PIPELINE_TYPE_COMPUTE;
+
+        s_RendererStorage->LightCullingPipeline = Pipeline::Create(lightCullingPipelineSpec);
+    }
+
     // Chromatic Aberration
     {
         FramebufferSpecification caFramebufferSpec    = {};
@@ -263,7 +402,8 @@ void Renderer::Init()
         attachment.LoadOp                             = ELoadOp::CLEAR;
         attachment.StoreOp                            = EStoreOp::STORE;
         caFramebufferSpec.Attachments.push_back(attachment);
-        caFramebufferSpec.Name = "ChromaticAbberation";
+        caFramebufferSpec.Name                 = "ChromaticAbberation";
+        caFramebufferSpec.ManagedByRenderGraph = true;
 
         for (auto& fb : s_RendererStorage->ChromaticAberrationFramebuffer)
             fb = Framebuffer::Create(caFramebufferSpec);
@@ -332,30 +472,44 @@ void Renderer::Init()
     for (auto& commandBuffer : s_RendererStorage->RenderCommandBuffer)
         commandBuffer = CommandBuffer::Create(ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS);
 
-    s_RendererStats.PipelineStatisticsResults.resize(s_RendererStorage->RenderCommandBuffer[0]->GetPipelineStatisticsResults().size());
+    // Main thread only waits while jobs record, so there's a pool per worker thread.
+    for (auto& commandPools : s_RendererStorage->RecordingCommandPools)
+    {
+        commandPools.resize(std::max(JobSystem::GetThreadCount(), 1u));
+        for (auto& commandPool : commandPools)
+            commandPool = CommandPool::Create(ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS);
+    }
 
-    s_RendererStorage->GPUParticleSystem = MakeRef<ParticleSystem>();
+    s_RendererStorage->QueryRing = GPUQueryRing::Create(ECommandBufferType::COMMAND_BUFFER_TYPE_GRAPHICS);
+    s_RendererStats.PipelineStatisticsResults.resize(s_RendererStorage->QueryRing->GetPipelineStatisticsNames().size());
 
-    // Animation
-    /*  {
-          PipelineSpecification animationPipelineSpec = {};
-          animationPipelineSpec.Name                  = "Animation";
-          animationPipelineSpec.TargetFramebuffer     = s_RendererStorage->GeometryFramebuffer;
-          animationPipelineSpec.PolygonMode           = EPolygonMode::POLYGON_MODE_FILL;
-          animationPipelineSpec.FrontFace             = EFrontFace::FRONT_FACE_COUNTER_CLOCKWISE;
-          animationPipelineSpec.CullMode              = ECullMode::CULL_MODE_BACK;
-          animationPipelineSpec.bDepthWrite           = true;
-          animationPipelineSpec.bDepthTest            = true;
-          animationPipelineSpec.DepthCompareOp        = ECompareOp::COMPARE_OP_LESS;
-          animationPipelineSpec.bDynamicPolygonMode   = true;
+    s_RendererStorage->GPUParticleSystem = ParticleSystem::Create();
+
+    // Skinning
+    {
+        BufferSpecification skinningBufferSpec = {};
+        skinningBufferSpec.Usage               = EBufferUsageFlags::STORAGE_BUFFER | EBufferUsageFlags::TRANSFER_DST;
 
-          auto animationShader                          = ShaderLibrary::Load("Resources/Cached/Shaders/Animated");
-          s_RendererStorage->AnimatedVertexBufferLayout = animationShader->GetVertexBufferLayout();
+        // Initial capacities, all of them grow on demand in SkinMeshes().
+        skinningBufferSpec.Size = 256 * sizeof(SkinningDispatch);
+        for (auto& ssbo : s_RendererStorage->SkinningDispatchesStorageBuffer)
+            ssbo = StorageBuffer::Create(skinningBufferSpec);
 
-          animationPipelineSpec.Shader = animationShader;
+        skinningBufferSpec.Size = 64 * 1024 * sizeof(AnimatedVertex);
+        for (auto& ssbo : s_RendererStorage->SkinningSourceStorageBuffer)
+            ssbo = StorageBuffer::Create(skinningBufferSpec);
 
-          s_RendererStorage->AnimationPipeline = Pipeline::Create(animationPipelineSpec);
-      }*/
+        skinningBufferSpec.Size = 1024 * sizeof(glm::mat4);
+        for (auto& ssbo : s_RendererStorage->BonePaletteStorageBuffer)
+            ssbo = StorageBuffer::Create(skinningBufferSpec);
+
+        PipelineSpecification skinningPipelineSpec = {};
+        skinningPipelineSpec.Name                  = "Skinning";
+        skinningPipelineSpec.Shader                = ShaderLibrary::Load("Skinning");
+        skinningPipelineSpec.PipelineType          = EPipelineType::PIPELINE_TYPE_COMPUTE;
+
+        s_RendererStorage->SkinningPipeline = Pipeline::Create(skinningPipelineSpec);
+    }
 }
 
 void Renderer::Shutdown()
@@ -363,25 +517,40 @@ void Renderer::Shutdown()
     GraphicsContext::Get().WaitDeviceOnFinish();
 
     ShaderLibrary::Shutdown();
+    AnimationLibrary::Shutdown();
 
-    for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
     {
         s_RendererStorage->GeometryFramebuffer[frame]->Destroy();
 
         s_RendererStorage->SetupFramebuffer[frame]->Destroy();
         s_RendererStorage->PBRFramebuffer[frame]->Destroy();
         s_RendererStorage->ShadowMapFramebuffer[frame]->Destroy();
-        s_RendererStorage->SSAOFramebuffer[frame]->Destroy();
-        s_RendererStorage->SSAOBlurFramebuffer[frame]->Destroy();
+        s_RendererStorage->LocalShadowAtlasFramebuffer[frame]->Destroy();
         s_RendererStorage->LightingFramebuffer[frame]->Destroy();
+        s_RendererStorage->ParticleFramebuffer[frame]->Destroy();
         s_RendererStorage->ChromaticAberrationFramebuffer[frame]->Destroy();
     }
 
     s_RendererStorage->GPUParticleSystem->Destroy();
+    s_RendererStorage->QueryRing->Destroy();
+
+    for (auto& commandPools : s_RendererStorage->RecordingCommandPools)
+    {
+        for (auto& commandPool : commandPools)
+            commandPool->Destroy();
+    }
 
     s_RendererStorage->UploadHeap->Destroy();
 
-    //  s_RendererStorage->AnimationPipeline->Destroy();
+    s_RendererStorage->SkinningPipeline->Destroy();
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
+    {
+        s_RendererStorage->SkinningDispatchesStorageBuffer[frame]->Destroy();
+        s_RendererStorage->SkinningSourceStorageBuffer[frame]->Destroy();
+        s_RendererStorage->BonePaletteStorageBuffer[frame]->Destroy();
+        if (s_RendererStorage->SkinnedVertexBuffer[frame]) s_RendererStorage->SkinnedVertexBuffer[frame]->Destroy();
+    }
 
     s_RendererStorage->GeometryPipeline->Destroy();
     s_RendererStorage->PBRPipeline->Destroy();
@@ -390,6 +559,14 @@ void Renderer::Shutdown()
     for (auto& ub : s_RendererStorage->ShadowsUniformBuffer)
         ub->Destroy();
 
+    s_RendererStorage->LocalShadowAtlasPipeline->Destroy();
+    for (auto& ssbo : s_RendererStorage->LocalShadowsStorageBuffer)
+        ssbo->Destroy();
+
+    // SSAO targets are shared between frames, graph owns their memory, so it goes after them.
+    s_RendererStorage->SSAOFramebuffer[0]->Destroy();
+    s_RendererStorage->SSAOBlurFramebuffer[0]->Destroy();
+
     s_RendererStorage->SSAOPipeline->Destroy();
     for (auto& ub : s_RendererStorage->SSAOUniformBuffer)
         ub->Destroy();
@@ -397,10 +574,31 @@ void Renderer::Shutdown()
     s_RendererStorage->SSAONoiseTexture->Destroy();
     s_RendererStorage->SSAOBlurPipeline->Destroy();
 
+    s_RendererStorage->SSAODepthDownsamplePipeline->Destroy();
+    s_RendererStorage->SSAOComputePipeline->Destroy();
+    s_RendererStorage->SSAOUpsamplePipeline->Destroy();
+    for (auto& depthLevel : s_RendererStorage->SSAODepthPyramid)
+        depthLevel->Destroy();
+
+    s_RendererStorage->SSAOLowResImage->Destroy();
+    s_RendererStorage->SSAOComputeImage->Destroy();
+    s_RendererStorage->DeferredRenderGraph->Destroy();
+
     s_RendererStorage->LightingPipeline->Destroy();
     for (auto& ub : s_RendererStorage->LightingUniformBuffer)
         ub->Destroy();
 
+    s_RendererStorage->LightCullingPipeline->Destroy();
+    for (auto& ub : s_RendererStorage->LightClustersUniformBuffer)
+        ub->Destroy();
+
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
+    {
+        s_RendererStorage->PointLightsStorageBuffer[frame]->Destroy();
+        s_RendererStorage->SpotLightsStorageBuffer[frame]->Destroy();
+        s_RendererStorage->LightClustersStorageBuffer[frame]->Destroy();
+    }
+
     s_RendererStorage->ChromaticAberrationPipeline->Destroy();
 
     for (auto& ub : s_RendererStorage->CameraUniformBuffer)
@@ -416,6 +614,37 @@ void Renderer::Shutdown()
     s_Renderer = nullptr;
 }
 
+void Renderer::InvalidateSSAOImages()
+{
+    const uint32_t scale  = s_RendererSettings.AO.QualityPresets[s_RendererSettings.AO.CurrentQualityPreset].second;
+    const uint32_t width  = s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetWidth();
+    const uint32_t height = s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetHeight();
+
+    auto& ssaoImage   = s_RendererStorage->SSAOComputeImage;
+    auto& lowResImage = s_RendererStorage->SSAOLowResImage;
+
+    const uint32_t lowResWidth  = std::max((width + scale - 1) / scale, 1u);
+    const uint32_t lowResHeight = std::max((height + scale - 1) / scale, 1u);
+    if (ssaoImage->GetWidth() == width && ssaoImage->GetHeight() == height && lowResImage->GetWidth() == lowResWidth &&
+        lowResImage->GetHeight() == lowResHeight)
+        return;
+
+    const auto resizeImage = [](Ref<Image>& image, const uint32_t newWidth, const uint32_t newHeight)
+    {
+        image->GetSpecification().Width  = std::max(newWidth, 1u);
+        image->GetSpecification().Height = std::max(newHeight, 1u);
+        image->Invalidate();
+    };
+
+    resizeImage(ssaoImage, width, height);
+    resizeImage(lowResImage, lowResWidth, lowResHeight);
+
+    // Each level is rounded up, so every low resolution texel has its footprint.
+    auto& depthPyramid = s_RendererStorage->SSAODepthPyramid;
+    resizeImage(depthPyramid[0], (width + 1) / 2, (height + 1) / 2);
+    resizeImage(depthPyramid[1], (depthPyramid[0]->GetWidth() + 1) / 2, (depthPyramid[0]->GetHeight() + 1) / 2);
+}
+
 const Ref<Image>& Renderer::GetFinalImage()
 {
     if (s_RendererSettings.ChromaticAberrationView)
@@ -425,17 +654,23 @@ const Ref<Image>& Renderer::GetFinalImage()
 
 void Renderer::Begin()
 {
-    s_Renderer->BeginImpl();
+    GNT_PROFILE_FUNCTION();
 
     s_RendererStorage->CurrentFrame = GraphicsContext::Get().GetCurrentFrameIndex();
-    s_RendererStats.DrawCalls       = 0;
-    s_RendererStats.PassStatistsics.clear();
-    if (s_RendererStorage->UploadHeap->GetCapacity() > s_RendererStats.s_MaxUploadHeapSizeMB)
-        s_RendererStorage->UploadHeap->Resize(s_RendererStats.s_MaxUploadHeapSizeMB);
 
-    s_RendererStats.UploadHeapCapacity = s_RendererStorage->UploadHeap->GetCapacity();
-    for (auto& currentStat : s_RendererStats.PipelineStatisticsResults)
-        currentStat = 0;
+    // Previous submit of this frame has been waited on, so its secondary command buffers can be reused.
+    for (auto& commandPool : s_RendererStorage->RecordingCommandPools[s_RendererStorage->CurrentFrame])
+        commandPool->Reset();
+
+    ++s_RendererStorage->FrameNumber;
+    s_RendererStats.DrawCalls = 0;
+    {
+        UPLOAD_HEAP_GUARD_LOCK;
+        if (s_RendererStorage->UploadHeap->GetCapacity() > s_RendererStats.s_MaxUploadHeapSizeMB)
+            s_RendererStorage->UploadHeap->Resize(s_RendererStats.s_MaxUploadHeapSizeMB);
+
+        s_RendererStats.UploadHeapCapacity = s_RendererStorage->UploadHeap->GetCapacity();
+    }
 
     if (s_RendererSettings.Shadows.ShadowPresets[s_RendererSettings.Shadows.CurrentShadowPreset].second !=
         s_RendererStorage->ShadowMapFramebuffer[s_RendererStorage->CurrentFrame]->GetWidth())
@@ -443,59 +678,47 @@ void Renderer::Begin()
         s_RendererStorage->ShadowMapFramebuffer[s_RendererStorage->CurrentFrame]->Resize(
             s_RendererSettings.Shadows.ShadowPresets[s_RendererSettings.Shadows.CurrentShadowPreset].second,
             s_RendererSettings.Shadows.ShadowPresets[s_RendererSettings.Shadows.CurrentShadowPreset].second);
+
+        for (auto& cascade : s_RendererStorage->ShadowCascades[s_RendererStorage->CurrentFrame])
+            cascade.bIsValid = false;
     }
 
-    if (s_RendererStorage->bFramebuffersNeedResize)
+    const auto& snapshot = GetReadSnapshot();
+    if (snapshot.bFramebuffersNeedResize)
     {
-        for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+        const glm::uvec2& newSize = snapshot.NewFramebufferSize;
+        for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
         {
-            s_RendererStorage->GeometryFramebuffer[frame]->Resize(s_RendererStorage->NewFramebufferSize.x,
-                                                                  s_RendererStorage->NewFramebufferSize.y);
-            s_RendererStorage->SetupFramebuffer[frame]->Resize(s_RendererStorage->NewFramebufferSize.x,
-                                                               s_RendererStorage->NewFramebufferSize.y);
-            s_RendererStorage->SSAOFramebuffer[frame]->Resize(s_RendererStorage->NewFramebufferSize.x,
-                                                              s_RendererStorage->NewFramebufferSize.y);
-            s_RendererStorage->SSAOBlurFramebuffer[frame]->Resize(s_RendererStorage->NewFramebufferSize.x,
-                                                                  s_RendererStorage->NewFramebufferSize.y);
-            s_RendererStorage->LightingFramebuffer[frame]->Resize(s_RendererStorage->NewFramebufferSize.x,
-                                                                  s_RendererStorage->NewFramebufferSize.y);
-            s_RendererStorage->ChromaticAberrationFramebuffer[frame]->Resize(s_RendererStorage->NewFramebufferSize.x,
-                                                                             s_RendererStorage->NewFramebufferSize.y);
+            s_RendererStorage->GeometryFramebuffer[frame]->Resize(newSize.x, newSize.y);
+            s_RendererStorage->SetupFramebuffer[frame]->Resize(newSize.x, newSize.y);
+            s_RendererStorage->LightingFramebuffer[frame]->Resize(newSize.x, newSize.y);
+            s_RendererStorage->ParticleFramebuffer[frame]->Resize(newSize.x, newSize.y);
+            s_RendererStorage->ChromaticAberrationFramebuffer[frame]->Resize(newSize.x, newSize.y);
 
-            s_RendererStorage->PBRFramebuffer[frame]->Resize(s_RendererStorage->NewFramebufferSize.x,
-                                                             s_RendererStorage->NewFramebufferSize.y);
+            s_RendererStorage->PBRFramebuffer[frame]->Resize(newSize.x, newSize.y);
         }
 
+        // Shared between frames.
+        s_RendererStorage->SSAOFramebuffer[0]->Resize(newSize.x, newSize.y);
+        s_RendererStorage->SSAOBlurFramebuffer[0]->Resize(newSize.x, newSize.y);
+
         /*for (auto& geometry : s_Data.SortedGeometry)
         {
             geometry.Material->Invalidate();
         }*/
-
-        s_RendererStorage->bFramebuffersNeedResize = false;
     }
 
+    InvalidateSSAOImages();
+
     // SSAO Enable
     s_RendererStorage->SSAOPipeline->GetSpecification().Shader->Set("u_TexNoiseMap", s_RendererStorage->SSAONoiseTexture);
-    if (Renderer::GetSettings().AO.EnableSSAO && !s_RendererStorage->SortedGeometry.empty())
-    {
-        if (Renderer::GetSettings().AO.BlurSSAO)
-        {
-            s_RendererStorage->LightingPipeline->GetSpecification().Shader->Set(
-                "u_SSAOMap", s_RendererStorage->SSAOBlurFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment);
-        }
-        else
-        {
-            s_RendererStorage->LightingPipeline->GetSpecification().Shader->Set(
-                "u_SSAOMap", s_RendererStorage->SSAOFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment);
-        }
-    }
-    else
-    {
-        s_RendererStorage->LightingPipeline->GetSpecification().Shader->Set("u_SSAOMap", s_RendererStorage->WhiteTexture);
-    }
+    s_RendererStorage->SSAOComputePipeline->GetSpecification().Shader->Set("u_TexNoiseMap", s_RendererStorage->SSAONoiseTexture);
+    s_RendererStorage->DeferredRenderGraph->SetAliasingEnabled(s_RendererSettings.AliasTransientImages);
 
     s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->BeginRecording();
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->BeginTimestamp(true);
+    s_RendererStorage->QueryRing->BeginFrame(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame],
+                                             s_RendererSettings.GPUProfiling);
+    s_RendererStorage->QueryRing->BeginPipelineStatistics(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
 
     // todo: auto image transition layouts
     //  Clear pass
@@ -507,309 +730,1233 @@ void Renderer::Begin()
         s_RendererStorage->SetupFramebuffer[s_RendererStorage->CurrentFrame]->EndPass(renderCommandBuffer);
 
         renderCommandBuffer->EndRecording();
+
+        // Simulation may upload resources at the same time.
+        GRAPHICS_GUARD_LOCK;
         renderCommandBuffer->Submit();
     }
+}
+
+void Renderer::Flush()
+{
+    GNT_PROFILE_FUNCTION();
 
+    // Post-GBuffer passes, render graph culls what doesn't contribute to the final image && inserts barriers between passes.
+    // SSAO passes of both paths are declared, lighting reads the one selected by quality preset, so the other one gets culled.
+    const bool bRenderSSAO   = !s_RendererStorage->Geometry.empty() && Renderer::GetSettings().AO.EnableSSAO;
+    const uint32_t ssaoScale = s_RendererSettings.AO.QualityPresets[s_RendererSettings.AO.CurrentQualityPreset].second;
+    if (bRenderSSAO)
     {
-        s_RendererStorage->UBGlobalLighting.Gamma = s_RendererSettings.Gamma;
-        for (uint32_t i = 0; i < s_RendererStorage->CurrentSpotLightIndex; ++i)
-            s_RendererStorage->UBGlobalLighting.SpotLights[i] = SpotLight();
+        s_RendererStorage->SSAODataBuffer.CameraProjection  = s_RendererStorage->UBGlobalCamera.Projection;
+        s_RendererStorage->SSAODataBuffer.InvViewProjection = s_RendererStorage->UBGlobalCamera.View;
+        s_RendererStorage->SSAODataBuffer.InvProjection     = s_RendererStorage->UBGlobalLightClusters.InvProjection;
+        s_RendererStorage->SSAODataBuffer.Radius            = s_RendererSettings.AO.Radius;
+        s_RendererStorage->SSAODataBuffer.Bias              = s_RendererSettings.AO.Bias;
+        s_RendererStorage->SSAODataBuffer.Magnitude         = s_RendererSettings.AO.Magnitude;
+        s_RendererStorage->SSAODataBuffer.BlurRadius        = s_RendererSettings.AO.BlurSSAO ? 2 : 1;
+        s_RendererStorage->SSAODataBuffer.ResolutionScale   = static_cast<int32_t>(ssaoScale);
 
-        for (uint32_t i = 0; i < s_RendererStorage->CurrentDirLightIndex; ++i)
-            s_RendererStorage->UBGlobalLighting.DirLights[i] = DirectionalLight();
+        // Updating SSAO
+        s_RendererStorage->SSAOUniformBuffer[s_RendererStorage->CurrentFrame]->SetData(&s_RendererStorage->SSAODataBuffer, sizeof(UBSSAO));
+    }
+
+    auto& renderGraph = s_RendererStorage->DeferredRenderGraph;
+    renderGraph->Reset();
+
+    // GBuffer && shadow maps were made visible to fragment shaders by their framebuffers.
+    constexpr auto fragmentRead     = ERenderGraphResourceState::FRAGMENT_SHADER_READ;
+    const uint32_t currentFrame     = s_RendererStorage->CurrentFrame;
+    const auto& geometryAttachments = s_RendererStorage->GeometryFramebuffer[currentFrame]->GetAttachments();
+
+    const auto albedo     = renderGraph->ImportImage("Albedo", geometryAttachments[0].Attachment, fragmentRead);
+    const auto normal     = renderGraph->ImportImage("Normal", geometryAttachments[1].Attachment, fragmentRead);
+    const auto materialAO = renderGraph->ImportImage("MaterialAO", geometryAttachments[2].Attachment, fragmentRead);
+    const auto depth      = renderGraph->ImportImage("Depth", geometryAttachments[3].Attachment, fragmentRead);
+
+    const auto& shadowMapImage   = s_RendererStorage->ShadowMapFramebuffer[currentFrame]->GetAttachments()[0].Attachment;
+    const auto& shadowAtlasImage = s_RendererStorage->LocalShadowAtlasFramebuffer[currentFrame]->GetAttachments()[0].Attachment;
+    const auto shadowMap         = renderGraph->ImportImage("ShadowMap", shadowMapImage, fragmentRead);
+    const auto localShadowAtlas  = renderGraph->ImportImage("LocalShadowAtlas", shadowAtlasImage, fragmentRead);
+    const auto lightClusters =
+        renderGraph->ImportBuffer("LightClusters", s_RendererStorage->LightClustersStorageBuffer[currentFrame], fragmentRead);
+
+    const auto& lightingImage            = s_RendererStorage->LightingFramebuffer[currentFrame]->GetAttachments()[0].Attachment;
+    const auto& chromaticAberrationImage = s_RendererStorage->ChromaticAberrationFramebuffer[currentFrame]->GetAttachments()[0].Attachment;
+    const auto lighting                  = renderGraph->ImportImage("Lighting", lightingImage, fragmentRead);
+    const auto chromaticAberration       = renderGraph->ImportImage("ChromaticAberration", chromaticAberrationImage, fragmentRead);
+
+    // Transient, memory is bound by the graph && reused between images whose passes don't overlap.
+    const auto& ssaoImage       = s_RendererStorage->SSAOFramebuffer[0]->GetAttachments()[0].Attachment;
+    const auto& ssaoBlurImage   = s_RendererStorage->SSAOBlurFramebuffer[0]->GetAttachments()[0].Attachment;
+    const auto ssaoHalfDepth    = renderGraph->ImportTransientImage("SSAO Half Depth", s_RendererStorage->SSAODepthPyramid[0]);
+    const auto ssaoQuarterDepth = renderGraph->ImportTransientImage("SSAO Quarter Depth", s_RendererStorage->SSAODepthPyramid[1]);
+    const auto ssaoLowRes       = renderGraph->ImportTransientImage("SSAO Low Resolution", s_RendererStorage->SSAOLowResImage);
+    const auto ssaoUpsampled    = renderGraph->ImportTransientImage("SSAO Upsampled", s_RendererStorage->SSAOComputeImage);
+    const auto ssao             = renderGraph->ImportTransientImage("SSAO", ssaoImage);
+    const auto ssaoBlur         = renderGraph->ImportTransientImage("SSAO-Blur", ssaoBlurImage);
+
+    // Presets with resolution scale of 4 sample quarter resolution depth.
+    const auto ssaoDepth          = ssaoScale == 2 ? ssaoHalfDepth : ssaoQuarterDepth;
+    const auto& ssaoDepthImage    = s_RendererStorage->SSAODepthPyramid[ssaoScale == 2 ? 0 : 1];
+    const auto& ssaoUniformBuffer = s_RendererStorage->SSAOUniformBuffer[currentFrame];
+
+    // SSAO (Compute), reduced resolution presets: depth pyramid -> AO -> bilateral upsample.
+    renderGraph->AddPass(
+        "SSAO Depth Downsample",
+        [&](RenderGraphPass& pass)
+        {
+            pass.Read(depth, ERenderGraphResourceState::COMPUTE_SHADER_READ);
+            pass.Write(ssaoHalfDepth, ERenderGraphResourceState::COMPUTE_SHADER_WRITE);
+            pass.Write(ssaoQuarterDepth, ERenderGraphResourceState::COMPUTE_SHADER_WRITE);
+        },
+        [&](const Ref<CommandBuffer>& commandBuffer)
+        {
+            const auto& depthPyramid    = s_RendererStorage->SSAODepthPyramid;
+            auto& depthDownsampleShader = s_RendererStorage->SSAODepthDownsamplePipeline->GetSpecification().Shader;
+            depthDownsampleShader->Set("u_DepthMap", geometryAttachments[3].Attachment);
+            depthDownsampleShader->Set("u_HalfDepth", depthPyramid[0]);
+            depthDownsampleShader->Set("u_QuarterDepth", depthPyramid[1]);
+            depthDownsampleShader->Set("u_UBSSAO", ssaoUniformBuffer);
+
+            Renderer::Dispatch(commandBuffer, s_RendererStorage->SSAODepthDownsamplePipeline, nullptr,
+                               (depthPyramid[0]->GetWidth() + s_SSAO_WORKGROUP_SIZE - 1) / s_SSAO_WORKGROUP_SIZE,
+                               (depthPyramid[0]->GetHeight() + s_SSAO_WORKGROUP_SIZE - 1) / s_SSAO_WORKGROUP_SIZE);
+        });
+
+    renderGraph->AddPass(
+        "SSAO (" + s_RendererSettings.AO.QualityPresets[s_RendererSettings.AO.CurrentQualityPreset].first + ")",
+        [&](RenderGraphPass& pass)
+        {
+            pass.Read(ssaoDepth, ERenderGraphResourceState::COMPUTE_SHADER_READ);
+            pass.Read(normal, ERenderGraphResourceState::COMPUTE_SHADER_READ);
+            pass.Write(ssaoLowRes, ERenderGraphResourceState::COMPUTE_SHADER_WRITE);
+        },
+        [&](const Ref<CommandBuffer>& commandBuffer)
+        {
+            const auto& lowResImage = s_RendererStorage->SSAOLowResImage;
+            auto& ssaoComputeShader = s_RendererStorage->SSAOComputePipeline->GetSpecification().Shader;
+            ssaoComputeShader->Set("u_DepthPyramid", ssaoDepthImage);
+            ssaoComputeShader->Set("u_NormalMap", geometryAttachments[1].Attachment);
+            ssaoComputeShader->Set("u_UBSSAO", ssaoUniformBuffer);
+            ssaoComputeShader->Set("u_AOImage", lowResImage);
+
+            Renderer::Dispatch(commandBuffer, s_RendererStorage->SSAOComputePipeline, nullptr,
+                               (lowResImage->GetWidth() + s_SSAO_WORKGROUP_SIZE - 1) / s_SSAO_WORKGROUP_SIZE,
+                               (lowResImage->GetHeight() + s_SSAO_WORKGROUP_SIZE - 1) / s_SSAO_WORKGROUP_SIZE);
+        });
+
+    renderGraph->AddPass(
+        "SSAO Upsample",
+        [&](RenderGraphPass& pass)
+        {
+            pass.Read(depth, ERenderGraphResourceState::COMPUTE_SHADER_READ);
+            pass.Read(ssaoDepth, ERenderGraphResourceState::COMPUTE_SHADER_READ);
+            pass.Read(ssaoLowRes, ERenderGraphResourceState::COMPUTE_SHADER_READ);
+            pass.Write(ssaoUpsampled, ERenderGraphResourceState::COMPUTE_SHADER_WRITE);
+        },
+        [&](const Ref<CommandBuffer>& commandBuffer)
+        {
+            const auto& upsampledImage = s_RendererStorage->SSAOComputeImage;
+            auto& ssaoUpsampleShader   = s_RendererStorage->SSAOUpsamplePipeline->GetSpecification().Shader;
+            ssaoUpsampleShader->Set("u_DepthMap", geometryAttachments[3].Attachment);
+            ssaoUpsampleShader->Set("u_LowResDepth", ssaoDepthImage);
+            ssaoUpsampleShader->Set("u_LowResAO", s_RendererStorage->SSAOLowResImage);
+            ssaoUpsampleShader->Set("u_UBSSAO", ssaoUniformBuffer);
+            ssaoUpsampleShader->Set("u_SSAOImage", upsampledImage);
+
+            Renderer::Dispatch(commandBuffer, s_RendererStorage->SSAOUpsamplePipeline, nullptr,
+                               (upsampledImage->GetWidth() + s_SSAO_UPSAMPLE_WORKGROUP_SIZE - 1) / s_SSAO_UPSAMPLE_WORKGROUP_SIZE,
+                               (upsampledImage->GetHeight() + s_SSAO_UPSAMPLE_WORKGROUP_SIZE - 1) / s_SSAO_UPSAMPLE_WORKGROUP_SIZE);
+        });
+
+    // SSAO (Fragment), full resolution.
+    renderGraph->AddPass(
+        "SSAO",
+        [&](RenderGraphPass& pass)
+        {
+            pass.Read(depth, fragmentRead);
+            pass.Read(normal, fragmentRead);
+            pass.Write(ssao, ERenderGraphResourceState::COLOR_ATTACHMENT);
+        },
+        [&](const Ref<CommandBuffer>& commandBuffer)
+        {
+            auto& ssaoShader = s_RendererStorage->SSAOPipeline->GetSpecification().Shader;
+            ssaoShader->Set("u_DepthMap", geometryAttachments[3].Attachment);
+            ssaoShader->Set("u_NormalMap", geometryAttachments[1].Attachment);
+            ssaoShader->Set("u_UBSSAO", ssaoUniformBuffer);
+
+            s_RendererStorage->SSAOFramebuffer[currentFrame]->BeginPass(commandBuffer);
+            SubmitFullscreenQuad(s_RendererStorage->SSAOPipeline);
+            s_RendererStorage->SSAOFramebuffer[currentFrame]->EndPass(commandBuffer);
+        });
+
+    renderGraph->AddPass(
+        "SSAO-Blur",
+        [&](RenderGraphPass& pass)
+        {
+            pass.Read(ssao, fragmentRead);
+            pass.Write(ssaoBlur, ERenderGraphResourceState::COLOR_ATTACHMENT);
+        },
+        [&](const Ref<CommandBuffer>& commandBuffer)
+        {
+            s_RendererStorage->SSAOBlurPipeline->GetSpecification().Shader->Set("u_SSAOMap", ssaoImage);
+
+            s_RendererStorage->SSAOBlurFramebuffer[currentFrame]->BeginPass(commandBuffer);
+            SubmitFullscreenQuad(s_RendererStorage->SSAOBlurPipeline);
+            s_RendererStorage->SSAOBlurFramebuffer[currentFrame]->EndPass(commandBuffer);
+        });
+
+    renderGraph->AddPass(
+        "Light Culling", [&](RenderGraphPass& pass) { pass.Write(lightClusters, ERenderGraphResourceState::COMPUTE_SHADER_WRITE); },
+        [&](const Ref<CommandBuffer>& commandBuffer)
+        {
+            auto& pointLightsSSBO   = s_RendererStorage->PointLightsStorageBuffer[currentFrame];
+            auto& spotLightsSSBO    = s_RendererStorage->SpotLightsStorageBuffer[currentFrame];
+            auto& lightClustersSSBO = s_RendererStorage->LightClustersStorageBuffer[currentFrame];
+
+            // SetData() grows buffers if needed, so descriptors should be updated after it.
+            if (!s_RendererStorage->PointLights.empty())
+                pointLightsSSBO->SetData(s_RendererStorage->PointLights.data(), s_RendererStorage->PointLights.size() * sizeof(PointLight));
+
+            if (!s_RendererStorage->SpotLights.empty())
+                spotLightsSSBO->SetData(s_RendererStorage->SpotLights.data(), s_RendererStorage->SpotLights.size() * sizeof(SpotLight));
+
+            auto& localShadowsSSBO = s_RendererStorage->LocalShadowsStorageBuffer[currentFrame];
+            if (!s_RendererStorage->LocalShadows.empty())
+                localShadowsSSBO->SetData(s_RendererStorage->LocalShadows.data(),
+                                          s_RendererStorage->LocalShadows.size() * sizeof(LocalLightShadow));
+
+            s_RendererStorage->UBGlobalLightClusters.PointLightCount = static_cast<uint32_t>(s_RendererStorage->PointLights.size());
+            s_RendererStorage->UBGlobalLightClusters.SpotLightCount  = static_cast<uint32_t>(s_RendererStorage->SpotLights.size());
+            s_RendererStorage->LightClustersUniformBuffer[currentFrame]->SetData(&s_RendererStorage->UBGlobalLightClusters,
+                                                                                 sizeof(UBLightClusters));
+
+            auto& lightCullingShader = s_RendererStorage->LightCullingPipeline->GetSpecification().Shader;
+            lightCullingShader->Set("u_LightClustersData", s_RendererStorage->LightClustersUniformBuffer[currentFrame]);
+            lightCullingShader->Set("s_PointLights", pointLightsSSBO);
+            lightCullingShader->Set("s_SpotLights", spotLightsSSBO);
+            lightCullingShader->Set("s_LightClusters", lightClustersSSBO);
+
+            Renderer::Dispatch(commandBuffer, s_RendererStorage->LightCullingPipeline, nullptr,
+                               s_LIGHT_CLUSTER_COUNT / s_LIGHT_CULLING_WORKGROUP_SIZE);
+        });
+
+    // Final Lighting-Pass
+    RenderGraphResource ssaoMap = s_INVALID_RENDER_GRAPH_RESOURCE;
+    if (bRenderSSAO) ssaoMap = ssaoScale > 1 ? ssaoUpsampled : (Renderer::GetSettings().AO.BlurSSAO ? ssaoBlur : ssao);
+
+    renderGraph->AddPass(
+        "Lighting",
+        [&](RenderGraphPass& pass)
+        {
+            for (const auto lightingInput : {albedo, normal, materialAO, depth, shadowMap, localShadowAtlas, lightClusters})
+                pass.Read(lightingInput, fragmentRead);
+
+            if (ssaoMap != s_INVALID_RENDER_GRAPH_RESOURCE) pass.Read(ssaoMap, fragmentRead);
+            pass.Write(lighting, ERenderGraphResourceState::COLOR_ATTACHMENT);
+        },
+        [&](const Ref<CommandBuffer>& commandBuffer)
+        {
+            s_RendererStorage->LightingUniformBuffer[currentFrame]->SetData(&s_RendererStorage->UBGlobalLighting,
+                                                                            sizeof(s_RendererStorage->UBGlobalLighting));
+
+            // Updating Lighting
+            auto& lightingShader = s_RendererStorage->LightingPipeline->GetSpecification().Shader;
+            lightingShader->Set("u_AlbedoMap", geometryAttachments[0].Attachment);
+            lightingShader->Set("u_NormalMap", geometryAttachments[1].Attachment);
+            lightingShader->Set("u_MaterialAOMap", geometryAttachments[2].Attachment);
+            lightingShader->Set("u_DepthMap", geometryAttachments[3].Attachment);
+            lightingShader->Set("u_LightingData", s_RendererStorage->LightingUniformBuffer[currentFrame]);
+
+            lightingShader->Set("u_ShadowMap", shadowMapImage);
+            lightingShader->Set("u_ShadowsData", s_RendererStorage->ShadowsUniformBuffer[currentFrame]);
+            lightingShader->Set("u_LocalShadowAtlas", shadowAtlasImage);
+
+            lightingShader->Set("u_LightClustersData", s_RendererStorage->LightClustersUniformBuffer[currentFrame]);
+            lightingShader->Set("s_PointLights", s_RendererStorage->PointLightsStorageBuffer[currentFrame]);
+            lightingShader->Set("s_SpotLights", s_RendererStorage->SpotLightsStorageBuffer[currentFrame]);
+            lightingShader->Set("s_LightClusters", s_RendererStorage->LightClustersStorageBuffer[currentFrame]);
+            lightingShader->Set("s_LocalShadows", s_RendererStorage->LocalShadowsStorageBuffer[currentFrame]);
+
+            // Descriptors capture image layout, so SSAO map is bound once graph has transitioned it.
+            if (ssaoMap == ssaoUpsampled)
+                lightingShader->Set("u_SSAOMap", s_RendererStorage->SSAOComputeImage);
+            else if (ssaoMap == ssaoBlur)
+                lightingShader->Set("u_SSAOMap", ssaoBlurImage);
+            else if (ssaoMap == ssao)
+                lightingShader->Set("u_SSAOMap", ssaoImage);
+            else
+                lightingShader->Set("u_SSAOMap", s_RendererStorage->WhiteTexture);
+
+            MeshPushConstants pushConstants = {};
+            pushConstants.Data              = glm::vec4(s_RendererStorage->UBGlobalCamera.Position, 0.0f);
+
+            s_RendererStorage->LightingFramebuffer[currentFrame]->BeginPass(commandBuffer);
+            SubmitFullscreenQuad(s_RendererStorage->LightingPipeline, &pushConstants);
+            s_RendererStorage->LightingFramebuffer[currentFrame]->EndPass(commandBuffer);
+        });
+
+    // Alpha blended particles on top of the lit image, GPU simulation was kicked off in EndScene().
+    renderGraph->AddPass(
+        "Particles",
+        [&](RenderGraphPass& pass)
+        {
+            pass.Read(depth, ERenderGraphResourceState::DEPTH_ATTACHMENT);
+            pass.Write(lighting, ERenderGraphResourceState::COLOR_ATTACHMENT);
+        },
+        [&](const Ref<CommandBuffer>& commandBuffer)
+        {
+            struct PushConstants
+            {
+                glm::mat4 CameraProjection = glm::mat4(1.0f);
+                glm::mat4 CameraView       = glm::mat4(1.0f);
+            } u_ParticleSystemData;
+
+            u_ParticleSystemData.CameraProjection = s_RendererStorage->UBGlobalCamera.Projection;
+            u_ParticleSystemData.CameraView       = s_RendererStorage->UBGlobalCamera.View;
+
+            s_RendererStorage->GPUParticleSystem->OnRender(commandBuffer, &u_ParticleSystemData);
+        });
+
+    renderGraph->AddPass(
+        "Chromatic Aberration",
+        [&](RenderGraphPass& pass)
+        {
+            pass.Read(lighting, fragmentRead);
+            pass.Write(chromaticAberration, ERenderGraphResourceState::COLOR_ATTACHMENT);
+        },
+        [&](const Ref<CommandBuffer>& commandBuffer)
+        {
+            s_RendererStorage->ChromaticAberrationPipeline->GetSpecification().Shader->Set("u_FinalImage", lightingImage);
+
+            s_RendererStorage->ChromaticAberrationFramebuffer[currentFrame]->BeginPass(commandBuffer);
+            SubmitFullscreenQuad(s_RendererStorage->ChromaticAberrationPipeline);
+            s_RendererStorage->ChromaticAberrationFramebuffer[currentFrame]->EndPass(commandBuffer);
+        });
 
-        for (uint32_t i = 0; i < s_RendererStorage->CurrentPointLightIndex; ++i)
-            s_RendererStorage->UBGlobalLighting.PointLights[i] = PointLight();
+    renderGraph->MarkOutput(s_RendererSettings.ChromaticAberrationView ? chromaticAberration : lighting);
+    renderGraph->Compile();
+    renderGraph->Execute(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame], s_RendererStorage->QueryRing);
 
-        s_RendererStorage->CurrentPointLightIndex = 0;
-        s_RendererStorage->CurrentDirLightIndex   = 0;
-        s_RendererStorage->CurrentSpotLightIndex  = 0;
+    s_RendererStorage->QueryRing->EndPipelineStatistics(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->EndRecording();
+    {
+        GRAPHICS_GUARD_LOCK;
+        s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->Submit();
     }
+    s_RendererStorage->QueryRing->EndFrame();
+}
 
-    s_RendererStorage->SortedGeometry.clear();
+// Index of compute shader invocations among graphics pipeline statistics, see GPUQueryRing::GetPipelineStatisticsNames().
+static constexpr size_t s_COMPUTE_SHADER_INVOCATIONS_STATISTIC = 10;
 
-    s_RendererStorage->GPUParticleSystem->OnUpdate();
+void Renderer::CollectPassStatistics()
+{
+    // Both rings hold results of frames in flight ago, they're only copied here, formatting is up to the viewer.
+    const auto& particleQueryRing = s_RendererStorage->GPUParticleSystem->GetQueryRing();
+    GNT_PROFILE_GPU_MARKERS("Graphics", s_RendererStorage->QueryRing->GetMarkers(), s_RendererStorage->QueryRing->GetMarkersSubmitTime());
+    GNT_PROFILE_GPU_MARKERS("Compute", particleQueryRing->GetMarkers(), particleQueryRing->GetMarkersSubmitTime());
+
+    s_RendererStats.GPUMarkers           = s_RendererStorage->QueryRing->GetMarkers();
+    s_RendererStats.GPUMarkersSubmitTime = s_RendererStorage->QueryRing->GetMarkersSubmitTime();
+    s_RendererStats.GPUMarkers.insert(s_RendererStats.GPUMarkers.end(), particleQueryRing->GetMarkers().begin(),
+                                      particleQueryRing->GetMarkers().end());
+
+    // Compute queue only counts compute shader invocations.
+    s_RendererStats.PipelineStatisticsResults = s_RendererStorage->QueryRing->GetPipelineStatistics();
+    s_RendererStats.PipelineStatisticsResults[s_COMPUTE_SHADER_INVOCATIONS_STATISTIC] += particleQueryRing->GetPipelineStatistics()[0];
+
+    s_RendererStats.RenderGraphPassesExecuted = static_cast<uint32_t>(s_RendererStorage->DeferredRenderGraph->GetExecutedPasses().size());
+    s_RendererStats.RenderGraphPassCount      = s_RendererStorage->DeferredRenderGraph->GetPassCount();
+    s_RendererStats.ParticleEmitters          = s_RendererStorage->GPUParticleSystem->GetActiveEmitterCount();
+    s_RendererStats.FrameDrawCalls            = s_RendererStats.DrawCalls.load();
 }
 
-void Renderer::Flush()
+void Renderer::BeginScene(const Camera& camera)
+{
+    // Snapshot left behind once render thread is turned off is overwritten rather than recorded twice.
+    auto& snapshot = GetWriteSnapshot();
+    ClearSnapshot(snapshot);
+
+    snapshot.Camera.Projection    = camera.GetProjectionMatrix();
+    snapshot.Camera.View          = camera.GetViewMatrix();
+    snapshot.Camera.Position      = camera.GetPosition();
+    snapshot.CameraViewProjection = camera.GetViewProjectionMatrix();
+    snapshot.CameraNear           = camera.GetNearClip();
+    snapshot.CameraFar            = camera.GetFarClip();
+}
+
+void Renderer::EndScene()
+{
+    GetWriteSnapshot().bHasScene = true;
+}
+
+void Renderer::SwapSnapshots()
+{
+    GNT_PROFILE_FUNCTION();
+
+    s_RendererStorage->SnapshotWriteIndex ^= 1;
+
+    // Render thread is done with it.
+    auto& snapshot                   = GetWriteSnapshot();
+    snapshot.bFramebuffersNeedResize = false;
+    ClearSnapshot(snapshot);
+}
+
+void Renderer::ClearSnapshot(SceneSnapshot& snapshot)
 {
-    // Particle System
+    // Lists keep their capacity.
+    snapshot.bHasScene     = false;
+    snapshot.DirLightCount = 0;
+    snapshot.Geometry.clear();
+    snapshot.SkinnedMeshes.clear();
+    snapshot.BoneMatrices.clear();
+    snapshot.PointLights.clear();
+    snapshot.SpotLights.clear();
+    snapshot.ShadowCastingPointLights.clear();
+    snapshot.ShadowCastingSpotLights.clear();
+    snapshot.ParticleEmitters.clear();
+}
+
+const std::vector<std::string>& Renderer::GetPipelineStatisticsNames()
+{
+    return s_RendererStorage->QueryRing->GetPipelineStatisticsNames();
+}
+
+template <typename T> static void HashCombine(size_t& seed, const T& value)
+{
+    seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// Bounding sphere of the camera frustum part between sliceNear and sliceFar. Radius doesn't depend on camera rotation, so cascade
+// extent stays the same and texel snapping keeps shadow edges from shimmering.
+static glm::vec4 GetFrustumSliceBoundingSphere(const glm::mat4& invViewProjection, const float zNear, const float zFar,
+                                               const float sliceNear, const float sliceFar)
+{
+    std::array<glm::vec3, 8> corners = {};
+    uint32_t cornerIndex             = 0;
+    for (const float x : {-1.0f, 1.0f})
     {
-        s_RendererStorage->GPUParticleSystem->OnCompute(s_RendererSettings.ParticleCount);
+        for (const float y : {-1.0f, 1.0f})
+        {
+            glm::vec4 nearCorner = invViewProjection * glm::vec4(x, y, 0.0f, 1.0f);
+            glm::vec4 farCorner  = invViewProjection * glm::vec4(x, y, 1.0f, 1.0f);
+            nearCorner /= nearCorner.w;
+            farCorner /= farCorner.w;
+
+            // View depth is linear along the corner ray.
+            const glm::vec3 ray    = glm::vec3(farCorner - nearCorner);
+            corners[cornerIndex++] = glm::vec3(nearCorner) + ray * (sliceNear - zNear) / (zFar - zNear);
+            corners[cornerIndex++] = glm::vec3(nearCorner) + ray * (sliceFar - zNear) / (zFar - zNear);
+        }
+    }
+
+    glm::vec3 center = glm::vec3(0.0f);
+    for (const auto& corner : corners)
+        center += corner;
+    center /= static_cast<float>(corners.size());
+
+    float radius = 0.0f;
+    for (const auto& corner : corners)
+        radius = glm::max(radius, glm::length(corner - center));
+    radius = glm::ceil(radius * 16.0f) / 16.0f;
+
+    return glm::vec4(center, radius);
+}
+
+static glm::mat4 GetCascadeLightSpaceMatrix(const glm::vec4& sliceSphere, const glm::vec3& lightDirection, const uint32_t shadowMapSize)
+{
+    const glm::vec3 center = glm::vec3(sliceSphere);
+    const glm::vec3 up     = glm::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+    const glm::mat4 lightView = glm::lookAt(center - lightDirection * (sliceSphere.w + s_SHADOW_CASTER_DISTANCE), center, up);
+    glm::mat4 lightProjection = glm::ortho(-sliceSphere.w, sliceSphere.w, -sliceSphere.w, sliceSphere.w, 0.0f,
+                                           2.0f * sliceSphere.w + s_SHADOW_CASTER_DISTANCE);
+
+    // Snap projection to shadow map texels, so the cascade moves in whole texel steps.
+    const glm::vec2 shadowOrigin  = glm::vec2(lightProjection * lightView * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)) * (shadowMapSize * 0.5f);
+    const glm::vec2 roundedOffset = (glm::round(shadowOrigin) - shadowOrigin) * (2.0f / shadowMapSize);
+    lightProjection[3][0] += roundedOffset.x;
+    lightProjection[3][1] += roundedOffset.y;
 
-        struct PushConstants
+    return lightProjection * lightView;
+}
+
+// Collects geometry whose bounding sphere touches cascade's ortho volume, returns hash of what's going to be rendered into it.
+size_t Renderer::CullShadowCasters(const glm::mat4& lightSpaceMatrix, const float cascadeRadius, const size_t settingsHash,
+                                   std::vector<GeometryData*>& outShadowCasters)
+{
+    outShadowCasters.clear();
+
+    // Ortho projection is linear, so the test can be done in clip space.
+    const float depthRange = 2.0f * cascadeRadius + s_SHADOW_CASTER_DISTANCE;
+    size_t casterHash      = settingsHash;
+    for (auto& geometry : s_RendererStorage->Geometry)
+    {
+        const glm::vec4 clipPos = lightSpaceMatrix * glm::vec4(glm::vec3(geometry.BoundingSphere), 1.0f);
+        const float xyRadius    = geometry.BoundingSphere.w / cascadeRadius;
+        const float zRadius     = geometry.BoundingSphere.w / depthRange;
+        if (glm::abs(clipPos.x) > 1.0f + xyRadius || glm::abs(clipPos.y) > 1.0f + xyRadius || clipPos.z < -zRadius ||
+            clipPos.z > 1.0f + zRadius)
+            continue;
+
+        outShadowCasters.push_back(&geometry);
+
+        HashCombine(casterHash, geometry.VertexBuffer.get());
+        if (geometry.bIsSkinned) HashCombine(casterHash, s_RendererStorage->FrameNumber);
+        for (uint32_t column = 0; column < 4; ++column)
         {
-            glm::mat4 CameraProjection = glm::mat4(1.0f);
-            glm::mat4 CameraView       = glm::mat4(1.0f);
-        } u_ParticleSystemData;
+            for (uint32_t row = 0; row < 4; ++row)
+                HashCombine(casterHash, geometry.Transform[column][row]);
+        }
+    }
 
-        u_ParticleSystemData.CameraProjection = s_RendererStorage->UBGlobalCamera.Projection;
-        u_ParticleSystemData.CameraView       = s_RendererStorage->UBGlobalCamera.View;
+    return casterHash;
+}
 
-        s_RendererStorage->GPUParticleSystem->OnRender(&u_ParticleSystemData);
+// Morton order keeps power of two tiles packed without gaps, as long as they're allocated from the largest to the smallest.
+static glm::uvec2 MortonDecode2D(const uint32_t code)
+{
+    glm::uvec2 result = glm::uvec2(0);
+    for (uint32_t bit = 0; bit < 16; ++bit)
+    {
+        result.x |= ((code >> (2 * bit)) & 1u) << bit;
+        result.y |= ((code >> (2 * bit + 1)) & 1u) << bit;
     }
-    // TODO: instead of creating new command buffer, insert execution dependency barrier!!
+    return result;
+}
+
+// Cube faces go in +X, -X, +Y, -Y, +Z, -Z order, shader picks the face by the major axis of light to fragment vector.
+static glm::mat4 GetPointLightFaceViewProjection(const glm::vec3& position, const float radius, const uint32_t face)
+{
+    static const std::array<glm::vec3, 6> s_FaceDirections = {glm::vec3(1.0f, 0.0f, 0.0f),  glm::vec3(-1.0f, 0.0f, 0.0f),
+                                                              glm::vec3(0.0f, 1.0f, 0.0f),  glm::vec3(0.0f, -1.0f, 0.0f),
+                                                              glm::vec3(0.0f, 0.0f, 1.0f),  glm::vec3(0.0f, 0.0f, -1.0f)};
+    static const std::array<glm::vec3, 6> s_FaceUps        = {glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+                                                              glm::vec3(0.0f, 0.0f, 1.0f),  glm::vec3(0.0f, 0.0f, -1.0f),
+                                                              glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)};
+
+    return glm::perspective(glm::radians(90.0f), 1.0f, s_LOCAL_SHADOW_NEAR_PLANE, radius) *
+           glm::lookAt(position, position + s_FaceDirections[face], s_FaceUps[face]);
+}
+
+static glm::mat4 GetSpotLightViewProjection(const glm::vec3& position, const glm::vec3& direction, const float radius,
+                                            const float outerCutOff)
+{
+    const glm::vec3 forward = glm::normalize(direction);
+    const glm::vec3 up      = glm::abs(forward.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const float fov         = glm::clamp(2.0f * glm::acos(glm::clamp(outerCutOff, -1.0f, 1.0f)), glm::radians(10.0f), glm::radians(170.0f));
+
+    return glm::perspective(fov, 1.0f, s_LOCAL_SHADOW_NEAR_PLANE, radius) * glm::lookAt(position, position + forward, up);
+}
+
+// Lights get atlas tiles sized by their screen coverage, tiles whose light && casters didn't change keep their contents, the rest are
+// re-rendered by priority within per-frame budget.
+void Renderer::UpdateLocalShadowAtlas()
+{
+    GNT_PROFILE_FUNCTION();
 
-    // TEMP
-    auto vulkanCommandBuffer =
-        std::static_pointer_cast<VulkanCommandBuffer>(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
-    GNT_ASSERT(vulkanCommandBuffer, "Failed to cast CommandBuffer to VulkanCommandBuffer");
+    auto& localShadows = s_RendererStorage->LocalShadows;
+    localShadows.clear();
+    s_RendererStats.LocalShadowTilesRendered = 0;
+    s_RendererStats.LocalShadowTilesVisible  = 0;
 
-    vulkanCommandBuffer->InsertBarrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                       VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 0, nullptr, 0, nullptr);
+    const auto& shadowConfig = Renderer::GetSettings().Shadows;
+    if (!shadowConfig.RenderShadows || !shadowConfig.RenderLocalShadows) return;
 
-    // SSAO-Pass
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->BeginTimestamp();
-    if (!s_RendererStorage->SortedGeometry.empty() && Renderer::GetSettings().AO.EnableSSAO)
+    struct ShadowRequest
     {
-        s_RendererStorage->SSAODataBuffer.CameraProjection  = s_RendererStorage->UBGlobalCamera.Projection;
-        s_RendererStorage->SSAODataBuffer.InvViewProjection = s_RendererStorage->UBGlobalCamera.View;
-        s_RendererStorage->SSAODataBuffer.Radius            = s_RendererSettings.AO.Radius;
-        s_RendererStorage->SSAODataBuffer.Bias              = s_RendererSettings.AO.Bias;
-        s_RendererStorage->SSAODataBuffer.Magnitude         = s_RendererSettings.AO.Magnitude;
+        uint32_t LightIndex  = 0;
+        bool bIsSpotLight    = false;
+        float ScreenCoverage = 0.0f;
+        uint32_t TileSize    = 0;
+        uint32_t ShadowIndex = 0;
+    };
+    std::vector<ShadowRequest> requests;
+
+    const glm::vec3& cameraPos  = s_RendererStorage->UBGlobalCamera.Position;
+    const glm::mat4& cameraView = s_RendererStorage->UBGlobalCamera.View;
+    const float projectionScale = glm::abs(s_RendererStorage->UBGlobalCamera.Projection[1][1]);
+    const uint32_t maxTileLevel =
+        static_cast<uint32_t>(glm::log2(static_cast<float>(s_LOCAL_SHADOW_MAX_TILE_SIZE / s_LOCAL_SHADOW_MIN_TILE_SIZE)));
+    const auto addShadowRequest = [&](const uint32_t lightIndex, const bool bIsSpotLight, const glm::vec4& lightSphere)
+    {
+        if (lightSphere.w <= s_LOCAL_SHADOW_NEAR_PLANE) return;
 
-        // Updating SSAO
-        s_RendererStorage->SSAOUniformBuffer[s_RendererStorage->CurrentFrame]->SetData(&s_RendererStorage->SSAODataBuffer, sizeof(UBSSAO));
+        // Light's range is entirely behind the camera.
+        if ((cameraView * glm::vec4(glm::vec3(lightSphere), 1.0f)).z > lightSphere.w) return;
+
+        // Projected radius relative to the screen height, 1.0 once camera is inside light's range.
+        const float distance = glm::max(glm::distance(cameraPos, glm::vec3(lightSphere)), lightSphere.w);
+        const float coverage = glm::min(lightSphere.w * projectionScale / distance, 1.0f);
+        const uint32_t level =
+            glm::min(static_cast<uint32_t>(glm::max(glm::floor(-glm::log2(glm::max(coverage, 0.0001f))), 0.0f)), maxTileLevel);
 
-        s_RendererStorage->SSAOPipeline->GetSpecification().Shader->Set(
-            "u_PositionMap", s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment);
+        requests.push_back({lightIndex, bIsSpotLight, coverage, s_LOCAL_SHADOW_MAX_TILE_SIZE >> level, 0});
+    };
 
-        s_RendererStorage->SSAOPipeline->GetSpecification().Shader->Set(
-            "u_NormalMap", s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[1].Attachment);
+    for (const auto lightIndex : s_RendererStorage->ShadowCastingPointLights)
+        addShadowRequest(lightIndex, false, s_RendererStorage->PointLights[lightIndex].Position);
 
-        s_RendererStorage->SSAOPipeline->GetSpecification().Shader->Set(
-            "u_UBSSAO", s_RendererStorage->SSAOUniformBuffer[s_RendererStorage->CurrentFrame]);
+    for (const auto lightIndex : s_RendererStorage->ShadowCastingSpotLights)
+        addShadowRequest(lightIndex, true, s_RendererStorage->SpotLights[lightIndex].Position);
 
-        s_RendererStorage->SSAOFramebuffer[s_RendererStorage->CurrentFrame]->BeginPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+    if (requests.empty()) return;
 
-        SubmitFullscreenQuad(s_RendererStorage->SSAOPipeline);
+    std::stable_sort(requests.begin(), requests.end(),
+                     [](const ShadowRequest& lhs, const ShadowRequest& rhs) { return lhs.ScreenCoverage > rhs.ScreenCoverage; });
+
+    // Atlas space is counted in the smallest tiles, shrink the least important lights first and drop them once they can't get any
+    // smaller.
+    const auto getTileUnits = [](const ShadowRequest& request)
+    {
+        const uint32_t side = request.TileSize / s_LOCAL_SHADOW_MIN_TILE_SIZE;
+        return side * side * (request.bIsSpotLight ? 1 : 6);
+    };
 
-        s_RendererStorage->SSAOFramebuffer[s_RendererStorage->CurrentFrame]->EndPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+    constexpr uint32_t atlasSide  = s_LOCAL_SHADOW_ATLAS_SIZE / s_LOCAL_SHADOW_MIN_TILE_SIZE;
+    constexpr uint32_t atlasUnits = atlasSide * atlasSide;
+    uint32_t usedUnits            = 0;
+    for (const auto& request : requests)
+        usedUnits += getTileUnits(request);
 
-        if (Renderer::GetSettings().AO.BlurSSAO)
+    while (usedUnits > atlasUnits)
+    {
+        auto it = std::find_if(requests.rbegin(), requests.rend(),
+                               [](const ShadowRequest& request) { return request.TileSize > s_LOCAL_SHADOW_MIN_TILE_SIZE; });
+        if (it == requests.rend())
         {
-            s_RendererStorage->SSAOBlurFramebuffer[s_RendererStorage->CurrentFrame]->BeginPass(
-                s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+            usedUnits -= getTileUnits(requests.back());
+            requests.pop_back();
+            continue;
+        }
 
-            // Updating SSAO-Blur
-            s_RendererStorage->SSAOBlurPipeline->GetSpecification().Shader->Set(
-                "u_SSAOMap", s_RendererStorage->SSAOFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment);
+        usedUnits -= getTileUnits(*it);
+        it->TileSize /= 2;
+        usedUnits += getTileUnits(*it);
+    }
 
-            SubmitFullscreenQuad(s_RendererStorage->SSAOBlurPipeline);
+    // Point light faces are stored consecutively, so lights only need their first entry index.
+    uint32_t shadowCount = 0;
+    for (auto& request : requests)
+    {
+        request.ShadowIndex = shadowCount;
+        shadowCount += request.bIsSpotLight ? 1 : 6;
+    }
+    localShadows.resize(shadowCount);
+    s_RendererStats.LocalShadowTilesVisible = shadowCount;
+
+    // Allocate tiles from the largest to the smallest.
+    std::vector<glm::uvec4> tileRects(shadowCount);
+    {
+        std::vector<const ShadowRequest*> requestsBySize(requests.size());
+        for (size_t i = 0; i < requests.size(); ++i)
+            requestsBySize[i] = &requests[i];
 
-            s_RendererStorage->SSAOBlurFramebuffer[s_RendererStorage->CurrentFrame]->EndPass(
-                s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+        std::stable_sort(requestsBySize.begin(), requestsBySize.end(),
+                         [](const ShadowRequest* lhs, const ShadowRequest* rhs) { return lhs->TileSize > rhs->TileSize; });
+
+        uint32_t mortonOffset = 0;
+        for (const auto request : requestsBySize)
+        {
+            const uint32_t side = request->TileSize / s_LOCAL_SHADOW_MIN_TILE_SIZE;
+            for (uint32_t face = 0; face < (request->bIsSpotLight ? 1u : 6u); ++face)
+            {
+                const glm::uvec2 offset                 = MortonDecode2D(mortonOffset) * s_LOCAL_SHADOW_MIN_TILE_SIZE;
+                tileRects[request->ShadowIndex + face] = glm::uvec4(offset, request->TileSize, request->TileSize);
+                mortonOffset += side * side;
+            }
         }
     }
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->EndTimestamp();
 
-    // TEMP
-    vulkanCommandBuffer->InsertBarrier(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                       VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 0, nullptr, 0, nullptr);
+    auto& atlasFramebuffer      = s_RendererStorage->LocalShadowAtlasFramebuffer[s_RendererStorage->CurrentFrame];
+    auto& atlasTiles            = s_RendererStorage->LocalShadowTiles[s_RendererStorage->CurrentFrame];
+    auto& commandBuffer         = s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame];
+    const uint32_t updateBudget = static_cast<uint32_t>(glm::max(shadowConfig.LocalShadowUpdateBudget, 0));
 
-    // Final Lighting-Pass
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->BeginTimestamp();
-    {
-        s_RendererStorage->LightingFramebuffer[s_RendererStorage->CurrentFrame]->BeginPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+    std::vector<GeometryData*> shadowCasters;
+    shadowCasters.reserve(s_RendererStorage->Geometry.size());
 
-        s_RendererStorage->LightingUniformBuffer[s_RendererStorage->CurrentFrame]->SetData(&s_RendererStorage->UBGlobalLighting,
-                                                                                           sizeof(s_RendererStorage->UBGlobalLighting));
+    // Requests are sorted by priority, so the most visible lights are updated first.
+    for (const auto& request : requests)
+    {
+        glm::vec4 lightSphere = glm::vec4(0.0f);
+        size_t lightHash      = 0;
+        if (request.bIsSpotLight)
+        {
+            auto& spotLight       = s_RendererStorage->SpotLights[request.LightIndex];
+            spotLight.ShadowIndex = static_cast<int32_t>(request.ShadowIndex);
+            lightSphere           = spotLight.Position;
+
+            HashCombine(lightHash, spotLight.Direction.x);
+            HashCombine(lightHash, spotLight.Direction.y);
+            HashCombine(lightHash, spotLight.Direction.z);
+            HashCombine(lightHash, spotLight.OuterCutOff);
+        }
+        else
+        {
+            auto& pointLight       = s_RendererStorage->PointLights[request.LightIndex];
+            pointLight.ShadowIndex = static_cast<int32_t>(request.ShadowIndex);
+            lightSphere            = pointLight.Position;
+        }
 
-        // Updating Lighting
-        s_RendererStorage->LightingPipeline->GetSpecification().Shader->Set(
-            "u_PositionMap", s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment);
+        for (uint32_t i = 0; i < 4; ++i)
+            HashCombine(lightHash, lightSphere[i]);
 
-        s_RendererStorage->LightingPipeline->GetSpecification().Shader->Set(
-            "u_NormalMap", s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[1].Attachment);
+        // Geometry whose bounding sphere touches light's range.
+        shadowCasters.clear();
+        size_t casterHash = lightHash;
+        for (auto& geometry : s_RendererStorage->Geometry)
+        {
+            if (glm::distance(glm::vec3(geometry.BoundingSphere), glm::vec3(lightSphere)) > lightSphere.w + geometry.BoundingSphere.w)
+                continue;
 
-        s_RendererStorage->LightingPipeline->GetSpecification().Shader->Set(
-            "u_AlbedoMap", s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[2].Attachment);
-        s_RendererStorage->LightingPipeline->GetSpecification().Shader->Set(
-            "u_MRAO", s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[3].Attachment);
+            shadowCasters.push_back(&geometry);
 
-        s_RendererStorage->LightingPipeline->GetSpecification().Shader->Set(
-            "u_LightingData", s_RendererStorage->LightingUniformBuffer[s_RendererStorage->CurrentFrame]);
+            HashCombine(casterHash, geometry.VertexBuffer.get());
+            if (geometry.bIsSkinned) HashCombine(casterHash, s_RendererStorage->FrameNumber);
+            for (uint32_t column = 0; column < 4; ++column)
+            {
+                for (uint32_t row = 0; row < 4; ++row)
+                    HashCombine(casterHash, geometry.Transform[column][row]);
+            }
+        }
 
-        MeshPushConstants pushConstants = {};
-        pushConstants.Data              = glm::vec4(s_RendererStorage->UBGlobalCamera.Position, 0.0f);
+        for (uint32_t face = 0; face < (request.bIsSpotLight ? 1u : 6u); ++face)
+        {
+            const uint32_t shadowIndex = request.ShadowIndex + face;
+            const glm::uvec4& tileRect = tileRects[shadowIndex];
+            const uint64_t tileKey     = (static_cast<uint64_t>(tileRect.x) << 32) | (static_cast<uint64_t>(tileRect.y) << 16) | tileRect.z;
+            const uint64_t lightID =
+                (static_cast<uint64_t>(request.bIsSpotLight) << 63) | (static_cast<uint64_t>(request.LightIndex) << 3) | face;
+
+            size_t contentHash = casterHash;
+            HashCombine(contentHash, face);
+
+            auto tileIt            = atlasTiles.find(tileKey);
+            const bool bIsUpToDate = tileIt != atlasTiles.end() && tileIt->second.LightID == lightID &&
+                                     tileIt->second.ContentHash == contentHash;
+            if (!bIsUpToDate && s_RendererStats.LocalShadowTilesRendered < updateBudget)
+            {
+                auto& tile       = atlasTiles[tileKey];
+                tile.LightID     = lightID;
+                tile.ContentHash = contentHash;
+                if (request.bIsSpotLight)
+                {
+                    const auto& spotLight = s_RendererStorage->SpotLights[request.LightIndex];
+                    tile.ViewProjection =
+                        GetSpotLightViewProjection(glm::vec3(lightSphere), spotLight.Direction, lightSphere.w, spotLight.OuterCutOff);
+                }
+                else
+                    tile.ViewProjection = GetPointLightFaceViewProjection(glm::vec3(lightSphere), lightSphere.w, face);
+
+                atlasFramebuffer->BeginPass(commandBuffer, 0, tileRect);
+
+                MatrixPushConstants mpc = {};
+                mpc.mat2                = tile.ViewProjection;
+                for (auto geometry : shadowCasters)
+                {
+                    mpc.mat1 = geometry->Transform;
+                    SubmitMesh(s_RendererStorage->LocalShadowAtlasPipeline, geometry->VertexBuffer, geometry->IndexBuffer, nullptr, &mpc,
+                               geometry->VertexOffset);
+                }
+
+                atlasFramebuffer->EndPass(commandBuffer);
+                ++s_RendererStats.LocalShadowTilesRendered;
+
+                tileIt = atlasTiles.find(tileKey);
+            }
 
-        SubmitFullscreenQuad(s_RendererStorage->LightingPipeline, &pushConstants);
+            // Out of budget tiles still holding this light are used as is, with the matrix they were rendered with.
+            if (tileIt == atlasTiles.end() || tileIt->second.LightID != lightID) continue;
 
-        s_RendererStorage->LightingFramebuffer[s_RendererStorage->CurrentFrame]->EndPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+            localShadows[shadowIndex].ViewProjection = tileIt->second.ViewProjection;
+            localShadows[shadowIndex].AtlasRect      = glm::vec4(tileRect) / static_cast<float>(s_LOCAL_SHADOW_ATLAS_SIZE);
+        }
     }
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->EndTimestamp();
+}
 
-    // Chromatic Aberration
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->BeginTimestamp();
+// Opaque:      pass(2) | pipeline(6) | material(16) | mesh(16) | depth(24), state changes are minimized && depth breaks ties front to back.
+// Transparent: pass(2) | inverted depth(24) | pipeline(6) | material(16) | mesh(16), blending needs back to front order.
+static constexpr uint32_t s_DRAW_KEY_DEPTH_BITS   = 24;
+static constexpr uint64_t s_DRAW_KEY_MAX_DEPTH    = (1ull << s_DRAW_KEY_DEPTH_BITS) - 1;
+static constexpr uint32_t s_DRAW_KEY_MAX_PIPELINE = (1u << 6) - 1;
+static constexpr uint32_t s_DRAW_KEY_MAX_STATE_ID = (1u << 16) - 1;
+
+uint64_t Renderer::MakeDrawKey(const EDrawPass pass, const uint32_t pipelineID, const uint32_t materialID, const uint32_t meshID,
+                               const float depth)
+{
+    GNT_ASSERT(pipelineID <= s_DRAW_KEY_MAX_PIPELINE && materialID <= s_DRAW_KEY_MAX_STATE_ID && meshID <= s_DRAW_KEY_MAX_STATE_ID,
+               "Draw key field overflow!");
+
+    const uint64_t quantizedDepth = static_cast<uint64_t>(glm::clamp(depth, 0.0f, 1.0f) * static_cast<float>(s_DRAW_KEY_MAX_DEPTH));
+    const uint64_t stateBits      = (static_cast<uint64_t>(pipelineID) << 32) | (static_cast<uint64_t>(materialID) << 16) | meshID;
+    const uint64_t passBits       = static_cast<uint64_t>(pass) << 62;
+
+    if (pass == EDrawPass::DRAW_PASS_TRANSPARENT) return passBits | ((s_DRAW_KEY_MAX_DEPTH - quantizedDepth) << 38) | stateBits;
+    return passBits | (stateBits << s_DRAW_KEY_DEPTH_BITS) | quantizedDepth;
+}
+
+void Renderer::BuildDrawKeys()
+{
+    GNT_PROFILE_FUNCTION();
+
+    auto& drawKeys = s_RendererStorage->DrawKeys;
+    drawKeys.clear();
+    s_RendererStorage->MaterialIDs.clear();
+    s_RendererStorage->MeshIDs.clear();
+
+    // IDs are handed out in submission order, so they stay small && stable while the scene doesn't change.
+    // Ones past the key's 16 bits share the last ID, such draws are only grouped worse, their order is still valid.
+    const auto getDrawStateID = [&](std::unordered_map<const void*, uint32_t>& stateIDs, const void* state)
     {
-        s_RendererStorage->ChromaticAberrationFramebuffer[s_RendererStorage->CurrentFrame]->BeginPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+        const uint32_t stateID = stateIDs.try_emplace(state, static_cast<uint32_t>(stateIDs.size())).first->second;
+        if (stateID <= s_DRAW_KEY_MAX_STATE_ID) return stateID;
+
+        if (!s_RendererStorage->bWarnedOutOfDrawStateIDs)
+            LOG_WARN("More than %u materials or meshes per frame, draw keys won't tell the rest apart!", s_DRAW_KEY_MAX_STATE_ID + 1);
+        s_RendererStorage->bWarnedOutOfDrawStateIDs = true;
+        return s_DRAW_KEY_MAX_STATE_ID;
+    };
+
+    const glm::vec3& cameraPos = s_RendererStorage->UBGlobalCamera.Position;
+    const float invCameraFar   = 1.0f / glm::max(s_RendererStorage->UBGlobalLightClusters.zFar, 0.001f);
+    for (uint32_t i = 0; i < s_RendererStorage->Geometry.size(); ++i)
+    {
+        const auto& geometry = s_RendererStorage->Geometry[i];
+
+        // Distance to the closest point of bounding sphere, so big occluders go first.
+        const float depth = (glm::distance(cameraPos, glm::vec3(geometry.BoundingSphere)) - geometry.BoundingSphere.w) * invCameraFar;
 
-        // Chromatic Aberration
-        s_RendererStorage->ChromaticAberrationPipeline->GetSpecification().Shader->Set(
-            "u_FinalImage", s_RendererStorage->LightingFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment);
+        // GBuffer has a single pipeline so far, everything goes into opaque pass.
+        const uint32_t materialID = getDrawStateID(s_RendererStorage->MaterialIDs, geometry.Material.get());
+        const uint32_t meshID     = getDrawStateID(s_RendererStorage->MeshIDs, geometry.VertexBuffer.get());
+        drawKeys.push_back({MakeDrawKey(EDrawPass::DRAW_PASS_OPAQUE, 0, materialID, meshID, depth), i});
+    }
 
-        SubmitFullscreenQuad(s_RendererStorage->ChromaticAberrationPipeline);
+    RadixSortDrawKeys(drawKeys, s_RendererStorage->DrawKeysScratch);
+}
 
-        s_RendererStorage->ChromaticAberrationFramebuffer[s_RendererStorage->CurrentFrame]->EndPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+// LSD radix sort, 8 bits per pass. It's stable, so keys that are equal keep their submission order.
+void Renderer::RadixSortDrawKeys(std::vector<DrawKey>& drawKeys, std::vector<DrawKey>& scratch)
+{
+    if (drawKeys.size() < 2) return;
+
+    // Histograms of all bytes are built at once, passes over bytes that are the same for every key are skipped.
+    std::array<std::array<uint32_t, 256>, sizeof(uint64_t)> histograms = {};
+    for (const auto& drawKey : drawKeys)
+    {
+        for (uint32_t byte = 0; byte < sizeof(uint64_t); ++byte)
+            ++histograms[byte][(drawKey.Key >> (byte * 8)) & 0xFF];
     }
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->EndTimestamp();
 
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->EndTimestamp(true);
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->EndRecording();
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->Submit();
+    scratch.resize(drawKeys.size());
+    for (uint32_t byte = 0; byte < sizeof(uint64_t); ++byte)
+    {
+        auto& histogram = histograms[byte];
+        if (histogram[(drawKeys[0].Key >> (byte * 8)) & 0xFF] == drawKeys.size()) continue;
+
+        // Counts to offsets.
+        uint32_t offset = 0;
+        for (auto& count : histogram)
+        {
+            const uint32_t bucketSize = count;
+            count                     = offset;
+            offset += bucketSize;
+        }
 
-    CollectPassStatistics();
+        for (const auto& drawKey : drawKeys)
+            scratch[histogram[(drawKey.Key >> (byte * 8)) & 0xFF]++] = drawKey;
+        drawKeys.swap(scratch);
+    }
 }
 
-void Renderer::CollectPassStatistics()
+// Bounding sphere radius is scaled by the largest axis scale, so it stays conservative under non-uniform scale.
+static float GetMaxScale(const glm::mat4& transform)
+{
+    return glm::sqrt(glm::max(glm::max(glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+                                       glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1]))),
+                              glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]))));
+}
+
+// Skinned meshes are culled with their bind pose bounds, animation can move vertices out of them.
+static constexpr float s_SKINNED_BOUNDS_SCALE = 1.5f;
+
+void Renderer::SkinMeshes()
 {
-    auto& timestampResults = s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->GetTimestampResults();
+    GNT_PROFILE_FUNCTION();
 
+    const uint32_t currentFrame     = s_RendererStorage->CurrentFrame;
+    const auto& skinnedMeshes       = s_RendererStorage->SkinnedMeshes;
+    s_RendererStats.SkinnedVertices = 0;
+    if (skinnedMeshes.empty()) return;
+
+    // Source vertices are stored once per mesh, however many instances of it there are.
+    auto& sourceOffsets = s_RendererStorage->SkinningSourceOffsets;
+    sourceOffsets.clear();
+
+    std::vector<Ref<Mesh>> sourceMeshes;
+    uint32_t sourceVertexCount = 0;
+    for (const auto& skinnedMesh : skinnedMeshes)
     {
-        const float time =
-            static_cast<float>(timestampResults[1] - timestampResults[0]) * GraphicsContext::Get().GetTimestampPeriod() / 1000000.0f;
-        const std::string str = "DirShadowMap Pass: " + std::to_string(time) + " (ms)";
-        s_RendererStats.PassStatistsics.push_back(str);
+        if (!sourceOffsets.try_emplace(skinnedMesh.Mesh.get(), sourceVertexCount).second) continue;
+
+        sourceMeshes.push_back(skinnedMesh.Mesh);
+        for (uint32_t i = 0; i < skinnedMesh.Mesh->GetSubmeshCount(); ++i)
+            sourceVertexCount += static_cast<uint32_t>(skinnedMesh.Mesh->GetAnimatedVertices(i).size());
     }
 
+    // Source buffer of this frame is re-uploaded only when the set of skinned meshes changes.
+    auto& sourceSSBO = s_RendererStorage->SkinningSourceStorageBuffer[currentFrame];
+    if (sourceMeshes != s_RendererStorage->SkinningSourceMeshes[currentFrame])
     {
-        const float time =
-            static_cast<float>(timestampResults[3] - timestampResults[2]) * GraphicsContext::Get().GetTimestampPeriod() / 1000000.0f;
-        const std::string str = "GBuffer Pass:   " + std::to_string(time) + " (ms)";
-        s_RendererStats.PassStatistsics.push_back(str);
+        auto& sourceVertices = s_RendererStorage->SkinningSourceVertices;
+        sourceVertices.clear();
+        sourceVertices.reserve(sourceVertexCount);
+        for (const auto& mesh : sourceMeshes)
+        {
+            for (uint32_t i = 0; i < mesh->GetSubmeshCount(); ++i)
+                sourceVertices.insert(sourceVertices.end(), mesh->GetAnimatedVertices(i).begin(), mesh->GetAnimatedVertices(i).end());
+        }
+
+        if (!sourceVertices.empty()) sourceSSBO->SetData(sourceVertices.data(), sourceVertices.size() * sizeof(AnimatedVertex));
+        s_RendererStorage->SkinningSourceMeshes[currentFrame].swap(sourceMeshes);
     }
 
+    // Every submesh instance gets its range of the output buffer && is drawn from it with a vertex offset.
+    auto& dispatches = s_RendererStorage->SkinningDispatches;
+    auto& geometry   = s_RendererStorage->Geometry;
+    dispatches.clear();
+
+    const size_t firstSkinnedGeometry = geometry.size();
+    uint32_t outputVertexCount        = 0;
+    uint32_t maxVertexCount           = 0;
+    for (const auto& skinnedMesh : skinnedMeshes)
     {
-        const float time =
-            static_cast<float>(timestampResults[5] - timestampResults[4]) * GraphicsContext::Get().GetTimestampPeriod() / 1000000.0f;
-        const std::string str = "SSAO Pass:      " + std::to_string(time) + " (ms)";
-        s_RendererStats.PassStatistsics.push_back(str);
+        const auto& mesh      = skinnedMesh.Mesh;
+        const float maxScale  = GetMaxScale(skinnedMesh.Transform);
+        uint32_t sourceOffset = sourceOffsets[mesh.get()];
+        for (uint32_t i = 0; i < mesh->GetSubmeshCount(); ++i)
+        {
+            const auto vertexCount = static_cast<uint32_t>(mesh->GetAnimatedVertices(i).size());
+            dispatches.push_back({sourceOffset, outputVertexCount, vertexCount, skinnedMesh.BoneOffset});
+
+            const glm::vec4& localSphere = mesh->GetBoundingSphere(i);
+            const glm::vec3 worldCenter  = glm::vec3(skinnedMesh.Transform * glm::vec4(glm::vec3(localSphere), 1.0f));
+
+            auto& skinnedGeometry          = geometry.emplace_back();
+            skinnedGeometry.Material       = mesh->GetMaterial(i);
+            skinnedGeometry.IndexBuffer    = mesh->GetIndexBuffers()[i];
+            skinnedGeometry.Transform      = skinnedMesh.Transform;
+            skinnedGeometry.BoundingSphere = glm::vec4(worldCenter, localSphere.w * maxScale * s_SKINNED_BOUNDS_SCALE);
+            skinnedGeometry.VertexOffset   = static_cast<int32_t>(outputVertexCount);
+            skinnedGeometry.bIsSkinned     = true;
+
+            maxVertexCount = std::max(maxVertexCount, vertexCount);
+            sourceOffset += vertexCount;
+            outputVertexCount += vertexCount;
+        }
     }
 
+    if (outputVertexCount == 0)
     {
-        const float time =
-            static_cast<float>(timestampResults[7] - timestampResults[6]) * GraphicsContext::Get().GetTimestampPeriod() / 1000000.0f;
-        const std::string str = "Lighting Pass:  " + std::to_string(time) + " (ms)";
-        s_RendererStats.PassStatistsics.push_back(str);
+        geometry.resize(firstSkinnedGeometry);
+        return;
     }
 
+    // Previous submit of this frame has been waited on, so its output buffer can be replaced.
+    auto& outputBuffer = s_RendererStorage->SkinnedVertexBuffer[currentFrame];
+    if (!outputBuffer || outputBuffer->GetCount() < outputVertexCount)
     {
-        const float time =
-            static_cast<float>(timestampResults[9] - timestampResults[8]) * GraphicsContext::Get().GetTimestampPeriod() / 1000000.0f;
-        const std::string str = "Chromatic Aberration: " + std::to_string(time) + " (ms)";
-        s_RendererStats.PassStatistsics.push_back(str);
+        if (outputBuffer) outputBuffer->Destroy();
+
+        // Headroom, so a growing crowd doesn't reallocate it every frame.
+        BufferSpecification outputBufferSpec = {};
+        outputBufferSpec.Usage               = EBufferUsageFlags::VERTEX_BUFFER | EBufferUsageFlags::STORAGE_BUFFER;
+        outputBufferSpec.Count               = outputVertexCount + outputVertexCount / 2;
+        outputBufferSpec.Size                = outputBufferSpec.Count * sizeof(MeshVertex);
+        outputBuffer                         = VertexBuffer::Create(outputBufferSpec);
     }
-}
 
-void Renderer::BeginScene(const Camera& camera)
-{
-    s_RendererStorage->UBGlobalCamera.Projection = camera.GetProjectionMatrix();
-    s_RendererStorage->UBGlobalCamera.View       = camera.GetViewMatrix();
-    s_RendererStorage->UBGlobalCamera.Position   = camera.GetPosition();
+    for (size_t i = firstSkinnedGeometry; i < geometry.size(); ++i)
+        geometry[i].VertexBuffer = outputBuffer;
 
-    s_RendererStorage->CameraUniformBuffer[s_RendererStorage->CurrentFrame]->SetData(&s_RendererStorage->UBGlobalCamera, sizeof(UBCamera));
-    Renderer2D::GetStorageData().CameraProjectionMatrix = camera.GetViewProjectionMatrix();
+    // SetData() grows buffers if needed, so descriptors should be updated after it.
+    auto& dispatchesSSBO  = s_RendererStorage->SkinningDispatchesStorageBuffer[currentFrame];
+    auto& bonePaletteSSBO = s_RendererStorage->BonePaletteStorageBuffer[currentFrame];
+    dispatchesSSBO->SetData(dispatches.data(), dispatches.size() * sizeof(SkinningDispatch));
+    bonePaletteSSBO->SetData(s_RendererStorage->BoneMatrices.data(), s_RendererStorage->BoneMatrices.size() * sizeof(glm::mat4));
+
+    auto& skinningShader = s_RendererStorage->SkinningPipeline->GetSpecification().Shader;
+    skinningShader->Set("s_SkinningDispatches", dispatchesSSBO);
+    skinningShader->Set("s_SourceVertices", sourceSSBO);
+    skinningShader->Set("s_BonePalette", bonePaletteSSBO);
+    skinningShader->Set("s_SkinnedVertices", outputBuffer);
+
+    auto& renderCommandBuffer = s_RendererStorage->RenderCommandBuffer[currentFrame];
+    GPUMarkerScope marker(s_RendererStorage->QueryRing, renderCommandBuffer, "Skinning");
+
+    // Workgroup rows along Y map to dispatch entries, rows of shorter submeshes exit early.
+    const uint32_t groupCountX = (maxVertexCount + s_SKINNING_WORKGROUP_SIZE - 1) / s_SKINNING_WORKGROUP_SIZE;
+    const auto dispatchCount   = static_cast<uint32_t>(dispatches.size());
+    for (uint32_t firstDispatch = 0; firstDispatch < dispatchCount; firstDispatch += s_MAX_SKINNING_DISPATCHES_PER_BATCH)
+    {
+        const uint32_t batchSize = std::min(dispatchCount - firstDispatch, s_MAX_SKINNING_DISPATCHES_PER_BATCH);
+        Renderer::Dispatch(renderCommandBuffer, s_RendererStorage->SkinningPipeline, &firstDispatch, groupCountX, batchSize);
+    }
+
+    s_Renderer->InsertComputeToVertexInputBarrierImpl(renderCommandBuffer);
+    s_RendererStats.SkinnedVertices = outputVertexCount;
 }
 
-const std::vector<std::string> Renderer::GetPipelineStatistics()
+// Fewer draws per job cost more in job && vkCmdExecuteCommands overhead than they save.
+static constexpr size_t s_MIN_DRAWS_PER_RECORDING_JOB = 64;
+
+void Renderer::RecordPassInParallel(const Ref<Framebuffer>& framebuffer, const uint32_t layer, const size_t drawCount,
+                                    const RecordDrawsFunc& recordDrawsFunc)
 {
-    std::vector<std::string> result =
-        s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->GetPipelineStatisticsStrings();
-    auto& statisticsResults = s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->GetPipelineStatisticsResults();
+    auto& renderCommandBuffer = s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame];
+    auto& commandPools        = s_RendererStorage->RecordingCommandPools[s_RendererStorage->CurrentFrame];
 
-    for (uint32_t i = 0; i < s_RendererStats.PipelineStatisticsResults.size(); ++i)
+    const size_t jobCount =
+        std::min(commandPools.size(), (drawCount + s_MIN_DRAWS_PER_RECORDING_JOB - 1) / s_MIN_DRAWS_PER_RECORDING_JOB);
+    if (!s_RendererSettings.ParallelRecording || jobCount <= 1)
     {
-        s_RendererStats.PipelineStatisticsResults[i] += statisticsResults[i];
-        result[i] += std::to_string(s_RendererStats.PipelineStatisticsResults[i]);
+        framebuffer->BeginPass(renderCommandBuffer, layer);
+        recordDrawsFunc(renderCommandBuffer, 0, drawCount);
+        framebuffer->EndPass(renderCommandBuffer);
+        return;
     }
 
-    return result;
+    // Each job records its contiguous chunk of draws with its own pool, so draw order is preserved once chunks are executed in order.
+    framebuffer->BeginPass(renderCommandBuffer, layer, glm::uvec4(0), true);
+
+    std::vector<Ref<CommandBuffer>> secondaryCommandBuffers(jobCount);
+    WaitGroup recordingJobs;
+    const size_t drawsPerJob = (drawCount + jobCount - 1) / jobCount;
+    for (size_t i = 0; i < jobCount; ++i)
+    {
+        secondaryCommandBuffers[i] = commandPools[i]->AcquireSecondaryCommandBuffer();
+
+        const size_t first = std::min(i * drawsPerJob, drawCount);
+        const size_t last  = std::min(first + drawsPerJob, drawCount);
+        JobSystem::Submit(
+            recordingJobs, [&framebuffer, &recordDrawsFunc, &commandBuffer = secondaryCommandBuffers[i], first, last]
+            {
+                GNT_PROFILE_SCOPE("RecordDraws");
+
+                framebuffer->BeginSecondaryPass(commandBuffer);
+                recordDrawsFunc(commandBuffer, first, last);
+                framebuffer->EndSecondaryPass(commandBuffer);
+            });
+    }
+    JobSystem::Wait(recordingJobs);
+
+    renderCommandBuffer->ExecuteCommands(secondaryCommandBuffers);
+    framebuffer->EndPass(renderCommandBuffer);
 }
 
-void Renderer::EndScene()
+void Renderer::RecordScene()
 {
-    std::sort(s_RendererStorage->SortedGeometry.begin(), s_RendererStorage->SortedGeometry.end(),
-              [&](const GeometryData& lhs, const GeometryData& rhs)
-              {
-                  const glm::vec3& cameraPos = s_RendererStorage->UBGlobalCamera.Position;
-                  const glm::vec3 lhsPos(lhs.Transform[3]);
-                  const glm::vec3 rhsPos(rhs.Transform[3]);
+    GNT_PROFILE_FUNCTION();
+
+    // Lists are swapped rather than copied, snapshot takes the old ones && clears them once it's written again.
+    auto& snapshot = GetReadSnapshot();
+    std::swap(s_RendererStorage->Geometry, snapshot.Geometry);
+    std::swap(s_RendererStorage->SkinnedMeshes, snapshot.SkinnedMeshes);
+    std::swap(s_RendererStorage->BoneMatrices, snapshot.BoneMatrices);
+    std::swap(s_RendererStorage->PointLights, snapshot.PointLights);
+    std::swap(s_RendererStorage->SpotLights, snapshot.SpotLights);
+    std::swap(s_RendererStorage->ShadowCastingPointLights, snapshot.ShadowCastingPointLights);
+    std::swap(s_RendererStorage->ShadowCastingSpotLights, snapshot.ShadowCastingSpotLights);
+
+    s_RendererStorage->UBGlobalLighting.Gamma = s_RendererSettings.Gamma;
+    for (uint32_t i = 0; i < s_MAX_DIR_LIGHTS; ++i)
+        s_RendererStorage->UBGlobalLighting.DirLights[i] = i < snapshot.DirLightCount ? snapshot.DirLights[i] : DirectionalLight();
+    s_RendererStorage->CurrentDirLightIndex = snapshot.DirLightCount;
+
+    if (!snapshot.bHasScene) return;
+
+    s_RendererStorage->UBGlobalCamera = snapshot.Camera;
+    s_RendererStorage->CameraUniformBuffer[s_RendererStorage->CurrentFrame]->SetData(&s_RendererStorage->UBGlobalCamera, sizeof(UBCamera));
+
+    s_RendererStorage->UBGlobalLightClusters.Projection    = snapshot.Camera.Projection;
+    s_RendererStorage->UBGlobalLightClusters.InvProjection = glm::inverse(snapshot.Camera.Projection);
+    s_RendererStorage->UBGlobalLighting.InvViewProjection  = glm::inverse(snapshot.CameraViewProjection);
+    s_RendererStorage->UBGlobalLightClusters.View          = snapshot.Camera.View;
+    s_RendererStorage->UBGlobalLightClusters.zNear         = snapshot.CameraNear;
+    s_RendererStorage->UBGlobalLightClusters.zFar          = snapshot.CameraFar;
+    Renderer2D::GetStorageData().CameraProjectionMatrix    = snapshot.CameraViewProjection;
 
-                  const float lhsLength = glm::length(cameraPos - lhsPos);
-                  const float rhsLength = glm::length(cameraPos - rhsPos);
+    // Simulation runs on compute queue while the frame is recorded && is waited on GPU only.
+    for (const auto& emitter : snapshot.ParticleEmitters)
+        s_RendererStorage->GPUParticleSystem->SubmitEmitter(emitter);
+    s_RendererStorage->GPUParticleSystem->OnCompute(s_RendererSettings.ParticlePoolSize);
 
-                  return lhsLength > rhsLength;  // Descending order
-              });
+    // Appends skinned instances to geometry, so they're sorted, culled && drawn along with the rest.
+    SkinMeshes();
+    BuildDrawKeys();
 
     // TODO: Compute Culling-Pass
 
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->BeginTimestamp();
-    // ShadowMap-Pass
+    // ShadowMap-Pass (Cascaded)
     {
-        s_RendererStorage->ShadowMapFramebuffer[s_RendererStorage->CurrentFrame]->BeginPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+        GPUMarkerScope marker(s_RendererStorage->QueryRing, s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame],
+                              "DirShadowMap Pass");
+        GNT_PROFILE_SCOPE("DirShadowMap Pass");
 
-        if (Renderer::GetSettings().Shadows.RenderShadows)
-        {
-            constexpr float cameraWidth     = 12.0f;
-            constexpr float zNear           = 0.0000001f;
-            constexpr float zFar            = 1024.0f;
-            const glm::mat4 lightProjection = glm::ortho(-cameraWidth, cameraWidth, -cameraWidth, cameraWidth, zNear, zFar);
+        auto& shadowsData        = s_RendererStorage->MeshShadowsBuffer;
+        auto& shadowCascades     = s_RendererStorage->ShadowCascades[s_RendererStorage->CurrentFrame];
+        const auto& shadowConfig = Renderer::GetSettings().Shadows;
 
-            const glm::mat4 lightView = glm::lookAt(glm::vec3(s_RendererStorage->UBGlobalLighting.DirLights[0].Direction), glm::vec3(0.0f),
-                                                    glm::vec3(0.0f, 1.0f, 0.0f));
+        shadowsData.CascadeCount               = 0;
+        shadowsData.SoftShadows                = shadowConfig.SoftShadows ? 1 : 0;
+        s_RendererStats.ShadowCascadesRendered = 0;
 
-            s_RendererStorage->MeshShadowsBuffer.LightSpaceMatrix = lightProjection * lightView;
+        // First directional light that casts shadows.
+        int32_t shadowLightIndex = -1;
+        for (uint32_t i = 0; i < s_RendererStorage->CurrentDirLightIndex && shadowLightIndex == -1; ++i)
+        {
+            const auto& dirLight = s_RendererStorage->UBGlobalLighting.DirLights[i];
+            if (dirLight.CastShadows && glm::length(dirLight.Direction) > 0.0f) shadowLightIndex = static_cast<int32_t>(i);
+        }
 
-            MatrixPushConstants mpc = {};
-            mpc.mat2                = s_RendererStorage->MeshShadowsBuffer.LightSpaceMatrix;
-            for (auto& geometry : s_RendererStorage->SortedGeometry)
+        if (shadowConfig.RenderShadows && shadowLightIndex != -1)
+        {
+            const int32_t cascadeCount = glm::clamp(shadowConfig.CascadeCount, 1, static_cast<int32_t>(s_MAX_SHADOW_CASCADES));
+            const glm::vec3 lightDirection = glm::normalize(s_RendererStorage->UBGlobalLighting.DirLights[shadowLightIndex].Direction);
+            const uint32_t shadowMapSize   = s_RendererStorage->ShadowMapFramebuffer[s_RendererStorage->CurrentFrame]->GetWidth();
+
+            const float cameraNear = s_RendererStorage->UBGlobalLightClusters.zNear;
+            const float cameraFar  = s_RendererStorage->UBGlobalLightClusters.zFar;
+            const float shadowFar  = glm::clamp(shadowConfig.ShadowDistance, cameraNear, cameraFar);
+            const glm::mat4 invViewProjection =
+                glm::inverse(s_RendererStorage->UBGlobalCamera.Projection * s_RendererStorage->UBGlobalCamera.View);
+
+            // Any change here invalidates all cached cascades.
+            size_t settingsHash = 0;
+            HashCombine(settingsHash, lightDirection.x);
+            HashCombine(settingsHash, lightDirection.y);
+            HashCombine(settingsHash, lightDirection.z);
+            HashCombine(settingsHash, cascadeCount);
+            HashCombine(settingsHash, shadowConfig.CascadeSplitLambda);
+            HashCombine(settingsHash, shadowFar);
+
+            std::vector<GeometryData*> shadowCasters;
+            shadowCasters.reserve(s_RendererStorage->Geometry.size());
+
+            float sliceNear = cameraNear;
+            for (int32_t i = 0; i < cascadeCount; ++i)
             {
-                mpc.mat1 = geometry.Transform;
-                SubmitMesh(s_RendererStorage->ShadowMapPipeline, geometry.VertexBuffer, geometry.IndexBuffer, nullptr, &mpc);
+                // Practical split scheme: blend of logarithmic and uniform splits.
+                const float p            = static_cast<float>(i + 1) / static_cast<float>(cascadeCount);
+                const float logSplit     = cameraNear * glm::pow(shadowFar / cameraNear, p);
+                const float uniformSplit = cameraNear + (shadowFar - cameraNear) * p;
+                const float sliceFar     = Math::Lerp(uniformSplit, logSplit, shadowConfig.CascadeSplitLambda);
+
+                const glm::vec4 sliceSphere = GetFrustumSliceBoundingSphere(invViewProjection, cameraNear, cameraFar, sliceNear, sliceFar);
+                auto& cascade               = shadowCascades[i];
+
+                // The first cascade is always re-rendered, others can reuse their contents while they still cover the slice.
+                const bool bCanReuse =
+                    i > 0 && cascade.bIsValid && cascade.BoundingSphere.w == sliceSphere.w &&
+                    glm::distance(glm::vec3(cascade.BoundingSphere), glm::vec3(sliceSphere)) <
+                        sliceSphere.w * s_SHADOW_CASCADE_REUSE_DISTANCE &&
+                    s_RendererStorage->FrameNumber - cascade.LastUpdateFrame < static_cast<uint64_t>(shadowConfig.FarCascadeUpdateInterval);
+
+                bool bNeedsUpdate = true;
+                if (bCanReuse)
+                {
+                    const size_t casterHash =
+                        CullShadowCasters(cascade.LightSpaceMatrix, cascade.BoundingSphere.w, settingsHash, shadowCasters);
+                    bNeedsUpdate            = casterHash != cascade.CasterHash;
+                }
+
+                if (bNeedsUpdate)
+                {
+                    cascade.LightSpaceMatrix = GetCascadeLightSpaceMatrix(sliceSphere, lightDirection, shadowMapSize);
+                    cascade.BoundingSphere   = sliceSphere;
+                    cascade.CasterHash       = CullShadowCasters(cascade.LightSpaceMatrix, sliceSphere.w, settingsHash, shadowCasters);
+                    cascade.LastUpdateFrame  = s_RendererStorage->FrameNumber;
+                    cascade.bIsValid         = true;
+
+                    RecordPassInParallel(s_RendererStorage->ShadowMapFramebuffer[s_RendererStorage->CurrentFrame], i, shadowCasters.size(),
+                                         [&](const Ref<CommandBuffer>& commandBuffer, const size_t first, const size_t last)
+                                         {
+                                             MatrixPushConstants mpc = {};
+                                             mpc.mat2                = cascade.LightSpaceMatrix;
+                                             for (size_t k = first; k < last; ++k)
+                                             {
+                                                 auto geometry = shadowCasters[k];
+                                                 mpc.mat1      = geometry->Transform;
+                                                 SubmitMesh(commandBuffer, s_RendererStorage->ShadowMapPipeline, geometry->VertexBuffer,
+                                                            geometry->IndexBuffer, nullptr, &mpc, geometry->VertexOffset);
+                                             }
+                                         });
+                    ++s_RendererStats.ShadowCascadesRendered;
+                }
+
+                shadowsData.LightSpaceMatrices[i] = cascade.LightSpaceMatrix;
+                shadowsData.CascadeSplits[i]      = sliceFar;
+                sliceNear                         = sliceFar;
             }
+
+            shadowsData.CascadeCount = static_cast<uint32_t>(cascadeCount);
+            shadowsData.LightIndex   = static_cast<uint32_t>(shadowLightIndex);
         }
-        s_RendererStorage->ShadowMapFramebuffer[s_RendererStorage->CurrentFrame]->EndPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+        else
+        {
+            for (auto& cascade : shadowCascades)
+                cascade.bIsValid = false;
+        }
+
+        s_RendererStorage->ShadowsUniformBuffer[s_RendererStorage->CurrentFrame]->SetData(&shadowsData, sizeof(UBShadows));
+    }
+
+    // Point && spot light shadows
+    {
+        GPUMarkerScope marker(s_RendererStorage->QueryRing, s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame],
+                              "LocalShadows Pass");
+
+        UpdateLocalShadowAtlas();
     }
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->EndTimestamp();
 
     // GPass
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->BeginTimestamp();
     {
-        s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->BeginPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+        GPUMarkerScope marker(s_RendererStorage->QueryRing, s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame],
+                              "GBuffer Pass");
+        GNT_PROFILE_SCOPE("GBuffer Pass");
 
-        for (auto& geometry : s_RendererStorage->SortedGeometry)
-        {
-            MatrixPushConstants mpc = {};
-            mpc.mat1                = geometry.Transform;
-            mpc.mat2                = glm::mat4(glm::transpose(glm::inverse(glm::mat3(geometry.Transform))));
+        // Materials update their GPU data, so it stays out of recording jobs.
+        for (auto& geometry : s_RendererStorage->Geometry)
             geometry.Material->Update();  // Is it useless?
 
+        RecordPassInParallel(s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame], 0,
+                             s_RendererStorage->DrawKeys.size(),
+                             [](const Ref<CommandBuffer>& commandBuffer, const size_t first, const size_t last)
+                             {
+                                 for (size_t i = first; i < last; ++i)
+                                 {
+                                     auto& geometry          = s_RendererStorage->Geometry[s_RendererStorage->DrawKeys[i].GeometryIndex];
+                                     MatrixPushConstants mpc = {};
+                                     mpc.mat1                = geometry.Transform;
+                                     mpc.mat2                = glm::mat4(glm::transpose(glm::inverse(glm::mat3(geometry.Transform))));
+
 #if MESH_SHADING_TEST
-            SubmitMeshShading();
+                                     SubmitMeshShading();
 #else
-            SubmitMesh(s_RendererStorage->GeometryPipeline, geometry.VertexBuffer, geometry.IndexBuffer, geometry.Material, &mpc);
+                                     SubmitMesh(commandBuffer, s_RendererStorage->GeometryPipeline, geometry.VertexBuffer,
+                                                geometry.IndexBuffer, geometry.Material, &mpc, geometry.VertexOffset);
 #endif
-        }
-
-        s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->EndPass(
-            s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]);
+                                 }
+                             });
     }
-    s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame]->EndTimestamp();
 
     /*  // PBR-ForwardPass
     {
         BeginRenderPass(s_RendererStorage->PBRFramebuffer, glm::vec4(0.5f, 0.0f, 0.0f, 1.0f));
 
-        for (auto& geometry : s_RendererStorage->SortedGeometry)
+        for (auto& geometry : s_RendererStorage->Geometry)
         {
             MeshPushConstants pushConstants = {};
             pushConstants.TransformMatrix   = geometry.Transform;
@@ -821,81 +1968,129 @@ void Renderer::EndScene()
     }*/
 }
 
-void Renderer::AddPointLight(const glm::vec3& position, const glm::vec3& color, const float intensity, int32_t active)
+// Distance at which light's radiance falls below s_LIGHT_ATTENUATION_THRESHOLD, used to bin lights into clusters.
+static float GetLightRadius(const glm::vec3& color, const float intensity)
 {
-    if (s_RendererStorage->CurrentPointLightIndex >= s_MAX_POINT_LIGHTS) return;
+    const float maxRadiance = glm::max(glm::max(color.r, color.g), color.b) * intensity;
+    return glm::sqrt(glm::max(maxRadiance, 0.0f) / s_LIGHT_ATTENUATION_THRESHOLD);
+}
 
-    s_RendererStorage->UBGlobalLighting.PointLights[s_RendererStorage->CurrentPointLightIndex].Position  = glm::vec4(position, 0.0f);
-    s_RendererStorage->UBGlobalLighting.PointLights[s_RendererStorage->CurrentPointLightIndex].Color     = glm::vec4(color, 0.0f);
-    s_RendererStorage->UBGlobalLighting.PointLights[s_RendererStorage->CurrentPointLightIndex].Intensity = intensity;
+void Renderer::AddPointLight(const glm::vec3& position, const glm::vec3& color, const float intensity, int32_t active,
+                             const bool castShadows)
+{
+    if (!active) return;
 
-    const bool bIsActive = color.x > 0.0f || color.y > 0.0f || color.z > 0.0f;
-    s_RendererStorage->UBGlobalLighting.PointLights[s_RendererStorage->CurrentPointLightIndex].IsActive = active;
-    ++s_RendererStorage->CurrentPointLightIndex;
+    auto& snapshot = GetWriteSnapshot();
+    if (castShadows) snapshot.ShadowCastingPointLights.push_back(static_cast<uint32_t>(snapshot.PointLights.size()));
+
+    auto& pointLight     = snapshot.PointLights.emplace_back();
+    pointLight.Position  = glm::vec4(position, GetLightRadius(color, intensity));
+    pointLight.Color     = glm::vec4(color, 0.0f);
+    pointLight.Intensity = intensity;
+    pointLight.IsActive  = active;
 }
 
 void Renderer::AddDirectionalLight(const glm::vec3& color, const glm::vec3& direction, int32_t castShadows, float intensity)
 {
-    s_RendererStorage->UBGlobalLighting.Gamma = s_RendererSettings.Gamma;
-
-    if (s_RendererStorage->CurrentDirLightIndex >= s_MAX_DIR_LIGHTS) return;
-
-    s_RendererStorage->UBGlobalLighting.DirLights[s_RendererStorage->CurrentDirLightIndex].Color       = glm::vec4(color, 0.0f);
-    s_RendererStorage->UBGlobalLighting.DirLights[s_RendererStorage->CurrentDirLightIndex].Direction   = glm::vec4(direction, 0.0f);
-    s_RendererStorage->UBGlobalLighting.DirLights[s_RendererStorage->CurrentDirLightIndex].CastShadows = castShadows;
-    s_RendererStorage->UBGlobalLighting.DirLights[s_RendererStorage->CurrentDirLightIndex].Intensity   = intensity;
-    ++s_RendererStorage->CurrentDirLightIndex;
+    auto& snapshot = GetWriteSnapshot();
+    if (snapshot.DirLightCount >= s_MAX_DIR_LIGHTS) return;
+
+    auto& dirLight       = snapshot.DirLights[snapshot.DirLightCount++];
+    dirLight.Color       = glm::vec4(color, 0.0f);
+    dirLight.Direction   = glm::vec4(direction, 0.0f);
+    dirLight.CastShadows = castShadows;
+    dirLight.Intensity   = intensity;
 }
 
 void Renderer::AddSpotLight(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color, const float intensity,
-                            const int32_t active, const float cutOff, const float outerCutOff)
+                            const int32_t active, const float cutOff, const float outerCutOff, const bool castShadows)
 {
-    if (s_RendererStorage->CurrentSpotLightIndex >= s_MAX_SPOT_LIGHTS) return;
-
-    s_RendererStorage->UBGlobalLighting.SpotLights[s_RendererStorage->CurrentSpotLightIndex].Position    = glm::vec4(position, 0.0f);
-    s_RendererStorage->UBGlobalLighting.SpotLights[s_RendererStorage->CurrentSpotLightIndex].Color       = glm::vec4(color, 0.0f);
-    s_RendererStorage->UBGlobalLighting.SpotLights[s_RendererStorage->CurrentSpotLightIndex].Direction   = glm::vec4(direction, 0.0f);
-    s_RendererStorage->UBGlobalLighting.SpotLights[s_RendererStorage->CurrentSpotLightIndex].CutOff      = cutOff;
-    s_RendererStorage->UBGlobalLighting.SpotLights[s_RendererStorage->CurrentSpotLightIndex].OuterCutOff = outerCutOff;
-
-    s_RendererStorage->UBGlobalLighting.SpotLights[s_RendererStorage->CurrentSpotLightIndex].Intensity = intensity;
-    s_RendererStorage->UBGlobalLighting.SpotLights[s_RendererStorage->CurrentSpotLightIndex].IsActive  = active;
+    if (!active) return;
+
+    auto& snapshot = GetWriteSnapshot();
+    if (castShadows) snapshot.ShadowCastingSpotLights.push_back(static_cast<uint32_t>(snapshot.SpotLights.size()));
+
+    auto& spotLight       = snapshot.SpotLights.emplace_back();
+    spotLight.Position    = glm::vec4(position, GetLightRadius(color, intensity));
+    spotLight.Color       = glm::vec4(color, 0.0f);
+    spotLight.Direction   = direction;
+    spotLight.CutOff      = cutOff;
+    spotLight.OuterCutOff = outerCutOff;
+    spotLight.Intensity   = intensity;
+    spotLight.IsActive    = active;
+}
 
-    ++s_RendererStorage->CurrentSpotLightIndex;
+void Renderer::SubmitParticleEmitter(const ParticleEmitter& emitter)
+{
+    GetWriteSnapshot().ParticleEmitters.push_back(emitter);
 }
 
 void Renderer::SubmitMesh(const Ref<Mesh>& mesh, const glm::mat4& transform)
 {
+    // Buffers are still being streamed.
+    if (!mesh->IsLoaded()) return;
+
+    const float maxScale = GetMaxScale(transform);
+
+    auto& geometry = GetWriteSnapshot().Geometry;
     for (uint32_t i = 0; i < mesh->GetSubmeshCount(); ++i)
     {
+        const glm::vec4& localSphere = mesh->GetBoundingSphere(i);
+        const glm::vec4 worldSphere  = glm::vec4(glm::vec3(transform * glm::vec4(glm::vec3(localSphere), 1.0f)), localSphere.w * maxScale);
+
 #if MESH_SHADING_TEST
-        s_RendererStorage->SortedGeometry.emplace_back(mesh->GetMaterial(i), mesh->GetVertexBuffers()[i], mesh->GetIndexBuffers()[i],
-                                                       mesh->GetMeshletBuffers()[i], mesh->GetMeshletSize() transform);
+        geometry.emplace_back(mesh->GetMaterial(i), mesh->GetVertexBuffers()[i], mesh->GetIndexBuffers()[i], mesh->GetMeshletBuffers()[i],
+                              mesh->GetMeshletSize() transform, worldSphere);
 #else
-        s_RendererStorage->SortedGeometry.emplace_back(mesh->GetMaterial(i), mesh->GetVertexBuffers()[i], mesh->GetIndexBuffers()[i],
-                                                       transform);
+        geometry.emplace_back(mesh->GetMaterial(i), mesh->GetVertexBuffers()[i], mesh->GetIndexBuffers()[i], transform, worldSphere);
 #endif
     }
 }
 
+void Renderer::SubmitSkinnedMesh(const Ref<Mesh>& mesh, const glm::mat4& transform, const std::vector<glm::mat4>& boneMatrices)
+{
+    if (!mesh->IsLoaded()) return;
+
+    // Without a pose there's nothing to skin, bind pose vertex buffers are drawn instead.
+    if (!mesh->IsAnimated() || boneMatrices.empty())
+    {
+        SubmitMesh(mesh, transform);
+        return;
+    }
+
+    auto& snapshot = GetWriteSnapshot();
+    snapshot.SkinnedMeshes.push_back({mesh, transform, static_cast<uint32_t>(snapshot.BoneMatrices.size())});
+    snapshot.BoneMatrices.insert(snapshot.BoneMatrices.end(), boneMatrices.begin(), boneMatrices.end());
+}
+
 std::vector<RendererOutput> Renderer::GetRendererOutput()
 {
     std::vector<RendererOutput> rendererOutput;
 
     rendererOutput.emplace_back(s_RendererStorage->ShadowMapFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment,
-                                "ShadowMap");
+                                "ShadowMap (Cascade 0)");
+    rendererOutput.emplace_back(
+        s_RendererStorage->LocalShadowAtlasFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment,
+        "LocalShadowAtlas");
     rendererOutput.emplace_back(s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment,
-                                "Position");
+                                "Albedo && Metallic");
     rendererOutput.emplace_back(s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[1].Attachment,
-                                "Normal");
+                                "Octahedral Normal && Roughness");
     rendererOutput.emplace_back(s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[2].Attachment,
-                                "Albedo");
+                                "Material AO");
     rendererOutput.emplace_back(s_RendererStorage->GeometryFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[3].Attachment,
                                 "Depth");
-    rendererOutput.emplace_back(s_RendererStorage->SSAOFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment,
-                                "SSAO");
-    rendererOutput.emplace_back(s_RendererStorage->SSAOBlurFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment,
-                                "SSAO-Blur");
+
+    // Transient images of culled passes have no memory, with aliasing enabled others may hold contents of images sharing their memory.
+    const auto addTransientOutput = [&](const Ref<Image>& image, const std::string& name)
+    {
+        if (s_RendererStorage->DeferredRenderGraph->IsAllocated(image)) rendererOutput.emplace_back(image, name);
+    };
+    addTransientOutput(s_RendererStorage->SSAOFramebuffer[0]->GetAttachments()[0].Attachment, "SSAO");
+    addTransientOutput(s_RendererStorage->SSAOBlurFramebuffer[0]->GetAttachments()[0].Attachment, "SSAO-Blur");
+    addTransientOutput(s_RendererStorage->SSAOLowResImage, "SSAO (Compute, Low Resolution)");
+    addTransientOutput(s_RendererStorage->SSAOComputeImage, "SSAO (Compute, Upsampled)");
+
     rendererOutput.emplace_back(s_RendererStorage->SSAONoiseTexture->GetImage(), "SSAO-Noise");
     rendererOutput.emplace_back(
         s_RendererStorage->ChromaticAberrationFramebuffer[s_RendererStorage->CurrentFrame]->GetAttachments()[0].Attachment,
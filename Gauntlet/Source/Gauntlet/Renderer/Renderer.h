@@ -7,12 +7,17 @@
 #include "Buffer.h"
 #include "CoreRendererTypes.h"
 #include "GraphicsContext.h"
+#include "GPUQueryRing.h"
+#include "ParticleSystem.h"
 
 namespace Gauntlet
 {
 
 #define GRAPHICS_GUARD_LOCK std::unique_lock<std::mutex> Lock(Renderer::GetResourceAccessMutex())
 
+// Held from staging write until the copy is submitted(or the heap is resized), streaming threads && main thread share the upload heap.
+#define UPLOAD_HEAP_GUARD_LOCK std::unique_lock<std::mutex> UploadHeapLock(Renderer::GetUploadHeapMutex())
+
 class Mesh;
 class Camera;
 class Image;
@@ -24,7 +29,9 @@ class IndexBuffer;
 class Framebuffer;
 class Pipeline;
 class CommandBuffer;
+class CommandPool;
 class ParticleSystem;
+class RenderGraph;
 
 struct RendererOutput
 {
@@ -41,13 +48,23 @@ class Renderer : private Uncopyable, private Unmovable
     static void Begin();
     static void Flush();
 
+    // Scene submitted between these is captured into a snapshot, nothing is recorded until it's swapped && RecordScene() is called.
     static void BeginScene(const Camera& camera);
     static void EndScene();
 
-    FORCEINLINE static void SubmitParticleSystem(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, Ref<StorageBuffer>& ssbo,
-                                                 uint32_t particleCount, void* pushConstants = nullptr)
+    // Called while render thread is idle, so simulation can write the next snapshot while the previous one is being recorded.
+    static void SwapSnapshots();
+    static void RecordScene();
+
+    // Statistics are read by layers while render thread records, so they're published from main thread once it's idle.
+    static void CollectPassStatistics();
+
+    // Particle count lives on GPU, so the draw is sourced from VkDrawIndirectCommand-like args at drawArgsOffset.
+    FORCEINLINE static void SubmitParticleSystem(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline,
+                                                 const Ref<StorageBuffer>& drawArgsBuffer, const uint64_t drawArgsOffset,
+                                                 void* pushConstants = nullptr)
     {
-        s_Renderer->SubmitParticleSystemImpl(commandBuffer, pipeline, ssbo, particleCount, pushConstants);
+        s_Renderer->SubmitParticleSystemImpl(commandBuffer, pipeline, drawArgsBuffer, drawArgsOffset, pushConstants);
     }
 
 #if MESH_SHADING_TEST
@@ -58,18 +75,35 @@ class Renderer : private Uncopyable, private Unmovable
     }
 #endif
 
+    // Vertex offset is added to every index, so geometry packed into a shared vertex buffer(e.g. skinned) is drawn with its own indices.
     FORCEINLINE static void SubmitMesh(Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer, Ref<IndexBuffer>& indexBuffer,
-                                       Ref<Material> material, void* pushConstants = nullptr)
+                                       Ref<Material> material, void* pushConstants = nullptr, const int32_t vertexOffset = 0)
     {
-        s_Renderer->SubmitMeshImpl(pipeline, vertexBuffer, indexBuffer, material, pushConstants);
+        s_Renderer->SubmitMeshImpl(s_RendererStorage->RenderCommandBuffer[s_RendererStorage->CurrentFrame], pipeline, vertexBuffer,
+                                   indexBuffer, material, pushConstants, vertexOffset);
     }
 
-    FORCEINLINE static void Dispatch(Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, void* pushConstants = nullptr,
+    // Thread-safe as long as each command buffer is recorded by a single thread.
+    FORCEINLINE static void SubmitMesh(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer,
+                                       Ref<IndexBuffer>& indexBuffer, Ref<Material> material, void* pushConstants = nullptr,
+                                       const int32_t vertexOffset = 0)
+    {
+        s_Renderer->SubmitMeshImpl(commandBuffer, pipeline, vertexBuffer, indexBuffer, material, pushConstants, vertexOffset);
+    }
+
+    FORCEINLINE static void Dispatch(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, void* pushConstants = nullptr,
                                      const uint32_t groupCountX = 1, const uint32_t groupCountY = 1, const uint32_t groupCountZ = 1)
     {
         s_Renderer->DispatchImpl(commandBuffer, pipeline, pushConstants, groupCountX, groupCountY, groupCountZ);
     }
 
+    FORCEINLINE static void DispatchIndirect(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline,
+                                             const Ref<StorageBuffer>& dispatchArgsBuffer, const uint64_t dispatchArgsOffset,
+                                             void* pushConstants = nullptr)
+    {
+        s_Renderer->DispatchIndirectImpl(commandBuffer, pipeline, dispatchArgsBuffer, dispatchArgsOffset, pushConstants);
+    }
+
     FORCEINLINE static void SubmitFullscreenQuad(Ref<Pipeline>& pipeline, void* pushConstants = nullptr)
     {
         s_Renderer->SubmitFullscreenQuadImpl(pipeline, pushConstants);
@@ -82,25 +116,33 @@ class Renderer : private Uncopyable, private Unmovable
     }
 
     static void SubmitMesh(const Ref<Mesh>& mesh, const glm::mat4& transform = glm::mat4(1.0f));
-    static void AddPointLight(const glm::vec3& position, const glm::vec3& color, const float intensity, int32_t active);
+
+    // Bone matrices are copied into the snapshot, instance is skinned on GPU before shadow && GBuffer passes of its frame.
+    static void SubmitSkinnedMesh(const Ref<Mesh>& mesh, const glm::mat4& transform, const std::vector<glm::mat4>& boneMatrices);
+    static void SubmitParticleEmitter(const ParticleEmitter& emitter);
+    static void AddPointLight(const glm::vec3& position, const glm::vec3& color, const float intensity, int32_t active,
+                              const bool castShadows = false);
 
     static void AddDirectionalLight(const glm::vec3& color, const glm::vec3& direction, int32_t castShadows, float intensity);
 
     static void AddSpotLight(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color, const float intensity,
-                             const int32_t active, const float cutOff, const float outerCutOff);
+                             const int32_t active, const float cutOff, const float outerCutOff, const bool castShadows = false);
 
+    // Applied along with the snapshot, so framebuffers && camera of the frame being recorded always match.
     FORCEINLINE static void ResizeFramebuffers(uint32_t width, uint32_t height)
     {
-        s_RendererStorage->bFramebuffersNeedResize = true;
-        s_RendererStorage->NewFramebufferSize      = {width, height};
+        auto& snapshot                   = GetWriteSnapshot();
+        snapshot.bFramebuffersNeedResize = true;
+        snapshot.NewFramebufferSize      = {width, height};
     }
 
     FORCEINLINE static auto& GetStats() { return s_RendererStats; }
     FORCEINLINE static auto& GetSettings() { return s_RendererSettings; }
-    static const std::vector<std::string> GetPipelineStatistics();
+    static const std::vector<std::string>& GetPipelineStatisticsNames();
 
     static const Ref<Image>& GetFinalImage();
     FORCEINLINE static std::mutex& GetResourceAccessMutex() { return s_ResourceAccessMutex; }
+    FORCEINLINE static std::mutex& GetUploadHeapMutex() { return s_UploadHeapMutex; }
 
     static std::vector<RendererOutput> GetRendererOutput();
     FORCEINLINE static const auto& GetStorageData() { return *s_RendererStorage; }
@@ -108,6 +150,7 @@ class Renderer : private Uncopyable, private Unmovable
   private:
     static Renderer* s_Renderer;
     static std::mutex s_ResourceAccessMutex;
+    static std::mutex s_UploadHeapMutex;  // Always taken before resource access mutex.
 
     struct GeometryData
     {
@@ -121,9 +164,74 @@ class Renderer : private Uncopyable, private Unmovable
 #endif
 
         glm::mat4 Transform;
+        glm::vec4 BoundingSphere;  // World space, xyz - center, w - radius
+
+        int32_t VertexOffset = 0;      // Into shared skinned vertex buffer.
+        bool bIsSkinned      = false;  // Vertices change every frame, so cached shadows can't rely on its transform only.
     };
 
-    static void CollectPassStatistics();
+    struct SkinnedMeshData
+    {
+        Ref<Gauntlet::Mesh> Mesh;
+        glm::mat4 Transform = glm::mat4(1.0f);
+        uint32_t BoneOffset = 0;  // First matrix of its palette in snapshot's bone matrices.
+    };
+
+    enum class EDrawPass : uint8_t
+    {
+        DRAW_PASS_OPAQUE = 0,
+        DRAW_PASS_TRANSPARENT,
+    };
+
+    // Keys are sorted instead of geometry, so its payload with refcounted handles isn't moved around.
+    struct DrawKey
+    {
+        uint64_t Key           = 0;
+        uint32_t GeometryIndex = 0;
+    };
+
+    // Everything scene recording needs, lists are swapped into renderer's storage when it's recorded.
+    struct SceneSnapshot
+    {
+        UBCamera Camera                = {};
+        glm::mat4 CameraViewProjection = glm::mat4(1.0f);
+        float CameraNear               = 0.0f;
+        float CameraFar                = 0.0f;
+        bool bHasScene                 = false;  // Set by EndScene(), passes aren't recorded without it.
+
+        bool bFramebuffersNeedResize  = false;
+        glm::uvec2 NewFramebufferSize = {1280, 720};
+
+        std::vector<GeometryData> Geometry;
+        std::vector<SkinnedMeshData> SkinnedMeshes;
+        std::vector<glm::mat4> BoneMatrices;  // Copied, animators keep advancing while the snapshot is recorded.
+        std::vector<PointLight> PointLights;
+        std::vector<SpotLight> SpotLights;
+        std::vector<uint32_t> ShadowCastingPointLights;
+        std::vector<uint32_t> ShadowCastingSpotLights;
+        std::array<DirectionalLight, s_MAX_DIR_LIGHTS> DirLights;
+        uint32_t DirLightCount = 0;
+        std::vector<ParticleEmitter> ParticleEmitters;
+    };
+
+    static SceneSnapshot& GetWriteSnapshot() { return s_RendererStorage->SceneSnapshots[s_RendererStorage->SnapshotWriteIndex]; }
+    static SceneSnapshot& GetReadSnapshot() { return s_RendererStorage->SceneSnapshots[s_RendererStorage->SnapshotWriteIndex ^ 1]; }
+    static void ClearSnapshot(SceneSnapshot& snapshot);
+
+    // Records draws [first, last) of a pass into the given command buffer.
+    using RecordDrawsFunc = std::function<void(const Ref<CommandBuffer>& commandBuffer, const size_t first, const size_t last)>;
+    static void RecordPassInParallel(const Ref<Framebuffer>& framebuffer, const uint32_t layer, const size_t drawCount,
+                                     const RecordDrawsFunc& recordDrawsFunc);
+    static size_t CullShadowCasters(const glm::mat4& lightSpaceMatrix, const float cascadeRadius, const size_t settingsHash,
+                                    std::vector<GeometryData*>& outShadowCasters);
+    static void UpdateLocalShadowAtlas();
+    static void SkinMeshes();
+    static void InvalidateSSAOImages();
+
+    static uint64_t MakeDrawKey(const EDrawPass pass, const uint32_t pipelineID, const uint32_t materialID, const uint32_t meshID,
+                                const float depth);
+    static void BuildDrawKeys();
+    static void RadixSortDrawKeys(std::vector<DrawKey>& drawKeys, std::vector<DrawKey>& scratch);
 
   protected:
     struct RendererSettings
@@ -132,14 +240,32 @@ class Renderer : private Uncopyable, private Unmovable
         float Exposure               = 1.0f;
         bool ShowWireframes          = false;
         bool VSync                   = false;
+        EPresentMode PresentMode     = EPresentMode::PRESENT_MODE_MAILBOX;
+        uint32_t FramesInFlight      = 2;      // [1, MAX_FRAMES_IN_FLIGHT], applied at the beginning of the next frame.
+        bool LowLatency              = false;  // Waits for the last frame to be presented && sleeps before input is sampled.
         bool ChromaticAberrationView = false;
-        uint32_t ParticleCount       = 500;
+        bool AliasTransientImages    = true;  // Transient images share memory, so only their final user's contents can be inspected.
+        uint32_t ParticlePoolSize    = 1 << 18;  // Particles shared by all emitters, spawns beyond it are dropped.
+        bool SortParticles           = true;     // Back to front, so alpha blended particles compose in order.
+        bool ParallelRecording       = true;     // GBuffer && shadow draws are recorded into secondary command buffers on job system.
+        bool RenderThread            = true;     // Frame is recorded on render thread, while the next one is simulated && extracted.
+        bool GPUProfiling            = true;     // GPU markers && pipeline statistics, results are read back without waiting.
 
         struct
         {
             bool RenderShadows           = true;
             bool SoftShadows             = false;
             uint16_t CurrentShadowPreset = 0;
+
+            int32_t CascadeCount     = s_MAX_SHADOW_CASCADES;
+            float CascadeSplitLambda = 0.9f;    // Blend between logarithmic(1.0) and uniform(0.0) splits.
+            float ShadowDistance     = 150.0f;  // Shadows are clipped beyond this view distance.
+            // Cascades except the first one are re-rendered every N frames, or when their casters/light change.
+            int32_t FarCascadeUpdateInterval = 4;
+
+            bool RenderLocalShadows = true;
+            // Max point light faces && spot lights re-rendered into the atlas per frame, the rest keep their old contents.
+            int32_t LocalShadowUpdateBudget = 8;
             // "Low" - "Resolution", since shadow images can have OxO resolution.
             const std::vector<std::pair<std::string, uint16_t>> ShadowPresets = {
                 {"Low", 1024},  //
@@ -155,6 +281,14 @@ class Renderer : private Uncopyable, private Unmovable
             float Radius      = 0.5f;
             float Bias        = 0.025f;
             int32_t Magnitude = 1;
+
+            // "Name" - "Resolution divider", full resolution uses fragment path, others run in compute with bilateral upsample.
+            uint16_t CurrentQualityPreset = 1;
+            const std::vector<std::pair<std::string, uint16_t>> QualityPresets = {
+                {"Full (Fragment)", 1},  //
+                {"Half (Compute)", 2},
+                {"Quarter (Compute)", 4},
+            };
         } AO;
     } static s_RendererSettings;
 
@@ -167,9 +301,14 @@ class Renderer : private Uncopyable, private Unmovable
         std::atomic<size_t> AllocatedBuffers = 0;
         std::atomic<size_t> AllocatedImages  = 0;
 
+        // Render graph transient images, saved is what dedicated memory for every declared transient image would take on top.
+        size_t TransientMemoryAllocated = 0;
+        size_t TransientMemorySaved     = 0;
+
         std::atomic<size_t> DrawCalls = 0;
         std::atomic<size_t> QuadCount = 0;
         uint32_t SamplerCount         = 0;
+        size_t FrameDrawCalls         = 0;  // DrawCalls of the last flushed frame, DrawCalls itself is reset on Begin().
 
         std::atomic<uint32_t> AllocatedDescriptorSets = 0;
         uint16_t FPS                                  = 0;
@@ -178,27 +317,43 @@ class Renderer : private Uncopyable, private Unmovable
         float GPUWaitTime = 0.0f;
         float PresentTime = 0.0f;
         float FrameTime   = 0.0f;
+        float LatencyWait = 0.0f;  // Present wait && sleep of low latency mode.
 
         std::string RenderingDevice                   = "None";
         static constexpr size_t s_MaxUploadHeapSizeMB = 4 * 1024 * 1024;
         size_t UploadHeapCapacity                     = 0;
 
-        std::vector<size_t> PipelineStatisticsResults;
-        std::vector<std::string> PassStatistsics;
+        uint32_t ShadowCascadesRendered   = 0;
+        uint32_t LocalShadowTilesRendered = 0;
+        uint32_t LocalShadowTilesVisible  = 0;
+
+        uint32_t RenderGraphPassesExecuted = 0;
+        uint32_t RenderGraphPassCount      = 0;
+        uint32_t ParticleEmitters          = 0;
+        uint32_t SkinnedVertices           = 0;
+
+        // Renderer's markers followed by compute queue ones, frames in flight late.
+        std::vector<GPUMarker> GPUMarkers;
+        double GPUMarkersSubmitTime = 0.0;  // (s) Submit time of renderer's markers frame, changes only when new ones are read back.
+        std::vector<uint64_t> PipelineStatisticsResults;  // In order of GetPipelineStatisticsNames().
     } static s_RendererStats;
 
     struct RendererStorage
     {
-        // Viewports
-        bool bFramebuffersNeedResize  = {false};
-        glm::uvec2 NewFramebufferSize = {1280, 720};
+        // Simulation writes snapshot at SnapshotWriteIndex, the other one belongs to render thread.
+        std::array<SceneSnapshot, 2> SceneSnapshots;
+        uint32_t SnapshotWriteIndex = 0;
+
         RenderCommandBufferPerFrame RenderCommandBuffer;
 
+        // Pool per recording job && frame in flight, secondary command buffers are reused once frame's pools are reset.
+        std::array<std::vector<Ref<CommandPool>>, MAX_FRAMES_IN_FLIGHT> RecordingCommandPools;
+
         Ref<ParticleSystem> GPUParticleSystem;
+        Ref<GPUQueryRing> QueryRing;
 
         // Defaults
         BufferLayout StaticMeshVertexBufferLayout;  // can remove?
-        BufferLayout AnimatedVertexBufferLayout;    // can remove?
         Ref<Texture2D> WhiteTexture = nullptr;
 
         // Clear-Pass
@@ -220,7 +375,39 @@ class Renderer : private Uncopyable, private Unmovable
         UniformBufferPerFrame ShadowsUniformBuffer;
         UBShadows MeshShadowsBuffer;
 
-        // SSAO
+        // What each shadow map layer currently holds, since far cascades are cached across frames.
+        struct ShadowCascade
+        {
+            glm::mat4 LightSpaceMatrix = glm::mat4(1.0f);
+            glm::vec4 BoundingSphere   = glm::vec4(0.0f);  // Frustum slice bounds at the time cascade was rendered.
+            size_t CasterHash          = 0;
+            uint64_t LastUpdateFrame   = 0;
+            bool bIsValid              = false;
+        };
+        std::array<std::array<ShadowCascade, s_MAX_SHADOW_CASCADES>, MAX_FRAMES_IN_FLIGHT> ShadowCascades;
+
+        // Point && spot light shadow atlas, one per frame in flight, since the next frame's tiles are rendered while lighting of the
+        // previous one may still sample its atlas.
+        FramebufferPerFrame LocalShadowAtlasFramebuffer;
+        Ref<Pipeline> LocalShadowAtlasPipeline = nullptr;
+        StorageBufferPerFrame LocalShadowsStorageBuffer;
+        std::vector<LocalLightShadow> LocalShadows;
+        std::vector<uint32_t> ShadowCastingPointLights;
+        std::vector<uint32_t> ShadowCastingSpotLights;
+
+        // What each tile of frame's atlas currently holds, keyed by tile rect.
+        struct LocalShadowTile
+        {
+            uint64_t LightID         = 0;  // Light type, submission index && cube face.
+            size_t ContentHash       = 0;
+            glm::mat4 ViewProjection = glm::mat4(1.0f);
+        };
+        std::array<std::unordered_map<uint64_t, LocalShadowTile>, MAX_FRAMES_IN_FLIGHT> LocalShadowTiles;
+
+        // Post-GBuffer passes(SSAO, light culling, lighting, post-processing), rebuilt every frame in Flush().
+        Ref<RenderGraph> DeferredRenderGraph = nullptr;
+
+        // SSAO, render graph transient targets shared by all frames, graph makes each frame's first use wait for the previous one.
         FramebufferPerFrame SSAOFramebuffer;
         Ref<Pipeline> SSAOPipeline = nullptr;
 
@@ -233,13 +420,34 @@ class Renderer : private Uncopyable, private Unmovable
         Ref<Pipeline> SSAOBlurPipeline  = nullptr;
         Ref<Texture2D> SSAONoiseTexture = nullptr;
 
-        // Animation
-        Ref<Pipeline> AnimationPipeline = nullptr;
+        // Compute SSAO, linear view depth at 1/2 && 1/4 resolution, AO at preset resolution, upsampled to full resolution.
+        Ref<Pipeline> SSAODepthDownsamplePipeline = nullptr;
+        Ref<Pipeline> SSAOComputePipeline         = nullptr;
+        Ref<Pipeline> SSAOUpsamplePipeline        = nullptr;
+        std::array<Ref<Image>, 2> SSAODepthPyramid;
+        Ref<Image> SSAOLowResImage  = nullptr;
+        Ref<Image> SSAOComputeImage = nullptr;
+
+        // Skinning, instances are skinned by compute into a shared vertex buffer, which every pass draws as regular geometry.
+        Ref<Pipeline> SkinningPipeline = nullptr;
+        StorageBufferPerFrame SkinningDispatchesStorageBuffer;
+        StorageBufferPerFrame SkinningSourceStorageBuffer;  // Bind pose vertices of skinned meshes, uploaded once their set changes.
+        StorageBufferPerFrame BonePaletteStorageBuffer;
+        VertexBufferPerFrame SkinnedVertexBuffer;
+        std::array<std::vector<Ref<Mesh>>, MAX_FRAMES_IN_FLIGHT> SkinningSourceMeshes;  // Held, so their addresses can't be reused.
+        std::vector<SkinnedMeshData> SkinnedMeshes;
+        std::vector<glm::mat4> BoneMatrices;
+        std::vector<SkinningDispatch> SkinningDispatches;
+        std::vector<AnimatedVertex> SkinningSourceVertices;               // Scratch, reused when source buffer is re-uploaded.
+        std::unordered_map<const Mesh*, uint32_t> SkinningSourceOffsets;  // First source vertex of each mesh.
 
         // Final Lighting
         FramebufferPerFrame LightingFramebuffer;
         Ref<Pipeline> LightingPipeline = nullptr;
 
+        // Particles, rendered into the lit image, tested against GBuffer depth.
+        FramebufferPerFrame ParticleFramebuffer;
+
         // Chromatic Aberration
         FramebufferPerFrame ChromaticAberrationFramebuffer;
         Ref<Pipeline> ChromaticAberrationPipeline = nullptr;
@@ -251,30 +459,50 @@ class Renderer : private Uncopyable, private Unmovable
         // Global lighting UB
         UniformBufferPerFrame LightingUniformBuffer;
         UBLighting UBGlobalLighting;
-        uint32_t CurrentPointLightIndex = 0;
-        uint32_t CurrentDirLightIndex   = 0;
-        uint32_t CurrentSpotLightIndex  = 0;
+        uint32_t CurrentDirLightIndex = 0;
+
+        // Clustered light culling
+        Ref<Pipeline> LightCullingPipeline = nullptr;
+        UniformBufferPerFrame LightClustersUniformBuffer;
+        UBLightClusters UBGlobalLightClusters;
+        StorageBufferPerFrame PointLightsStorageBuffer;
+        StorageBufferPerFrame SpotLightsStorageBuffer;
+        StorageBufferPerFrame LightClustersStorageBuffer;
+        std::vector<PointLight> PointLights;
+        std::vector<SpotLight> SpotLights;
+
+        // Geometry stays in submission order && is drawn in order of its sorted keys.
+        std::vector<GeometryData> Geometry;
+        std::vector<DrawKey> DrawKeys;
+        std::vector<DrawKey> DrawKeysScratch;
+        std::unordered_map<const void*, uint32_t> MaterialIDs;  // Compact IDs for draw keys, reassigned every frame.
+        std::unordered_map<const void*, uint32_t> MeshIDs;
+        bool bWarnedOutOfDrawStateIDs = false;
 
         // Misc
-        std::vector<GeometryData> SortedGeometry;
         Ref<StagingBuffer> UploadHeap = nullptr;
         uint32_t CurrentFrame         = 0;
+        uint64_t FrameNumber          = 0;
     } static* s_RendererStorage;
 
   protected:
     Renderer()          = default;
     virtual ~Renderer() = default;
 
-    virtual void BeginImpl() = 0;
-
-    virtual void SubmitParticleSystemImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, Ref<StorageBuffer>& ssbo,
-                                          uint32_t particleCount, void* pushConstants = nullptr)                              = 0;
-    virtual void DispatchImpl(Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, void* pushConstants = nullptr,
+    virtual void SubmitParticleSystemImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline,
+                                          const Ref<StorageBuffer>& drawArgsBuffer, const uint64_t drawArgsOffset,
+                                          void* pushConstants = nullptr)                                                      = 0;
+    virtual void DispatchImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, void* pushConstants = nullptr,
                               const uint32_t groupCountX = 1, const uint32_t groupCountY = 1, const uint32_t groupCountZ = 1) = 0;
+    virtual void DispatchIndirectImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline,
+                                      const Ref<StorageBuffer>& dispatchArgsBuffer, const uint64_t dispatchArgsOffset,
+                                      void* pushConstants = nullptr)                                                          = 0;
 
     virtual void SubmitFullscreenQuadImpl(Ref<Pipeline>& pipeline, void* pushConstants = nullptr) = 0;
-    virtual void SubmitMeshImpl(Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer, Ref<IndexBuffer>& indexBuffer,
-                                Ref<Material>& material, void* pushConstants = nullptr)           = 0;
+    virtual void SubmitMeshImpl(const Ref<CommandBuffer>& commandBuffer, Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer,
+                                Ref<IndexBuffer>& indexBuffer, Ref<Material>& material, void* pushConstants = nullptr,
+                                const int32_t vertexOffset = 0)                                   = 0;
+    virtual void InsertComputeToVertexInputBarrierImpl(const Ref<CommandBuffer>& commandBuffer)   = 0;
 
 #if MESH_SHADING_TEST
     virtual void SubmitMeshShadingImpl(Ref<Pipeline>& pipeline, Ref<VertexBuffer>& vertexBuffer, Ref<IndexBuffer>& indexBuffer,
@@ -10,6 +10,8 @@
 #include "Pipeline.h"
 #include "Framebuffer.h"
 
+#include "Gauntlet/Core/Profiler.h"
+
 #include "Gauntlet/Platform/Vulkan/VulkanRenderer.h"
 
 namespace Gauntlet
@@ -67,7 +69,7 @@ void Renderer2D::Init()
     }
     s_RendererStorage2D->QuadPipeline->GetSpecification().Shader->Set("u_Sprites", s_RendererStorage2D->TextureSlots[0]);
 
-    for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
     {
         s_RendererStorage2D->QuadVertexBufferBase[frame] = new QuadVertex[s_RendererStorage2D->MaxVertices];
 
@@ -83,7 +85,7 @@ void Renderer2D::Shutdown()
 {
     GraphicsContext::Get().WaitDeviceOnFinish();
 
-    for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+    for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame)
     {
         delete[] s_RendererStorage2D->QuadVertexBufferBase[frame];
         for (auto& vb : s_RendererStorage2D->QuadVertexBuffers[frame])
@@ -126,7 +128,33 @@ void Renderer2D::Begin()
     s_RendererStorage2D->Sprites.clear();
 }
 
+void Renderer2D::SwapSnapshots()
+{
+    s_RendererStorage2D->SnapshotWriteIndex ^= 1;
+    ClearSnapshot();
+}
+
+void Renderer2D::ClearSnapshot()
+{
+    s_RendererStorage2D->QuadSnapshots[s_RendererStorage2D->SnapshotWriteIndex].clear();
+}
+
 void Renderer2D::Flush()
+{
+    GNT_PROFILE_FUNCTION();
+
+    for (const auto& quad : s_RendererStorage2D->QuadSnapshots[s_RendererStorage2D->SnapshotWriteIndex ^ 1])
+    {
+        if (s_RendererStorage2D->QuadIndexCount >= s_RendererStorage2D->MaxIndices) FlushAndReset();
+
+        const float textureID = GetTextureSlot(quad.Texture);
+        DrawQuadInternal(quad.Transform, quad.Color, textureID, quad.TexCoords.data());
+    }
+
+    FlushBatch();
+}
+
+void Renderer2D::FlushBatch()
 {
     if (s_RendererStorage2D->QuadIndexCount <= 0) return;
 
@@ -155,11 +183,13 @@ void Renderer2D::Flush()
         currentVertexBufferArray.push_back(VertexBuffer::Create(vbInfo));
     }
 
-    static auto& rs = Renderer::GetStorageData();
-    rs.UploadHeap->SetData(s_RendererStorage2D->QuadVertexBufferBase[s_RendererStorage2D->CurrentFrameIndex], DataSize);
-
+    static auto& rs    = Renderer::GetStorageData();
     auto& vertexBuffer = currentVertexBufferArray[s_RendererStorage2D->CurrentVertexBufferIndex[s_RendererStorage2D->CurrentFrameIndex]];
-    vertexBuffer->SetStagedData(rs.UploadHeap, DataSize);
+    {
+        UPLOAD_HEAP_GUARD_LOCK;
+        rs.UploadHeap->SetData(s_RendererStorage2D->QuadVertexBufferBase[s_RendererStorage2D->CurrentFrameIndex], DataSize);
+        vertexBuffer->SetStagedData(rs.UploadHeap, DataSize);
+    }
 
     rs.GeometryFramebuffer[rs.CurrentFrame]->BeginPass(rs.RenderCommandBuffer[rs.CurrentFrame]);
 
@@ -189,13 +219,11 @@ void Renderer2D::DrawRotatedQuad(const glm::vec2& position, const glm::vec2& siz
 
 void Renderer2D::DrawRotatedQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec3& rotation, const glm::vec4& color)
 {
-    if (s_RendererStorage2D->QuadIndexCount >= s_RendererStorage2D->MaxIndices) FlushAndReset();
-
     const auto transform = glm::translate(glm::mat4(1.0f), position) *
                            glm::rotate(glm::mat4(1.0f), glm::radians(rotation.z), glm::vec3(0, 0, 1)) *
                            glm::scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
 
-    DrawQuadInternal(transform, color, 0.0f);
+    SubmitQuad(transform, color, nullptr, RendererStorage2D::TextureCoords);
 }
 
 void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec3& rotation, const Ref<Texture2D>& texture,
@@ -207,36 +235,15 @@ void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, cons
 void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec3& rotation, const Ref<Texture2D>& texture,
                           const glm::vec4& color)
 {
-    if (s_RendererStorage2D->QuadIndexCount >= s_RendererStorage2D->MaxIndices) FlushAndReset();
-
-    float TextureId = 0.0f;
-    for (uint32_t i = 1; i < s_RendererStorage2D->CurrentTextureSlotIndex; ++i)
-    {
-        if (s_RendererStorage2D->TextureSlots[i] == texture)
-        {
-            TextureId = (float)i;
-            break;
-        }
-    }
-
-    if (TextureId == 0.0f)
-    {
-        if (s_RendererStorage2D->CurrentTextureSlotIndex + 1 >= RendererStorage2D::MaxTextureSlots) FlushAndReset();
-
-        s_RendererStorage2D->TextureSlots[s_RendererStorage2D->CurrentTextureSlotIndex] = texture;
-        TextureId = (float)s_RendererStorage2D->CurrentTextureSlotIndex;
-        ++s_RendererStorage2D->CurrentTextureSlotIndex;
-    }
-
     const auto Transform = glm::translate(glm::mat4(1.0f), position) *
                            glm::rotate(glm::mat4(1.0f), glm::radians(rotation.z), glm::vec3(0, 0, 1)) *
                            glm::scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
-    DrawQuadInternal(Transform, color, TextureId);
+    SubmitQuad(Transform, color, texture, RendererStorage2D::TextureCoords);
 }
 
 void Renderer2D::DrawQuad(const glm::mat4& transform, const glm::vec4& color)
 {
-    DrawQuadInternal(transform, color, 0.0f);
+    SubmitQuad(transform, color, nullptr, RendererStorage2D::TextureCoords);
 }
 
 void Renderer2D::DrawTexturedQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture,
@@ -248,29 +255,8 @@ void Renderer2D::DrawTexturedQuad(const glm::vec2& position, const glm::vec2& si
 void Renderer2D::DrawTexturedQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture,
                                   const glm::vec4& InBlendColor)
 {
-    if (s_RendererStorage2D->QuadIndexCount >= s_RendererStorage2D->MaxIndices) FlushAndReset();
-
-    float TextureId = 0.0f;
-    for (uint32_t i = 1; i < s_RendererStorage2D->CurrentTextureSlotIndex; ++i)
-    {
-        if (s_RendererStorage2D->TextureSlots[i] == texture)
-        {
-            TextureId = (float)i;
-            break;
-        }
-    }
-
-    if (TextureId == 0.0f)
-    {
-        if (s_RendererStorage2D->CurrentTextureSlotIndex + 1 >= RendererStorage2D::MaxTextureSlots) FlushAndReset();
-
-        s_RendererStorage2D->TextureSlots[s_RendererStorage2D->CurrentTextureSlotIndex] = texture;
-        TextureId = (float)s_RendererStorage2D->CurrentTextureSlotIndex;
-        ++s_RendererStorage2D->CurrentTextureSlotIndex;
-    }
-
     const auto Transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
-    DrawQuadInternal(Transform, InBlendColor, TextureId);
+    SubmitQuad(Transform, InBlendColor, texture, RendererStorage2D::TextureCoords);
 }
 
 void Renderer2D::DrawTexturedQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& textureAtlas,
@@ -294,29 +280,6 @@ void Renderer2D::DrawTexturedQuad(const glm::vec2& position, const glm::vec2& si
 void Renderer2D::DrawTexturedQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec3& rotation,
                                   const Ref<Texture2D>& textureAtlas, const glm::vec2& spriteCoords, const glm::vec2& spriteSize)
 {
-    if (s_RendererStorage2D->QuadIndexCount >= s_RendererStorage2D->MaxIndices) FlushAndReset();
-
-    float textureID = 0.0f;
-    for (uint32_t i = 1; i <= s_RendererStorage2D->CurrentTextureSlotIndex; ++i)
-    {
-        if (s_RendererStorage2D->TextureSlots[i] == textureAtlas)
-        {
-            textureID = (float)i;
-            break;
-        }
-    }
-
-    if (textureID == 0.0f)
-    {
-        s_RendererStorage2D->TextureSlots[s_RendererStorage2D->CurrentTextureSlotIndex] = textureAtlas;
-        textureID = (float)s_RendererStorage2D->CurrentTextureSlotIndex;
-    }
-
-    if (s_RendererStorage2D->CurrentTextureSlotIndex + 1 >= RendererStorage2D::MaxTextureSlots)
-        FlushAndReset();
-    else
-        ++s_RendererStorage2D->CurrentTextureSlotIndex;
-
     const glm::vec2 spriteSheetSize = glm::vec2(textureAtlas->GetWidth(), textureAtlas->GetHeight());
     const glm::vec2 texCoords[]     = {
         {(spriteCoords.x * spriteSize.x) / spriteSheetSize.x, (spriteCoords.y * spriteSize.y) / spriteSheetSize.y},              //
@@ -330,29 +293,42 @@ void Renderer2D::DrawTexturedQuad(const glm::vec3& position, const glm::vec2& si
                                      glm::rotate(glm::mat4(1.0f), glm::radians(rotation.z), glm::vec3(0, 0, 1));   // around Z
     const glm::mat4 transform =
         glm::translate(glm::mat4(1.0f), position) * rotationMatrix * glm::scale(glm::mat4(1.0f), {size.x, size.y, 1.0f});
-    for (uint32_t i = 0; i < 4; ++i)
+    SubmitQuad(transform, glm::vec4(1.0f), textureAtlas, texCoords);
+}
+
+void Renderer2D::SubmitQuad(const glm::mat4& transform, const glm::vec4& color, const Ref<Texture2D>& texture, const glm::vec2* texCoords)
+{
+    auto& quad     = s_RendererStorage2D->QuadSnapshots[s_RendererStorage2D->SnapshotWriteIndex].emplace_back();
+    quad.Transform = transform;
+    quad.Color     = color;
+    quad.Texture   = texture;
+    std::copy(texCoords, texCoords + quad.TexCoords.size(), quad.TexCoords.begin());
+}
+
+float Renderer2D::GetTextureSlot(const Ref<Texture2D>& texture)
+{
+    if (!texture) return 0.0f;
+
+    for (uint32_t i = 1; i < s_RendererStorage2D->CurrentTextureSlotIndex; ++i)
     {
-        s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex]->Position =
-            transform * s_RendererStorage2D->QuadVertexPositions[i];
-        s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex]->Color     = glm::vec4(1.0f);
-        s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex]->TexCoord  = texCoords[i];
-        s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex]->TextureId = textureID;
-        ++s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex];
+        if (s_RendererStorage2D->TextureSlots[i] == texture) return static_cast<float>(i);
     }
 
-    s_RendererStorage2D->QuadIndexCount += 6;
-    s_RendererStorage2D->PushConstants.TransformMatrix = s_RendererStorage2D->CameraProjectionMatrix;
-    ++Renderer::GetStats().QuadCount;
+    if (s_RendererStorage2D->CurrentTextureSlotIndex + 1 >= RendererStorage2D::MaxTextureSlots) FlushAndReset();
+
+    s_RendererStorage2D->TextureSlots[s_RendererStorage2D->CurrentTextureSlotIndex] = texture;
+    return static_cast<float>(s_RendererStorage2D->CurrentTextureSlotIndex++);
 }
 
-void Renderer2D::DrawQuadInternal(const glm::mat4& transform, const glm::vec4& blendColor, const float textureID)
+void Renderer2D::DrawQuadInternal(const glm::mat4& transform, const glm::vec4& blendColor, const float textureID,
+                                  const glm::vec2* texCoords)
 {
     for (uint32_t i = 0; i < 4; ++i)
     {
         s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex]->Position =
             transform * s_RendererStorage2D->QuadVertexPositions[i];
         s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex]->Color     = blendColor;
-        s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex]->TexCoord  = RendererStorage2D::TextureCoords[i];
+        s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex]->TexCoord  = texCoords[i];
         s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex]->TextureId = textureID;
         ++s_RendererStorage2D->QuadVertexBufferPtr[s_RendererStorage2D->CurrentFrameIndex];
     }
@@ -367,7 +343,7 @@ void Renderer2D::DrawQuadInternal(const glm::mat4& transform, const glm::vec4& b
 
 void Renderer2D::FlushAndReset()
 {
-    Flush();
+    FlushBatch();
 
     for (uint32_t i = 1; i <= s_RendererStorage2D->CurrentTextureSlotIndex; ++i)
         s_RendererStorage2D->TextureSlots[i] = nullptr;
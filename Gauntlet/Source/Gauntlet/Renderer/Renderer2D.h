@@ -34,6 +34,10 @@ class Renderer2D : private Uncopyable, private Unmovable
     static void Begin();
     static void Flush();
 
+    // Quads drawn since the last swap are recorded by the next Flush(), while new ones go into the other snapshot.
+    static void SwapSnapshots();
+    static void ClearSnapshot();  // Drops quads drawn since the last swap.
+
     static void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
     static void DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color);
 
@@ -68,8 +72,22 @@ class Renderer2D : private Uncopyable, private Unmovable
     Renderer2D()          = default;
     virtual ~Renderer2D() = default;
 
+    // Captured by value on simulation side, batched into vertices when its snapshot is flushed.
+    struct QuadSubmission
+    {
+        glm::mat4 Transform                = glm::mat4(1.0f);
+        glm::vec4 Color                    = glm::vec4(1.0f);
+        Ref<Texture2D> Texture             = nullptr;  // White texture if not set.
+        std::array<glm::vec2, 4> TexCoords = {};
+    };
+
+    static void SubmitQuad(const glm::mat4& transform, const glm::vec4& color, const Ref<Texture2D>& texture, const glm::vec2* texCoords);
+
     // Final helper-only function
-    static void DrawQuadInternal(const glm::mat4& transform, const glm::vec4& blendColor, const float textureID);
+    static void DrawQuadInternal(const glm::mat4& transform, const glm::vec4& blendColor, const float textureID,
+                                 const glm::vec2* texCoords);
+    static float GetTextureSlot(const Ref<Texture2D>& texture);
+    static void FlushBatch();
     static void FlushAndReset();
 
     struct RendererStorage2D
@@ -93,13 +111,13 @@ class Renderer2D : private Uncopyable, private Unmovable
 
         // Quad2D Base Stuff
         BufferLayout VertexBufferLayout;
-        using VertexBufferPtrPerFrame = std::array<QuadVertex*, FRAMES_IN_FLIGHT>;
+        using VertexBufferPtrPerFrame = std::array<QuadVertex*, MAX_FRAMES_IN_FLIGHT>;
         VertexBufferPtrPerFrame QuadVertexBufferBase;
         VertexBufferPtrPerFrame QuadVertexBufferPtr;
         uint32_t CurrentFrameIndex = 0;
 
-        std::array<std::vector<Ref<VertexBuffer>>, FRAMES_IN_FLIGHT> QuadVertexBuffers;  // Per-frame
-        std::array<uint32_t, FRAMES_IN_FLIGHT> CurrentVertexBufferIndex;
+        std::array<std::vector<Ref<VertexBuffer>>, MAX_FRAMES_IN_FLIGHT> QuadVertexBuffers;  // Per-frame
+        std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> CurrentVertexBufferIndex;
 
         Ref<Pipeline> QuadPipeline;
         Ref<IndexBuffer> QuadIndexBuffer;
@@ -107,6 +125,10 @@ class Renderer2D : private Uncopyable, private Unmovable
 
         std::vector<Sprite> Sprites;
 
+        // Written by simulation at SnapshotWriteIndex, the other one is read by render thread.
+        std::array<std::vector<QuadSubmission>, 2> QuadSnapshots;
+        uint32_t SnapshotWriteIndex = 0;
+
         std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
         uint32_t CurrentTextureSlotIndex = 1;  // 0 slot already tied with white texture
 
@@ -32,6 +32,7 @@ class Texture2D;
 class TextureCube;
 class Image;
 class UniformBuffer;
+class VertexBuffer;
 
 class Shader
 {
@@ -49,6 +50,9 @@ class Shader
     virtual void Set(const std::string& name, const Ref<StorageBuffer>& ssbo, const uint64_t offset = 0)          = 0;
     virtual void Set(const std::string& name, const std::vector<Ref<Texture2D>>& textures)                        = 0;
 
+    // Vertex buffer should be created with STORAGE_BUFFER usage, e.g. to be written by compute.
+    virtual void Set(const std::string& name, const Ref<VertexBuffer>& vertexBuffer) = 0;
+
     static Ref<Shader> Create(const std::string_view& filePath);
 };
 
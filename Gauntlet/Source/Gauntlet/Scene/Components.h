@@ -5,10 +5,12 @@
 #include <string>
 
 #include "Gauntlet/Core/Math.h"
+#include <entt/entt.hpp>
 
 #include "Gauntlet/Core/UUID.h"
 #include "Gauntlet/Renderer/Camera/Camera.h"
 #include "Gauntlet/Renderer/Mesh.h"
+#include "Gauntlet/Renderer/Animation.h"
 #include "Gauntlet/Renderer/Material.h"
 #include "Gauntlet/Renderer/Texture.h"
 
@@ -33,34 +35,77 @@ struct TagComponent
     TagComponent(const std::string& tag) : Tag(tag) {}
 };
 
+// Local to parent, world one is cached in WorldTransformComponent. Edits should be followed by Scene::MarkTransformDirty().
 struct TransformComponent
 {
     glm::vec3 Translation{0.0f};
-    glm::vec3 Rotation{0.0f};
+    glm::quat Rotation{1.0f, 0.0f, 0.0f, 0.0f};
     glm::vec3 Scale{1.0f};
     bool Padlock{false};
 
+    // (degrees) Last angles set, returned while Rotation is left unchanged, since deriving them back flips them once |Y| passes 90.
+    glm::vec3 CachedEulerAngles{0.0f};
+    glm::quat CachedEulerRotation{1.0f, 0.0f, 0.0f, 0.0f};
+
     TransformComponent()                          = default;
     TransformComponent(const TransformComponent&) = default;
-    TransformComponent(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale)
+    TransformComponent(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
         : Translation(translation), Rotation(rotation), Scale(scale)
     {
     }
 
-    glm::mat4 GetTransform() const
+    // (degrees) Applied in X * Y * Z order, editor && scene files keep using them.
+    glm::vec3 GetEulerAngles() const
+    {
+        if (Rotation == CachedEulerRotation) return CachedEulerAngles;
+
+        glm::vec3 angles{0.0f};
+        glm::extractEulerAngleXYZ(glm::mat4_cast(Rotation), angles.x, angles.y, angles.z);
+        return glm::degrees(angles);
+    }
+
+    void SetEulerAngles(const glm::vec3& degrees)
+    {
+        const glm::vec3 angles = glm::radians(degrees);
+        Rotation               = glm::normalize(glm::quat_cast(glm::eulerAngleXYZ(angles.x, angles.y, angles.z)));
+        CachedEulerAngles      = degrees;
+        CachedEulerRotation    = Rotation;
+    }
+
+    // If you don't understand order look at this: https://learnopengl.com/Getting-started/Transformations
+    glm::mat4 GetLocalTransform() const
     {
-        const float RotationX    = Rotation.x;
-        const float RotationY    = Rotation.y;
-        const float RotationZ    = Rotation.z;
-        const glm::mat4 Rotation = glm::rotate(glm::mat4(1.0f), glm::radians(RotationX), glm::vec3(1, 0, 0)) *
-                                   glm::rotate(glm::mat4(1.0f), glm::radians(RotationY), glm::vec3(0, 1, 0)) *
-                                   glm::rotate(glm::mat4(1.0f), glm::radians(RotationZ), glm::vec3(0, 0, 1));
-
-        // If you don't understand order look at this: https://learnopengl.com/Getting-started/Transformations
-        return glm::translate(glm::mat4(1.0f), Translation) * Rotation * glm::scale(glm::mat4(1.0f), Scale);
+        glm::mat4 transform = glm::mat4_cast(Rotation);
+        transform[0] *= Scale.x;
+        transform[1] *= Scale.y;
+        transform[2] *= Scale.z;
+        transform[3] = glm::vec4(Translation, 1.0f);
+        return transform;
     }
+};
+
+// Propagated from TransformComponent by Scene::UpdateWorldTransforms(), only dirty subtrees are touched.
+struct WorldTransformComponent
+{
+    glm::mat4 Transform{1.0f};
+    uint32_t HierarchyIndex = 0;  // Position in scene's flattened hierarchy, see Scene::RebuildTransformHierarchy().
+    bool bIsDirty           = true;
 
-    operator glm::mat4() const { return GetTransform(); }
+    WorldTransformComponent()                               = default;
+    WorldTransformComponent(const WorldTransformComponent&) = default;
+};
+
+// Children form an intrusive linked list, so hierarchy doesn't allocate per entity.
+struct RelationshipComponent
+{
+    entt::entity Parent      = entt::null;
+    entt::entity FirstChild  = entt::null;
+    entt::entity PrevSibling = entt::null;
+    entt::entity NextSibling = entt::null;
+    uint32_t ChildCount      = 0;
+
+    RelationshipComponent()                             = default;
+    RelationshipComponent(const RelationshipComponent&) = default;
 };
 
 struct SpriteRendererComponent
@@ -92,11 +137,25 @@ struct MeshComponent
     MeshComponent(const std::string& meshFilePath) { Mesh = Gauntlet::Mesh::Create(meshFilePath); }
 };
 
+// Plays one of the animations of mesh on the same entity, animator is created once the mesh has its skeleton loaded.
+struct AnimatorComponent
+{
+    Ref<Gauntlet::Animator> Animator{nullptr};
+    uint32_t AnimationIndex = 0;
+    float PlaybackSpeed     = 1.0f;
+    float CrossFadeDuration = 0.2f;  // (seconds) Switching animation blends into the new one over this time.
+    bool bIsPlaying         = true;
+
+    AnimatorComponent()                         = default;
+    AnimatorComponent(const AnimatorComponent&) = default;
+};
+
 struct PointLightComponent
 {
     glm::vec3 Color{0.0f};
-    float Intensity = 1.0f;
-    bool bIsActive  = true;
+    float Intensity   = 1.0f;
+    bool bIsActive    = true;
+    bool bCastShadows = false;
 
     PointLightComponent()                           = default;
     PointLightComponent(const PointLightComponent&) = default;
@@ -119,9 +178,29 @@ struct SpotLightComponent
     float CutOff      = 0.0f;
     float OuterCutOff = 0.0f;
     bool bIsActive    = true;
+    bool bCastShadows = false;
 
     SpotLightComponent()                          = default;
     SpotLightComponent(const SpotLightComponent&) = default;
 };
 
+struct ParticleEmitterComponent
+{
+    glm::vec4 StartColor{1.0f};
+    glm::vec4 EndColor{1.0f, 1.0f, 1.0f, 0.0f};
+    glm::vec3 Velocity{0.0f, 1.0f, 0.0f};
+    glm::vec3 VelocityVariation{0.5f};
+    glm::vec3 BoundsExtent{5.0f};  // Half size of AABB around emitter, particles outside of it may be culled.
+    float SpawnRate = 100.0f;      // Particles per second.
+    float Lifetime  = 2.0f;
+    float StartSize = 0.1f;
+    float EndSize   = 0.05f;
+    bool bIsActive  = true;
+
+    float SpawnAccumulator = 0.0f;  // Fraction of particle left from previous frames.
+
+    ParticleEmitterComponent()                                = default;
+    ParticleEmitterComponent(const ParticleEmitterComponent&) = default;
+};
+
 }  // namespace Gauntlet
\ No newline at end of file
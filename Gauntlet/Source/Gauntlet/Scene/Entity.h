@@ -36,7 +36,8 @@ class Entity final
     {
         GNT_ASSERT(HasComponent<T>(), "Attempting to delete component that entity doesn't have.");
 
-        if (typeid(T) == typeid(IDComponent) || typeid(T) == typeid(TransformComponent) || typeid(T) == typeid(TagComponent))
+        if (typeid(T) == typeid(IDComponent) || typeid(T) == typeid(TransformComponent) || typeid(T) == typeid(TagComponent) ||
+            typeid(T) == typeid(WorldTransformComponent) || typeid(T) == typeid(RelationshipComponent))
         {
             LOG_WARN("Attempting to delete transform/tag component! Returning...");
             return;
@@ -4,12 +4,36 @@
 
 #include "Gauntlet/Renderer/Renderer2D.h"
 #include "Gauntlet/Renderer/Renderer.h"
+#include "Gauntlet/Renderer/ParticleSystem.h"
+#include "Gauntlet/Core/Profiler.h"
+#include "Gauntlet/Core/JobSystem.h"
 
 #pragma warning(disable : 4996)
 
 namespace Gauntlet
 {
 
+static constexpr size_t s_MIN_ENTITIES_PER_EXTRACTION_JOB = 512;
+static constexpr size_t s_MIN_ANIMATORS_PER_JOB           = 8;
+
+// Lights shine down their local -Z axis, it's taken from world transform, so they follow their parents.
+static glm::vec3 GetWorldForward(const glm::mat4& worldTransform)
+{
+    static constexpr float s_MIN_AXIS_LENGTH_SQUARED = 1e-12f;
+
+    const glm::vec3 forward = -glm::vec3(worldTransform[2]);
+    if (glm::dot(forward, forward) > s_MIN_AXIS_LENGTH_SQUARED) return glm::normalize(forward);
+
+    // Zero Z scale collapses the axis, it's rebuilt from the other two, if they're collapsed as well, light keeps its default direction.
+    const glm::vec3 rebuilt = glm::cross(glm::vec3(worldTransform[1]), glm::vec3(worldTransform[0]));
+    if (glm::dot(rebuilt, rebuilt) > s_MIN_AXIS_LENGTH_SQUARED) return glm::normalize(rebuilt);
+
+    return glm::vec3(0.0f, 0.0f, -1.0f);
+}
+
+// Drawn as a sprite at the entity's transform while its mesh is streaming.
+static constexpr glm::vec4 s_STREAMING_PLACEHOLDER_COLOR = glm::vec4(0.5f, 0.5f, 0.5f, 0.35f);
+
 Scene::Scene(const std::string& name) : m_Name(name) {}
 
 Scene::~Scene()
@@ -36,71 +60,404 @@ Entity Scene::CreateEntityWithUUID(UUID uuid, const std::string& name)
     tag.Tag   = name;
 
     entity.AddComponent<TransformComponent>();
+    entity.AddComponent<WorldTransformComponent>();
+    entity.AddComponent<RelationshipComponent>();
+    m_bTransformHierarchyChanged = true;
 
     return entity;
 }
 
 void Scene::DestroyEntity(Entity entity)
 {
+    // Children go along with their parent. Destroying them moves components around, so relationship is fetched every time.
+    while (entity.GetComponent<RelationshipComponent>().FirstChild != entt::null)
+        DestroyEntity(Entity{entity.GetComponent<RelationshipComponent>().FirstChild, this});
+
+    UnlinkFromParent(entity);
     m_Registry.destroy(entity);  // Implicitly returns entt::entity by Gauntlet::Entity impl
+    m_bTransformHierarchyChanged = true;
 }
 
-void Scene::OnUpdate(const float deltaTime)
+void Scene::UnlinkFromParent(entt::entity entity)
 {
-    for (auto entityID : m_Registry.view<IDComponent>())
+    auto& relationship = m_Registry.get<RelationshipComponent>(entity);
+    if (relationship.Parent == entt::null) return;
+
+    auto& parentRelationship = m_Registry.get<RelationshipComponent>(relationship.Parent);
+    if (parentRelationship.FirstChild == entity) parentRelationship.FirstChild = relationship.NextSibling;
+    if (relationship.PrevSibling != entt::null)
+        m_Registry.get<RelationshipComponent>(relationship.PrevSibling).NextSibling = relationship.NextSibling;
+    if (relationship.NextSibling != entt::null)
+        m_Registry.get<RelationshipComponent>(relationship.NextSibling).PrevSibling = relationship.PrevSibling;
+    --parentRelationship.ChildCount;
+
+    relationship.Parent      = entt::null;
+    relationship.PrevSibling = entt::null;
+    relationship.NextSibling = entt::null;
+}
+
+void Scene::SetParent(Entity entity, Entity parent)
+{
+    const entt::entity entityHandle = entity;
+    const entt::entity parentHandle = parent.IsValid() ? static_cast<entt::entity>(parent) : entt::null;
+
+    auto& relationship = m_Registry.get<RelationshipComponent>(entityHandle);
+    if (relationship.Parent == parentHandle) return;
+
+    for (entt::entity ancestor = parentHandle; ancestor != entt::null; ancestor = m_Registry.get<RelationshipComponent>(ancestor).Parent)
+    {
+        if (ancestor != entityHandle) continue;
+
+        LOG_WARN("Entity can't be parented to itself or its descendants!");
+        return;
+    }
+
+    UnlinkFromParent(entityHandle);
+    if (parentHandle != entt::null)
+    {
+        // Appended to the end, so children keep their order.
+        auto& parentRelationship = m_Registry.get<RelationshipComponent>(parentHandle);
+        entt::entity lastChild   = parentRelationship.FirstChild;
+        while (lastChild != entt::null && m_Registry.get<RelationshipComponent>(lastChild).NextSibling != entt::null)
+            lastChild = m_Registry.get<RelationshipComponent>(lastChild).NextSibling;
+
+        if (lastChild == entt::null)
+            parentRelationship.FirstChild = entityHandle;
+        else
+            m_Registry.get<RelationshipComponent>(lastChild).NextSibling = entityHandle;
+
+        relationship.Parent      = parentHandle;
+        relationship.PrevSibling = lastChild;
+        ++parentRelationship.ChildCount;
+    }
+
+    m_bTransformHierarchyChanged = true;
+}
+
+void Scene::MarkTransformDirty(Entity entity)
+{
+    auto& worldTransform = entity.GetComponent<WorldTransformComponent>();
+    if (worldTransform.bIsDirty) return;
+
+    worldTransform.bIsDirty = true;
+    m_DirtyTransforms.push_back(entity);
+}
+
+void Scene::RebuildTransformHierarchy()
+{
+    m_TransformHierarchy.clear();
+
+    std::vector<TransformHierarchyNode> stack;
+    for (const auto entity : m_Registry.view<RelationshipComponent>())
     {
-        Entity entity{entityID, this};
+        if (m_Registry.get<RelationshipComponent>(entity).Parent != entt::null) continue;
 
-        if (entity.HasComponent<TransformComponent>())
+        stack.push_back({entity, UINT32_MAX});
+        while (!stack.empty())
         {
-            auto& Transform = entity.GetComponent<TransformComponent>();
+            auto node = stack.back();
+            stack.pop_back();
 
-            if (entity.HasComponent<SpriteRendererComponent>())
-            {
-                auto& Color = entity.GetComponent<SpriteRendererComponent>().Color;
+            const auto index = static_cast<uint32_t>(m_TransformHierarchy.size());
+            m_TransformHierarchy.push_back(node);
+            m_Registry.get<WorldTransformComponent>(node.Handle).HierarchyIndex = index;
+
+            // Pushed from the last one, so children are visited in their list order.
+            entt::entity child = m_Registry.get<RelationshipComponent>(node.Handle).FirstChild;
+            while (child != entt::null && m_Registry.get<RelationshipComponent>(child).NextSibling != entt::null)
+                child = m_Registry.get<RelationshipComponent>(child).NextSibling;
+
+            for (; child != entt::null; child = m_Registry.get<RelationshipComponent>(child).PrevSibling)
+                stack.push_back({child, index});
+        }
+    }
+
+    // Descendants always follow their ancestors, so walking backwards accumulates subtree sizes bottom-up.
+    for (size_t i = m_TransformHierarchy.size(); i > 0; --i)
+    {
+        const auto& node = m_TransformHierarchy[i - 1];
+        if (node.ParentIndex != UINT32_MAX) m_TransformHierarchy[node.ParentIndex].SubtreeSize += node.SubtreeSize;
+    }
+
+    m_WorldTransforms.resize(m_TransformHierarchy.size());
+}
 
-                Renderer2D::DrawQuad(Transform, Color);
-            }
+void Scene::UpdateTransformRange(const uint32_t first, const uint32_t count)
+{
+    for (uint32_t i = first; i < first + count; ++i)
+    {
+        const auto& node               = m_TransformHierarchy[i];
+        const glm::mat4 localTransform = m_Registry.get<TransformComponent>(node.Handle).GetLocalTransform();
+        m_WorldTransforms[i] = node.ParentIndex == UINT32_MAX ? localTransform : m_WorldTransforms[node.ParentIndex] * localTransform;
+
+        auto& worldTransform     = m_Registry.get<WorldTransformComponent>(node.Handle);
+        worldTransform.Transform = m_WorldTransforms[i];
+        worldTransform.bIsDirty  = false;
+    }
+}
+
+void Scene::UpdateWorldTransforms()
+{
+    GNT_PROFILE_FUNCTION();
+
+    if (m_bTransformHierarchyChanged)
+    {
+        RebuildTransformHierarchy();
+        UpdateTransformRange(0, static_cast<uint32_t>(m_TransformHierarchy.size()));
+
+        m_DirtyTransforms.clear();
+        m_bTransformHierarchyChanged = false;
+        return;
+    }
+
+    if (m_DirtyTransforms.empty()) return;
+
+    m_DirtyTransformIndices.clear();
+    for (const auto entity : m_DirtyTransforms)
+    {
+        if (m_Registry.valid(entity)) m_DirtyTransformIndices.push_back(m_Registry.get<WorldTransformComponent>(entity).HierarchyIndex);
+    }
+    m_DirtyTransforms.clear();
 
-            if (entity.HasComponent<MeshComponent>())
+    // Ancestors come first && their ranges cover dirty descendants, so those are skipped.
+    std::sort(m_DirtyTransformIndices.begin(), m_DirtyTransformIndices.end());
+    uint32_t updatedEnd = 0;
+    for (const auto index : m_DirtyTransformIndices)
+    {
+        if (index < updatedEnd) continue;
+
+        const uint32_t subtreeSize = m_TransformHierarchy[index].SubtreeSize;
+        UpdateTransformRange(index, subtreeSize);
+        updatedEnd = index + subtreeSize;
+    }
+}
+
+void Scene::UpdateAnimations(const float deltaTime)
+{
+    GNT_PROFILE_FUNCTION();
+
+    // Animators are created && switched on the calling thread, workers only advance them.
+    m_ActiveAnimators.clear();
+    m_Registry.view<MeshComponent, AnimatorComponent>().each(
+        [&](const auto& mc, auto& ac)
+        {
+            if (!mc.Mesh || !mc.Mesh->IsLoaded() || !mc.Mesh->GetSkeleton() || mc.Mesh->GetAnimations().empty()) return;
+
+            const auto& animations = mc.Mesh->GetAnimations();
+            const auto& animation  = animations[std::min<size_t>(ac.AnimationIndex, animations.size() - 1)];
+            if (!ac.Animator || ac.Animator->GetSkeleton() != mc.Mesh->GetSkeleton())
+                ac.Animator = MakeRef<Animator>(mc.Mesh->GetSkeleton(), animation);
+            else if (ac.Animator->GetAnimation() != animation)
+                ac.Animator->CrossFade(animation, ac.CrossFadeDuration);
+
+            if (ac.bIsPlaying) m_ActiveAnimators.emplace_back(ac.Animator.get(), deltaTime * ac.PlaybackSpeed);
+        });
+
+    const size_t animatorCount = m_ActiveAnimators.size();
+    m_Stats.AnimatorCount      = static_cast<uint32_t>(animatorCount);
+    if (animatorCount == 0) return;
+
+    // Animators don't share any state, so each job takes a contiguous chunk of them.
+    const size_t maxJobCount     = static_cast<size_t>(JobSystem::GetThreadCount()) + 1;
+    const size_t wantedJobCount  = (animatorCount + s_MIN_ANIMATORS_PER_JOB - 1) / s_MIN_ANIMATORS_PER_JOB;
+    const size_t jobCount        = std::clamp<size_t>(wantedJobCount, 1, maxJobCount);
+    const size_t animatorsPerJob = (animatorCount + jobCount - 1) / jobCount;
+    WaitGroup animationJobs;
+    for (size_t i = 0; i < jobCount; ++i)
+    {
+        const size_t first = std::min(i * animatorsPerJob, animatorCount);
+        const size_t last  = std::min(first + animatorsPerJob, animatorCount);
+        JobSystem::Submit(
+            animationJobs, [this, first, last]
             {
-                auto& Mesh = entity.GetComponent<MeshComponent>().Mesh;
+                GNT_PROFILE_SCOPE("UpdateAnimations");
 
-                if (Mesh->IsAnimated())
-                {
-                    // Animate here
-                }
-                else
+                for (size_t k = first; k < last; ++k)
+                    m_ActiveAnimators[k].first->UpdateAnimation(m_ActiveAnimators[k].second);
+            });
+    }
+
+    JobSystem::Wait(animationJobs);
+}
+
+void Scene::ExtractRenderPackets(const float deltaTime)
+{
+    GNT_PROFILE_FUNCTION();
+
+    // Groups && views are created up front, creating them may add storages to registry while workers walk it.
+    auto meshes      = m_Registry.group<MeshComponent>(entt::get<WorldTransformComponent>);
+    auto sprites     = m_Registry.group<SpriteRendererComponent>(entt::get<WorldTransformComponent>);
+    auto pointLights = m_Registry.group<PointLightComponent>(entt::get<WorldTransformComponent>);
+    auto animators   = m_Registry.view<AnimatorComponent>();
+
+    auto directionalLights = m_Registry.view<WorldTransformComponent, DirectionalLightComponent>();
+    auto spotLights        = m_Registry.view<WorldTransformComponent, SpotLightComponent>();
+    auto particleEmitters  = m_Registry.view<IDComponent, WorldTransformComponent, ParticleEmitterComponent>();
+
+    const auto getJobCount = [](const size_t entityCount)
+    {
+        const size_t maxJobCount = static_cast<size_t>(JobSystem::GetThreadCount()) + 1;
+        const size_t jobCount    = (entityCount + s_MIN_ENTITIES_PER_EXTRACTION_JOB - 1) / s_MIN_ENTITIES_PER_EXTRACTION_JOB;
+        return std::clamp<size_t>(jobCount, 1, maxJobCount);
+    };
+
+    const size_t meshJobCount       = getJobCount(meshes.size());
+    const size_t spriteJobCount     = getJobCount(sprites.size());
+    const size_t pointLightJobCount = getJobCount(pointLights.size());
+
+    // Sized before any job starts, so lists aren't moved under workers.
+    const size_t jobCount = meshJobCount + spriteJobCount + pointLightJobCount;
+    if (m_RenderPacketLists.size() < jobCount) m_RenderPacketLists.resize(jobCount);
+    for (auto& packetList : m_RenderPacketLists)
+    {
+        packetList.Meshes.clear();
+        packetList.Sprites.clear();
+        packetList.PointLights.clear();
+    }
+    m_Stats.ExtractionJobs = static_cast<uint32_t>(jobCount);
+
+    // Each job walks its contiguous chunk of a group && appends to its own list, so workers don't share anything.
+    size_t packetListIndex = 0;
+    WaitGroup extractionJobs;
+
+    const auto submitJobs = [&](const auto& group, const size_t groupJobCount, auto extractFunc)
+    {
+        const size_t entityCount    = group.size();
+        const size_t entitiesPerJob = (entityCount + groupJobCount - 1) / groupJobCount;
+        for (size_t i = 0; i < groupJobCount; ++i)
+        {
+            const auto first = static_cast<std::ptrdiff_t>(std::min(i * entitiesPerJob, entityCount));
+            const auto last  = static_cast<std::ptrdiff_t>(std::min(i * entitiesPerJob + entitiesPerJob, entityCount));
+            JobSystem::Submit(
+                extractionJobs, [group, first, last, extractFunc, &packetList = m_RenderPacketLists[packetListIndex++]]
                 {
-                }
+                    GNT_PROFILE_SCOPE("ExtractRenderPackets");
 
-                Renderer::SubmitMesh(Mesh, Transform);
-            }
+                    for (auto it = group.begin() + first; it != group.begin() + last; ++it)
+                        extractFunc(packetList, group, *it);
+                });
+        }
+    };
 
-            if (entity.HasComponent<PointLightComponent>())
-            {
-                auto& plc = entity.GetComponent<PointLightComponent>();
+    submitJobs(meshes, meshJobCount,
+               [animators](auto& packetList, const auto& group, const entt::entity entity)
+               {
+                   const auto& [mc, wtc] = group.template get<MeshComponent, WorldTransformComponent>(entity);
+                   if (!mc.Mesh) return;
 
-                const glm::vec4 Position = glm::vec4(Transform.Translation, 1.0f);
-                Renderer::AddPointLight(Position, plc.Color, plc.Intensity, plc.bIsActive);
-            }
+                   if (!mc.Mesh->IsLoaded())
+                   {
+                       packetList.Sprites.push_back({wtc.Transform, s_STREAMING_PLACEHOLDER_COLOR});
+                       return;
+                   }
 
-            if (entity.HasComponent<DirectionalLightComponent>())
-            {
-                auto& dlc = entity.GetComponent<DirectionalLightComponent>();
+                   // Animators were created && advanced before extraction, so their palettes are only read here.
+                   const std::vector<glm::mat4>* boneMatrices = nullptr;
+                   if (animators.contains(entity))
+                   {
+                       const auto& ac = animators.template get<AnimatorComponent>(entity);
+                       if (ac.Animator) boneMatrices = &ac.Animator->GetFinalBoneMatrices();
+                   }
 
-                Renderer::AddDirectionalLight(dlc.Color, glm::radians(Transform.Rotation), dlc.bCastShadows, dlc.Intensity);
-            }
+                   packetList.Meshes.push_back({&mc.Mesh, wtc.Transform, boneMatrices});
+               });
 
-            if (entity.HasComponent<SpotLightComponent>())
-            {
-                auto& slc = entity.GetComponent<SpotLightComponent>();
+    submitJobs(sprites, spriteJobCount,
+               [](auto& packetList, const auto& group, const entt::entity entity)
+               {
+                   const auto& [src, wtc] = group.template get<SpriteRendererComponent, WorldTransformComponent>(entity);
+                   packetList.Sprites.push_back({wtc.Transform, src.Color});
+               });
+
+    submitJobs(pointLights, pointLightJobCount,
+               [](auto& packetList, const auto& group, const entt::entity entity)
+               {
+                   const auto& [plc, wtc] = group.template get<PointLightComponent, WorldTransformComponent>(entity);
+                   const glm::vec3 position(wtc.Transform[3]);
+                   packetList.PointLights.push_back({position, plc.Color, plc.Intensity, plc.bIsActive, plc.bCastShadows});
+               });
+
+    // There're only a few of these, they're submitted right away while workers are busy.
+    directionalLights.each(
+        [](const auto& wtc, const auto& dlc)
+        { Renderer::AddDirectionalLight(dlc.Color, GetWorldForward(wtc.Transform), dlc.bCastShadows, dlc.Intensity); });
+
+    spotLights.each(
+        [](const auto& wtc, const auto& slc)
+        {
+            Renderer::AddSpotLight(glm::vec3(wtc.Transform[3]), GetWorldForward(wtc.Transform), slc.Color, slc.Intensity,
+                                   (int32_t)slc.bIsActive, glm::cos(glm::radians(slc.CutOff)), glm::cos(glm::radians(slc.OuterCutOff)),
+                                   slc.bCastShadows);
+        });
+
+    particleEmitters.each(
+        [&](const auto& idc, const auto& wtc, auto& pec)
+        {
+            if (!pec.bIsActive) return;
+
+            // Whole particles are spawned, the rest carries over so low rates don't round down to zero.
+            pec.SpawnAccumulator += pec.SpawnRate * deltaTime;
+            const float spawnCount = glm::floor(pec.SpawnAccumulator);
+            pec.SpawnAccumulator -= spawnCount;
+
+            ParticleEmitter emitter   = {};
+            emitter.ID                = idc.ID;
+            emitter.Transform         = wtc.Transform;
+            emitter.StartColor        = pec.StartColor;
+            emitter.EndColor          = pec.EndColor;
+            emitter.Velocity          = pec.Velocity;
+            emitter.VelocityVariation = pec.VelocityVariation;
+            emitter.BoundsExtent      = pec.BoundsExtent;
+            emitter.Lifetime          = pec.Lifetime;
+            emitter.StartSize         = pec.StartSize;
+            emitter.EndSize           = pec.EndSize;
+            emitter.SpawnCount        = static_cast<uint32_t>(spawnCount);
+            Renderer::SubmitParticleEmitter(emitter);
+        });
+
+    JobSystem::Wait(extractionJobs);
+}
 
-                Renderer::AddSpotLight(Transform.Translation, glm::radians(Transform.Rotation), slc.Color, slc.Intensity,
-                                       (int32_t)slc.bIsActive, glm::cos(glm::radians(slc.CutOff)), glm::cos(glm::radians(slc.OuterCutOff)));
-            }
+void Scene::SubmitRenderPackets()
+{
+    GNT_PROFILE_FUNCTION();
+
+    // Lists are merged in job order, which follows group order, so submission order doesn't depend on scheduling.
+    for (size_t i = 0; i < m_Stats.ExtractionJobs; ++i)
+    {
+        const auto& packetList = m_RenderPacketLists[i];
+        for (const auto& packet : packetList.Meshes)
+        {
+            if (packet.BoneMatrices)
+                Renderer::SubmitSkinnedMesh(*packet.Mesh, packet.Transform, *packet.BoneMatrices);
+            else
+                Renderer::SubmitMesh(*packet.Mesh, packet.Transform);
         }
+
+        for (const auto& packet : packetList.Sprites)
+            Renderer2D::DrawQuad(packet.Transform, packet.Color);
+
+        for (const auto& packet : packetList.PointLights)
+            Renderer::AddPointLight(packet.Position, packet.Color, packet.Intensity, packet.bIsActive, packet.bCastShadows);
     }
 }
 
+void Scene::OnUpdate(const float deltaTime)
+{
+    GNT_PROFILE_FUNCTION();
+
+    UpdateWorldTransforms();
+
+    const double animationBegin = Timer::Now();
+    UpdateAnimations(deltaTime);
+    m_Stats.AnimationTime = static_cast<float>((Timer::Now() - animationBegin) * 1000.0);
+
+    const double extractionBegin = Timer::Now();
+    ExtractRenderPackets(deltaTime);
+    SubmitRenderPackets();
+
+    m_Stats.ExtractionTime = static_cast<float>((Timer::Now() - extractionBegin) * 1000.0);
+    m_Stats.EntityCount    = static_cast<uint32_t>(m_Registry.view<IDComponent>().size());
+}
+
 }  // namespace Gauntlet
\ No newline at end of file
@@ -9,6 +9,16 @@ namespace Gauntlet
 class Entity;
 class SceneHierarchyPanel;
 
+struct SceneStats
+{
+    float ExtractionTime    = 0.0f;  // (ms) Walking typed views && merging render packets into renderer.
+    uint32_t EntityCount    = 0;
+    uint32_t ExtractionJobs = 0;
+
+    float AnimationTime    = 0.0f;  // (ms) Sampling keyframes && building bone matrices.
+    uint32_t AnimatorCount = 0;
+};
+
 class Scene final : private Uncopyable, private Unmovable
 {
   public:
@@ -19,13 +29,78 @@ class Scene final : private Uncopyable, private Unmovable
     Entity CreateEntityWithUUID(UUID uuid, const std::string& name = "Entity");
     void DestroyEntity(Entity entity);
 
+    // Parent can be an empty entity, which makes the entity a root. Local transform is kept as is.
+    void SetParent(Entity entity, Entity parent);
+    void MarkTransformDirty(Entity entity);
+    void UpdateWorldTransforms();
+
     void OnUpdate(const float deltaTime);
 
+    template <typename... Components> FORCEINLINE auto GetAllEntitiesWith() { return m_Registry.view<Components...>(); }
+
     FORCEINLINE const auto& GetName() const { return m_Name; }
+    FORCEINLINE const auto& GetStats() const { return m_Stats; }
 
   private:
+    struct TransformHierarchyNode
+    {
+        entt::entity Handle  = entt::null;
+        uint32_t ParentIndex = UINT32_MAX;
+        uint32_t SubtreeSize = 1;  // Node itself && all of its descendants, they follow it in depth-first order.
+    };
+
+    // Extracted by job system workers, submitted to renderer on the calling thread, since renderer isn't thread-safe.
+    struct RenderPacketList
+    {
+        struct MeshPacket
+        {
+            const Ref<Mesh>* Mesh = nullptr;  // Points into MeshComponent, registry isn't modified until packets are merged.
+            glm::mat4 Transform{1.0f};
+            const std::vector<glm::mat4>* BoneMatrices = nullptr;  // Animator's palette, null for meshes drawn as is.
+        };
+
+        struct SpritePacket
+        {
+            glm::mat4 Transform{1.0f};
+            glm::vec4 Color{1.0f};
+        };
+
+        struct PointLightPacket
+        {
+            glm::vec3 Position{0.0f};
+            glm::vec3 Color{0.0f};
+            float Intensity   = 1.0f;
+            bool bIsActive    = true;
+            bool bCastShadows = false;
+        };
+
+        std::vector<MeshPacket> Meshes;
+        std::vector<SpritePacket> Sprites;
+        std::vector<PointLightPacket> PointLights;
+    };
+
     entt::registry m_Registry;
     std::string m_Name;
+    SceneStats m_Stats;
+
+    std::vector<RenderPacketList> m_RenderPacketLists;  // One per extraction job, kept between frames to reuse their capacity.
+
+    // Depth-first order, so parents come before children && every subtree is a contiguous range.
+    std::vector<TransformHierarchyNode> m_TransformHierarchy;
+    std::vector<glm::mat4> m_WorldTransforms;  // Parallel to m_TransformHierarchy, parents are read from here instead of registry.
+    std::vector<entt::entity> m_DirtyTransforms;
+    std::vector<uint32_t> m_DirtyTransformIndices;  // Scratch, reused every update.
+    bool m_bTransformHierarchyChanged = true;
+
+    std::vector<std::pair<Animator*, float>> m_ActiveAnimators;  // Scratch, animator && its scaled delta time.
+
+    void RebuildTransformHierarchy();
+    void UpdateTransformRange(const uint32_t first, const uint32_t count);
+    void UnlinkFromParent(entt::entity entity);
+
+    void UpdateAnimations(const float deltaTime);
+    void ExtractRenderPackets(const float deltaTime);
+    void SubmitRenderPackets();
 
     // Specify classes that have public access to Scene class properties
     friend class Entity;
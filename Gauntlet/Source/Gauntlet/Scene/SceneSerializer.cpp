@@ -2,19 +2,20 @@
 #include "SceneSerializer.h"
 
 #include "Gauntlet/Core/Timer.h"
-#include "Gauntlet/Core/JobSystem.h"
+#include "Gauntlet/Core/Profiler.h"
 
 #include "Scene.h"
 #include "Entity.h"
 #include "Components.h"
 
 #include <fstream>
+#include <charconv>
 #include <nlohmann/json.hpp>
 
 namespace Gauntlet
 {
 
-static void SerializeEntity(nlohmann::ordered_json& out, Entity entity)
+static void SerializeEntity(nlohmann::ordered_json& out, Entity entity, Scene* scene)
 {
     GNT_ASSERT(entity.HasComponent<IDComponent>(), "Every entity should have ID!");
 
@@ -33,10 +34,18 @@ static void SerializeEntity(nlohmann::ordered_json& out, Entity entity)
         auto& tc = entity.GetComponent<TransformComponent>();
         node["TransformComponent"].emplace("Translation",
                                            std::initializer_list<float>({tc.Translation.x, tc.Translation.y, tc.Translation.z}));
-        node["TransformComponent"].emplace("Rotation", std::initializer_list<float>({tc.Rotation.x, tc.Rotation.y, tc.Rotation.z}));
+        const glm::vec3 rotation = tc.GetEulerAngles();
+        node["TransformComponent"].emplace("Rotation", std::initializer_list<float>({rotation.x, rotation.y, rotation.z}));
         node["TransformComponent"].emplace("Scale", std::initializer_list<float>({tc.Scale.x, tc.Scale.y, tc.Scale.z}));
     }
 
+    if (entity.HasComponent<RelationshipComponent>())
+    {
+        auto& rc = entity.GetComponent<RelationshipComponent>();
+        if (rc.Parent != entt::null)
+            node["RelationshipComponent"].emplace("Parent", static_cast<uint64_t>(Entity(rc.Parent, scene).GetUUID()));
+    }
+
     if (entity.HasComponent<SpriteRendererComponent>())
     {
         auto& src = entity.GetComponent<SpriteRendererComponent>();
@@ -56,12 +65,22 @@ static void SerializeEntity(nlohmann::ordered_json& out, Entity entity)
         node["MeshComponent"].emplace("Name", mc.Mesh->GetMeshNameWithDirectory());
     }
 
+    if (entity.HasComponent<AnimatorComponent>())
+    {
+        auto& ac = entity.GetComponent<AnimatorComponent>();
+        node["AnimatorComponent"].emplace("AnimationIndex", ac.AnimationIndex);
+        node["AnimatorComponent"].emplace("PlaybackSpeed", ac.PlaybackSpeed);
+        node["AnimatorComponent"].emplace("CrossFadeDuration", ac.CrossFadeDuration);
+        node["AnimatorComponent"].emplace("Playing", ac.bIsPlaying);
+    }
+
     if (entity.HasComponent<PointLightComponent>())
     {
         auto& plc = entity.GetComponent<PointLightComponent>();
         node["PointLightComponent"].emplace("Color", std::initializer_list<float>({plc.Color.x, plc.Color.y, plc.Color.z}));
         node["PointLightComponent"].emplace("Intensity", plc.Intensity);
         node["PointLightComponent"].emplace("Active", plc.bIsActive);
+        node["PointLightComponent"].emplace("CastShadows", plc.bCastShadows);
     }
 
     if (entity.HasComponent<DirectionalLightComponent>())
@@ -80,12 +99,299 @@ static void SerializeEntity(nlohmann::ordered_json& out, Entity entity)
         node["SpotLightComponent"].emplace("CutOff", slc.CutOff);
         node["SpotLightComponent"].emplace("OuterCutOff", slc.OuterCutOff);
         node["SpotLightComponent"].emplace("Active", slc.bIsActive);
+        node["SpotLightComponent"].emplace("CastShadows", slc.bCastShadows);
+    }
+    if (entity.HasComponent<ParticleEmitterComponent>())
+    {
+        auto& pec   = entity.GetComponent<ParticleEmitterComponent>();
+        auto& pnode = node["ParticleEmitterComponent"];
+        pnode.emplace("StartColor", std::initializer_list<float>({pec.StartColor.x, pec.StartColor.y, pec.StartColor.z, pec.StartColor.w}));
+        pnode.emplace("EndColor", std::initializer_list<float>({pec.EndColor.x, pec.EndColor.y, pec.EndColor.z, pec.EndColor.w}));
+        pnode.emplace("Velocity", std::initializer_list<float>({pec.Velocity.x, pec.Velocity.y, pec.Velocity.z}));
+        pnode.emplace("VelocityVariation",
+                      std::initializer_list<float>({pec.VelocityVariation.x, pec.VelocityVariation.y, pec.VelocityVariation.z}));
+        pnode.emplace("BoundsExtent", std::initializer_list<float>({pec.BoundsExtent.x, pec.BoundsExtent.y, pec.BoundsExtent.z}));
+        pnode.emplace("SpawnRate", pec.SpawnRate);
+        pnode.emplace("Lifetime", pec.Lifetime);
+        pnode.emplace("StartSize", pec.StartSize);
+        pnode.emplace("EndSize", pec.EndSize);
+        pnode.emplace("Active", pec.bIsActive);
+    }
+}
+
+/*
+ * Runtime scene layout, values are stored as is, so files are only portable between little-endian machines:
+ *   RuntimeSceneHeader
+ *   String table - uint32 length && characters per string, scene name, tags && asset paths are stored once.
+ *   Entity table - UUIDs, tag string indices && parent entity indices, each one as a separate array.
+ *   Asset table  - RuntimeAssetRecord per unique asset, components reference assets by their IDs.
+ *   Chunks       - RuntimeChunkHeader, entity indices && packed records of a single component type.
+ * Chunk headers carry record size, so chunks of unknown types are skipped.
+ */
+static constexpr uint32_t s_RUNTIME_SCENE_MAGIC   = 0x53544E47;  // "GNTS"
+static constexpr uint32_t s_RUNTIME_SCENE_VERSION = 1;
+static constexpr uint32_t s_INVALID_INDEX         = std::numeric_limits<uint32_t>::max();
+
+struct RuntimeSceneHeader
+{
+    uint32_t Magic       = s_RUNTIME_SCENE_MAGIC;
+    uint32_t Version     = s_RUNTIME_SCENE_VERSION;
+    uint32_t SceneName   = 0;  // Into string table.
+    uint32_t StringCount = 0;
+    uint32_t EntityCount = 0;
+    uint32_t AssetCount  = 0;
+    uint32_t ChunkCount  = 0;
+};
+
+enum class ERuntimeAssetType : uint32_t
+{
+    RUNTIME_ASSET_TYPE_MESH = 0,
+};
+
+struct RuntimeAssetRecord
+{
+    uint64_t ID            = 0;  // FNV-1a of path, stays the same between saves.
+    uint32_t Path          = 0;  // Into string table, relative to "Resources/Models/".
+    ERuntimeAssetType Type = ERuntimeAssetType::RUNTIME_ASSET_TYPE_MESH;
+};
+
+enum class ERuntimeChunkType : uint32_t
+{
+    RUNTIME_CHUNK_TYPE_TRANSFORM = 0,
+    RUNTIME_CHUNK_TYPE_SPRITE_RENDERER,
+    RUNTIME_CHUNK_TYPE_MESH,
+    RUNTIME_CHUNK_TYPE_ANIMATOR,
+    RUNTIME_CHUNK_TYPE_POINT_LIGHT,
+    RUNTIME_CHUNK_TYPE_DIRECTIONAL_LIGHT,
+    RUNTIME_CHUNK_TYPE_SPOT_LIGHT,
+    RUNTIME_CHUNK_TYPE_PARTICLE_EMITTER,
+    RUNTIME_CHUNK_TYPE_CAMERA,  // Added after the others, so existing values && files stay valid.
+};
+
+struct RuntimeChunkHeader
+{
+    ERuntimeChunkType Type = ERuntimeChunkType::RUNTIME_CHUNK_TYPE_TRANSFORM;
+    uint32_t RecordCount   = 0;
+    uint32_t RecordSize    = 0;
+};
+
+// Records hold serialized fields only, they are written && read as plain memory.
+struct TransformRecord
+{
+    glm::vec3 Translation;
+    glm::quat Rotation;  // Stored as is, text scenes go through euler angles.
+    glm::vec3 Scale;
+};
+
+struct SpriteRendererRecord
+{
+    glm::vec4 Color;
+};
+
+struct MeshRecord
+{
+    uint64_t AssetID;
+};
+
+struct AnimatorRecord
+{
+    uint32_t AnimationIndex;
+    float PlaybackSpeed;
+    float CrossFadeDuration;
+    uint32_t bIsPlaying;
+};
+
+struct PointLightRecord
+{
+    glm::vec3 Color;
+    float Intensity;
+    uint32_t bIsActive;
+    uint32_t bCastShadows;
+};
+
+struct DirectionalLightRecord
+{
+    glm::vec3 Color;
+    float Intensity;
+    uint32_t bCastShadows;
+};
+
+struct SpotLightRecord
+{
+    glm::vec3 Color;
+    float Intensity;
+    float CutOff;
+    float OuterCutOff;
+    uint32_t bIsActive;
+    uint32_t bCastShadows;
+};
+
+struct ParticleEmitterRecord
+{
+    glm::vec4 StartColor;
+    glm::vec4 EndColor;
+    glm::vec3 Velocity;
+    glm::vec3 VelocityVariation;
+    glm::vec3 BoundsExtent;
+    float SpawnRate;
+    float Lifetime;
+    float StartSize;
+    float EndSize;
+    uint32_t bIsActive;
+};
+
+struct CameraRecord
+{
+    uint32_t bIsActive;
+};
+
+static uint64_t GetAssetID(const std::string& path)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const char c : path)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+class RuntimeSceneWriter final
+{
+  public:
+    template <typename T> void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        WriteBytes(&value, sizeof(T));
+    }
+
+    template <typename T> void WriteArray(const std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        WriteBytes(values.data(), values.size() * sizeof(T));
+    }
+
+    void WriteBytes(const void* data, const size_t size)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        m_Data.insert(m_Data.end(), bytes, bytes + size);
+    }
+
+    FORCEINLINE const auto& GetData() const { return m_Data; }
+
+  private:
+    std::vector<uint8_t> m_Data;
+};
+
+// Every read is bounds checked, truncated || corrupted files fail to load instead of reading past the end.
+class RuntimeSceneReader final
+{
+  public:
+    RuntimeSceneReader(const std::vector<uint8_t>& data) : m_Data(data) {}
+
+    template <typename T> bool Read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return ReadBytes(&value, sizeof(T));
+    }
+
+    template <typename T> bool ReadArray(std::vector<T>& values, const size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (count > GetRemainingSize() / sizeof(T)) return false;
+
+        values.resize(count);
+        return ReadBytes(values.data(), count * sizeof(T));
+    }
+
+    bool ReadString(std::string& string)
+    {
+        uint32_t length = 0;
+        if (!Read(length) || length > GetRemainingSize()) return false;
+
+        string.assign(reinterpret_cast<const char*>(m_Data.data() + m_Offset), length);
+        m_Offset += length;
+        return true;
+    }
+
+    bool ReadBytes(void* data, const size_t size)
+    {
+        if (size > GetRemainingSize()) return false;
+
+        if (size > 0) std::memcpy(data, m_Data.data() + m_Offset, size);
+        m_Offset += size;
+        return true;
+    }
+
+    bool Skip(const size_t size)
+    {
+        if (size > GetRemainingSize()) return false;
+
+        m_Offset += size;
+        return true;
+    }
+
+    FORCEINLINE size_t GetRemainingSize() const { return m_Data.size() - m_Offset; }
+
+  private:
+    const std::vector<uint8_t>& m_Data;
+    size_t m_Offset = 0;
+};
+
+// Gathers records of every entity having the component, recordFunc may reject a component by returning false.
+template <typename Component, typename Record, typename RecordFunc>
+static void WriteChunk(RuntimeSceneWriter& writer, uint32_t& chunkCount, entt::registry& registry,
+                       const std::unordered_map<entt::entity, uint32_t>& entityIndices, const ERuntimeChunkType type,
+                       RecordFunc&& recordFunc)
+{
+    std::vector<uint32_t> indices;
+    std::vector<Record> records;
+    for (const auto entityID : registry.view<Component>())
+    {
+        Record record = {};
+        if (!recordFunc(registry.get<Component>(entityID), record)) continue;
+
+        indices.push_back(entityIndices.at(entityID));
+        records.push_back(record);
+    }
+
+    if (records.empty()) return;
+
+    RuntimeChunkHeader chunkHeader = {};
+    chunkHeader.Type               = type;
+    chunkHeader.RecordCount        = static_cast<uint32_t>(records.size());
+    chunkHeader.RecordSize         = sizeof(Record);
+
+    writer.Write(chunkHeader);
+    writer.WriteArray(indices);
+    writer.WriteArray(records);
+    ++chunkCount;
+}
+
+template <typename Record, typename ApplyFunc>
+static bool ReadChunk(RuntimeSceneReader& reader, const RuntimeChunkHeader& chunkHeader, const std::vector<Entity>& entities,
+                      ApplyFunc&& applyFunc)
+{
+    std::vector<uint32_t> indices;
+    std::vector<Record> records;
+    if (!reader.ReadArray(indices, chunkHeader.RecordCount) || !reader.ReadArray(records, chunkHeader.RecordCount)) return false;
+
+    // Writer stores each entity once per chunk, a repeated one would make applyFunc add its component twice.
+    std::vector<bool> seenEntities(entities.size(), false);
+    for (uint32_t i = 0; i < chunkHeader.RecordCount; ++i)
+    {
+        if (indices[i] >= entities.size() || seenEntities[indices[i]]) return false;
+
+        seenEntities[indices[i]] = true;
+        applyFunc(entities[indices[i]], records[i]);
     }
+
+    return true;
 }
 
 SceneSerializer::SceneSerializer(Ref<Scene>& scene) : m_Scene(scene) {}
 
-void SceneSerializer::Serialize(const std::string& filePath)
+void SceneSerializer::Serialize(const std::string& filePath, const bool bPrettyPrint)
 {
     const auto serializeBegin = Timer::Now();
 
@@ -98,7 +404,7 @@ void SceneSerializer::Serialize(const std::string& filePath)
         [&](auto entityID)
         {
             Entity entity(entityID, m_Scene.get());
-            SerializeEntity(entities_node, entity);
+            SerializeEntity(entities_node, entity, m_Scene.get());
         });
 
     std::ofstream out(filePath.data(), std::ios::out | std::ios::trunc);
@@ -108,7 +414,8 @@ void SceneSerializer::Serialize(const std::string& filePath)
         return;
     }
 
-    out << std::setw(2) << json << std::endl;
+    // Without indentation && line breaks large scenes get several times smaller, reader doesn't care about whitespace.
+    out << json.dump(bPrettyPrint ? 2 : -1) << std::endl;
     out.close();
 
     const auto serializeEnd = Timer::Now();
@@ -117,149 +424,871 @@ void SceneSerializer::Serialize(const std::string& filePath)
 
 void SceneSerializer::SerializeRuntime(const std::string& filePath)
 {
-    GNT_ASSERT(false, "Not implmented!");
+    GNT_PROFILE_FUNCTION();
+
+    const auto serializeBegin = Timer::Now();
+    auto& registry            = m_Scene->m_Registry;
+
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringIndices;
+    const auto addString = [&](const std::string& string)
+    {
+        const auto [it, bInserted] = stringIndices.try_emplace(string, static_cast<uint32_t>(strings.size()));
+        if (bInserted) strings.push_back(string);
+        return it->second;
+    };
+
+    RuntimeSceneHeader header = {};
+    header.SceneName          = addString(m_Scene->GetName());
+
+    // Entities are referred to by their position in the table, chunks && parent links store these indices.
+    std::vector<entt::entity> entityIDs;
+    std::unordered_map<entt::entity, uint32_t> entityIndices;
+    registry.each(
+        [&](const auto entityID)
+        {
+            entityIndices.emplace(entityID, static_cast<uint32_t>(entityIDs.size()));
+            entityIDs.push_back(entityID);
+        });
+
+    std::vector<uint64_t> uuids;
+    std::vector<uint32_t> tags;
+    std::vector<uint32_t> parents;
+    uuids.reserve(entityIDs.size());
+    tags.reserve(entityIDs.size());
+    parents.reserve(entityIDs.size());
+    for (const auto entityID : entityIDs)
+    {
+        Entity entity(entityID, m_Scene.get());
+        GNT_ASSERT(entity.HasComponent<IDComponent>(), "Every entity should have ID!");
+
+        uuids.push_back(entity.GetUUID());
+        tags.push_back(addString(entity.HasComponent<TagComponent>() ? entity.GetComponent<TagComponent>().Tag : "Entity"));
+
+        const auto* rc = registry.try_get<RelationshipComponent>(entityID);
+        parents.push_back(rc && rc->Parent != entt::null ? entityIndices.at(rc->Parent) : s_INVALID_INDEX);
+    }
+
+    // Meshes shared by many entities are stored && later loaded once.
+    std::vector<RuntimeAssetRecord> assets;
+    std::unordered_set<uint64_t> assetIDs;
+
+    RuntimeSceneWriter chunkWriter;
+    WriteChunk<TransformComponent, TransformRecord>(chunkWriter, header.ChunkCount, registry, entityIndices,
+                                                    ERuntimeChunkType::RUNTIME_CHUNK_TYPE_TRANSFORM,
+                                                    [](const auto& tc, auto& record)
+                                                    {
+                                                        record = {tc.Translation, tc.Rotation, tc.Scale};
+                                                        return true;
+                                                    });
+
+    WriteChunk<SpriteRendererComponent, SpriteRendererRecord>(chunkWriter, header.ChunkCount, registry, entityIndices,
+                                                              ERuntimeChunkType::RUNTIME_CHUNK_TYPE_SPRITE_RENDERER,
+                                                              [](const auto& src, auto& record)
+                                                              {
+                                                                  record = {src.Color};
+                                                                  return true;
+                                                              });
+
+    WriteChunk<MeshComponent, MeshRecord>(chunkWriter, header.ChunkCount, registry, entityIndices,
+                                          ERuntimeChunkType::RUNTIME_CHUNK_TYPE_MESH,
+                                          [&](const auto& mc, auto& record)
+                                          {
+                                              if (!mc.Mesh) return false;
+
+                                              const std::string& path = mc.Mesh->GetMeshNameWithDirectory();
+                                              record                  = {GetAssetID(path)};
+                                              if (assetIDs.insert(record.AssetID).second)
+                                              {
+                                                  assets.push_back(
+                                                      {record.AssetID, addString(path), ERuntimeAssetType::RUNTIME_ASSET_TYPE_MESH});
+                                              }
+                                              return true;
+                                          });
+
+    WriteChunk<AnimatorComponent, AnimatorRecord>(chunkWriter, header.ChunkCount, registry, entityIndices,
+                                                  ERuntimeChunkType::RUNTIME_CHUNK_TYPE_ANIMATOR,
+                                                  [](const auto& ac, auto& record)
+                                                  {
+                                                      record = {ac.AnimationIndex, ac.PlaybackSpeed, ac.CrossFadeDuration, ac.bIsPlaying};
+                                                      return true;
+                                                  });
+
+    WriteChunk<PointLightComponent, PointLightRecord>(chunkWriter, header.ChunkCount, registry, entityIndices,
+                                                      ERuntimeChunkType::RUNTIME_CHUNK_TYPE_POINT_LIGHT,
+                                                      [](const auto& plc, auto& record)
+                                                      {
+                                                          record = {plc.Color, plc.Intensity, plc.bIsActive, plc.bCastShadows};
+                                                          return true;
+                                                      });
+
+    WriteChunk<DirectionalLightComponent, DirectionalLightRecord>(chunkWriter, header.ChunkCount, registry, entityIndices,
+                                                                  ERuntimeChunkType::RUNTIME_CHUNK_TYPE_DIRECTIONAL_LIGHT,
+                                                                  [](const auto& dlc, auto& record)
+                                                                  {
+                                                                      record = {dlc.Color, dlc.Intensity, dlc.bCastShadows};
+                                                                      return true;
+                                                                  });
+
+    WriteChunk<SpotLightComponent, SpotLightRecord>(chunkWriter, header.ChunkCount, registry, entityIndices,
+                                                    ERuntimeChunkType::RUNTIME_CHUNK_TYPE_SPOT_LIGHT,
+                                                    [](const auto& slc, auto& record)
+                                                    {
+                                                        record = {slc.Color,       slc.Intensity, slc.CutOff,
+                                                                  slc.OuterCutOff, slc.bIsActive, slc.bCastShadows};
+                                                        return true;
+                                                    });
+
+    WriteChunk<ParticleEmitterComponent, ParticleEmitterRecord>(
+        chunkWriter, header.ChunkCount, registry, entityIndices, ERuntimeChunkType::RUNTIME_CHUNK_TYPE_PARTICLE_EMITTER,
+        [](const auto& pec, auto& record)
+        {
+            record = {pec.StartColor, pec.EndColor,  pec.Velocity,  pec.VelocityVariation, pec.BoundsExtent,
+                      pec.SpawnRate,  pec.Lifetime, pec.StartSize, pec.EndSize,           pec.bIsActive};
+            return true;
+        });
+
+    WriteChunk<CameraComponent, CameraRecord>(chunkWriter, header.ChunkCount, registry, entityIndices,
+                                              ERuntimeChunkType::RUNTIME_CHUNK_TYPE_CAMERA,
+                                              [](const auto& cc, auto& record)
+                                              {
+                                                  record = {cc.bIsActive};
+                                                  return true;
+                                              });
+
+    header.StringCount = static_cast<uint32_t>(strings.size());
+    header.EntityCount = static_cast<uint32_t>(entityIDs.size());
+    header.AssetCount  = static_cast<uint32_t>(assets.size());
+
+    RuntimeSceneWriter writer;
+    writer.Write(header);
+    for (const auto& string : strings)
+    {
+        writer.Write(static_cast<uint32_t>(string.size()));
+        writer.WriteBytes(string.data(), string.size());
+    }
+
+    writer.WriteArray(uuids);
+    writer.WriteArray(tags);
+    writer.WriteArray(parents);
+    writer.WriteArray(assets);
+    writer.WriteBytes(chunkWriter.GetData().data(), chunkWriter.GetData().size());
+
+    std::ofstream out(filePath.data(), std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out.is_open())
+    {
+        LOG_WARN("Failed to serialize runtime scene! %s", filePath.data());
+        return;
+    }
+
+    out.write(reinterpret_cast<const char*>(writer.GetData().data()), writer.GetData().size());
+    out.close();
+
+    const auto serializeEnd = Timer::Now();
+    LOG_WARN("Time took to serialize runtime \"%s\", %zu bytes, (%0.2f) ms.", filePath.data(), writer.GetData().size(),
+             (serializeEnd - serializeBegin) * 1000.0f);
 }
 
-bool SceneSerializer::Deserialize(const std::string& filePath)
+/*
+ * Text scenes are read as a stream of SAX events, components are filled right as their values arrive, so no DOM is built.
+ * Layout: {"Scene": name, "Entities": {UUID: {ComponentName: {Field: value or array of values}}}}, TagComponent is a plain string.
+ * Names are resolved once per key, unknown components && fields are skipped.
+ */
+class SceneJsonReader final : public nlohmann::json_sax<nlohmann::json>
 {
-    const auto deserializeBegin = Timer::Now();
+  public:
+    SceneJsonReader(const Ref<Scene>& scene) : m_Scene(scene) {}
+    ~SceneJsonReader() = default;
 
-    std::ifstream in(filePath.data());
-    if (!in.is_open())
+    FORCEINLINE const auto& GetSceneName() const { return m_SceneName; }
+    FORCEINLINE const auto& GetEntitiesByUUID() const { return m_EntitiesByUUID; }
+    FORCEINLINE const auto& GetParentLinks() const { return m_ParentLinks; }
+
+    bool null() final override { return true; }
+    bool boolean(bool value) final override
     {
-        LOG_WARN("Failed to open scene! %s", filePath.data());
+        if (IsFieldValue() && m_Field.Type == EFieldType::FIELD_TYPE_BOOL) *static_cast<bool*>(m_Field.Target) = value;
+        return true;
+    }
+
+    bool number_integer(number_integer_t value) final override
+    {
+        return OnNumber(static_cast<double>(value), value > 0 ? static_cast<uint64_t>(value) : 0);
+    }
+    bool number_unsigned(number_unsigned_t value) final override { return OnNumber(static_cast<double>(value), value); }
+    bool number_float(number_float_t value, const string_t&) final override
+    {
+        return OnNumber(value, value > 0.0 ? static_cast<uint64_t>(value) : 0);
+    }
+
+    bool string(string_t& value) final override;
+    bool binary(binary_t&) final override { return true; }
+
+    bool start_object(std::size_t) final override;
+    bool end_object() final override;
+    bool start_array(std::size_t) final override
+    {
+        ++m_Depth;
+        return true;
+    }
+    bool end_array() final override
+    {
+        --m_Depth;
+        return true;
+    }
+
+    bool key(string_t& value) final override;
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& exception) final override
+    {
+        LOG_WARN("Failed to parse scene at %zu: %s", position, exception.what());
         return false;
     }
 
-    const nlohmann::ordered_json json = nlohmann::json::parse(in);
-    in.close();
+  private:
+    // Depth of containers that hold each part of the scene, field arrays are one level deeper.
+    static constexpr uint32_t s_ROOT_DEPTH      = 1;
+    static constexpr uint32_t s_ENTITIES_DEPTH  = 2;
+    static constexpr uint32_t s_ENTITY_DEPTH    = 3;
+    static constexpr uint32_t s_COMPONENT_DEPTH = 4;
 
-    std::string sceneName     = json["Scene"];
-    const size_t slashPos     = filePath.find_last_of("/\\");
-    const size_t extensionPos = filePath.find_last_of('.');
+    enum class ERootKey : uint8_t
+    {
+        ROOT_KEY_NONE = 0,
+        ROOT_KEY_SCENE,
+        ROOT_KEY_ENTITIES
+    };
 
-    if (sceneName == "Default" && slashPos != std::string::npos && extensionPos != std::string::npos)
-        sceneName = std::string(filePath.begin() + slashPos + 1, filePath.begin() + extensionPos);
+    enum class EComponentType : uint8_t
+    {
+        COMPONENT_TYPE_NONE = 0,
+        COMPONENT_TYPE_TAG,
+        COMPONENT_TYPE_TRANSFORM,
+        COMPONENT_TYPE_RELATIONSHIP,
+        COMPONENT_TYPE_CAMERA,
+        COMPONENT_TYPE_SPRITE_RENDERER,
+        COMPONENT_TYPE_MESH,
+        COMPONENT_TYPE_ANIMATOR,
+        COMPONENT_TYPE_POINT_LIGHT,
+        COMPONENT_TYPE_DIRECTIONAL_LIGHT,
+        COMPONENT_TYPE_SPOT_LIGHT,
+        COMPONENT_TYPE_PARTICLE_EMITTER
+    };
 
-    m_Scene = MakeRef<Scene>(sceneName);
+    enum class EFieldType : uint8_t
+    {
+        FIELD_TYPE_NONE = 0,
+        FIELD_TYPE_FLOAT,
+        FIELD_TYPE_UINT32,
+        FIELD_TYPE_UINT64,
+        FIELD_TYPE_BOOL,
+        FIELD_TYPE_MESH  // Path relative to models directory, resolved into a mesh shared by every entity that references it.
+    };
 
-    nlohmann::json entities = json["Entities"];
-    for (auto& item : entities.items())
+    // Where values of the current field go, arrays fill up to Count consecutive values.
+    struct FieldBinding
     {
-        const nlohmann::json& node = item.value();
+        EFieldType Type = EFieldType::FIELD_TYPE_NONE;
+        void* Target    = nullptr;
+        uint32_t Count  = 0;
+    };
 
-        const std::string tag = node["TagComponent"].get<std::string>();
-        const uint64_t id     = std::stoull(item.key());
-        Entity entity         = m_Scene->CreateEntityWithUUID(id, tag);
+    Ref<Scene> m_Scene = nullptr;
+    std::string m_SceneName;
+    std::unordered_map<uint64_t, Entity> m_EntitiesByUUID;
+    std::vector<std::pair<Entity, uint64_t>> m_ParentLinks;  // Parents may come after their children.
+    std::unordered_map<std::string, Ref<Mesh>> m_Meshes;
 
-        {
-            auto& tc                         = entity.GetComponent<TransformComponent>();
-            std::array<float, 3> translation = node["TransformComponent"]["Translation"].get<std::array<float, 3>>();
-            tc.Translation                   = glm::vec3(translation[0], translation[1], translation[2]);
+    uint32_t m_Depth        = 0;
+    ERootKey m_RootKey      = ERootKey::ROOT_KEY_NONE;
+    bool m_bIsInEntities    = false;
+    Entity m_Entity         = {};
+    EComponentType m_Type   = EComponentType::COMPONENT_TYPE_NONE;
+    void* m_Component       = nullptr;
+    FieldBinding m_Field    = {};
+    uint32_t m_ValueIndex   = 0;
+    glm::vec3 m_EulerAngles = glm::vec3(0.0f);  // (degrees) Rotation is stored as euler angles, it's converted once component ends.
+    bool m_bHasEulerAngles  = false;
+    uint64_t m_ParentID     = 0;
+    bool m_bHasParent       = false;
 
-            std::array<float, 3> rotation = node["TransformComponent"]["Rotation"].get<std::array<float, 3>>();
-            tc.Rotation                   = glm::vec3(rotation[0], rotation[1], rotation[2]);
+    // Scalars are values of component fields, array elements are one level deeper.
+    FORCEINLINE bool IsFieldValue() const
+    {
+        return m_bIsInEntities && m_Component && (m_Depth == s_COMPONENT_DEPTH || m_Depth == s_COMPONENT_DEPTH + 1);
+    }
 
-            std::array<float, 3> scale = node["TransformComponent"]["Scale"].get<std::array<float, 3>>();
-            tc.Scale                   = glm::vec3(scale[0], scale[1], scale[2]);
-        }
+    bool OnNumber(const double floatValue, const uint64_t integerValue);
+    void BeginComponent();
+    void EndComponent();
+    FieldBinding ResolveField(const std::string& name);
+    static EComponentType ResolveComponentType(const std::string& name);
+};
+
+bool SceneJsonReader::OnNumber(const double floatValue, const uint64_t integerValue)
+{
+    if (!IsFieldValue() || m_ValueIndex >= m_Field.Count) return true;
+
+    switch (m_Field.Type)
+    {
+        case EFieldType::FIELD_TYPE_FLOAT: static_cast<float*>(m_Field.Target)[m_ValueIndex] = static_cast<float>(floatValue); break;
+        case EFieldType::FIELD_TYPE_UINT32:
+            static_cast<uint32_t*>(m_Field.Target)[m_ValueIndex] = static_cast<uint32_t>(integerValue);
+            break;
+        case EFieldType::FIELD_TYPE_UINT64: static_cast<uint64_t*>(m_Field.Target)[m_ValueIndex] = integerValue; break;
+        default: break;
+    }
+
+    ++m_ValueIndex;
+    return true;
+}
+
+bool SceneJsonReader::string(string_t& value)
+{
+    if (m_Depth == s_ROOT_DEPTH && m_RootKey == ERootKey::ROOT_KEY_SCENE)
+    {
+        m_SceneName = std::move(value);
+        return true;
+    }
+
+    if (!m_bIsInEntities) return true;
+
+    if (m_Depth == s_ENTITY_DEPTH && m_Type == EComponentType::COMPONENT_TYPE_TAG)
+    {
+        m_Entity.GetComponent<TagComponent>().Tag = std::move(value);
+        return true;
+    }
+
+    if (IsFieldValue() && m_Field.Type == EFieldType::FIELD_TYPE_MESH)
+    {
+        auto& mesh = m_Meshes[value];
+        if (!mesh) mesh = Mesh::Create("Resources/Models/" + value);
+
+        *static_cast<Ref<Mesh>*>(m_Field.Target) = mesh;
+    }
+
+    return true;
+}
+
+bool SceneJsonReader::start_object(std::size_t)
+{
+    ++m_Depth;
+    if (m_Depth == s_ENTITIES_DEPTH && m_RootKey == ERootKey::ROOT_KEY_ENTITIES)
+        m_bIsInEntities = true;
+    else if (m_bIsInEntities && m_Depth == s_COMPONENT_DEPTH)
+        BeginComponent();
+
+    return true;
+}
+
+bool SceneJsonReader::end_object()
+{
+    if (m_bIsInEntities && m_Depth == s_COMPONENT_DEPTH) EndComponent();
+    if (m_Depth == s_ENTITIES_DEPTH) m_bIsInEntities = false;
+
+    --m_Depth;
+    return true;
+}
+
+bool SceneJsonReader::key(string_t& value)
+{
+    if (m_Depth == s_ROOT_DEPTH)
+    {
+        if (value == "Entities")
+            m_RootKey = ERootKey::ROOT_KEY_ENTITIES;
+        else if (value == "Scene")
+            m_RootKey = ERootKey::ROOT_KEY_SCENE;
+        else
+            m_RootKey = ERootKey::ROOT_KEY_NONE;
+        return true;
+    }
+
+    if (!m_bIsInEntities) return true;
+
+    switch (m_Depth)
+    {
+        case s_ENTITIES_DEPTH:
+        {
+            uint64_t id          = 0;
+            const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), id);
+            if (ec != std::errc() || ptr != value.data() + value.size())
+            {
+                LOG_WARN("Invalid entity UUID: \"%s\"!", value.data());
+                return false;
+            }
 
-        if (node.contains("SpriteRendererComponent"))
+            m_Entity             = m_Scene->CreateEntityWithUUID(id);
+            m_EntitiesByUUID[id] = m_Entity;
+            break;
+        }
+        case s_ENTITY_DEPTH: m_Type = ResolveComponentType(value); break;
+        case s_COMPONENT_DEPTH:
         {
-            auto& src                  = entity.AddComponent<SpriteRendererComponent>();
-            std::array<float, 4> color = node["SpriteRendererComponent"]["Color"].get<std::array<float, 4>>();
-            src.Color                  = glm::vec4(color[0], color[1], color[2], color[3]);
+            m_Field      = ResolveField(value);
+            m_ValueIndex = 0;
+            break;
         }
+    }
 
-        // TODO: Add camera component
-        // if (node.contains("CameraComponent"))
+    return true;
+}
 
-        if (node.contains("MeshComponent"))
+SceneJsonReader::EComponentType SceneJsonReader::ResolveComponentType(const std::string& name)
+{
+    static const std::unordered_map<std::string_view, EComponentType> s_ComponentTypes = {
+        {"TagComponent", EComponentType::COMPONENT_TYPE_TAG},
+        {"TransformComponent", EComponentType::COMPONENT_TYPE_TRANSFORM},
+        {"RelationshipComponent", EComponentType::COMPONENT_TYPE_RELATIONSHIP},
+        {"CameraComponent", EComponentType::COMPONENT_TYPE_CAMERA},
+        {"SpriteRendererComponent", EComponentType::COMPONENT_TYPE_SPRITE_RENDERER},
+        {"MeshComponent", EComponentType::COMPONENT_TYPE_MESH},
+        {"AnimatorComponent", EComponentType::COMPONENT_TYPE_ANIMATOR},
+        {"PointLightComponent", EComponentType::COMPONENT_TYPE_POINT_LIGHT},
+        {"DirectionalLightComponent", EComponentType::COMPONENT_TYPE_DIRECTIONAL_LIGHT},
+        {"SpotLightComponent", EComponentType::COMPONENT_TYPE_SPOT_LIGHT},
+        {"ParticleEmitterComponent", EComponentType::COMPONENT_TYPE_PARTICLE_EMITTER},
+    };
+
+    const auto it = s_ComponentTypes.find(name);
+    return it != s_ComponentTypes.end() ? it->second : EComponentType::COMPONENT_TYPE_NONE;
+}
+
+void SceneJsonReader::BeginComponent()
+{
+    m_Field = {};
+    switch (m_Type)
+    {
+        case EComponentType::COMPONENT_TYPE_TRANSFORM:
         {
-            auto& mc                 = entity.AddComponent<MeshComponent>();
-            std::string meshFilePath = node["MeshComponent"]["Name"].get<std::string>();
-            mc.Mesh                  = Mesh::Create("Resources/Models/" + meshFilePath);
+            m_Component       = &m_Entity.GetComponent<TransformComponent>();
+            m_EulerAngles     = glm::vec3(0.0f);
+            m_bHasEulerAngles = false;
+            break;
         }
-
-        if (node.contains("PointLightComponent"))
+        case EComponentType::COMPONENT_TYPE_RELATIONSHIP:
         {
-            auto& plc = entity.AddComponent<PointLightComponent>();
+            m_Component  = &m_Entity.GetComponent<RelationshipComponent>();
+            m_bHasParent = false;
+            break;
+        }
+        case EComponentType::COMPONENT_TYPE_CAMERA: m_Component = &m_Entity.AddComponent<CameraComponent>(); break;
+        case EComponentType::COMPONENT_TYPE_SPRITE_RENDERER: m_Component = &m_Entity.AddComponent<SpriteRendererComponent>(); break;
+        case EComponentType::COMPONENT_TYPE_MESH: m_Component = &m_Entity.AddComponent<MeshComponent>(); break;
+        case EComponentType::COMPONENT_TYPE_ANIMATOR: m_Component = &m_Entity.AddComponent<AnimatorComponent>(); break;
+        case EComponentType::COMPONENT_TYPE_POINT_LIGHT: m_Component = &m_Entity.AddComponent<PointLightComponent>(); break;
+        case EComponentType::COMPONENT_TYPE_DIRECTIONAL_LIGHT: m_Component = &m_Entity.AddComponent<DirectionalLightComponent>(); break;
+        case EComponentType::COMPONENT_TYPE_SPOT_LIGHT: m_Component = &m_Entity.AddComponent<SpotLightComponent>(); break;
+        case EComponentType::COMPONENT_TYPE_PARTICLE_EMITTER: m_Component = &m_Entity.AddComponent<ParticleEmitterComponent>(); break;
+        default: m_Component = nullptr; break;
+    }
+}
 
-            if (node["PointLightComponent"].contains("Color"))
-            {
-                std::array<float, 3> color = node["PointLightComponent"]["Color"].get<std::array<float, 3>>();
-                plc.Color                  = glm::vec3(color[0], color[1], color[2]);
-            }
+void SceneJsonReader::EndComponent()
+{
+    if (m_Type == EComponentType::COMPONENT_TYPE_TRANSFORM && m_bHasEulerAngles)
+        static_cast<TransformComponent*>(m_Component)->SetEulerAngles(m_EulerAngles);
+    else if (m_Type == EComponentType::COMPONENT_TYPE_RELATIONSHIP && m_bHasParent)
+        m_ParentLinks.emplace_back(m_Entity, m_ParentID);
 
-            if (node["PointLightComponent"].contains("Intensity"))
-            {
-                plc.Intensity = node["PointLightComponent"]["Intensity"].get<float>();
-            }
+    m_Component = nullptr;
+    m_Field     = {};
+}
+
+SceneJsonReader::FieldBinding SceneJsonReader::ResolveField(const std::string& name)
+{
+    if (!m_Component) return {};
+
+    const auto floats = [](float* target, const uint32_t count) { return FieldBinding{EFieldType::FIELD_TYPE_FLOAT, target, count}; };
+    const auto flag   = [](bool* target) { return FieldBinding{EFieldType::FIELD_TYPE_BOOL, target, 1}; };
 
-            if (node["PointLightComponent"].contains("Active"))
+    switch (m_Type)
+    {
+        case EComponentType::COMPONENT_TYPE_TRANSFORM:
+        {
+            auto* tc = static_cast<TransformComponent*>(m_Component);
+            if (name == "Translation") return floats(&tc->Translation.x, 3);
+            if (name == "Scale") return floats(&tc->Scale.x, 3);
+            if (name == "Rotation")
             {
-                plc.bIsActive = node["PointLightComponent"]["Active"].get<bool>();
+                m_bHasEulerAngles = true;
+                return floats(&m_EulerAngles.x, 3);
             }
+            break;
         }
+        case EComponentType::COMPONENT_TYPE_RELATIONSHIP:
+        {
+            if (name != "Parent") break;
 
-        if (node.contains("DirectionalLightComponent"))
+            m_bHasParent = true;
+            return {EFieldType::FIELD_TYPE_UINT64, &m_ParentID, 1};
+        }
+        case EComponentType::COMPONENT_TYPE_CAMERA:
         {
-            auto& dlc = entity.AddComponent<DirectionalLightComponent>();
+            auto* cc = static_cast<CameraComponent*>(m_Component);
+            if (name == "Active") return flag(&cc->bIsActive);
+            break;
+        }
+        case EComponentType::COMPONENT_TYPE_SPRITE_RENDERER:
+        {
+            auto* src = static_cast<SpriteRendererComponent*>(m_Component);
+            if (name == "Color") return floats(&src->Color.x, 4);
+            break;
+        }
+        case EComponentType::COMPONENT_TYPE_MESH:
+        {
+            auto* mc = static_cast<MeshComponent*>(m_Component);
+            if (name == "Name") return {EFieldType::FIELD_TYPE_MESH, &mc->Mesh, 1};
+            break;
+        }
+        case EComponentType::COMPONENT_TYPE_ANIMATOR:
+        {
+            auto* ac = static_cast<AnimatorComponent*>(m_Component);
+            if (name == "AnimationIndex") return {EFieldType::FIELD_TYPE_UINT32, &ac->AnimationIndex, 1};
+            if (name == "PlaybackSpeed") return floats(&ac->PlaybackSpeed, 1);
+            if (name == "CrossFadeDuration") return floats(&ac->CrossFadeDuration, 1);
+            if (name == "Playing") return flag(&ac->bIsPlaying);
+            break;
+        }
+        case EComponentType::COMPONENT_TYPE_POINT_LIGHT:
+        {
+            auto* plc = static_cast<PointLightComponent*>(m_Component);
+            if (name == "Color") return floats(&plc->Color.x, 3);
+            if (name == "Intensity") return floats(&plc->Intensity, 1);
+            if (name == "Active") return flag(&plc->bIsActive);
+            if (name == "CastShadows") return flag(&plc->bCastShadows);
+            break;
+        }
+        case EComponentType::COMPONENT_TYPE_DIRECTIONAL_LIGHT:
+        {
+            auto* dlc = static_cast<DirectionalLightComponent*>(m_Component);
+            if (name == "Color") return floats(&dlc->Color.x, 3);
+            if (name == "Intensity") return floats(&dlc->Intensity, 1);
+            if (name == "CastShadows") return flag(&dlc->bCastShadows);
+            break;
+        }
+        case EComponentType::COMPONENT_TYPE_SPOT_LIGHT:
+        {
+            auto* slc = static_cast<SpotLightComponent*>(m_Component);
+            if (name == "Color") return floats(&slc->Color.x, 3);
+            if (name == "Intensity") return floats(&slc->Intensity, 1);
+            if (name == "CutOff") return floats(&slc->CutOff, 1);
+            if (name == "OuterCutOff") return floats(&slc->OuterCutOff, 1);
+            if (name == "Active") return flag(&slc->bIsActive);
+            if (name == "CastShadows") return flag(&slc->bCastShadows);
+            break;
+        }
+        case EComponentType::COMPONENT_TYPE_PARTICLE_EMITTER:
+        {
+            auto* pec = static_cast<ParticleEmitterComponent*>(m_Component);
+            if (name == "StartColor") return floats(&pec->StartColor.x, 4);
+            if (name == "EndColor") return floats(&pec->EndColor.x, 4);
+            if (name == "Velocity") return floats(&pec->Velocity.x, 3);
+            if (name == "VelocityVariation") return floats(&pec->VelocityVariation.x, 3);
+            if (name == "BoundsExtent") return floats(&pec->BoundsExtent.x, 3);
+            if (name == "SpawnRate") return floats(&pec->SpawnRate, 1);
+            if (name == "Lifetime") return floats(&pec->Lifetime, 1);
+            if (name == "StartSize") return floats(&pec->StartSize, 1);
+            if (name == "EndSize") return floats(&pec->EndSize, 1);
+            if (name == "Active") return flag(&pec->bIsActive);
+            break;
+        }
+        default: break;
+    }
 
-            if (node["DirectionalLightComponent"].contains("Color"))
-            {
-                std::array<float, 3> color = node["DirectionalLightComponent"]["Color"].get<std::array<float, 3>>();
-                dlc.Color                  = glm::vec3(color[0], color[1], color[2]);
-            }
+    return {};
+}
 
-            if (node["DirectionalLightComponent"].contains("CastShadows"))
-            {
-                dlc.bCastShadows = node["DirectionalLightComponent"]["CastShadows"].get<bool>();
-            }
-        }
+bool SceneSerializer::Deserialize(const std::string& filePath)
+{
+    GNT_PROFILE_FUNCTION();
+
+    const auto deserializeBegin = Timer::Now();
 
-        if (node.contains("SpotLightComponent"))
+    std::ifstream in(filePath.data(), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+    {
+        LOG_WARN("Failed to open scene! %s", filePath.data());
+        return false;
+    }
+
+    // Parsed from memory, pulling characters one by one through the stream is way slower.
+    std::string text(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    in.read(text.data(), text.size());
+    in.close();
+
+    // Scene is swapped in only once the whole file is parsed, so the current one is kept on failure.
+    Ref<Scene> scene = MakeRef<Scene>();
+    SceneJsonReader reader(scene);
+    if (!nlohmann::json::sax_parse(text, &reader))
+    {
+        LOG_WARN("Failed to deserialize scene! %s", filePath.data());
+        return false;
+    }
+
+    std::string sceneName     = reader.GetSceneName();
+    const size_t slashPos     = filePath.find_last_of("/\\");
+    const size_t extensionPos = filePath.find_last_of('.');
+
+    if ((sceneName.empty() || sceneName == "Default") && slashPos != std::string::npos && extensionPos != std::string::npos)
+        sceneName = std::string(filePath.begin() + slashPos + 1, filePath.begin() + extensionPos);
+    if (!sceneName.empty()) scene->m_Name = sceneName;
+
+    const auto& entitiesByUUID = reader.GetEntitiesByUUID();
+    for (auto& [entity, parentID] : reader.GetParentLinks())
+    {
+        const auto parentIt = entitiesByUUID.find(parentID);
+        if (parentIt != entitiesByUUID.end()) scene->SetParent(entity, parentIt->second);
+    }
+    m_Scene = scene;
+
+    // Meshes keep streaming in background, entities are drawn with placeholders until they're published.
+    const auto deserializeEnd = Timer::Now();
+    LOG_WARN("Time took to deserialize \"%s\", (%0.2f) ms.", filePath.data(), (deserializeEnd - deserializeBegin) * 1000.0f);
+    return true;
+}
+
+bool SceneSerializer::DeserializeRuntime(const std::string& filePath)
+{
+    GNT_PROFILE_FUNCTION();
+
+    const auto deserializeBegin = Timer::Now();
+
+    std::ifstream in(filePath.data(), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+    {
+        LOG_WARN("Failed to open runtime scene! %s", filePath.data());
+        return false;
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(data.data()), data.size());
+    in.close();
+
+    RuntimeSceneReader reader(data);
+    RuntimeSceneHeader header = {};
+    if (!reader.Read(header) || header.Magic != s_RUNTIME_SCENE_MAGIC)
+    {
+        LOG_WARN("\"%s\" is not a runtime scene!", filePath.data());
+        return false;
+    }
+
+    if (header.Version != s_RUNTIME_SCENE_VERSION)
+    {
+        LOG_WARN("Runtime scene \"%s\" has version %u, expected %u!", filePath.data(), header.Version, s_RUNTIME_SCENE_VERSION);
+        return false;
+    }
+
+    const auto onCorrupted = [&]
+    {
+        LOG_WARN("Runtime scene \"%s\" is corrupted!", filePath.data());
+        return false;
+    };
+
+    if (header.StringCount > reader.GetRemainingSize() / sizeof(uint32_t)) return onCorrupted();
+
+    std::vector<std::string> strings(header.StringCount);
+    for (auto& string : strings)
+    {
+        if (!reader.ReadString(string)) return onCorrupted();
+    }
+
+    std::vector<uint64_t> uuids;
+    std::vector<uint32_t> tags;
+    std::vector<uint32_t> parents;
+    std::vector<RuntimeAssetRecord> assets;
+    if (!reader.ReadArray(uuids, header.EntityCount) || !reader.ReadArray(tags, header.EntityCount) ||
+        !reader.ReadArray(parents, header.EntityCount) || !reader.ReadArray(assets, header.AssetCount))
+        return onCorrupted();
+
+    const auto isValidString = [&](const uint32_t index) { return index < strings.size(); };
+    if (!isValidString(header.SceneName) || !std::all_of(tags.begin(), tags.end(), isValidString) ||
+        !std::all_of(assets.begin(), assets.end(), [&](const auto& asset) { return isValidString(asset.Path); }))
+        return onCorrupted();
+
+    // Built aside, so a corrupted file leaves the current scene untouched.
+    Ref<Scene> scene = MakeRef<Scene>(strings[header.SceneName]);
+
+    std::vector<Entity> entities;
+    entities.reserve(header.EntityCount);
+    for (uint32_t i = 0; i < header.EntityCount; ++i)
+        entities.push_back(scene->CreateEntityWithUUID(uuids[i], strings[tags[i]]));
+
+    // Every unique asset starts streaming once, entities referencing it share the result.
+    std::unordered_map<uint64_t, Ref<Mesh>> meshes;
+    for (const auto& asset : assets)
+    {
+        if (asset.Type == ERuntimeAssetType::RUNTIME_ASSET_TYPE_MESH)
+            meshes.try_emplace(asset.ID, Mesh::Create("Resources/Models/" + strings[asset.Path]));
+    }
+
+    // Every component type is written as a single chunk, so a repeated one is rejected as well.
+    std::unordered_set<uint32_t> chunkTypes;
+    for (uint32_t chunk = 0; chunk < header.ChunkCount; ++chunk)
+    {
+        RuntimeChunkHeader chunkHeader = {};
+        if (!reader.Read(chunkHeader) || !chunkTypes.insert(static_cast<uint32_t>(chunkHeader.Type)).second) return onCorrupted();
+
+        bool bIsRead = true;
+        switch (chunkHeader.Type)
         {
-            auto& slc = entity.AddComponent<SpotLightComponent>();
+            case ERuntimeChunkType::RUNTIME_CHUNK_TYPE_TRANSFORM:
+            {
+                if (chunkHeader.RecordSize != sizeof(TransformRecord)) return onCorrupted();
 
-            if (node["SpotLightComponent"].contains("Color"))
+                bIsRead = ReadChunk<TransformRecord>(reader, chunkHeader, entities,
+                                                     [](Entity entity, const auto& record)
+                                                     {
+                                                         auto& tc       = entity.GetComponent<TransformComponent>();
+                                                         tc.Translation = record.Translation;
+                                                         tc.Rotation    = record.Rotation;
+                                                         tc.Scale       = record.Scale;
+                                                     });
+                break;
+            }
+            case ERuntimeChunkType::RUNTIME_CHUNK_TYPE_SPRITE_RENDERER:
             {
-                std::array<float, 3> color = node["SpotLightComponent"]["Color"].get<std::array<float, 3>>();
-                slc.Color                  = glm::vec3(color[0], color[1], color[2]);
+                if (chunkHeader.RecordSize != sizeof(SpriteRendererRecord)) return onCorrupted();
+
+                bIsRead = ReadChunk<SpriteRendererRecord>(reader, chunkHeader, entities, [](Entity entity, const auto& record)
+                                                          { entity.AddComponent<SpriteRendererComponent>(record.Color); });
+                break;
             }
+            case ERuntimeChunkType::RUNTIME_CHUNK_TYPE_MESH:
+            {
+                if (chunkHeader.RecordSize != sizeof(MeshRecord)) return onCorrupted();
+
+                bIsRead = ReadChunk<MeshRecord>(reader, chunkHeader, entities,
+                                                [&](Entity entity, const auto& record)
+                                                {
+                                                    const auto meshIt = meshes.find(record.AssetID);
+                                                    if (meshIt == meshes.end())
+                                                    {
+                                                        LOG_WARN("Mesh asset %llu is missing from asset table!",
+                                                                 static_cast<unsigned long long>(record.AssetID));
+                                                        return;
+                                                    }
 
-            if (node["SpotLightComponent"].contains("Intensity"))
+                                                    entity.AddComponent<MeshComponent>(meshIt->second);
+                                                });
+                break;
+            }
+            case ERuntimeChunkType::RUNTIME_CHUNK_TYPE_ANIMATOR:
             {
-                slc.Intensity = node["SpotLightComponent"]["Intensity"].get<float>();
+                if (chunkHeader.RecordSize != sizeof(AnimatorRecord)) return onCorrupted();
+
+                bIsRead = ReadChunk<AnimatorRecord>(reader, chunkHeader, entities,
+                                                    [](Entity entity, const auto& record)
+                                                    {
+                                                        auto& ac             = entity.AddComponent<AnimatorComponent>();
+                                                        ac.AnimationIndex    = record.AnimationIndex;
+                                                        ac.PlaybackSpeed     = record.PlaybackSpeed;
+                                                        ac.CrossFadeDuration = record.CrossFadeDuration;
+                                                        ac.bIsPlaying        = record.bIsPlaying != 0;
+                                                    });
+                break;
             }
+            case ERuntimeChunkType::RUNTIME_CHUNK_TYPE_POINT_LIGHT:
+            {
+                if (chunkHeader.RecordSize != sizeof(PointLightRecord)) return onCorrupted();
 
-            if (node["SpotLightComponent"].contains("CutOff"))
+                bIsRead = ReadChunk<PointLightRecord>(reader, chunkHeader, entities,
+                                                      [](Entity entity, const auto& record)
+                                                      {
+                                                          auto& plc        = entity.AddComponent<PointLightComponent>();
+                                                          plc.Color        = record.Color;
+                                                          plc.Intensity    = record.Intensity;
+                                                          plc.bIsActive    = record.bIsActive != 0;
+                                                          plc.bCastShadows = record.bCastShadows != 0;
+                                                      });
+                break;
+            }
+            case ERuntimeChunkType::RUNTIME_CHUNK_TYPE_DIRECTIONAL_LIGHT:
             {
-                slc.CutOff = node["SpotLightComponent"]["CutOff"].get<float>();
+                if (chunkHeader.RecordSize != sizeof(DirectionalLightRecord)) return onCorrupted();
+
+                bIsRead = ReadChunk<DirectionalLightRecord>(reader, chunkHeader, entities,
+                                                            [](Entity entity, const auto& record)
+                                                            {
+                                                                auto& dlc        = entity.AddComponent<DirectionalLightComponent>();
+                                                                dlc.Color        = record.Color;
+                                                                dlc.Intensity    = record.Intensity;
+                                                                dlc.bCastShadows = record.bCastShadows != 0;
+                                                            });
+                break;
             }
+            case ERuntimeChunkType::RUNTIME_CHUNK_TYPE_SPOT_LIGHT:
+            {
+                if (chunkHeader.RecordSize != sizeof(SpotLightRecord)) return onCorrupted();
 
-            if (node["SpotLightComponent"].contains("OuterCutOff"))
+                bIsRead = ReadChunk<SpotLightRecord>(reader, chunkHeader, entities,
+                                                     [](Entity entity, const auto& record)
+                                                     {
+                                                         auto& slc        = entity.AddComponent<SpotLightComponent>();
+                                                         slc.Color        = record.Color;
+                                                         slc.Intensity    = record.Intensity;
+                                                         slc.CutOff       = record.CutOff;
+                                                         slc.OuterCutOff  = record.OuterCutOff;
+                                                         slc.bIsActive    = record.bIsActive != 0;
+                                                         slc.bCastShadows = record.bCastShadows != 0;
+                                                     });
+                break;
+            }
+            case ERuntimeChunkType::RUNTIME_CHUNK_TYPE_PARTICLE_EMITTER:
             {
-                slc.OuterCutOff = node["SpotLightComponent"]["OuterCutOff"].get<float>();
+                if (chunkHeader.RecordSize != sizeof(ParticleEmitterRecord)) return onCorrupted();
+
+                bIsRead = ReadChunk<ParticleEmitterRecord>(reader, chunkHeader, entities,
+                                                           [](Entity entity, const auto& record)
+                                                           {
+                                                               auto& pec             = entity.AddComponent<ParticleEmitterComponent>();
+                                                               pec.StartColor        = record.StartColor;
+                                                               pec.EndColor          = record.EndColor;
+                                                               pec.Velocity          = record.Velocity;
+                                                               pec.VelocityVariation = record.VelocityVariation;
+                                                               pec.BoundsExtent      = record.BoundsExtent;
+                                                               pec.SpawnRate         = record.SpawnRate;
+                                                               pec.Lifetime          = record.Lifetime;
+                                                               pec.StartSize         = record.StartSize;
+                                                               pec.EndSize           = record.EndSize;
+                                                               pec.bIsActive         = record.bIsActive != 0;
+                                                           });
+                break;
             }
+            case ERuntimeChunkType::RUNTIME_CHUNK_TYPE_CAMERA:
+            {
+                if (chunkHeader.RecordSize != sizeof(CameraRecord)) return onCorrupted();
 
-            if (node["SpotLightComponent"].contains("Active"))
+                bIsRead = ReadChunk<CameraRecord>(reader, chunkHeader, entities,
+                                                  [](Entity entity, const auto& record)
+                                                  { entity.AddComponent<CameraComponent>().bIsActive = record.bIsActive != 0; });
+                break;
+            }
+            default:
             {
-                slc.bIsActive = node["SpotLightComponent"]["Active"].get<bool>();
+                LOG_WARN("Skipping unknown chunk type %u in runtime scene \"%s\".", static_cast<uint32_t>(chunkHeader.Type),
+                         filePath.data());
+                bIsRead = reader.Skip(static_cast<size_t>(chunkHeader.RecordCount) * (sizeof(uint32_t) + chunkHeader.RecordSize));
+                break;
             }
         }
+
+        if (!bIsRead) return onCorrupted();
     }
 
-    JobSystem::Wait();
+    for (uint32_t i = 0; i < header.EntityCount; ++i)
+    {
+        if (parents[i] == s_INVALID_INDEX) continue;
+        if (parents[i] >= entities.size()) return onCorrupted();
+
+        scene->SetParent(entities[i], entities[parents[i]]);
+    }
+
+    m_Scene = scene;
+
     const auto deserializeEnd = Timer::Now();
-    LOG_WARN("Time took to deserialize \"%s\", (%0.2f) ms.", filePath.data(), (deserializeEnd - deserializeBegin) * 1000.0f);
+    LOG_WARN("Time took to deserialize runtime \"%s\", (%0.2f) ms.", filePath.data(), (deserializeEnd - deserializeBegin) * 1000.0f);
     return true;
 }
 
-bool SceneSerializer::DeserializeRuntime(const std::string& filePath)
-{
-    GNT_ASSERT(false, "Not implmented!");
-    return false;
-}
-
 }  // namespace Gauntlet
\ No newline at end of file
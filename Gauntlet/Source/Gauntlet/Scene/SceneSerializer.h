@@ -10,9 +10,13 @@ class Scene;
 class SceneSerializer final : private Uncopyable, private Unmovable
 {
   public:
+    // Text scenes are meant for editing, runtime ones are compact binary snapshots built for fast loading.
+    static constexpr std::string_view s_RUNTIME_SCENE_EXTENSION = ".gntltb";
+
     SceneSerializer(Ref<Scene>& scene);
 
-    void Serialize(const std::string& filePath);
+    // Pretty printed text is meant to be diffed && edited by hand, compact one is written as a single line.
+    void Serialize(const std::string& filePath, const bool bPrettyPrint = true);
     void SerializeRuntime(const std::string& filePath);
 
     bool Deserialize(const std::string& filePath);
@@ -27,6 +27,7 @@
 #include <mutex>
 #include <future>
 #include <condition_variable>
+#include <atomic>
 
 #include <Gauntlet/Core/Log.h>
 #include <Gauntlet/Core/Timer.h>
\ No newline at end of file
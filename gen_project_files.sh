@@ -0,0 +1,10 @@
+#!/bin/sh
+
+# Linux counterpart of gen_project_files.bat, generates makefiles: make config=release_x64 -j$(nproc)
+PREMAKE=vendor/premake/premake5
+if [ ! -x "$PREMAKE" ]; then PREMAKE=premake5; fi
+
+"$PREMAKE" gmake2 || exit 1
+
+mkdir -p Forge/Resources/Cached/Shaders
+mkdir -p Forge/Resources/Cached/Pipelines
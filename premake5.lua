@@ -34,6 +34,13 @@ Libraries["Shaderc_Release"] =       "%{VULKAN_PATH}/Lib/shaderc_shared.lib"
 Libraries["Shaderc_RelWithDebInfo"] ="%{VULKAN_PATH}/Lib/shaderc_shared.lib" 
 Libraries["Shaderc_Debug"] =         "%{VULKAN_PATH}/Lib/shaderc_sharedd.lib" 
 
+-- Linux links system(or LunarG SDK) shaderc && assimp, vendored assimp binaries are picked up from Binaries/Linux if present.
+Libraries["Assimp_Linux"] =          "assimp"
+Libraries["Shaderc_Linux"] =         "shaderc_shared"
+LibraryDir = {}
+LibraryDir["VULKAN_Linux"] =         "%{VULKAN_PATH}/lib"
+LibraryDir["Assimp_Linux"] =         "%{wks.location}/Gauntlet/vendor/assimp/Binaries/Linux"
+
 group "Dependencies"
     include "Gauntlet/vendor/GLFW"
     include "Gauntlet/vendor/imgui"
@@ -103,32 +110,44 @@ project "Gauntlet"
 			"GLM_FORCE_DEPTH_ZERO_TO_ONE"
 		}
 
+		removefiles { "%{prj.name}/Source/Gauntlet/Platform/Linux/**" }
+
+	-- premake5 gmake2, LunarG SDK layout is lowercase, distro packages resolve from system paths.
+	filter "system:linux"
+		pic "On"
+
+		defines
+		{
+			"GLFW_INCLUDE_NONE",
+			"GLM_FORCE_RADIANS",
+			"GLM_FORCE_DEPTH_ZERO_TO_ONE"
+		}
+
+		includedirs { "%{IncludeDir.VULKAN}/include" }
+		removefiles { "%{prj.name}/Source/Gauntlet/Platform/Windows/**" }
+
     filter "configurations:Debug"
         defines "GNT_DEBUG"
         symbols "On"
         optimize "Off"
-        
-        links
-        {
-            "%{Libraries.Shaderc_Debug}"
-        }
 
-        
     filter "configurations:Release"
         defines "GNT_RELEASE"
         symbols "Off"
         optimize "Full"
 
-        links
-        {
-            "%{Libraries.Shaderc_Release}"
-        }
-
     filter "configurations:RelWithDebInfo"
         defines "GNT_RELEASE"
         symbols "On"
         optimize "Debug"
-        
+
+    filter { "system:windows", "configurations:Debug" }
+        links
+        {
+            "%{Libraries.Shaderc_Debug}"
+        }
+
+    filter { "system:windows", "configurations:Release or RelWithDebInfo" }
         links
         {
             "%{Libraries.Shaderc_Release}"
@@ -177,11 +196,54 @@ project "Forge"
 			"GLM_FORCE_DEPTH_ZERO_TO_ONE"
 		}
 
+	-- Static libraries don't carry their dependencies on gmake, so they're linked here, grouped to ignore link order.
+	filter "system:linux"
+		linkgroups "On"
+
+		defines
+		{
+			"GLM_FORCE_RADIANS",
+			"GLM_FORCE_DEPTH_ZERO_TO_ONE"
+		}
+
+		libdirs
+		{
+			"%{LibraryDir.VULKAN_Linux}",
+			"%{LibraryDir.Assimp_Linux}"
+		}
+
+		links
+		{
+			"GLFW",
+			"ImGui",
+			"VulkanMemoryAllocator",
+			"spirv-reflect",
+			"meshoptimizer",
+			"%{Libraries.Shaderc_Linux}",
+			"%{Libraries.Assimp_Linux}",
+			"X11",
+			"dl",
+			"pthread"
+		}
+
+		runpathdirs { "%{LibraryDir.Assimp_Linux}" }
+
     filter "configurations:Debug"
         defines "GNT_DEBUG"
         symbols "On"
         optimize "Off"
+
+    filter "configurations:Release"
+        kind "WindowedApp"
+        defines "GNT_RELEASE"
+        symbols "Off"
+        optimize "Full"
         
+    filter "configurations:RelWithDebInfo"
+        symbols "On"
+        optimize "Debug"
+
+    filter { "system:windows", "configurations:Debug" }
         links
         {
             "%{Libraries.Assimp_Debug}"
@@ -192,13 +254,134 @@ project "Forge"
          	' {COPY} "%{Binaries.Assimp_Debug}" "%{cfg.targetdir}" '
         }
 
+    filter { "system:windows", "configurations:Release" }
+        links
+        {
+            "%{Libraries.Assimp_Release}"
+        }
+
+        postbuildcommands 
+        {
+         	' {COPY} "%{Binaries.Assimp_Release}" "%{cfg.targetdir}" '
+        }
+
+    filter { "system:windows", "configurations:RelWithDebInfo" }
+        links
+        {
+            "%{Libraries.Assimp_RelWithDebInfo}"
+        }
+
+        postbuildcommands 
+        {
+         	' {COPY} "%{Binaries.Assimp_RelWithDebInfo}" "%{cfg.targetdir}" '
+        }
+group ""
+
+group "Tools"
+project "Benchmark"
+    location "Benchmark"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+    staticruntime "off"
+
+    targetdir("Binaries/" .. outputdir .. "/%{prj.name}")
+    objdir("Intermediate/" .. outputdir .. "/%{prj.name}")
+
+    -- Scenes && shaders are resolved relative to the editor's directory.
+    debugdir "Forge"
+
+    files 
+    {
+        "%{prj.name}/Source/**.h",
+        "%{prj.name}/Source/**.cpp"
+    }
+
+    includedirs
+    {
+        "Benchmark/Source",
+        "%{IncludeDir.glm}",
+        "%{IncludeDir.entt}",
+        "%{IncludeDir.json}",
+		"Gauntlet/vendor",
+		"Gauntlet/Source"
+    }
+
+    links 
+    {
+		"Gauntlet"
+    }
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+			"_CRT_SECURE_NO_WARNINGS",
+			"GLM_FORCE_RADIANS",
+			"GLM_FORCE_DEPTH_ZERO_TO_ONE"
+		}
+
+	-- Static libraries don't carry their dependencies on gmake, so they're linked here, grouped to ignore link order.
+	filter "system:linux"
+		linkgroups "On"
+
+		defines
+		{
+			"GLM_FORCE_RADIANS",
+			"GLM_FORCE_DEPTH_ZERO_TO_ONE"
+		}
 
+		libdirs
+		{
+			"%{LibraryDir.VULKAN_Linux}",
+			"%{LibraryDir.Assimp_Linux}"
+		}
+
+		links
+		{
+			"GLFW",
+			"ImGui",
+			"VulkanMemoryAllocator",
+			"spirv-reflect",
+			"meshoptimizer",
+			"%{Libraries.Shaderc_Linux}",
+			"%{Libraries.Assimp_Linux}",
+			"X11",
+			"dl",
+			"pthread"
+		}
+
+		runpathdirs { "%{LibraryDir.Assimp_Linux}" }
+
+    filter "configurations:Debug"
+        defines "GNT_DEBUG"
+        symbols "On"
+        optimize "Off"
+        
+    -- Stays a console application, results are also logged.
     filter "configurations:Release"
-        kind "WindowedApp"
         defines "GNT_RELEASE"
         symbols "Off"
         optimize "Full"
         
+    filter "configurations:RelWithDebInfo"
+        defines "GNT_RELEASE"
+        symbols "On"
+        optimize "Debug"
+
+    filter { "system:windows", "configurations:Debug" }
+        links
+        {
+            "%{Libraries.Assimp_Debug}"
+        }
+
+        postbuildcommands 
+        {
+         	' {COPY} "%{Binaries.Assimp_Debug}" "%{cfg.targetdir}" '
+        }
+
+    filter { "system:windows", "configurations:Release" }
         links
         {
             "%{Libraries.Assimp_Release}"
@@ -208,11 +391,8 @@ project "Forge"
         {
          	' {COPY} "%{Binaries.Assimp_Release}" "%{cfg.targetdir}" '
         }
-        
-    filter "configurations:RelWithDebInfo"
-        symbols "On"
-        optimize "Debug"
 
+    filter { "system:windows", "configurations:RelWithDebInfo" }
         links
         {
             "%{Libraries.Assimp_RelWithDebInfo}"
@@ -222,4 +402,4 @@ project "Forge"
         {
          	' {COPY} "%{Binaries.Assimp_RelWithDebInfo}" "%{cfg.targetdir}" '
         }
-group ""
\ No newline at end of file
+group ""